@@ -779,9 +779,9 @@ static char *getEndPoint_input()
 
 static void init()
 {
-    config = (EdgeConfigure *) EdgeMalloc(sizeof(EdgeConfigure));
+    config = (EdgeConfigure *) EdgeCalloc(1, sizeof(EdgeConfigure));
     VERIFY_NON_NULL_NR(config);
-    config->recvCallback = (ReceivedMessageCallback *) EdgeMalloc(sizeof(ReceivedMessageCallback));
+    config->recvCallback = (ReceivedMessageCallback *) EdgeCalloc(1, sizeof(ReceivedMessageCallback));
     VERIFY_NON_NULL_NR(config->recvCallback);
     config->recvCallback->resp_msg_cb = response_msg_cb;
     config->recvCallback->monitored_msg_cb = monitored_msg_cb;
@@ -45,6 +45,34 @@ typedef void (*response_cb_t) (EdgeMessage *data);
  */
 typedef void (*send_cb_t) (EdgeMessage *data);
 
+/**
+ * @brief Callback Function to register for sending several requests together
+ * @param[out]  data Request EdgeMessages
+ * @param[out]  count Number of messages
+ */
+typedef void (*send_batch_cb_t) (EdgeMessage **data, size_t count);
+
+/**
+ * @brief Callback Function to register for the requests dropped before they were sent
+ * @param[out]  data Request EdgeMessage
+ * @param[out]  code Result code of the error response
+ * @param[out]  reason Why the request was dropped
+ */
+typedef void (*discard_cb_t) (EdgeMessage *data, EdgeStatusCode code, const char *reason);
+
+/**
+ * @brief Callback Function to register for choosing the client session of a request when it is queued
+ * @param[in]  data Request EdgeMessage
+ * @return index of the session among the sessions of the endpoint
+ */
+typedef uint32_t (*session_select_cb_t) (EdgeMessage *data);
+
+/**
+ * @brief Callback Function to register for the requests which are done with their client session
+ * @param[in]  data Request EdgeMessage
+ */
+typedef void (*session_release_cb_t) (EdgeMessage *data);
+
 /**
  * @brief Callback Function to register for receiving the status response
  * @param  epInfo Endpoint information
@@ -111,6 +111,12 @@ typedef struct EdgeResponse
     /**< request id */
     int requestId;
 
+    /**< Attribute which was read. 0 for other commands. */
+    uint32_t attributeId;
+
+    /**< OPC UA status code of the operation on the node. Set by writes, 0 (Good) otherwise. */
+    uint32_t status;
+
     /**< Diagnostic information */
     EdgeDiagnosticInfo *m_diagnosticInfo;
 } EdgeResponse;
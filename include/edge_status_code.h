@@ -94,6 +94,9 @@ typedef enum
     /** Result is more than requests.*/
     STATUS_WRITE_TOO_MANY_RESPONSE = 52,
 
+    /** Write request was not sent, because a newer one to the same node was queued.*/
+    STATUS_WRITE_SUPERSEDED = 53,
+
     /** NodeId of all the results are unknown.*/
     STATUS_VIEW_NODEID_UNKNOWN_ALL_RESULTS = 60,
 
@@ -255,6 +258,9 @@ typedef enum
 /** STATUS_WRITE_TOO_MANY_RESPONSE - Description.*/
 #define STATUS_WRITE_TOO_MANY_RESPONSE_VALUE         "result is more than requests"
 
+/** STATUS_WRITE_SUPERSEDED - Description.*/
+#define STATUS_WRITE_SUPERSEDED_VALUE         "superseded by a newer write to the same node"
+
 /** STATUS_VIEW_NODEID_UNKNOWN_ALL_RESULTS - Description.*/
 #define STATUS_VIEW_NODEID_UNKNOWN_ALL_RESULTS_VALUE         "all of results has Bad_NodeIdUnknown error"
 
@@ -229,6 +229,58 @@ typedef struct EdgeBrowseParameter
     int maxReferencesPerNode;
 } EdgeBrowseParameter;
 
+/**
+  * @brief Enum which represents the behaviour of a full send/receive queue
+  *
+  */
+typedef enum
+{
+    /**< Default behaviour of the queue. REJECT for send queue, BLOCK for receive queue. */
+    EDGE_QUEUE_OVERFLOW_DEFAULT = 0,
+    /**< Producer waits until a slot is free. */
+    EDGE_QUEUE_OVERFLOW_BLOCK,
+    /**< Oldest queued message is dropped to make room for the new message. */
+    EDGE_QUEUE_OVERFLOW_DROP_OLDEST,
+    /**< New message is rejected. sendRequest() returns STATUS_ENQUEUE_ERROR. */
+    EDGE_QUEUE_OVERFLOW_REJECT
+} EdgeQueueOverflowPolicy;
+
+/**
+  * @brief Enum which represents the priority of a request in the send queue
+  * Requests of a higher priority are processed first, but a lower priority still gets
+  * a share of the processing. Requests to an endpoint are processed in order
+  * only when they have the same priority.
+  * Start, stop and subscription requests do not take a priority. They are processed in the
+  * order they are sent, ahead of the other requests. A stop request still waits until every
+  * request sent to its endpoint before it is done, and the requests sent after it wait
+  * for the stop.
+  *
+  */
+typedef enum
+{
+    /**< Priority derived from the command.
+    NORMAL for write and method, BULK for read and browse. */
+    EDGE_MESSAGE_PRIORITY_DEFAULT = 0,
+    /**< Urgent requests, served like the control requests. */
+    EDGE_MESSAGE_PRIORITY_HIGH,
+    /**< Time-critical requests. */
+    EDGE_MESSAGE_PRIORITY_NORMAL,
+    /**< Large or slow requests. */
+    EDGE_MESSAGE_PRIORITY_BULK
+} EdgeMessagePriority;
+
+/**
+  * @brief Enum which represents how the requests to an endpoint are spread over its sessions
+  *
+  */
+typedef enum
+{
+    /**< Sessions take turns. */
+    EDGE_SESSION_POLICY_ROUND_ROBIN = 0,
+    /**< Session with the fewest queued and running requests. */
+    EDGE_SESSION_POLICY_LEAST_OUTSTANDING
+} EdgeSessionPolicy;
+
 /**
   * @brief Structure which represents the endpoint configuratino information
   *
@@ -246,6 +298,35 @@ typedef struct EdgeEndpointConfig
 
     /**< Port.*/
     uint32_t bindPort;
+
+    /**< Number of client sessions opened to the endpoint, 0 or 1 for a single session.
+     * Requests to one session are sent in order, requests to different sessions in parallel.
+     * Writes and method calls all go to the same session, so those of the same priority are
+     * executed in the order they were queued in. Reads and browses are spread over the
+     * sessions, so with more than one session a read may be answered before a write queued
+     * ahead of it. Queue the read once the write was answered when it must see the written
+     * value.*/
+    uint32_t sessionCount;
+
+    /**< How reads and browses are spread over the sessions. Subscriptions always use the
+     * first session.*/
+    EdgeSessionPolicy sessionPolicy;
+
+    /**< The first session only serves subscriptions. Needs a sessionCount of 2 or more.*/
+    bool dedicatedSubscriptionSession;
+
+    /**< Reconnect a lost session and restore its subscriptions instead of dropping the endpoint.*/
+    bool autoReconnect;
+
+    /**< Delay before the first reconnect attempt in milliseconds, 0 for the default.
+     * The delay doubles with every failed attempt.*/
+    uint32_t reconnectInitialDelay;
+
+    /**< Longest delay between reconnect attempts in milliseconds, 0 for the default.*/
+    uint32_t reconnectMaxDelay;
+
+    /**< Reconnect attempts before the endpoint is dropped, 0 to retry until it is disconnected.*/
+    uint32_t reconnectMaxAttempts;
 } EdgeEndpointConfig;
 
 /**
@@ -448,6 +529,17 @@ typedef struct EdgeRequest
 
     /**< Return Diagnostics.*/
     int returnDiagnostic;
+
+    /**< Oldest value in milliseconds a read accepts from the client cache or the server.
+     * 0 always reads the current value.*/
+    double maxAge;
+
+    /**< Attribute to read. 0 reads the attribute of the command.*/
+    uint32_t attributeId;
+
+    /**< Elements of an array value to read, ex) "10:20". NULL reads the whole value.
+     * A range "first:last" of a long array is read in pages which fit into a message.*/
+    char *indexRange;
 } EdgeRequest;
 
 /**
@@ -498,6 +590,10 @@ typedef struct EdgeMessage
     /**< Response length */
     size_t responseLength;
 
+    /**< Results of a group read in one block, when EdgeQueueConfigure.flatReadResults is set.
+     * responses is NULL then. Read with getFlatResultValue() and getFlatResultString(). **/
+    struct EdgeFlatResults *flatResults;
+
     /**< Status code of requested operation.*/
     EdgeResult *result;
 
@@ -516,8 +612,226 @@ typedef struct EdgeMessage
     /**< Server Time Stamp **/
     EdgeTimeInfo serverTime;
 
+    /**< Priority of the request in the send queue **/
+    EdgeMessagePriority priority;
+
+    /**< Time in milliseconds the request may take from sendRequest() on, 0 for no deadline.
+     * A request still queued when it expires is dropped with an ERROR_RESPONSE.
+     * The remaining time is also the timeout of the service call. **/
+    uint32_t timeoutMs;
+
+    /**< Set to true to send a READ request at once instead of holding it back for up to
+     * EdgeQueueConfigure.readBatchWindowMs to be read along with other requests. **/
+    bool sendImmediately;
+
+    /**< Monotonic time in microseconds the request expires at, derived from timeoutMs.
+     * 0 when there is no deadline. Set by the stack only. **/
+    uint64_t deadline;
+
+    /**< Hash of the address in endpointInfo, which selects the send thread and the client
+     * session. 0 until the message is queued. Set by the stack only. **/
+    uint32_t endpointHash;
+
+    /**< Session of the endpoint which serves the request, chosen when the message is queued.
+     * Set by the stack only. **/
+    uint32_t sessionIndex;
+
+    /**< Sequence number of a WRITE request to one node while EdgeQueueConfigure.coalesceWrites is
+     * set, which tells whether a newer write to the node is queued. 0 for other messages.
+     * Set by the stack only. **/
+    uint32_t writeSequence;
+
+    /**< 1 while the request is counted in the requests of its endpoint a stop waits for,
+     * otherwise 0. Set by the stack only. **/
+    uint32_t endpointCounted;
+
+    /**< Order the request is queued in, which tells whether a cancellation applies to it.
+     * 0 while it is not waiting in the send queues. Set by the stack only. **/
+    uint64_t queueSequence;
+
+    /**< Arena holding the message and all its members, released by destroyEdgeMessage().
+     * NULL when they are allocated one by one. Set by the stack only. **/
+    struct EdgeArena *arena;
+
+    /**< Prepared group the request executes, whose nodes are built already. It owns the
+     * endpoint and the requests of the message. NULL for other messages. Set by the stack only. **/
+    struct EdgePreparedGroup *preparedGroup;
+
 } EdgeMessage;
 
+/**
+  * @brief Number of buckets of EdgeLatencyHistogram.
+  */
+#define EDGE_LATENCY_HISTOGRAM_BUCKETS (128)
+
+/**
+  * @brief Number of commands in EdgeAdapterStatistics. The commands are indexed by EdgeCommand.
+  */
+#define EDGE_STATISTICS_COMMAND_COUNT (CMD_READ_SAMPLING_INTERVAL + 1)
+
+/**
+  * @brief Maximum number of send queues in EdgeAdapterStatistics.
+  */
+#define EDGE_STATISTICS_MAX_SEND_QUEUES (16)
+
+/**
+  * @brief Histogram of durations in microseconds.
+  * Durations below 4 microseconds have one bucket each. Above, each power of two is split
+  * into four buckets of equal width. getLatencyBucketLowerBound() gives the range of a bucket.
+  *
+  */
+typedef struct EdgeLatencyHistogram
+{
+    /**< Number of recorded durations.*/
+    uint64_t count;
+
+    /**< Sum of the recorded durations.*/
+    uint64_t totalUs;
+
+    /**< Longest recorded duration.*/
+    uint64_t maxUs;
+
+    /**< Number of recorded durations in each bucket.*/
+    uint64_t buckets[EDGE_LATENCY_HISTOGRAM_BUCKETS];
+} EdgeLatencyHistogram;
+
+/**
+  * @brief Occupancy of a message queue.
+  *
+  */
+typedef struct EdgeQueueStatistics
+{
+    /**< Number of messages in the queue.*/
+    uint32_t depth;
+
+    /**< Largest number of messages seen in the queue.*/
+    uint32_t highWaterMark;
+
+    /**< Number of messages dropped by EDGE_QUEUE_OVERFLOW_DROP_OLDEST.*/
+    uint32_t droppedCount;
+} EdgeQueueStatistics;
+
+/**
+  * @brief Timings of the messages of one command.
+  *
+  */
+typedef struct EdgeCommandStatistics
+{
+    /**< Time requests waited in the send queue.*/
+    EdgeLatencyHistogram sendWait;
+
+    /**< Time taken to process requests, including the OPC UA service call.*/
+    EdgeLatencyHistogram sendService;
+
+    /**< Time responses and reports waited in the receive queue.*/
+    EdgeLatencyHistogram recvWait;
+
+    /**< Time spent in the application callbacks.*/
+    EdgeLatencyHistogram recvCallback;
+} EdgeCommandStatistics;
+
+/**
+  * @brief Statistics of the send and receive paths.
+  *
+  */
+typedef struct EdgeAdapterStatistics
+{
+    /**< Whether the timings and high water marks are collected.
+    See EdgeQueueConfigure.collectStatistics.*/
+    bool enabled;
+
+    /**< Number of send queues.*/
+    uint32_t sendQueueCount;
+
+    /**< Send queues. One per send thread.*/
+    EdgeQueueStatistics sendQueues[EDGE_STATISTICS_MAX_SEND_QUEUES];
+
+    /**< Receive queue.*/
+    EdgeQueueStatistics recvQueue;
+
+    /**< Timings per command, indexed by EdgeCommand. Reports are counted under CMD_SUB.*/
+    EdgeCommandStatistics commands[EDGE_STATISTICS_COMMAND_COUNT];
+} EdgeAdapterStatistics;
+
+/**
+  * @brief Counters of a poll started with startPolling().
+  *
+  */
+typedef struct EdgePollStatistics
+{
+    /**< Interval of the poll in milliseconds.*/
+    uint32_t intervalMs;
+
+    /**< Number of cycles started.*/
+    uint64_t cycles;
+
+    /**< Number of cycles skipped, because the previous cycle was still running at their
+    deadline or their deadline passed before the poll thread woke up.*/
+    uint64_t overruns;
+
+    /**< Longest time in microseconds a cycle started after its deadline.*/
+    uint64_t maxLatenessUs;
+} EdgePollStatistics;
+
+/**
+  * @brief Entry of a node in EdgeFlatResults.
+  *
+  */
+typedef struct EdgeFlatValue
+{
+    /**< Type of the value, as EdgeResponse.type. 0 if the node was not read.*/
+    int type;
+
+    /**< Status code of the read of the node, 0 if it was read.*/
+    uint32_t status;
+
+    /**< Request Id of the node.*/
+    int requestId;
+
+    /**< Attribute Id which was read.*/
+    uint32_t attributeId;
+
+    /**< true if the value is an array.*/
+    bool isArray;
+
+    /**< true if the elements are in the string pool, false if they are in the data block.*/
+    bool isString;
+
+    /**< Number of elements, 1 for a scalar.*/
+    size_t elementCount;
+
+    /**< Position of the first element in EdgeFlatResults.data or EdgeFlatResults.strings.*/
+    size_t offset;
+} EdgeFlatValue;
+
+/**
+  * @brief Results of a group read in one contiguous block.
+  * Values of fixed size types lie in data, each in the memory layout of its type and aligned
+  * to 8 bytes. Strings, byte strings, XML elements and GUIDs lie in the string pool, each
+  * as a 32 bit length followed by the bytes and a terminating '\0'.
+  *
+  */
+typedef struct EdgeFlatResults
+{
+    /**< Number of entries, one for each node in the order of the requests.*/
+    size_t count;
+
+    /**< Entries of the nodes.*/
+    EdgeFlatValue *values;
+
+    /**< Values of fixed size types.*/
+    unsigned char *data;
+
+    /**< Size of data in bytes.*/
+    size_t dataSize;
+
+    /**< String pool.*/
+    unsigned char *strings;
+
+    /**< Size of the string pool in bytes.*/
+    size_t stringsSize;
+} EdgeFlatResults;
+
 #ifdef __cplusplus
 }
 #endif
@@ -54,6 +54,13 @@ typedef void (*response_msg_cb_t) (EdgeMessage *data);
  */
 typedef void (*monitored_msg_cb_t) (EdgeMessage *data);
 
+/**
+ * @brief Monitored Message callback which represents all the data change notifications
+ * of one publish cycle. Each response of the message is one notification.
+ *
+ */
+typedef void (*monitored_batch_msg_cb_t) (EdgeMessage *data);
+
 /**
  * @brief Error Message callback which represents the occurence of error in requested operation
  *
@@ -166,6 +173,69 @@ typedef struct EdgeConfigure
     DiscoveryCallback *discoveryCallback;
 } EdgeConfigure_t;
 
+/**
+ * @brief EdgeQueueConfigure structure which contains the configuration of the send and
+ * receive paths, given to configureQueue(). Zeroed members select the defaults.
+ *
+ */
+typedef struct EdgeQueueConfigure
+{
+    /**< Number of threads which process the requests.
+    Requests to the same endpoint are processed in order by one thread,
+    requests to different endpoints are processed in parallel.
+    0 selects the number of processors.*/
+    uint32_t sendWorkerCount;
+
+    /**< Maximum number of pending requests of each priority in each send queue.
+    0 selects the default.*/
+    uint32_t sendQueueCapacity;
+
+    /**< Behaviour of sendRequest() when the send queue is full.*/
+    EdgeQueueOverflowPolicy sendQueueOverflowPolicy;
+
+    /**< Maximum number of pending responses and reports in the receive queue.
+    0 selects the default.*/
+    uint32_t recvQueueCapacity;
+
+    /**< Behaviour of the receive path when the receive queue is full.*/
+    EdgeQueueOverflowPolicy recvQueueOverflowPolicy;
+
+    /**< Time in milliseconds a READ request may be held back to be sent
+    together with other READ requests to the same endpoint in one read service call.
+    Each request still gets its own response. 0 disables the batching.
+    A request with EdgeMessage.sendImmediately set is never held back.*/
+    uint32_t readBatchWindowMs;
+
+    /**< Maximum number of nodes in one batched read service call.
+    Reaching it sends the batch without waiting for readBatchWindowMs. 0 selects the default.*/
+    uint32_t readBatchMaxNodes;
+
+    /**< Monitored Response callback for subscription, receiving the notifications in batches.
+    Optional. When set, it is called instead of monitored_msg_cb. A batch holds the
+    notifications of one subscription request, and carries its message_id. */
+    monitored_batch_msg_cb_t monitoredBatchCallback;
+
+    /**< Maximum number of notifications in one message given to monitoredBatchCallback.
+    Reaching it delivers the message before the end of the publish cycle. 0 selects the default.*/
+    uint32_t reportBatchMaxSize;
+
+    /**< Set to true to collect the queue wait and processing times per command and the
+    queue high water marks, read with getAdapterStatistics(). Messages are not time stamped
+    when false. Takes effect when the queues are created.*/
+    bool collectStatistics;
+
+    /**< Set to true to deliver the results of a READ group request in one EdgeFlatResults
+    instead of an EdgeResponse per node. Groups with values of other types than numbers,
+    DateTime, StatusCode, strings, byte strings, XML elements and GUIDs get EdgeResponses.*/
+    bool flatReadResults;
+
+    /**< Set to true to send only the newest of the queued WRITE requests with one node,
+    per endpoint and node. The older ones are answered with an ERROR_RESPONSE whose result
+    code is STATUS_WRITE_SUPERSEDED instead of being sent. Writes queued before a read of
+    their node or a method call to their endpoint are always sent.*/
+    bool coalesceWrites;
+} EdgeQueueConfigure_t;
+
 #ifdef __cplusplus
 }
 #endif
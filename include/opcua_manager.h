@@ -42,6 +42,7 @@ extern "C" {
 #endif
 
 typedef struct EdgeConfigure EdgeConfigure;
+typedef struct EdgeQueueConfigure EdgeQueueConfigure;
 typedef struct EdgeResult EdgeResult;
 typedef struct EdgeMessage EdgeMessage;
 typedef struct EdgeDevice EdgeDevice;
@@ -52,11 +53,20 @@ typedef struct EdgeRequest EdgeRequest;
 typedef struct EdgeEndpointConfig EdgeEndpointConfig;
 typedef struct EdgeApplicationConfig EdgeApplicationConfig;
 typedef struct EdgeBrowseParameter EdgeBrowseParameter;
+typedef struct EdgePreparedGroup EdgePreparedGroup;
 
 void onSendMessage(EdgeMessage* msg);
+void onSendMessageBatch(EdgeMessage **msgs, size_t count);
+void onDiscardMessage(EdgeMessage *msg, EdgeStatusCode code, const char *reason);
+uint32_t onSelectSession(EdgeMessage *msg);
+void onReleaseSession(EdgeMessage *msg);
 void onResponseMessage(EdgeMessage *msg);
 void onStatusCallback(EdgeEndPointInfo *epInfo, EdgeStatusCode status);
 void onDiscoveryCallback(EdgeDevice *device);
+bool onPollCycle(const uint32_t *pollIds, size_t pollCount, void *context, void **job);
+void onPollDispatch(void *job);
+void *onPollMerge(void *context, void *added);
+void onPollFree(void *context);
 
 /**
  * @brief Function for creating the server
@@ -115,6 +125,15 @@ EXPORT void disconnectClient(EdgeEndPointInfo *epInfo);
  */
 EXPORT void configure(EdgeConfigure *config);
 
+/**
+ * @brief Set the configuration of the send and receive paths.\n
+ *        Optional. Without it the defaults are used. The worker count, the queue
+ *        capacities and policies, the read batching and the statistics take effect when
+ *        the queues are created, so this is called before the first server or client start.
+ * @param[in]  config Configuration of the queues. It is copied.
+ */
+EXPORT void configureQueue(EdgeQueueConfigure *config);
+
 /**
  * @brief Add a new namespace to the server.
  * @param[in]  name Namespace name/URI
@@ -226,9 +245,185 @@ EXPORT void showNodeList(void);
  * @retval #STATUS_OK Successful
  * @retval #STATUS_PARAM_INVALID Invalid parameter
  * @retval #STATUS_ERROR Operation failed
+ * @retval #STATUS_ENQUEUE_ERROR Send queue is full (EDGE_QUEUE_OVERFLOW_REJECT policy)
  */
 EXPORT EdgeResult sendRequest(EdgeMessage* msg);
 
+/**
+ * @brief Send the EdgeMessage request to queue for processing without copying it.\n
+ *        The stack takes ownership of the message and destroys it once the request is
+ *        processed, or right away if it is rejected. The message must be created with
+ *        createEdgeMessage() and must not be used by the application after this call.
+ * @param[in]  msg EdgeMessage request data
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ENQUEUE_ERROR Send queue is full (EDGE_QUEUE_OVERFLOW_REJECT policy)
+ */
+EXPORT EdgeResult sendRequestMove(EdgeMessage* msg);
+
+/**
+ * @brief Prepare a read message to be sent repeatedly.\n
+ *        The nodes are parsed and their read request is built once, so executePreparedRead()
+ *        only queues the request. The message is copied and stays owned by the application.
+ *        Every execution is answered with the message_id of the message.
+ * @param[in]  msg EdgeMessage with CMD_READ or CMD_READ_SAMPLING_INTERVAL and its nodes
+ * @return prepared group on success, to be destroyed with destroyPreparedGroup(),
+ *         NULL if msg is invalid or memory allocation failed
+ */
+EXPORT EdgePreparedGroup *prepareReadGroup(EdgeMessage *msg);
+
+/**
+ * @brief Prepare a write message to be sent repeatedly with new values.\n
+ *        The nodes are parsed and their write values are built once, so executePreparedWrite()
+ *        only copies the values and queues the request. The message is copied and stays owned
+ *        by the application. Every execution is answered with the message_id of the message.
+ * @param[in]  msg EdgeMessage with CMD_WRITE and its nodes and values
+ * @return prepared group on success, to be destroyed with destroyPreparedGroup(),
+ *         NULL if msg is invalid or memory allocation failed
+ */
+EXPORT EdgePreparedGroup *prepareWriteGroup(EdgeMessage *msg);
+
+/**
+ * @brief Send the request of a prepared read group to queue for processing
+ * @param[in]  group Group prepared with prepareReadGroup()
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ * @retval #STATUS_ENQUEUE_ERROR Send queue is full (EDGE_QUEUE_OVERFLOW_REJECT policy)
+ */
+EXPORT EdgeResult executePreparedRead(EdgePreparedGroup *group);
+
+/**
+ * @brief Send the request of a prepared write group to queue for processing
+ * @param[in]  group Group prepared with prepareWriteGroup()
+ * @param[in]  values Values to write, one per node in the order the nodes were inserted,
+ *             or NULL to write the values of the prepared message. They are copied.
+ * @param[in]  valueCounts Number of elements of each value, 1 for a scalar.
+ *             NULL if all values are scalars.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ * @retval #STATUS_ENQUEUE_ERROR Send queue is full (EDGE_QUEUE_OVERFLOW_REJECT policy)
+ */
+EXPORT EdgeResult executePreparedWrite(EdgePreparedGroup *group, void **values,
+        const size_t *valueCounts);
+
+/**
+ * @brief Destroy a prepared group. Executions still queued complete before it is freed.
+ * @param[in]  group Group. NULL is ignored.
+ */
+EXPORT void destroyPreparedGroup(EdgePreparedGroup *group);
+
+/**
+ * @brief Read the nodes of a message every intervalMs milliseconds.\n
+ *        The cycles start on a fixed grid of the interval, so they do not drift. The nodes
+ *        of all polls with the same command, endpoint and interval are read together, but
+ *        each poll keeps its own id. Every cycle is answered through resp_msg_cb with a
+ *        message for each poll, whose message_id is the id of the poll and which holds the
+ *        responses for its nodes only. Each response carries the requestId of its request.
+ *        A cycle is skipped while the previous one is still running.
+ *        The message is copied and stays owned by the application.
+ * @param[in]  msg EdgeMessage with CMD_READ or CMD_READ_SAMPLING_INTERVAL and its nodes
+ * @param[in]  intervalMs Interval between the cycles in milliseconds
+ * @param[out] pollId Id of the poll which reads the nodes
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EXPORT EdgeResult startPolling(EdgeMessage *msg, uint32_t intervalMs, uint32_t *pollId);
+
+/**
+ * @brief Stop a poll started with startPolling(), with the nodes it reads. The polls read
+ *        together with it keep reading their nodes.
+ *        A cycle already queued is still answered.
+ * @param[in]  pollId Id of the poll
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID No such poll
+ */
+EXPORT EdgeResult stopPolling(uint32_t pollId);
+
+/**
+ * @brief Get the cycle and overrun counters of a poll.
+ * @param[in]  pollId Id of the poll
+ * @param[out] stats Counters of the poll
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter or no such poll
+ */
+EXPORT EdgeResult getPollingStatistics(uint32_t pollId, EdgePollStatistics *stats);
+
+/**
+ * @brief Get the elements of a fixed size value in the flat results of a read response.\n
+ *        The elements have the memory layout of the type of the entry, e.g. double for
+ *        UA_NS0ID_DOUBLE, and there are elementCount of them.
+ * @param[in]  msg Read response with flatResults
+ * @param[in]  index Position of the node in the request
+ * @return First element, NULL if the node was not read or its value is a string
+ */
+EXPORT const void *getFlatResultValue(const EdgeMessage *msg, size_t index);
+
+/**
+ * @brief Get the first string of a value in the flat results of a read response.\n
+ *        Strings, byte strings, XML elements and GUIDs are strings.
+ * @param[in]  msg Read response with flatResults
+ * @param[in]  index Position of the node in the request
+ * @param[out] length Length of the string in bytes
+ * @return String terminated by '\0', NULL if the node was not read or its value is no string
+ */
+EXPORT const char *getFlatResultString(const EdgeMessage *msg, size_t index, size_t *length);
+
+/**
+ * @brief Get the next string of an array in the flat results of a read response.\n
+ *        Only elementCount strings may be taken for an entry.
+ * @param[in]  str String of the array
+ * @param[out] length Length of the next string in bytes
+ * @return Next string terminated by '\0'
+ */
+EXPORT const char *getNextFlatResultString(const char *str, size_t *length);
+
+/**
+ * @brief Withdraw the requests with the given message id which are still waiting in the send queue.\n
+ *        Each of them is answered with an ERROR_RESPONSE instead of being sent.
+ *        Requests already sent to the server and the requests sent afterwards with the
+ *        same message_id, like the next cycles of a poll, are not affected.
+ * @param[in]  message_id message_id of the requests
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_ERROR No request with the message_id waits in the send queue
+ */
+EXPORT EdgeResult cancelRequest(uint32_t message_id);
+
+/**
+ * @brief Get the queue depths, high water marks and the wait and processing times
+ *        per command, collected when EdgeQueueConfigure.collectStatistics is set.\n
+ *        EdgeAdapterStatistics is large, allocate it on the heap.
+ * @param[out]  stats Statistics of the adapter
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ */
+EXPORT EdgeResult getAdapterStatistics(EdgeAdapterStatistics *stats);
+
+/**
+ * @brief Get the smallest time counted in a bucket of EdgeLatencyHistogram.
+ * @param[in]  bucket Bucket index
+ * @return Time in microseconds
+ */
+EXPORT uint64_t getLatencyBucketLowerBound(size_t bucket);
+
+/**
+ * @brief Get an upper estimate of a percentile of the times in EdgeLatencyHistogram.
+ * @param[in]  histogram Histogram
+ * @param[in]  percentile Percentile between 0 and 100, e.g. 99.9
+ * @return Time in microseconds, 0 if the histogram is empty
+ */
+EXPORT uint64_t getLatencyPercentile(const EdgeLatencyHistogram *histogram, double percentile);
+
 /**
  * @brief Deallocates the dynamic memory for EdgeResult. \n
                   Behaviour is undefined if EdgeResult is not dynamically allocated.
@@ -408,6 +603,23 @@ EXPORT EdgeMessage* createEdgeMessage(const char *endpointUri, size_t requestSiz
  */
 EXPORT EdgeResult insertReadAccessNode(EdgeMessage **msg, const char* nodeName);
 
+/**
+ * @brief Insert Read Access of an attribute or a part of an array to the EdgeMessage request data.\n
+ *        Attributes and ranges may be mixed in one CMD_READ message.
+ * @param[in]  msg EdgeMessage request
+ * @param[in]  nodeName Node name
+ * @param[in]  attributeId Attribute to read, ex) UA_ATTRIBUTEID_DATATYPE. 0 for the attribute of the command
+ * @param[in]  indexRange Elements of an array value to read, ex) "65024:65535".
+ *             NULL for the whole value. It is copied.
+ * @param[out]  msg EdgeMessage request
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EXPORT EdgeResult insertReadAttributeNode(EdgeMessage **msg, const char* nodeName,
+        uint32_t attributeId, const char *indexRange);
+
 /**
  * @brief Insert Write Access to the EdgeMessage request data
  * @param[in]  msg EdgeMessage request
@@ -27,9 +27,14 @@
 #include "edge_open62541.h"
 #include "edge_malloc.h"
 #include "edge_random.h"
+#include "edge_prepared_group.h"
+#include "edge_poll_scheduler.h"
+#include "edge_flat_results.h"
+#include "ocatomic.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #ifndef _WIN32
 #include <regex.h>
@@ -40,6 +45,7 @@
 static ReceivedMessageCallback *receivedMsgCb;
 static StatusCallback *statusCb;
 static DiscoveryCallback *discoveryCb;
+static monitored_batch_msg_cb_t monitoredBatchCb;
 
 static bool b_serverInitialized = false;
 
@@ -80,6 +86,25 @@ void configure(EdgeConfigure *config)
     registerClientCallback(onResponseMessage, onStatusCallback, onDiscoveryCallback);
     registerServerCallback(onStatusCallback);
     registerMQCallback(onResponseMessage, onSendMessage);
+    registerMQBatchCallback(onSendMessageBatch);
+    registerMQDiscardCallback(onDiscardMessage);
+    registerMQSessionCallback(onSelectSession, onReleaseSession);
+    registerEdgePollCallbacks(onPollCycle, onPollDispatch, onPollMerge, onPollFree);
+}
+
+void configureQueue(EdgeQueueConfigure *config)
+{
+    VERIFY_NON_NULL_NR_MSG(config, "NULL config param in configureQueue\n");
+    monitoredBatchCb = config->monitoredBatchCallback;
+    configure_send_workers(config->sendWorkerCount);
+    configure_queue(config->sendQueueCapacity, config->sendQueueOverflowPolicy,
+            config->recvQueueCapacity, config->recvQueueOverflowPolicy);
+    configure_read_batch(config->readBatchWindowMs, config->readBatchMaxNodes);
+    configure_write_coalescing(config->coalesceWrites);
+    configureReportBatch(IS_NOT_NULL(config->monitoredBatchCallback),
+            config->reportBatchMaxSize);
+    configure_statistics(config->collectStatistics);
+    configureReadResultLayout(config->flatReadResults);
 }
 
 EdgeResult createNamespace(const char *name, const char *rootNodeId, const char *rootBrowseName,
@@ -353,11 +378,273 @@ EdgeResult sendRequest(EdgeMessage* msg)
     EdgeMessage *msgCopy = cloneEdgeMessage(msg);
     result.code = STATUS_ERROR;
     VERIFY_NON_NULL_MSG(msgCopy, "NULL messageCopy recevied in send request\n", result);
+    // On failure, the queue destroys the copy.
     bool ret = add_to_sendQ(msgCopy);
     result.code = (ret ? STATUS_OK : STATUS_ENQUEUE_ERROR);
     return result;
 }
 
+EdgeResult sendRequestMove(EdgeMessage* msg)
+{
+    // Initializes the queueing thread if it is not initialized yet.
+    init_queue();
+
+    EdgeResult result = checkParameterValid(msg);
+    if (STATUS_OK != result.code)
+    {
+        // The message is owned by the stack even when it is rejected.
+        if (msg)
+        {
+            freeEdgeMessage(msg);
+        }
+        return result;
+    }
+    // The queue destroys the message once processed, or on failure.
+    bool ret = add_to_sendQ(msg);
+    result.code = (ret ? STATUS_OK : STATUS_ENQUEUE_ERROR);
+    return result;
+}
+
+static EdgePreparedGroup *prepareGroup(EdgeMessage *msg, bool write)
+{
+    EdgeResult result = checkParameterValid(msg);
+    COND_CHECK((result.code != STATUS_OK), NULL);
+    if (write)
+    {
+        COND_CHECK_MSG((CMD_WRITE != msg->command), "Invalid command in prepareWriteGroup\n", NULL);
+    }
+    else
+    {
+        COND_CHECK_MSG((CMD_READ != msg->command && CMD_READ_SAMPLING_INTERVAL != msg->command),
+                "Invalid command in prepareReadGroup\n", NULL);
+    }
+    return createEdgePreparedGroup(msg);
+}
+
+EdgePreparedGroup *prepareReadGroup(EdgeMessage *msg)
+{
+    return prepareGroup(msg, false);
+}
+
+EdgePreparedGroup *prepareWriteGroup(EdgeMessage *msg)
+{
+    return prepareGroup(msg, true);
+}
+
+static EdgeResult executePreparedGroup(EdgePreparedGroup *group, void **values,
+        const size_t *valueCounts)
+{
+    // Initializes the queueing thread if it is not initialized yet.
+    init_queue();
+
+    EdgeResult result;
+    result.code = STATUS_ERROR;
+    EdgeMessage *msg = createEdgePreparedMessage(group, values, valueCounts);
+    VERIFY_NON_NULL_MSG(msg, "NULL message of the prepared group\n", result);
+    // On failure, the queue destroys the message.
+    bool ret = add_to_sendQ(msg);
+    result.code = (ret ? STATUS_OK : STATUS_ENQUEUE_ERROR);
+    return result;
+}
+
+EdgeResult executePreparedRead(EdgePreparedGroup *group)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(group, "NULL group in executePreparedRead\n", result);
+    COND_CHECK_MSG((IS_NULL(group->readValueIds)), "Not a read group in executePreparedRead\n",
+            result);
+    return executePreparedGroup(group, NULL, NULL);
+}
+
+EdgeResult executePreparedWrite(EdgePreparedGroup *group, void **values, const size_t *valueCounts)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(group, "NULL group in executePreparedWrite\n", result);
+    COND_CHECK_MSG((IS_NULL(group->writeValues)), "Not a write group in executePreparedWrite\n",
+            result);
+    return executePreparedGroup(group, values, valueCounts);
+}
+
+void destroyPreparedGroup(EdgePreparedGroup *group)
+{
+    releaseEdgePreparedGroup(group);
+}
+
+bool onPollCycle(const uint32_t *pollIds, size_t pollCount, void *context, void **job)
+{
+    EdgePreparedGroup *group = (EdgePreparedGroup *) context;
+    // Only the poll holds the group while no execution of it is queued or running.
+    COND_CHECK((OC_ATOMIC_LOAD(&group->refCount) > 1), false);
+
+    // Each poll sharing the cycle is answered with its own id.
+    COND_CHECK_MSG((!setEdgePreparedGroupPartIds(group, pollIds, pollCount)),
+            "Polls do not match the parts of the cycle\n", true);
+    EdgeMessage *msg = createEdgePreparedMessage(group, NULL, NULL);
+    VERIFY_NON_NULL_MSG(msg, "NULL message of a poll cycle\n", true);
+    msg->message_id = pollIds[0];
+    *job = msg;
+    return true;
+}
+
+void onPollDispatch(void *job)
+{
+    init_queue();
+    // On failure, the queue destroys the message.
+    if (!add_to_sendQ((EdgeMessage *) job))
+    {
+        EDGE_LOG(TAG, "Failed to queue the cycle of a poll\n");
+    }
+}
+
+void *onPollMerge(void *context, void *added)
+{
+    const EdgeMessage *first = ((EdgePreparedGroup *) context)->msg;
+    const EdgeMessage *second = ((EdgePreparedGroup *) added)->msg;
+
+    // The requests of both groups are copied into the merged group.
+    EdgeMessage merged = *first;
+    merged.requestLength = first->requestLength + second->requestLength;
+    merged.requests = (EdgeRequest **) EdgeCalloc(merged.requestLength, sizeof(EdgeRequest *));
+    VERIFY_NON_NULL_MSG(merged.requests, "EdgeCalloc FAILED for the requests of a poll\n", NULL);
+    memcpy(merged.requests, first->requests, first->requestLength * sizeof(EdgeRequest *));
+    memcpy(merged.requests + first->requestLength, second->requests,
+            second->requestLength * sizeof(EdgeRequest *));
+
+    EdgePreparedGroup *group = createEdgePreparedGroup(&merged);
+    EdgeFree(merged.requests);
+    if (group && !setEdgePreparedGroupParts(group, context, added))
+    {
+        releaseEdgePreparedGroup(group);
+        return NULL;
+    }
+    return group;
+}
+
+void onPollFree(void *context)
+{
+    releaseEdgePreparedGroup((EdgePreparedGroup *) context);
+}
+
+EdgeResult startPolling(EdgeMessage *msg, uint32_t intervalMs, uint32_t *pollId)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(pollId, "NULL pollId in startPolling\n", result);
+    COND_CHECK_MSG((0 == intervalMs), "Invalid interval in startPolling\n", result);
+    EdgePreparedGroup *group = prepareGroup(msg, false);
+    VERIFY_NON_NULL_MSG(group, "Failed to prepare the nodes to poll\n", result);
+
+    // Polls of the same command and endpoint are merged when their interval is the same.
+    const char *endpointUri = group->msg->endpointInfo->endpointUri;
+    size_t keySize = strlen(endpointUri) + 16;
+    char *key = (char *) EdgeMalloc(keySize);
+    result.code = STATUS_ERROR;
+    if (IS_NULL(key))
+    {
+        EDGE_LOG(TAG, "EdgeMalloc FAILED for the key of a poll\n");
+        releaseEdgePreparedGroup(group);
+        return result;
+    }
+    snprintf(key, keySize, "%d;%s", msg->command, endpointUri);
+
+    // On failure, the scheduler releases the group.
+    *pollId = addEdgePoll(key, intervalMs, group);
+    EdgeFree(key);
+    COND_CHECK((0 == *pollId), result);
+    result.code = STATUS_OK;
+    return result;
+}
+
+EdgeResult stopPolling(uint32_t pollId)
+{
+    EdgeResult result;
+    result.code = (removeEdgePoll(pollId) ? STATUS_OK : STATUS_PARAM_INVALID);
+    return result;
+}
+
+EdgeResult getPollingStatistics(uint32_t pollId, EdgePollStatistics *stats)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(stats, "NULL stats received in getPollingStatistics\n", result);
+    COND_CHECK((!getEdgePollStatistics(pollId, stats)), result);
+    result.code = STATUS_OK;
+    return result;
+}
+
+EdgeResult cancelRequest(uint32_t message_id)
+{
+    EdgeResult result;
+    bool ret = cancel_request(message_id);
+    result.code = (ret ? STATUS_OK : STATUS_ERROR);
+    return result;
+}
+
+EdgeResult getAdapterStatistics(EdgeAdapterStatistics *stats)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(stats, "NULL stats received in getAdapterStatistics\n", result);
+    get_queue_statistics(stats);
+    result.code = STATUS_OK;
+    return result;
+}
+
+const void *getFlatResultValue(const EdgeMessage *msg, size_t index)
+{
+    VERIFY_NON_NULL_MSG(msg, "NULL msg received in getFlatResultValue\n", NULL);
+    return getEdgeFlatValue(msg->flatResults, index);
+}
+
+const char *getFlatResultString(const EdgeMessage *msg, size_t index, size_t *length)
+{
+    VERIFY_NON_NULL_MSG(msg, "NULL msg received in getFlatResultString\n", NULL);
+    return getEdgeFlatString(msg->flatResults, index, length);
+}
+
+const char *getNextFlatResultString(const char *str, size_t *length)
+{
+    return getNextEdgeFlatString(str, length);
+}
+
+uint64_t getLatencyBucketLowerBound(size_t bucket)
+{
+    return getEdgeLatencyBucketLowerBound(bucket);
+}
+
+uint64_t getLatencyPercentile(const EdgeLatencyHistogram *histogram, double percentile)
+{
+    COND_CHECK((IS_NULL(histogram) || 0 == histogram->count), 0);
+    if (percentile < 0)
+    {
+        percentile = 0;
+    }
+    else if (percentile > 100)
+    {
+        percentile = 100;
+    }
+
+    uint64_t rank = (uint64_t) ceil(histogram->count * percentile / 100);
+    if (0 == rank)
+    {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < EDGE_LATENCY_HISTOGRAM_BUCKETS - 1; i++)
+    {
+        seen += histogram->buckets[i];
+        if (seen >= rank)
+        {
+            // Upper bound of the bucket, never above the largest recorded time.
+            uint64_t upper = getEdgeLatencyBucketLowerBound(i + 1) - 1;
+            return (upper < histogram->maxUs) ? upper : histogram->maxUs;
+        }
+    }
+    return histogram->maxUs;
+}
+
 void onSendMessage(EdgeMessage* msg)
 {
     if (CMD_START_SERVER == msg->command)
@@ -371,7 +658,8 @@ void onSendMessage(EdgeMessage* msg)
     else if (CMD_START_CLIENT == msg->command)
     {
         EDGE_LOG(TAG, "\n[Received command] :: START CLIENT \n");
-        bool result = connect_client(msg->endpointInfo->endpointUri);
+        bool result = connect_client(msg->endpointInfo->endpointUri,
+                msg->endpointInfo->endpointConfig);
         VERIFY_NON_NULL_NR_MSG(!result, "");
     }
     else if (CMD_STOP_SERVER == msg->command)
@@ -417,6 +705,34 @@ void onSendMessage(EdgeMessage* msg)
     }
 }
 
+void onSendMessageBatch(EdgeMessage **msgs, size_t count)
+{
+    VERIFY_NON_NULL_NR_MSG(msgs, "NULL Message param in onSendMessageBatch\n");
+    if (CMD_READ == msgs[0]->command || CMD_READ_SAMPLING_INTERVAL == msgs[0]->command)
+    {
+        EDGE_LOG_V(TAG, "\n[Received command] :: READ BATCH (%zu)\n", count);
+        readNodesBatchFromServer(msgs, count);
+    }
+}
+
+void onDiscardMessage(EdgeMessage *msg, EdgeStatusCode code, const char *reason)
+{
+    VERIFY_NON_NULL_NR_MSG(msg, "NULL Message param in onDiscardMessage\n");
+    discardRequest(msg, code, reason);
+}
+
+uint32_t onSelectSession(EdgeMessage *msg)
+{
+    VERIFY_NON_NULL_MSG(msg, "NULL Message param in onSelectSession\n", 0);
+    return selectMessageSession(msg);
+}
+
+void onReleaseSession(EdgeMessage *msg)
+{
+    VERIFY_NON_NULL_NR_MSG(msg, "NULL Message param in onReleaseSession\n");
+    releaseMessageSession(msg);
+}
+
 void onResponseMessage(EdgeMessage *msg)
 {
     VERIFY_NON_NULL_NR_MSG(receivedMsgCb, "NULL receivedMsgCb in onResponseMessage\n");
@@ -427,7 +743,12 @@ void onResponseMessage(EdgeMessage *msg)
     if(msg->type == BROWSE_RESPONSE)
         receivedMsgCb->browse_msg_cb(msg);
     if(msg->type == REPORT)
-        receivedMsgCb->monitored_msg_cb(msg);
+    {
+        if (monitoredBatchCb)
+            monitoredBatchCb(msg);
+        else
+            receivedMsgCb->monitored_msg_cb(msg);
+    }
     if(msg->type == ERROR_RESPONSE)
         receivedMsgCb->error_msg_cb(msg);
 }
@@ -505,6 +826,16 @@ EdgeNodeInfo* createEdgeNodeInfo(const char* nodeName)
     nodeInfo->nodeId->nodeId = copyString(browseName);
     nodeInfo->nodeId->nameSpace = (uint16_t) nsIdx;
     nodeInfo->nodeId->type = getEdgeNodeIdType(nodeType);
+    if (EDGE_INTEGER == nodeInfo->nodeId->type)
+    {
+        // The commands address numeric nodes by their number, e.g. "{2;N;v=0}1001".
+        char *end = NULL;
+        unsigned long identifier = strtoul(browseName, &end, 10);
+        if (end != browseName && '\0' == *end && identifier <= UINT32_MAX)
+        {
+            nodeInfo->nodeId->integerNodeId = (int) (uint32_t) identifier;
+        }
+    }
 
     return nodeInfo;
 }
@@ -724,6 +1055,24 @@ EdgeResult insertReadAccessNode(EdgeMessage **msg, const char* nodeName)
     return result;
 }
 
+EdgeResult insertReadAttributeNode(EdgeMessage **msg, const char* nodeName,
+        uint32_t attributeId, const char *indexRange)
+{
+    EdgeResult result = insertReadAccessNode(msg, nodeName);
+    COND_CHECK((result.code != STATUS_OK), result);
+
+    EdgeRequest *request = (*msg)->requests[(*msg)->requestLength - 1];
+    request->attributeId = attributeId;
+    if (indexRange)
+    {
+        request->indexRange = cloneString(indexRange);
+        result.code = STATUS_ERROR;
+        VERIFY_NON_NULL_MSG(request->indexRange, "Error : Malloc failed for indexRange", result);
+    }
+    result.code = STATUS_OK;
+    return result;
+}
+
 EdgeResult insertWriteAccessNode(EdgeMessage **msg, const char* nodeName, void* value,
         size_t valueCount)
 {
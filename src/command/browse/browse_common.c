@@ -26,6 +26,7 @@
 #include "message_dispatcher.h"
 #include "command_adapter.h"
 #include "uqueue.h"
+#include "edge_server_capabilities.h"
 
 #include <inttypes.h>
 #include <string.h>
@@ -79,6 +80,7 @@ UA_NodeId *getNodeId(EdgeRequest *req)
 
     UA_NodeId *node = (UA_NodeId *) EdgeCalloc(1, sizeof(UA_NodeId));
     VERIFY_NON_NULL_MSG(node, "EdgeCalloc FAILED for UA Node Id\n", NULL);
+    UA_NodeId borrowed;
     if (req->nodeInfo->nodeId->type == EDGE_INTEGER)
     {
         *node = UA_NODEID_NUMERIC(req->nodeInfo->nodeId->nameSpace,
@@ -89,6 +91,12 @@ UA_NodeId *getNodeId(EdgeRequest *req)
         *node = UA_NODEID_STRING_ALLOC(req->nodeInfo->nodeId->nameSpace,
                 req->nodeInfo->nodeId->nodeId);
     }
+    else if ((req->nodeInfo->nodeId->type == EDGE_UUID
+            || req->nodeInfo->nodeId->type == EDGE_BYTESTRING)
+            && convertToUANodeId(req->nodeInfo, &borrowed))
+    {
+        UA_NodeId_copy(&borrowed, node);
+    }
     else
     {
         *node = UA_NODEID_NUMERIC(req->nodeInfo->nodeId->nameSpace, UA_NS0ID_ROOTFOLDER);
@@ -495,39 +503,23 @@ static unsigned char *joinPaths(unsigned char *path1, unsigned char *path2)
 
 static uint16_t getMaxNodesToBrowse(UA_Client *client)
 {
-    /* Read Maximum browse continuation points supported by the server */
-    UA_UInt16 maxBrowseContinuationPoints = 1; // Server's mandatory property. Minimum value assumed.
-    UA_Variant *val = UA_Variant_new();
-    UA_StatusCode retval = UA_Client_readValueAttribute(client,
-            UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERCAPABILITIES_MAXBROWSECONTINUATIONPOINTS), val);
-    if(retval == UA_STATUSCODE_GOOD && UA_Variant_isScalar(val) &&
-       val->type == &UA_TYPES[UA_TYPES_UINT16])
-    {
-        maxBrowseContinuationPoints = *(UA_UInt16*)val->data;
-        EDGE_LOG_V(TAG, "Maximum browse continuation points supported by the server is: %u\n",
-                maxBrowseContinuationPoints);
-    }
-    UA_Variant_delete(val);
-
-    /* Read Maximum nodes per browse supported by the server */
-    UA_UInt32 maxNodesPerBrowse = 0; // Server's optional property.
-    val = UA_Variant_new();
-    retval = UA_Client_readValueAttribute(client,
-            UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERBROWSE), val);
-    if(retval == UA_STATUSCODE_GOOD && UA_Variant_isScalar(val) &&
-       val->type == &UA_TYPES[UA_TYPES_UINT32])
-    {
-        maxNodesPerBrowse = *(UA_UInt32*)val->data;
-        EDGE_LOG_V(TAG, "Maximum nodes per browse request supported by the server is: %u\n",
-                maxNodesPerBrowse);
-    }
-    UA_Variant_delete(val);
+    /* The server capabilities are read when the session is connected */
+    EdgeServerCapabilities capabilities;
+    if (!getServerCapabilities(client, &capabilities))
+    {
+        loadServerCapabilities(client);
+        getServerCapabilities(client, &capabilities);
+    }
+    EDGE_LOG_V(TAG, "Maximum browse continuation points supported by the server is: %u\n",
+            capabilities.maxBrowseContinuationPoints);
+    EDGE_LOG_V(TAG, "Maximum nodes per browse request supported by the server is: %u\n",
+            capabilities.maxNodesPerBrowse);
 
     /* Choose the minimum of them */
-    uint16_t minimum = maxBrowseContinuationPoints;
-    if(maxNodesPerBrowse != 0 && maxNodesPerBrowse < minimum)
+    uint16_t minimum = capabilities.maxBrowseContinuationPoints;
+    if(capabilities.maxNodesPerBrowse != 0 && capabilities.maxNodesPerBrowse < minimum)
     {
-        minimum = maxNodesPerBrowse;
+        minimum = capabilities.maxNodesPerBrowse;
     }
 
     return minimum;
@@ -1312,7 +1304,7 @@ void browseNodes(UA_Client *client, EdgeMessage *msg)
         return;
     }
 
-    // Read server's capability and find out the maximum nodes
+    // Find out from the server's capabilities the maximum nodes
     // which can be browsed through a single browse request.
     uint16_t maxNodesToBrowse = getMaxNodesToBrowse(client);
 
@@ -20,9 +20,11 @@
 
 #include "cmd_util.h"
 #include "edge_malloc.h"
+#include "edge_arena.h"
 #include "edge_utils.h"
 #include "edge_open62541.h"
 #include "message_dispatcher.h"
+#include "edge_prepared_group.h"
 
 #define TAG "cmd_util"
 #define ERROR_DESC_LENGTH (100)
@@ -39,41 +41,73 @@ int get_response_type(const UA_DataType *datatype)
 
 void sendErrorResponse(const EdgeMessage *msg, char *err_desc)
 {
-    EdgeMessage *resultMsg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
-    VERIFY_NON_NULL_NR_MSG(resultMsg, "EdgeCalloc FAILED for EdgeMessage in sendErrorResponse\n");
-    resultMsg->endpointInfo = cloneEdgeEndpointInfo(msg->endpointInfo);
+    sendErrorResponseWithCode(msg, err_desc, STATUS_ERROR);
+}
+
+void sendErrorResponseWithCode(const EdgeMessage *msg, char *err_desc, EdgeStatusCode code)
+{
+    /* The cycle of polls which share it is answered with an error for each poll. */
+    size_t partCount = 0;
+    EdgeMessage *parts = createEdgePreparedPartMessages(msg, &partCount);
+    if (parts)
+    {
+        for (size_t i = 0; i < partCount; i++)
+        {
+            sendErrorResponseWithCode(&parts[i], err_desc, code);
+        }
+        EdgeFree(parts);
+        return;
+    }
+
+    /* Callers may be building a response in their own arena. The error response gets its own. */
+    EdgeArena *arena = EdgeArenaAcquire();
+
+    EdgeMessage *resultMsg = (EdgeMessage *) EdgeArenaCalloc(arena, 1, sizeof(EdgeMessage));
+    if (IS_NULL(resultMsg))
+    {
+        EDGE_LOG(TAG, "EdgeCalloc FAILED for EdgeMessage in sendErrorResponse\n");
+        EdgeArenaRelease(arena);
+        return;
+    }
+    resultMsg->arena = arena;
+    resultMsg->endpointInfo = cloneEdgeEndpointInfoInArena(arena, msg->endpointInfo);
     resultMsg->type = ERROR_RESPONSE;
     resultMsg->responseLength = 1;
     resultMsg->message_id = msg->message_id;
 
-    resultMsg->responses = (EdgeResponse **) malloc(sizeof(EdgeResponse *) * resultMsg->responseLength);
+    resultMsg->responses = (EdgeResponse **) EdgeArenaAlloc(arena,
+            sizeof(EdgeResponse *) * resultMsg->responseLength);
+    if(IS_NULL(resultMsg->responses))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for responses sendErrorResponse\n");
+        goto EXIT;
+    }
     for (int i = 0; i < resultMsg->responseLength; i++)
     {
-        resultMsg->responses[i] = (EdgeResponse*) EdgeCalloc(1, sizeof(EdgeResponse));
+        resultMsg->responses[i] = (EdgeResponse*) EdgeArenaCalloc(arena, 1, sizeof(EdgeResponse));
         if(IS_NULL(resultMsg->responses[i]))
         {
             EDGE_LOG(TAG, "Error : Allocation has failed\n");
             goto EXIT;
         }
 
-        resultMsg->responses[i]->message = (EdgeVersatility *) EdgeCalloc(1, sizeof(EdgeVersatility));
+        resultMsg->responses[i]->message = (EdgeVersatility *) EdgeArenaCalloc(arena, 1,
+                sizeof(EdgeVersatility));
         if(IS_NULL(resultMsg->responses[i]->message))
         {
             EDGE_LOG(TAG, "Error : Malloc failed for EdgeVersatility sendErrorResponse\n");
             goto EXIT;
         }
-        char* err_description = (char*) EdgeMalloc(strlen(err_desc) + 1);
-        strncpy(err_description, err_desc, strlen(err_desc));
-        err_description[strlen(err_desc)] = '\0';
+        char* err_description = EdgeArenaCloneString(arena, err_desc);
         resultMsg->responses[i]->message->value = (void *) err_description;
     }
-    resultMsg->result = (EdgeResult *) EdgeMalloc(sizeof(EdgeResult));
+    resultMsg->result = (EdgeResult *) EdgeArenaAlloc(arena, sizeof(EdgeResult));
     if(IS_NULL(resultMsg->result))
     {
         EDGE_LOG(TAG, "Error : Malloc failed for EdgeResult sendErrorResponse\n");
         goto EXIT;
     }
-    resultMsg->result->code = STATUS_ERROR;
+    resultMsg->result->code = code;
 
     /* Adding Error response message to receiver Q */
     add_to_recvQ(resultMsg);
@@ -84,10 +118,25 @@ void sendErrorResponse(const EdgeMessage *msg, char *err_desc)
     freeEdgeMessage(resultMsg);
 }
 
-EdgeDiagnosticInfo *checkDiagnosticInfo(int nodesToProcess,
+bool hasValidNodeIds(const EdgeMessage *msg)
+{
+    for (size_t i = 0; !msg->preparedGroup && i < msg->requestLength; i++)
+    {
+        UA_NodeId nodeId;
+        if (!convertToUANodeId(msg->requests[i]->nodeInfo, &nodeId))
+        {
+            EDGE_LOG_V(TAG, "Invalid node id :: %s\n", msg->requests[i]->nodeInfo->valueAlias);
+            return false;
+        }
+    }
+    return true;
+}
+
+EdgeDiagnosticInfo *checkDiagnosticInfoInArena(EdgeArena *arena, int nodesToProcess,
         UA_DiagnosticInfo *diagnosticInfo, int diagnosticInfoLength, int returnDiagnostic)
 {
-    EdgeDiagnosticInfo *diagnostics = (EdgeDiagnosticInfo *) EdgeMalloc(sizeof(EdgeDiagnosticInfo));
+    EdgeDiagnosticInfo *diagnostics = (EdgeDiagnosticInfo *) EdgeArenaAlloc(arena,
+            sizeof(EdgeDiagnosticInfo));
     VERIFY_NON_NULL_MSG(diagnostics, "EdgeMalloc FAILED for EdgeDiagnosticInfo in checkDiagnosticInfo\n", NULL);
     diagnostics->symbolicId = 0;
     diagnostics->localizedText = 0;
@@ -107,7 +156,8 @@ EdgeDiagnosticInfo *checkDiagnosticInfo(int nodesToProcess,
         diagnostics->locale = diagnosticInfo[0].locale;
         if (diagnosticInfo[0].hasAdditionalInfo)
         {
-            char *additional_info = (char *) EdgeMalloc(diagnosticInfo[0].additionalInfo.length + 1);
+            char *additional_info = (char *) EdgeArenaAlloc(arena,
+                    diagnosticInfo[0].additionalInfo.length + 1);
             if(IS_NULL(additional_info))
             {
                 EDGE_LOG(TAG, "Error : Malloc for additional_info failed in checkDiagnosticInfo");
@@ -137,65 +187,67 @@ EdgeDiagnosticInfo *checkDiagnosticInfo(int nodesToProcess,
     return diagnostics;
 }
 
+EdgeDiagnosticInfo *checkDiagnosticInfo(int nodesToProcess,
+        UA_DiagnosticInfo *diagnosticInfo, int diagnosticInfoLength, int returnDiagnostic)
+{
+    return checkDiagnosticInfoInArena(NULL, nodesToProcess, diagnosticInfo, diagnosticInfoLength,
+            returnDiagnostic);
+}
+
 /**
  * @brief convertToEdgeLocalizedText - Util function to handle LocalizedText read response
+ * @param arena - Arena holding the result, NULL for the heap
  * @param lt - Localized text to be handled
  * @return Edge_LocalizedText*
  */
-static Edge_LocalizedText *convertToEdgeLocalizedText(UA_LocalizedText *lt)
+static Edge_LocalizedText *convertToEdgeLocalizedText(EdgeArena *arena, UA_LocalizedText *lt)
 {
     VERIFY_NON_NULL_MSG(lt, "Input parameter(lt) is NULL", NULL);
-    Edge_LocalizedText *value = (Edge_LocalizedText *) EdgeCalloc(1, sizeof(Edge_LocalizedText));
+    Edge_LocalizedText *value = (Edge_LocalizedText *) EdgeArenaCalloc(arena, 1,
+            sizeof(Edge_LocalizedText));
     VERIFY_NON_NULL_MSG(value, "Memory allocation failed.", NULL);
 
-    Edge_String *edgeStr = convertToEdgeString(&lt->locale);
-    if(IS_NULL(edgeStr))
+    if (!convertToEdgeStringInArena(arena, &lt->locale, &value->locale))
     {
         EDGE_LOG(TAG, "Failed to convert locale.");
-        EdgeFree(value);
+        EdgeArenaFree(arena, value);
         return NULL;
     }
-    value->locale = *edgeStr;
-    EdgeFree(edgeStr);
 
-    edgeStr = convertToEdgeString(&lt->text);
-    if(IS_NULL(edgeStr))
+    if (!convertToEdgeStringInArena(arena, &lt->text, &value->text))
     {
         EDGE_LOG(TAG, "Failed to convert text.");
-        EdgeFree(value->locale.data);
-        EdgeFree(value);
+        EdgeArenaFree(arena, value->locale.data);
+        EdgeArenaFree(arena, value);
         return NULL;
     }
-    value->text = *edgeStr;
-    EdgeFree(edgeStr);
     return value;
 }
 
 /**
  * @brief convertToEdgeQualifiedName - Utility function to handle QualifiedName response
+ * @param arena - Arena holding the result, NULL for the heap
  * @param qn - Qualified name to be handled
  * @return Edge_QualifiedName*
  */
-static Edge_QualifiedName *convertToEdgeQualifiedName(UA_QualifiedName *qn)
+static Edge_QualifiedName *convertToEdgeQualifiedName(EdgeArena *arena, UA_QualifiedName *qn)
 {
     VERIFY_NON_NULL_MSG(qn, "Input parameter(qn) is NULL", NULL);
-    Edge_QualifiedName *value = (Edge_QualifiedName *) EdgeCalloc(1, sizeof(Edge_QualifiedName));
+    Edge_QualifiedName *value = (Edge_QualifiedName *) EdgeArenaCalloc(arena, 1,
+            sizeof(Edge_QualifiedName));
     VERIFY_NON_NULL_MSG(value, "Memory allocation failed.", NULL);
 
     value->namespaceIndex = qn->namespaceIndex;
-    Edge_String *edgeStr = convertToEdgeString(&qn->name);
-    if(IS_NULL(edgeStr))
+    if (!convertToEdgeStringInArena(arena, &qn->name, &value->name))
     {
         EDGE_LOG(TAG, "Failed to convert name.");
-        EdgeFree(value);
+        EdgeArenaFree(arena, value);
         return NULL;
     }
-    value->name = *edgeStr;
-    EdgeFree(edgeStr);
     return value;
 }
 
-EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
+EdgeVersatility* parseResponseInArena(EdgeArena *arena, EdgeResponse *response, UA_Variant val)
 {
     char errorDesc[ERROR_DESC_LENGTH] = {'\0'};
     EdgeVersatility *versatility = NULL;
@@ -209,7 +261,12 @@ EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
     if (response->type < 0)
         return versatility;
 
-    versatility = (EdgeVersatility*) EdgeCalloc(1, sizeof(EdgeVersatility));
+    versatility = (EdgeVersatility*) EdgeArenaCalloc(arena, 1, sizeof(EdgeVersatility));
+    if (IS_NULL(versatility))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        goto EXIT;
+    }
 
     if (isScalar)
     {
@@ -223,12 +280,11 @@ EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
             /* STRING or BYTESTRING or XMLELEMENT scalar response handling */
             UA_String str = *((UA_String *) val.data);
             size_t len = str.length;
-            versatility->value = (void *) EdgeCalloc(1, len+1);
+            versatility->value = (void *) EdgeArenaCalloc(arena, 1, len+1);
             if(IS_NULL(versatility->value))
             {
                 EDGE_LOG(TAG, "Memory allocation failed.");
                 strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
                 goto EXIT;
             }
             strncpy(versatility->value, (char*) str.data, len);
@@ -238,12 +294,11 @@ EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
         {
             /* GUID scalar response handling */
             UA_Guid str = *((UA_Guid *) val.data);
-            char *value = (char *) EdgeMalloc(GUID_LENGTH + 1);
+            char *value = (char *) EdgeArenaAlloc(arena, GUID_LENGTH + 1);
             if(IS_NULL(value))
             {
                 EDGE_LOG(TAG, "Error : Malloc failed for Guid SCALAR value in Read Group\n");
                 strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
                 goto EXIT;
             }
 
@@ -255,12 +310,12 @@ EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
         else if(response->type == UA_NS0ID_LOCALIZEDTEXT)
         {
             /* LOCALIZEDTEXT scalar response handling */
-            Edge_LocalizedText *value = convertToEdgeLocalizedText((UA_LocalizedText *) val.data);
+            Edge_LocalizedText *value = convertToEdgeLocalizedText(arena,
+                    (UA_LocalizedText *) val.data);
             if(IS_NULL(value))
             {
                 EDGE_LOG(TAG, "Failed to parse localized text.");
                 strncpy(errorDesc, "Failed to parse localized text.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
                 goto EXIT;
             }
             versatility->value = value;
@@ -268,12 +323,12 @@ EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
         else if(response->type == UA_NS0ID_QUALIFIEDNAME)
         {
             /* QUALIFIEDNAME scalar response handling */
-            Edge_QualifiedName *value = convertToEdgeQualifiedName((UA_QualifiedName *) val.data);
+            Edge_QualifiedName *value = convertToEdgeQualifiedName(arena,
+                    (UA_QualifiedName *) val.data);
             if(IS_NULL(value))
             {
                 EDGE_LOG(TAG, "Failed to convert qualified name.");
                 strncpy(errorDesc, "Failed to convert qualified name.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
                 goto EXIT;
             }
             versatility->value = value;
@@ -281,24 +336,22 @@ EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
         else if(response->type == UA_NS0ID_NODEID)
         {
             /* NODEID scalar response handling */
-            versatility->value = convertToEdgeNodeIdType((UA_NodeId *) val.data);
+            versatility->value = convertToEdgeNodeIdTypeInArena(arena, (UA_NodeId *) val.data);
             if(IS_NULL(versatility->value))
             {
                 EDGE_LOG(TAG, "Failed to convert NodeId.");
                 strncpy(errorDesc, "Failed to convert NodeId.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
                 goto EXIT;
             }
         }
         else
         {
             /* Response handling for other array data types */
-            versatility->value = (void *) EdgeCalloc(1, size);
+            versatility->value = (void *) EdgeArenaCalloc(arena, 1, size);
             if(IS_NULL(versatility->value))
             {
                 EDGE_LOG(TAG, "Memory allocation failed.");
                 strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
                 goto EXIT;
             }
             memcpy(versatility->value, val.data, size);
@@ -314,24 +367,22 @@ EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
         {
             /* STRING or BYTESTRING or XMLELEMENT array response handling */
             UA_String *str = ((UA_String *) val.data);
-            versatility->value = EdgeCalloc (val.arrayLength, sizeof(char *));
+            versatility->value = EdgeArenaCalloc(arena, val.arrayLength, sizeof(char *));
             if(IS_NULL(versatility->value))
             {
                 EDGE_LOG(TAG, "Error : Malloc failed for String Array values in Read Group\n");
                 strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
                 goto EXIT;
             }
 
             char **values = (char **) versatility->value;
             for (int j = 0; j < val.arrayLength; j++)
             {
-                values[j] = (char *) EdgeMalloc(str[j].length + 1);
+                values[j] = (char *) EdgeArenaAlloc(arena, str[j].length + 1);
                 if(IS_NULL(values[j]))
                 {
                     EDGE_LOG_V(TAG, "Error : Malloc failed for ByteString Array value %d in Read Group\n", j);
                     strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                    freeEdgeResponse(response);
                     goto EXIT;
                 }
                 strncpy(values[j], (char *) str[j].data, str[j].length);
@@ -342,24 +393,22 @@ EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
         {
             /* GUID Array response handling */
             UA_Guid *str = ((UA_Guid *) val.data);
-            versatility->value = EdgeCalloc(val.arrayLength, sizeof(char *));
+            versatility->value = EdgeArenaCalloc(arena, val.arrayLength, sizeof(char *));
             if(IS_NULL(versatility->value))
             {
                 EDGE_LOG(TAG, "Error : Malloc failed for Guid Array values in Read Group\n");
                 strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
                 goto EXIT;
             }
 
             char **values = (char **) versatility->value;
             for (int j = 0; j < val.arrayLength; j++)
             {
-                values[j] = (char *) EdgeMalloc(GUID_LENGTH + 1);
+                values[j] = (char *) EdgeArenaAlloc(arena, GUID_LENGTH + 1);
                 if(IS_NULL(values[j]))
                 {
                     EDGE_LOG_V(TAG, "Error : Malloc failed for Guid Array value %d in Read Group\n", j);
                     strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                    freeEdgeResponse(response);
                     goto EXIT;
                 }
                 convertGuidToString(str[j], &(values[j]));
@@ -370,24 +419,23 @@ EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
         {
             /* QUALIFIEDNAME array response handling */
             UA_QualifiedName *qnArr = ((UA_QualifiedName *) val.data);
-            versatility->value = EdgeCalloc(val.arrayLength, sizeof(UA_QualifiedName *));
+            versatility->value = EdgeArenaCalloc(arena, val.arrayLength,
+                    sizeof(UA_QualifiedName *));
             if(IS_NULL(versatility->value))
             {
                 EDGE_LOG(TAG, "Error : Malloc failed for QualifiedName Array values in Read Group\n");
                 strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
                 goto EXIT;
             }
 
             Edge_QualifiedName **values = (Edge_QualifiedName **) versatility->value;
             for (int j = 0; j < val.arrayLength; j++)
             {
-                values[j] = convertToEdgeQualifiedName(&qnArr[j]);
+                values[j] = convertToEdgeQualifiedName(arena, &qnArr[j]);
                 if(IS_NULL(values[j]))
                 {
                     EDGE_LOG(TAG, "Failed to convert the qualified name.");
                     strncpy(errorDesc, "Failed to convert the qualified name.", ERROR_DESC_LENGTH);
-                    freeEdgeResponse(response);
                     goto EXIT;
                 }
             }
@@ -396,24 +444,23 @@ EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
         {
             /* LOCALIZEDTEXT array response handling */
             UA_LocalizedText *ltArr = ((UA_LocalizedText *) val.data);
-            versatility->value = EdgeCalloc(val.arrayLength, sizeof(UA_LocalizedText *));
+            versatility->value = EdgeArenaCalloc(arena, val.arrayLength,
+                    sizeof(UA_LocalizedText *));
             if(IS_NULL(versatility->value))
             {
                 EDGE_LOG(TAG, "Error : Malloc failed for LocalizedText Array values in Read Group\n");
                 strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
                 goto EXIT;
             }
 
             Edge_LocalizedText **values = (Edge_LocalizedText **) versatility->value;
             for (int j = 0; j < val.arrayLength; j++)
             {
-                values[j] = convertToEdgeLocalizedText(&ltArr[j]);
+                values[j] = convertToEdgeLocalizedText(arena, &ltArr[j]);
                 if(IS_NULL(values[j]))
                 {
                     EDGE_LOG(TAG, "Failed to convert the localized text.");
                     strncpy(errorDesc, "Failed to convert the localized text.", ERROR_DESC_LENGTH);
-                    freeEdgeResponse(response);
                     goto EXIT;
                 }
             }
@@ -422,24 +469,22 @@ EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
         {
             /* NODEID array response handling */
             UA_NodeId *nodeIdArr = ((UA_NodeId *) val.data);
-            versatility->value = EdgeCalloc(val.arrayLength, sizeof(Edge_NodeId *));
+            versatility->value = EdgeArenaCalloc(arena, val.arrayLength, sizeof(Edge_NodeId *));
             if(IS_NULL(versatility->value))
             {
                 EDGE_LOG(TAG, "Error : Malloc failed for NodeId Array values in Read Group\n");
                 strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
                 goto EXIT;
             }
 
             Edge_NodeId **values = (Edge_NodeId **) versatility->value;
             for (int j = 0; j < val.arrayLength; j++)
             {
-                values[j] = convertToEdgeNodeIdType(&nodeIdArr[j]);
+                values[j] = convertToEdgeNodeIdTypeInArena(arena, &nodeIdArr[j]);
                 if(IS_NULL(values[j]))
                 {
                     EDGE_LOG(TAG, "Failed to convert the NodeId.");
                     strncpy(errorDesc, "Failed to convert the NodeId.", ERROR_DESC_LENGTH);
-                    freeEdgeResponse(response);
                     goto EXIT;
                 }
             }
@@ -451,16 +496,15 @@ EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
             {
                 EDGE_LOG(TAG, "Vaue type is NULL ERROR.");
                 strncpy(errorDesc, "Vaue type is NULL ERROR..", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
                 goto EXIT;
             }
 
-            versatility->value = (void *) EdgeCalloc(versatility->arrayLength, val.type->memSize);
+            versatility->value = (void *) EdgeArenaCalloc(arena, versatility->arrayLength,
+                    val.type->memSize);
             if(IS_NULL(versatility->value))
             {
                 EDGE_LOG(TAG, "Memory allocation failed.");
                 strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
                 goto EXIT;
             }
 
@@ -471,6 +515,16 @@ EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
     return versatility;
 
     EXIT:
-    freeEdgeVersatility(versatility);
+    /* Memory of an arena is given back with the whole message */
+    if (IS_NULL(arena))
+    {
+        freeEdgeResponse(response);
+        freeEdgeVersatility(versatility);
+    }
     return NULL;
 }
+
+EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
+{
+    return parseResponseInArena(NULL, response, val);
+}
@@ -29,6 +29,7 @@
 
 #include "opcua_common.h"
 #include "open62541.h"
+#include "edge_arena.h"
 
 /**
  * @brief Get the numeric identifier of the data type.
@@ -44,6 +45,22 @@ int get_response_type(const UA_DataType *type);
  */
 void sendErrorResponse(const EdgeMessage *msg, char *err_desc);
 
+/**
+ * @brief Sends error response message with the given result code
+ * @param[in]  msg EdgeMessage
+ * @param[in]  err_desc error message description
+ * @param[in]  code Result code of the response
+ */
+void sendErrorResponseWithCode(const EdgeMessage *msg, char *err_desc, EdgeStatusCode code);
+
+/**
+ * @brief Checks whether the nodes of all requests of the message convert to NodeIds.
+ * The nodes of a prepared group are checked when it is prepared.
+ * @param[in]  msg EdgeMessage
+ * @return true if all nodes convert, false otherwise
+ */
+bool hasValidNodeIds(const EdgeMessage *msg);
+
 /**
  * @brief Get the data type of the response message
  * @param[in]  nodesToProcess number of nodes
@@ -55,8 +72,30 @@ void sendErrorResponse(const EdgeMessage *msg, char *err_desc);
 EdgeDiagnosticInfo *checkDiagnosticInfo(int nodesToProcess,
         UA_DiagnosticInfo *diagnosticInfo, int diagnosticInfoLength, int returnDiagnostic);
 
+/**
+ * @brief Get the diagnostic information of the response message, allocated in an arena
+ * @param[in]  arena Arena holding the result, NULL for the heap
+ * @param[in]  nodesToProcess number of nodes
+ * @param[in]  diagnosticInfo Diagnostics information
+ * @param[in]  diagnosticInfoLength Diagnostic information length
+ * @param[in]  returnDiagnostic Return Diagnostic
+ * @return EdgeDiagnosticInfo object
+ */
+EdgeDiagnosticInfo *checkDiagnosticInfoInArena(EdgeArena *arena, int nodesToProcess,
+        UA_DiagnosticInfo *diagnosticInfo, int diagnosticInfoLength, int returnDiagnostic);
+
 
 EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val);
 
+/**
+ * @brief Converts the value of a response, allocated in an arena. On failure, a response
+ * on the heap is freed along with the value, like parseResponse() does.
+ * @param[in]  arena Arena holding the value, NULL for the heap
+ * @param[in]  response Response of the value. Its type is set
+ * @param[in]  val Value
+ * @return Converted value on success, NULL otherwise
+ */
+EdgeVersatility* parseResponseInArena(EdgeArena *arena, EdgeResponse *response, UA_Variant val);
+
 
 #endif // EDGE_CMD_UTIL_H
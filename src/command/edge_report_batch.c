@@ -0,0 +1,224 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_report_batch.h"
+#include "cmd_util.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "edge_utils.h"
+#include "message_dispatcher.h"
+
+#include <time.h>
+#ifndef _WIN32
+#include <sys/time.h>
+#else
+#include <winsock2.h>
+#endif
+
+#define TAG "report_batch"
+
+/* Number of responses first allocated for a batch of notifications */
+#define EDGE_UA_REPORT_BATCH_INITIAL_SIZE (16)
+
+struct EdgeReportBatch
+{
+    /* REPORT message, with the message id of the subscription request */
+    EdgeMessage *msg;
+    /* Number of responses allocated in msg */
+    size_t capacity;
+    /* Next batch of the publish cycle */
+    struct EdgeReportBatch *next;
+};
+
+EdgeMessage *createReportMessage(const EdgeMessage *request, EdgeArena *arena, size_t capacity)
+{
+    VERIFY_NON_NULL_MSG(request, "NULL request in createReportMessage\n", NULL);
+    EdgeMessage *resultMsg = (EdgeMessage *) EdgeArenaCalloc(arena, 1, sizeof(EdgeMessage));
+    VERIFY_NON_NULL_MSG(resultMsg, "EdgeCalloc FAILED for edgeMessage in createReportMessage\n",
+            NULL);
+    resultMsg->arena = arena;
+
+    resultMsg->endpointInfo = cloneEdgeEndpointInfoInArena(arena, request->endpointInfo);
+    if(IS_NULL(resultMsg->endpointInfo))
+    {
+        EDGE_LOG(TAG,
+                "Error : EdgeCalloc failed for resultMsg.endpointInfo in monitor item handler\n");
+        goto REPORT_ERROR;
+    }
+
+    time_t rawtime;
+    time(&rawtime);
+    resultMsg->serverTime.timeInfo = localtime(&rawtime);
+
+#ifndef _WIN32
+    gettimeofday(&(resultMsg->serverTime.tv), NULL);
+#else
+    getTimeofDay(&(resultMsg->serverTime.tv), NULL);
+#endif
+
+    resultMsg->message_id = request->message_id;
+    resultMsg->type = REPORT;
+    resultMsg->responseLength = 0;
+    resultMsg->responses = (EdgeResponse **) EdgeArenaCalloc(arena, capacity,
+            sizeof(EdgeResponse*));
+    if(IS_NULL(resultMsg->responses))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for resultMsg.responses in monitor item handler\n");
+        goto REPORT_ERROR;
+    }
+    return resultMsg;
+
+    REPORT_ERROR:
+    /* Free memory. An arena is released by the caller. */
+    if (IS_NULL(arena))
+    {
+        freeEdgeMessage(resultMsg);
+    }
+    return NULL;
+}
+
+EdgeResponse *createReportResponse(EdgeArena *arena, const char *valueAlias, UA_DataValue *value)
+{
+    EdgeResponse *response = (EdgeResponse *) EdgeArenaCalloc(arena, 1, sizeof(EdgeResponse));
+    VERIFY_NON_NULL_MSG(response, "EdgeCalloc FAILED for response in monitor item handler\n", NULL);
+
+    response->nodeInfo = (EdgeNodeInfo *) EdgeArenaCalloc(arena, 1, sizeof(EdgeNodeInfo));
+    if(IS_NULL(response->nodeInfo))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for response->nodeInfo in monitor item handler\n");
+        return NULL;
+    }
+    response->nodeInfo->valueAlias = EdgeArenaCloneString(arena, valueAlias);
+    if(IS_NULL(response->nodeInfo->valueAlias))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for response->nodeInfo->valueAlias "
+                "in monitor item handler\n");
+        return NULL;
+    }
+
+    response->message = parseResponseInArena(arena, response, value->value);
+    if(IS_NULL(response->message))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for versatility in monitor item handler\n");
+        return NULL;
+    }
+    return response;
+}
+
+/**
+ * @brief takeReportBatch - Takes a pending batch out of the batches of the publish cycle
+ * @param batches - Batches of the publish cycle
+ * @param batch - Batch to take out
+ * @return REPORT message of the batch
+ */
+static EdgeMessage *takeReportBatch(EdgeReportBatch **batches, EdgeReportBatch *batch)
+{
+    for (EdgeReportBatch **link = batches; *link; link = &(*link)->next)
+    {
+        if (*link == batch)
+        {
+            *link = batch->next;
+            break;
+        }
+    }
+    EdgeMessage *msg = batch->msg;
+    EdgeFree(batch);
+    return msg;
+}
+
+void flushReportBatches(EdgeReportBatch **batches)
+{
+    VERIFY_NON_NULL_NR_MSG(batches, "NULL batches in flushReportBatches\n");
+    while (IS_NOT_NULL(*batches))
+    {
+        /* Adding the batched subscription responses to receiver Q */
+        add_to_recvQ(takeReportBatch(batches, *batches));
+    }
+}
+
+/**
+ * @brief getReportBatch - Gets the pending batch for the subscription request of a notification.
+ * The batch is created if needed.
+ * @param batches - Batches of the publish cycle
+ * @param request - Subscription request of the notification
+ * @return Batch on success, NULL otherwise
+ */
+static EdgeReportBatch *getReportBatch(EdgeReportBatch **batches, const EdgeMessage *request)
+{
+    EdgeReportBatch **link = batches;
+    for (; *link; link = &(*link)->next)
+    {
+        /* Each REPORT carries the message id of its own subscription request */
+        if ((*link)->msg->message_id == request->message_id)
+        {
+            return *link;
+        }
+    }
+
+    EdgeReportBatch *batch = (EdgeReportBatch *) EdgeCalloc(1, sizeof(EdgeReportBatch));
+    VERIFY_NON_NULL_MSG(batch, "EdgeCalloc FAILED for reportBatch\n", NULL);
+    /* The batch is built in one arena, which freeEdgeMessage() gives back to the pool. */
+    EdgeArena *arena = EdgeArenaAcquire();
+    batch->msg = createReportMessage(request, arena, EDGE_UA_REPORT_BATCH_INITIAL_SIZE);
+    if (IS_NULL(batch->msg))
+    {
+        EdgeArenaRelease(arena);
+        EdgeFree(batch);
+        return NULL;
+    }
+    batch->capacity = EDGE_UA_REPORT_BATCH_INITIAL_SIZE;
+    *link = batch;
+    return batch;
+}
+
+void addToReportBatch(EdgeReportBatch **batches, const EdgeMessage *request,
+        const char *valueAlias, UA_DataValue *value, size_t maxSize)
+{
+    VERIFY_NON_NULL_NR_MSG(batches, "NULL batches in addToReportBatch\n");
+    VERIFY_NON_NULL_NR_MSG(request, "NULL request in addToReportBatch\n");
+    EdgeReportBatch *batch = getReportBatch(batches, request);
+    COND_CHECK_NR_MSG(IS_NULL(batch), "");
+    EdgeMessage *msg = batch->msg;
+
+    if (msg->responseLength == batch->capacity)
+    {
+        size_t capacity = batch->capacity * 2;
+        EdgeResponse **responses = (EdgeResponse **) EdgeArenaRealloc(msg->arena, msg->responses,
+                capacity * sizeof(EdgeResponse *));
+        if (IS_NULL(responses))
+        {
+            EDGE_LOG(TAG, "Error : Realloc failed for batch responses in monitor item handler\n");
+            return;
+        }
+        msg->responses = responses;
+        batch->capacity = capacity;
+    }
+
+    EdgeResponse *response = createReportResponse(msg->arena, valueAlias, value);
+    if (IS_NOT_NULL(response))
+    {
+        msg->responses[msg->responseLength++] = response;
+    }
+
+    if (msg->responseLength >= maxSize)
+    {
+        add_to_recvQ(takeReportBatch(batches, batch));
+    }
+}
@@ -0,0 +1,92 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_report_batch.h
+ *
+ * @brief This file contains the REPORT messages the data change notifications are delivered in.
+ *
+ * When notifications are delivered in batches, the notifications of each subscription request
+ * in a publish cycle are collected in one REPORT message, which carries the message id of the
+ * request. A batch is handed to the receive queue as soon as it holds the most notifications
+ * allowed, the others at the end of the publish cycle. The batches of a client are only used
+ * by the thread running its publish cycle.
+ */
+
+#ifndef EDGE_REPORT_BATCH_H
+#define EDGE_REPORT_BATCH_H
+
+#include <stddef.h>
+
+#include "opcua_common.h"
+#include "open62541.h"
+#include "edge_arena.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Notifications of one subscription request in the current publish cycle. */
+typedef struct EdgeReportBatch EdgeReportBatch;
+
+/**
+ * @brief Creates an empty REPORT message for the notifications of a subscription request.
+ * @param[in]  request Subscription request. The report gets its endpoint and message id.
+ * @param[in]  arena Arena holding the message, NULL if allocated one by one.
+ * @param[in]  capacity Number of responses to allocate.
+ * @return message on success, NULL if memory allocation failed.
+ */
+EdgeMessage *createReportMessage(const EdgeMessage *request, EdgeArena *arena, size_t capacity);
+
+/**
+ * @brief Creates the response for one data change notification.
+ * @param[in]  arena Arena of the REPORT message, which holds the response.
+ * @param[in]  valueAlias Value alias of the monitored item.
+ * @param[in]  value Changed value.
+ * @return response on success, NULL if memory allocation failed.
+ */
+EdgeResponse *createReportResponse(EdgeArena *arena, const char *valueAlias, UA_DataValue *value);
+
+/**
+ * @brief Adds a notification to the batch of its subscription request, which is created if
+ *        needed. The batch is handed to the receive queue once it holds maxSize notifications.
+ * @param[in,out]  batches Batches of the current publish cycle, in the order of their first
+ *                 notification.
+ * @param[in]  request Subscription request of the notification.
+ * @param[in]  valueAlias Value alias of the monitored item.
+ * @param[in]  value Changed value.
+ * @param[in]  maxSize Most notifications in one REPORT message.
+ */
+void addToReportBatch(EdgeReportBatch **batches, const EdgeMessage *request,
+        const char *valueAlias, UA_DataValue *value, size_t maxSize);
+
+/**
+ * @brief Hands the batches of the publish cycle to the receive queue, in the order of their
+ *        first notification.
+ * @param[in,out]  batches Batches of the publish cycle. NULL afterwards.
+ */
+void flushReportBatches(EdgeReportBatch **batches);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_REPORT_BATCH_H
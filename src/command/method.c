@@ -70,9 +70,13 @@ EdgeResult executeMethod(UA_Client *client, const EdgeMessage *msg)
     UA_Variant *output = NULL;
     EdgeMessage *resultMsg = NULL;
     /* Execute Method Call */
-    UA_StatusCode retVal = UA_Client_call(client, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
-            UA_NODEID_STRING(request->nodeInfo->nodeId->nameSpace, request->nodeInfo->valueAlias),
-            num_inpArgs, input, &outputSize, &output);
+    UA_NodeId methodId;
+    UA_StatusCode retVal = UA_STATUSCODE_BADNODEIDINVALID;
+    if (convertToUANodeId(request->nodeInfo, &methodId))
+    {
+        retVal = UA_Client_call(client, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER), methodId,
+                num_inpArgs, input, &outputSize, &output);
+    }
     if (retVal != UA_STATUSCODE_GOOD)
     {
         /* Method call failed */
@@ -24,15 +24,31 @@
 #include "message_dispatcher.h"
 #include "edge_logger.h"
 #include "edge_malloc.h"
+#include "edge_arena.h"
 #include "edge_open62541.h"
+#include "edge_server_capabilities.h"
+#include "edge_value_cache.h"
+#include "edge_prepared_group.h"
+#include "edge_index_range.h"
+#include "edge_flat_results.h"
 
 #include <inttypes.h>
+#include <string.h>
 
 #define TAG "read"
 
 #define GUID_LENGTH (36)
 #define ERROR_DESC_LENGTH (100)
 
+static bool g_flatReadResults = false;
+
+static UA_ReadResponse readService(UA_Client *client, const UA_ReadRequest request)
+{
+    return UA_Client_Service_read(client, request);
+}
+
+static edge_read_service_t g_readService = readService;
+
 #ifdef CTT_ENABLED
 UA_Int64 DateTime_toUnixTime(UA_DateTime date)
 {
@@ -85,77 +101,877 @@ static bool checkInvalidTime(UA_DateTime serverTime, UA_DateTime sourceTime, int
     int64_t server_time = UA_DateTime_toUnixTime(serverTime);
     int64_t source_time = UA_DateTime_toUnixTime(sourceTime);
 
-    if (UA_TIMESTAMPSTORETURN_BOTH == stamp)
+    if (UA_TIMESTAMPSTORETURN_BOTH == stamp)
+    {
+        /* Both server and source timestamps requested */
+        COND_CHECK_MSG((server_time == 0), "Invalid server timestamp\n", false);
+        COND_CHECK_MSG((source_time == 0), "Invalid source timestamp\n", false);
+
+        COND_CHECK_MSG((compareNumber(now_time - server_time, validMilliSec)), "", false);
+        COND_CHECK_MSG((compareNumber(now_time - source_time, validMilliSec)), "", false);
+        COND_CHECK_MSG((compareNumber(server_time, now_time)), "", false);
+        COND_CHECK_MSG((compareNumber(source_time, now_time)), "", false);
+    }
+    else if (UA_TIMESTAMPSTORETURN_SOURCE == stamp)
+    {
+        /* Only source timestamp requested from server */
+        COND_CHECK_MSG((source_time == 0), "Invalid source timestamp\n", false);
+
+        COND_CHECK_MSG((compareNumber(now_time - source_time, validMilliSec)), "", false);
+        COND_CHECK_MSG((compareNumber(source_time, now_time)), "", false);
+    }
+    else if (UA_TIMESTAMPSTORETURN_SERVER == stamp)
+    {
+        /* Only server timestamp requested from server */
+        COND_CHECK_MSG((server_time == 0), "Invalid server timestamp\n", false);
+
+        COND_CHECK_MSG((compareNumber(now_time - server_time, validMilliSec)), "", false);
+        COND_CHECK_MSG((compareNumber(server_time, now_time)), "", false);
+    }
+
+    return true;
+}
+
+/**
+ * @brief checkValidation - Validates the read response
+ * @param value - Read response value
+ * @param msg - Edge Message
+ * @param stamp - TimestampsToReturn parameter in read request
+ * @param maxAge - Max Age
+ * @return value on success, NULL on error
+ */
+static void *checkValidation(UA_DataValue *value, const EdgeMessage *msg, UA_TimestampsToReturn stamp,
+        double maxAge)
+{
+    /* Error check for invalid timestamp returned by server */
+    if (!checkInvalidTime(value->serverTimestamp, value->sourceTimestamp, 86400000, stamp))
+    {
+        // Error message handling
+        sendErrorResponse(msg, "Invalid Time");
+        return NULL;
+    }
+
+    /* Error check of status code returned by server */
+    if (UA_STATUSCODE_GOOD != value->status)
+    {
+        // Error message handling
+        sendErrorResponse(msg, "Error status code from server");
+        return NULL;
+    }
+
+    /* Error check for array value response */
+    if (!UA_Variant_isScalar(&(value->value)))
+    {
+        if (value->value.arrayLength == 0)
+        {
+            // Error message handling
+            sendErrorResponse(msg, "Invalid array length in read response");
+            return NULL;
+        }
+    }
+    return value;
+}
+#endif // CTT_ENABLED
+
+/**
+ * @brief getRequestAttributeId - Gets the attribute to read for a request
+ * @param request - Edge request
+ * @param attributeId - Attribute Id of the command
+ * @return Attribute Id of the request if it has one, else the one of the command
+ */
+static UA_UInt32 getRequestAttributeId(const EdgeRequest *request, UA_UInt32 attributeId)
+{
+    return (request->attributeId > 0) ? request->attributeId : attributeId;
+}
+
+/**
+ * @brief fillReadValueId - Fills the read value id for the node of a request.
+ * A paged index range asks for its first page only
+ * @param request - Edge request
+ * @param attributeId - Attribute Id of the command
+ * @param rv - Read value id to fill
+ */
+static void fillReadValueId(const EdgeRequest *request, UA_UInt32 attributeId, UA_ReadValueId *rv)
+{
+    EDGE_LOG_V(TAG, "[READGROUP] Node to read :: %s [ns : %d]\n", request->nodeInfo->valueAlias,
+            request->nodeInfo->nodeId->nameSpace);
+    UA_ReadValueId_init(rv);
+    rv->attributeId = getRequestAttributeId(request, attributeId);
+    UA_NodeId nodeId;
+    if (convertToUANodeId(request->nodeInfo, &nodeId))
+    {
+        UA_NodeId_copy(&nodeId, &rv->nodeId);
+    }
+    if (request->indexRange)
+    {
+        char page[EDGE_INDEX_RANGE_SIZE];
+        rv->indexRange = UA_STRING_ALLOC(getEdgeIndexRangeFirstPage(request->indexRange, page,
+                sizeof(page)));
+    }
+}
+
+/**
+ * @brief fillReadValueIds - Fills the read value ids for the nodes of a request message.
+ * The read value ids of a prepared group are shared, not copied
+ * @param msg - Request edge message
+ * @param attributeId - Attribute Id to read
+ * @param rv - Read value ids to fill. Must have room for msg->requestLength entries
+ */
+static void fillReadValueIds(const EdgeMessage *msg, UA_UInt32 attributeId, UA_ReadValueId *rv)
+{
+    if (msg->preparedGroup)
+    {
+        memcpy(rv, msg->preparedGroup->readValueIds, sizeof(UA_ReadValueId) * msg->requestLength);
+        return;
+    }
+    for (size_t i = 0; i < msg->requestLength; i++)
+    {
+        fillReadValueId(msg->requests[i], attributeId, &rv[i]);
+    }
+}
+
+/**
+ * @brief deleteReadValueIds - Frees the members filled by fillReadValueIds
+ * @param msg - Request edge message
+ * @param rv - Read value ids of the nodes of the message
+ */
+static void deleteReadValueIds(const EdgeMessage *msg, UA_ReadValueId *rv)
+{
+    for (size_t i = 0; !msg->preparedGroup && i < msg->requestLength; i++)
+    {
+        UA_ReadValueId_deleteMembers(&rv[i]);
+    }
+}
+
+/**
+ * @brief acceptsCachedValues - Checks whether a node of the request message accepts a cached value
+ * @param msg - Request edge message
+ * @return true if a request has a maxAge
+ */
+static bool acceptsCachedValues(const EdgeMessage *msg)
+{
+    for (size_t i = 0; i < msg->requestLength; i++)
+    {
+        if (msg->requests[i]->maxAge > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief readsAlone - Checks whether the request message is read on its own instead of in a batch
+ * @param msg - Request edge message
+ * @return true if the message accepts cached values or has an invalid node
+ */
+static bool readsAlone(const EdgeMessage *msg)
+{
+    return acceptsCachedValues(msg) || !hasValidNodeIds(msg);
+}
+
+/**
+ * @brief cacheReadResult - Stores the read result of a request in the value cache.
+ * Parts of an array are not stored
+ * @param cache - Value cache of the session. Nothing is stored if NULL
+ * @param request - Edge request
+ * @param attributeId - Attribute Id of the command
+ * @param result - Read result of the request
+ */
+static void cacheReadResult(EdgeValueCache *cache, const EdgeRequest *request,
+        UA_UInt32 attributeId, const UA_DataValue *result)
+{
+    COND_CHECK_NR_MSG((IS_NULL(cache) || IS_NOT_NULL(request->indexRange)), "");
+    UA_NodeId nodeId;
+    COND_CHECK_NR_MSG((!convertToUANodeId(request->nodeInfo, &nodeId)), "");
+    updateCachedValue(cache, &nodeId, getRequestAttributeId(request, attributeId), result);
+}
+
+/**
+ * @brief cacheReadResults - Stores the read results of a request message in the value cache
+ * @param cache - Value cache of the session. Nothing is stored if NULL
+ * @param msg - Request edge message
+ * @param attributeId - Attribute Id of the command
+ * @param results - Read results in the order of msg->requests
+ */
+static void cacheReadResults(EdgeValueCache *cache, const EdgeMessage *msg, UA_UInt32 attributeId,
+        const UA_DataValue *results)
+{
+    for (size_t i = 0; cache && i < msg->requestLength; i++)
+    {
+        cacheReadResult(cache, msg->requests[i], attributeId, &results[i]);
+    }
+}
+
+/**
+ * @brief getEncodedElementSize - Estimates the encoded size of an element of an array value
+ * @param value - Array value
+ * @return Size in bytes, 0 if it is not known for the type of the value
+ */
+static size_t getEncodedElementSize(const UA_Variant *value)
+{
+    if (value->type->pointerFree)
+    {
+        return value->type->memSize;
+    }
+    if (value->type == &UA_TYPES[UA_TYPES_STRING] || value->type == &UA_TYPES[UA_TYPES_BYTESTRING])
+    {
+        /* Length prefix and the longest string of the value */
+        size_t size = 0;
+        const UA_String *strings = (const UA_String *) value->data;
+        for (size_t i = 0; i < value->arrayLength; i++)
+        {
+            size = (strings[i].length > size) ? strings[i].length : size;
+        }
+        return size + sizeof(UA_Int32);
+    }
+    return 0;
+}
+
+/**
+ * @brief appendRangePage - Appends the elements of a page to the elements read before
+ * @param value - Array value read so far
+ * @param page - Value of the page. A scalar is one element. Its elements are taken over
+ * @param pageLen - Number of elements appended
+ * @return true on success
+ */
+static bool appendRangePage(UA_Variant *value, UA_Variant *page, size_t *pageLen)
+{
+    *pageLen = UA_Variant_isScalar(page) ? 1 : page->arrayLength;
+    COND_CHECK((0 == *pageLen), true);
+    COND_CHECK((page->type != value->type), false);
+    size_t total = value->arrayLength + *pageLen;
+    void *data = UA_Array_new(total, value->type);
+    VERIFY_NON_NULL_MSG(data, "Memory allocation failed for a page of an index range.", false);
+
+    /* The elements are moved, so only the arrays holding them are freed */
+    size_t memSize = value->type->memSize;
+    memcpy(data, value->data, value->arrayLength * memSize);
+    memcpy((char *) data + value->arrayLength * memSize, page->data, *pageLen * memSize);
+    UA_free(value->data);
+    UA_free(page->data);
+    page->data = NULL;
+    page->arrayLength = 0;
+    value->data = data;
+    value->arrayLength = total;
+
+    /* The dimensions the server sent are those of the first page */
+    UA_Array_delete(value->arrayDimensions, value->arrayDimensionsSize, &UA_TYPES[UA_TYPES_UINT32]);
+    value->arrayDimensions = NULL;
+    value->arrayDimensionsSize = 0;
+    return true;
+}
+
+/**
+ * @brief setReadFailure - Replaces a read result by a bad status
+ * @param result - Read result
+ * @param status - Bad status code
+ */
+static void setReadFailure(UA_DataValue *result, UA_StatusCode status)
+{
+    UA_DataValue_deleteMembers(result);
+    UA_DataValue_init(result);
+    result->hasStatus = true;
+    result->status = (UA_STATUSCODE_GOOD != status) ? status : UA_STATUSCODE_BADUNEXPECTEDERROR;
+}
+
+/**
+ * @brief readRangePages - Reads the pages after the first one of a paged index range, each in
+ * its own read, and appends them to the result of the first page. The pages are sized to fit
+ * into the message size negotiated with the server
+ * @param client - Client handle
+ * @param request - Edge request
+ * @param rv - Read value id of the first page
+ * @param result - Read result of the first page
+ */
+static void readRangePages(UA_Client *client, const EdgeRequest *request, const UA_ReadValueId *rv,
+        UA_DataValue *result)
+{
+    uint32_t first = 0;
+    uint32_t last = 0;
+    COND_CHECK_NR_MSG((IS_NULL(request->indexRange)
+            || !parseEdgeIndexRange(request->indexRange, &first, &last)
+            || last - first < EDGE_INDEX_RANGE_FIRST_PAGE), "");
+    /* The array ended within the first page */
+    COND_CHECK_NR_MSG((UA_STATUSCODE_GOOD != result->status || !result->hasValue
+            || UA_Variant_isScalar(&result->value)
+            || result->value.arrayLength < EDGE_INDEX_RANGE_FIRST_PAGE), "");
+
+    EdgeServerCapabilities capabilities;
+    getServerCapabilities(client, &capabilities);
+    uint64_t next = (uint64_t) first + result->value.arrayLength;
+    uint32_t pageSize = getEdgeIndexRangePageSize(capabilities.maxMessageSize,
+            getEncodedElementSize(&result->value), (uint32_t) (last - next + 1));
+    EDGE_LOG_V(TAG, "[READ] Range %s in pages of %u\n", request->indexRange, pageSize);
+
+    char range[EDGE_INDEX_RANGE_SIZE];
+    UA_ReadValueId pageRv = *rv;
+    UA_ReadRequest readRequest;
+    UA_ReadRequest_init(&readRequest);
+    readRequest.nodesToRead = &pageRv;
+    readRequest.nodesToReadSize = 1;
+    readRequest.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+    while (next <= last)
+    {
+        uint32_t pageLast = (last - next + 1 > pageSize) ? (uint32_t) (next + pageSize - 1) : last;
+        formatEdgeIndexRange((uint32_t) next, pageLast, range, sizeof(range));
+        pageRv.indexRange = UA_STRING(range);
+
+        UA_ReadResponse readResponse = g_readService(client, readRequest);
+        UA_StatusCode status = readResponse.responseHeader.serviceResult;
+        if (UA_STATUSCODE_GOOD == status)
+        {
+            status = (1 == readResponse.resultsSize) ? readResponse.results[0].status :
+                    UA_STATUSCODE_BADUNEXPECTEDERROR;
+        }
+        if (UA_STATUSCODE_BADINDEXRANGENODATA == status)
+        {
+            /* The array ended with the previous page */
+            UA_ReadResponse_deleteMembers(&readResponse);
+            break;
+        }
+
+        size_t pageLen = 0;
+        if (UA_STATUSCODE_GOOD != status || !readResponse.results[0].hasValue
+                || !appendRangePage(&result->value, &readResponse.results[0].value, &pageLen))
+        {
+            EDGE_LOG_V(TAG, "Error in reading the range %s :: 0x%08x(%s)\n", range, status,
+                    UA_StatusCode_name(status));
+            setReadFailure(result, status);
+            UA_ReadResponse_deleteMembers(&readResponse);
+            return;
+        }
+        UA_ReadResponse_deleteMembers(&readResponse);
+        if (pageLen < pageLast - next + 1)
+        {
+            /* The array ended within this page */
+            break;
+        }
+        next = (uint64_t) pageLast + 1;
+    }
+}
+
+/**
+ * @brief readMessageRangePages - Reads the rest of the paged index ranges of a request message
+ * @param client - Client handle
+ * @param msg - Request edge message
+ * @param rv - Read value ids of the first read, in the order of msg->requests
+ * @param results - Read results of the first read, in the order of msg->requests
+ */
+static void readMessageRangePages(UA_Client *client, const EdgeMessage *msg,
+        const UA_ReadValueId *rv, UA_DataValue *results)
+{
+    for (size_t i = 0; i < msg->requestLength; i++)
+    {
+        readRangePages(client, msg->requests[i], &rv[i], &results[i]);
+    }
+}
+
+/**
+ * @brief moveChunkResults - Moves the results of one chunk into the merged response
+ * @param merged - Merged response with room for all results
+ * @param chunk - Response of the chunk. Its results are taken over
+ * @param offset - Position of the first node of the chunk
+ * @param chunkLen - Number of nodes in the chunk
+ */
+static void moveChunkResults(UA_ReadResponse *merged, UA_ReadResponse *chunk, size_t offset,
+        size_t chunkLen)
+{
+    memcpy(merged->results + offset, chunk->results, sizeof(UA_DataValue) * chunkLen);
+    UA_free(chunk->results);
+    chunk->results = NULL;
+    chunk->resultsSize = 0;
+
+    /* Diagnostics are kept only if every chunk has them for each of its nodes */
+    if (IS_NOT_NULL(merged->diagnosticInfos) && chunk->diagnosticInfosSize == chunkLen)
+    {
+        memcpy(merged->diagnosticInfos + offset, chunk->diagnosticInfos,
+                sizeof(UA_DiagnosticInfo) * chunkLen);
+        UA_free(chunk->diagnosticInfos);
+        chunk->diagnosticInfos = NULL;
+        chunk->diagnosticInfosSize = 0;
+    }
+    else if (IS_NOT_NULL(merged->diagnosticInfos))
+    {
+        UA_Array_delete(merged->diagnosticInfos, merged->diagnosticInfosSize,
+                &UA_TYPES[UA_TYPES_DIAGNOSTICINFO]);
+        merged->diagnosticInfos = NULL;
+        merged->diagnosticInfosSize = 0;
+    }
+}
+
+/**
+ * @brief readInChunks - Reads the nodes of the request in chunks of at most MaxNodesPerRead
+ * of the server, one after another on the session, and merges the results in the order of
+ * the request
+ * @param client - Client handle
+ * @param readRequest - Read request of all the nodes
+ * @return Read response for all the nodes. The service result is the first bad one of the chunks
+ */
+static UA_ReadResponse readInChunks(UA_Client *client, UA_ReadRequest *readRequest)
+{
+    EdgeServerCapabilities capabilities;
+    getServerCapabilities(client, &capabilities);
+    size_t reqLen = readRequest->nodesToReadSize;
+    size_t chunkSize = getOperationChunkSize(capabilities.maxNodesPerRead, reqLen);
+    if (chunkSize == reqLen)
+    {
+        return g_readService(client, *readRequest);
+    }
+
+    UA_ReadResponse merged;
+    UA_ReadResponse_init(&merged);
+    merged.results = (UA_DataValue *) UA_Array_new(reqLen, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    merged.diagnosticInfos = (UA_DiagnosticInfo *) UA_Array_new(reqLen,
+            &UA_TYPES[UA_TYPES_DIAGNOSTICINFO]);
+    if (IS_NULL(merged.results) || IS_NULL(merged.diagnosticInfos))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed for the chunked read response.");
+        UA_ReadResponse_deleteMembers(&merged);
+        UA_ReadResponse_init(&merged);
+        merged.responseHeader.serviceResult = UA_STATUSCODE_BADOUTOFMEMORY;
+        return merged;
+    }
+    merged.resultsSize = reqLen;
+    merged.diagnosticInfosSize = reqLen;
+
+    EDGE_LOG_V(TAG, "[READ] %zu nodes in chunks of %zu\n", reqLen, chunkSize);
+    UA_ReadValueId *nodesToRead = readRequest->nodesToRead;
+    for (size_t offset = 0; offset < reqLen; offset += chunkSize)
+    {
+        size_t chunkLen = getOperationChunkSize((uint32_t) chunkSize, reqLen - offset);
+        readRequest->nodesToRead = nodesToRead + offset;
+        readRequest->nodesToReadSize = chunkLen;
+        UA_ReadResponse chunk = g_readService(client, *readRequest);
+        if (chunk.responseHeader.serviceResult != UA_STATUSCODE_GOOD || chunk.resultsSize != chunkLen)
+        {
+            merged.responseHeader.serviceResult = (chunk.responseHeader.serviceResult != UA_STATUSCODE_GOOD) ?
+                    chunk.responseHeader.serviceResult : UA_STATUSCODE_BADUNEXPECTEDERROR;
+            UA_ReadResponse_deleteMembers(&chunk);
+            break;
+        }
+        moveChunkResults(&merged, &chunk, offset, chunkLen);
+        UA_ReadResponse_deleteMembers(&chunk);
+    }
+    readRequest->nodesToRead = nodesToRead;
+    readRequest->nodesToReadSize = reqLen;
+    return merged;
+}
+
+void setReadResultLayout(bool flat)
+{
+    g_flatReadResults = flat;
+}
+
+void setReadService(edge_read_service_t service)
+{
+    g_readService = service ? service : readService;
+}
+
+/**
+ * @brief isFlatStringType - Checks whether the values of a type go into the string pool of
+ * the flat results
+ * @param type - Type of the value, as EdgeResponse.type
+ * @return true for strings, byte strings, XML elements and GUIDs
+ */
+static bool isFlatStringType(int type)
+{
+    return (UA_NS0ID_STRING == type || UA_NS0ID_BYTESTRING == type
+            || UA_NS0ID_XMLELEMENT == type || UA_NS0ID_GUID == type);
+}
+
+/**
+ * @brief isFlatFixedType - Checks whether the values of a type go into the data of the flat
+ * results
+ * @param type - Type of the value, as EdgeResponse.type
+ * @return true for the numbers, DateTime and StatusCode
+ */
+static bool isFlatFixedType(int type)
+{
+    return ((type >= UA_NS0ID_BOOLEAN && type <= UA_NS0ID_DOUBLE) || UA_NS0ID_DATETIME == type
+            || UA_NS0ID_STATUSCODE == type);
+}
+
+/**
+ * @brief sizeFlatResult - Adds the size of a read result to the flat results
+ * @param builder - Builder of the flat results
+ * @param result - Read result
+ * @return false if the type of the value cannot be held by the flat results
+ */
+static bool sizeFlatResult(EdgeFlatResultsBuilder *builder, const UA_DataValue *result)
+{
+    const UA_Variant *val = &result->value;
+    COND_CHECK((result->status != UA_STATUSCODE_GOOD || UA_Variant_isEmpty(val)), true);
+
+    int type = get_response_type(val->type);
+    size_t elementCount = UA_Variant_isScalar(val) ? 1 : val->arrayLength;
+    if (isFlatFixedType(type))
+    {
+        sizeEdgeFlatValue(builder, val->type->memSize, elementCount);
+        return true;
+    }
+    COND_CHECK((!isFlatStringType(type)), false);
+    for (size_t j = 0; j < elementCount; j++)
+    {
+        sizeEdgeFlatString(builder, (UA_NS0ID_GUID == type) ?
+                GUID_LENGTH : ((const UA_String *) val->data)[j].length);
+    }
+    return true;
+}
+
+/**
+ * @brief appendFlatResult - Copies a read result into the flat results
+ * @param builder - Builder of the flat results
+ * @param index - Position of the node in the request message
+ * @param result - Read result
+ * @return true on success
+ */
+static bool appendFlatResult(EdgeFlatResultsBuilder *builder, size_t index,
+        const UA_DataValue *result)
+{
+    EdgeFlatValue *value = &builder->results->values[index];
+    const UA_Variant *val = &result->value;
+    value->status = result->status;
+    COND_CHECK((result->status != UA_STATUSCODE_GOOD || UA_Variant_isEmpty(val)), true);
+
+    value->type = get_response_type(val->type);
+    value->isArray = !UA_Variant_isScalar(val);
+    size_t elementCount = value->isArray ? val->arrayLength : 1;
+    if (isFlatFixedType(value->type))
+    {
+        void *data = appendEdgeFlatValue(builder, index, val->type->memSize, elementCount);
+        COND_CHECK((IS_NULL(data)), false);
+        if (elementCount > 0)
+        {
+            memcpy(data, val->data, val->type->memSize * elementCount);
+        }
+        return true;
+    }
+
+    value->isString = true;
+    for (size_t j = 0; j < elementCount; j++)
+    {
+        bool appended = false;
+        if (UA_NS0ID_GUID == value->type)
+        {
+            char guid[GUID_LENGTH + 1];
+            char *out = guid;
+            convertGuidToString(((const UA_Guid *) val->data)[j], &out);
+            appended = appendEdgeFlatString(builder, index, guid, GUID_LENGTH);
+        }
+        else
+        {
+            const UA_String *str = &((const UA_String *) val->data)[j];
+            appended = appendEdgeFlatString(builder, index, (const char *) str->data, str->length);
+        }
+        COND_CHECK((!appended), false);
+    }
+    return true;
+}
+
+/**
+ * @brief sendFlatReadResponse - Sends the read results of a group request message to the
+ * application in one EdgeFlatResults. Nodes which were not read keep their status code in
+ * their entry, no error response is sent for them. Diagnostics are not returned
+ * @param msg - Request edge message
+ * @param attributeId - Attribute Id of the command
+ * @param results - Read results in the order of msg->requests
+ * @return false if a value has a type the flat results cannot hold. Nothing is sent then
+ */
+static bool sendFlatReadResponse(const EdgeMessage *msg, UA_UInt32 attributeId,
+        UA_DataValue *results)
+{
+    size_t reqLen = msg->requestLength;
+    EdgeFlatResultsBuilder builder;
+    memset(&builder, 0, sizeof(builder));
+    builder.count = reqLen;
+    for (size_t i = 0; i < reqLen; i++)
+    {
+        COND_CHECK((!sizeFlatResult(&builder, &results[i])), false);
+    }
+
+    /* The response is built in one arena, which freeEdgeMessage() gives back to the pool. */
+    EdgeArena *arena = EdgeArenaAcquire();
+
+    EdgeMessage *resultMsg = (EdgeMessage *) EdgeArenaCalloc(arena, 1, sizeof(EdgeMessage));
+    if (IS_NULL(resultMsg))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for resultMsg in Read Group\n");
+        EdgeArenaRelease(arena);
+        sendErrorResponse(msg, "Memory allocation failed.");
+        return true;
+    }
+    resultMsg->arena = arena;
+    resultMsg->command = (UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL == attributeId) ?
+            CMD_READ_SAMPLING_INTERVAL : CMD_READ;
+    resultMsg->type = GENERAL_RESPONSE;
+    resultMsg->message_id = msg->message_id;
+    resultMsg->endpointInfo = cloneEdgeEndpointInfoInArena(arena, msg->endpointInfo);
+    resultMsg->flatResults = createEdgeFlatResultsInArena(arena, &builder);
+    bool built = IS_NOT_NULL(resultMsg->endpointInfo) && IS_NOT_NULL(resultMsg->flatResults);
+    for (size_t i = 0; built && i < reqLen; i++)
+    {
+        resultMsg->flatResults->values[i].requestId = msg->requests[i]->requestId;
+        resultMsg->flatResults->values[i].attributeId =
+                getRequestAttributeId(msg->requests[i], attributeId);
+        built = appendFlatResult(&builder, i, &results[i]);
+    }
+    if (!built)
+    {
+        EDGE_LOG(TAG, "Error : Failed to build the flat results in Read Group\n");
+        sendErrorResponse(msg, "Memory allocation failed.");
+        freeEdgeMessage(resultMsg);
+        return true;
+    }
+
+    EDGE_LOG_V(TAG, "[READGROUP] %zu results in %zu data and %zu string bytes\n", reqLen,
+            resultMsg->flatResults->dataSize, resultMsg->flatResults->stringsSize);
+    add_to_recvQ(resultMsg);
+    return true;
+}
+
+/**
+ * @brief sendReadResponse - Sends the read results of a request message to the application
+ * @param msg - Request edge message
+ * @param attributeId - Attribute Id of the command
+ * @param results - Read results in the order of msg->requests
+ * @param diagnosticInfos - Diagnostic information in the order of msg->requests
+ * @param diagnosticInfosSize - Number of diagnostic information
+ * @param returnDiagnostics - Return diagnostics parameter of the read request
+ */
+static void sendReadResponse(const EdgeMessage *msg, UA_UInt32 attributeId, UA_DataValue *results,
+        UA_DiagnosticInfo *diagnosticInfos, size_t diagnosticInfosSize, UA_UInt32 returnDiagnostics)
+{
+    char errorDesc[ERROR_DESC_LENGTH] = {'\0'};
+    EdgeMessage *resultMsg = NULL;
+    size_t reqLen = msg->requestLength;
+
+    /* Group reads may be answered in one block, unless a value does not fit into it */
+    if (g_flatReadResults && reqLen > 1 && sendFlatReadResponse(msg, attributeId, results))
+    {
+        return;
+    }
+
+    /* The response is built in one arena, which freeEdgeMessage() gives back to the pool. */
+    EdgeArena *arena = EdgeArenaAcquire();
+
+    resultMsg = (EdgeMessage *) EdgeArenaCalloc(arena, 1, sizeof(EdgeMessage));
+    if(IS_NULL(resultMsg))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for resultMsg in Read Group\n");
+        strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
+        goto EXIT;
+    }
+    resultMsg->arena = arena;
+
+    resultMsg->responses = (EdgeResponse **) EdgeArenaCalloc(arena, reqLen,
+            sizeof(EdgeResponse *));
+    if(IS_NULL(resultMsg->responses))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for responses in Read Group\n");
+        strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
+        goto EXIT;
+    }
+
+    resultMsg->responseLength = 0;
+    if (UA_ATTRIBUTEID_VALUE == attributeId) {
+        resultMsg->command = CMD_READ;
+    } else if (UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL == attributeId) {
+        resultMsg->command = CMD_READ_SAMPLING_INTERVAL;
+    }
+    resultMsg->type = GENERAL_RESPONSE;
+    resultMsg->message_id = msg->message_id;
+    resultMsg->endpointInfo = cloneEdgeEndpointInfoInArena(arena, msg->endpointInfo);
+    if(IS_NULL(resultMsg->endpointInfo))
+    {
+        EDGE_LOG(TAG, "Error : EdgeCalloc failed for resultMsg.endpointInfo in Read Group\n");
+        strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
+        goto EXIT;
+    }
+
+    int respIndex = 0;
+    for (int i = 0; i < reqLen; i++)
+    {
+        if (results[i].status == UA_STATUSCODE_GOOD)
+        {
+            UA_Variant val = results[i].value;
+
+            EdgeResponse *response = (EdgeResponse *) EdgeArenaCalloc(arena, 1,
+                    sizeof(EdgeResponse));
+            if (IS_NULL(response))
+            {
+                EDGE_LOG(TAG, "Memory allocation failed\n");
+                strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
+                goto EXIT;
+            }
+
+            response->nodeInfo = cloneEdgeNodeInfoInArena(arena, msg->requests[i]->nodeInfo);
+            if(IS_NULL(response->nodeInfo))
+            {
+                EDGE_LOG(TAG, "Error : Malloc failed for response.Nodeinfo in Read Group\n");
+                strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
+                goto EXIT;
+            }
+
+            response->requestId = msg->requests[i]->requestId;
+            response->attributeId = getRequestAttributeId(msg->requests[i], attributeId);
+            response->message = parseResponseInArena(arena, response, val);
+            if (IS_NULL(response->message))
+            {
+                goto EXIT;
+            }
+
+            /* Check for diagnostic information in read response */
+            response->m_diagnosticInfo = checkDiagnosticInfoInArena(arena, msg->requestLength,
+                    diagnosticInfos, diagnosticInfosSize, returnDiagnostics);
+
+            resultMsg->responseLength++;
+            resultMsg->responses[respIndex++] = response;
+        }
+        else
+        {
+            /* Error in read response for a particular node */
+            EDGE_LOG_V(TAG, "Error in group read response for particular node :: 0x%08x(%s)\n",
+                    results[i].status, UA_StatusCode_name(results[i].status));
+            if(1 == reqLen)
+            {
+                // Error response for the node(only one) in the given read request.
+                snprintf(errorDesc, ERROR_DESC_LENGTH, "Bad service result for the given node");
+                goto EXIT;
+            }
+            snprintf(errorDesc, ERROR_DESC_LENGTH, "Bad service result for the node at position(%d)", i);
+            sendErrorResponse(msg, errorDesc);
+        }
+    }
+
+    if (reqLen > 1 && resultMsg->responseLength < 1)
     {
-        /* Both server and source timestamps requested */
-        COND_CHECK_MSG((server_time == 0), "Invalid server timestamp\n", false);
-        COND_CHECK_MSG((source_time == 0), "Invalid source timestamp\n", false);
-
-        COND_CHECK_MSG((compareNumber(now_time - server_time, validMilliSec)), "", false);
-        COND_CHECK_MSG((compareNumber(now_time - source_time, validMilliSec)), "", false);
-        COND_CHECK_MSG((compareNumber(server_time, now_time)), "", false);
-        COND_CHECK_MSG((compareNumber(source_time, now_time)), "", false);
+        EDGE_LOG(TAG, "There are no valid responses.");
+        strncpy(errorDesc, "There are no valid responses.", ERROR_DESC_LENGTH);
+        goto EXIT;
     }
-    else if (UA_TIMESTAMPSTORETURN_SOURCE == stamp)
-    {
-        /* Only source timestamp requested from server */
-        COND_CHECK_MSG((source_time == 0), "Invalid source timestamp\n", false);
+    /* Adding the read response to receiver Q */
+    add_to_recvQ(resultMsg);
+    return;
 
-        COND_CHECK_MSG((compareNumber(now_time - source_time, validMilliSec)), "", false);
-        COND_CHECK_MSG((compareNumber(source_time, now_time)), "", false);
+    EXIT:
+    /* Free the memory */
+    sendErrorResponse(msg, errorDesc);
+    if (resultMsg)
+    {
+        freeEdgeMessage(resultMsg);
     }
-    else if (UA_TIMESTAMPSTORETURN_SERVER == stamp)
+    else
     {
-        /* Only server timestamp requested from server */
-        COND_CHECK_MSG((server_time == 0), "Invalid server timestamp\n", false);
-
-        COND_CHECK_MSG((compareNumber(now_time - server_time, validMilliSec)), "", false);
-        COND_CHECK_MSG((compareNumber(server_time, now_time)), "", false);
+        EdgeArenaRelease(arena);
     }
-
-    return true;
 }
 
 /**
- * @brief checkValidation - Validates the read response
- * @param value - Read response value
- * @param msg - Edge Message
- * @param stamp - TimestampsToReturn parameter in read request
- * @param maxAge - Max Age
- * @return value on success, NULL on error
+ * @brief readGroupCached - Executes read operation of single/group nodes which accept cached
+ * values. Nodes whose cached value is not older than the maxAge of their request are answered
+ * from the cache, only the others are read from the server
+ * @param client - Client handle
+ * @param msg - Request edge message
+ * @param attributeId - Attribute Id to read
+ * @param cache - Value cache of the session
  */
-static void *checkValidation(UA_DataValue *value, const EdgeMessage *msg, UA_TimestampsToReturn stamp,
-        double maxAge)
+static void readGroupCached(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attributeId,
+        EdgeValueCache *cache)
 {
-    /* Error check for invalid timestamp returned by server */
-    if (!checkInvalidTime(value->serverTimestamp, value->sourceTimestamp, 86400000, stamp))
+    size_t reqLen = msg->requestLength;
+    UA_DataValue *results = (UA_DataValue *) UA_Array_new(reqLen, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    UA_ReadValueId *rv = (UA_ReadValueId *) EdgeMalloc(sizeof(UA_ReadValueId) * reqLen);
+    size_t *positions = (size_t *) EdgeMalloc(sizeof(size_t) * reqLen);
+    if (IS_NULL(results) || IS_NULL(rv) || IS_NULL(positions))
     {
-        // Error message handling
-        sendErrorResponse(msg, "Invalid Time");
-        return NULL;
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        sendErrorResponse(msg, "Memory allocation failed.");
+        UA_Array_delete(results, reqLen, &UA_TYPES[UA_TYPES_DATAVALUE]);
+        EdgeFree(rv);
+        EdgeFree(positions);
+        return;
     }
 
-    /* Error check of status code returned by server */
-    if (UA_STATUSCODE_GOOD != value->status)
+    /* The server may answer the others from its own cache within the least maxAge of them */
+    size_t staleLen = 0;
+    double maxAge = 0;
+    for (size_t i = 0; i < reqLen; i++)
     {
-        // Error message handling
-        sendErrorResponse(msg, "Error status code from server");
-        return NULL;
+        EdgeRequest *request = msg->requests[i];
+        UA_NodeId nodeId;
+        if (IS_NULL(request->indexRange) && convertToUANodeId(request->nodeInfo, &nodeId)
+                && getCachedValue(cache, &nodeId, getRequestAttributeId(request, attributeId),
+                        request->maxAge, &results[i]))
+        {
+            continue;
+        }
+        maxAge = (0 == staleLen || request->maxAge < maxAge) ? request->maxAge : maxAge;
+        if (msg->preparedGroup)
+        {
+            rv[staleLen] = msg->preparedGroup->readValueIds[i];
+        }
+        else
+        {
+            fillReadValueId(request, attributeId, &rv[staleLen]);
+        }
+        positions[staleLen++] = i;
     }
+    EDGE_LOG_V(TAG, "[READGROUP] %zu of %zu nodes from the cache\n", reqLen - staleLen, reqLen);
 
-    /* Error check for array value response */
-    if (!UA_Variant_isScalar(&(value->value)))
+    UA_ReadRequest readRequest;
+    UA_ReadRequest_init(&readRequest);
+    UA_ReadResponse readResponse;
+    UA_ReadResponse_init(&readResponse);
+    bool failed = false;
+    if (staleLen > 0)
     {
-        if (value->value.arrayLength == 0)
+        readRequest.nodesToRead = rv;
+        readRequest.nodesToReadSize = staleLen;
+        readRequest.maxAge = (maxAge > 0) ? maxAge : 0;
+        readRequest.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+        readResponse = readInChunks(client, &readRequest);
+        if (readResponse.responseHeader.serviceResult != UA_STATUSCODE_GOOD
+                || readResponse.resultsSize != staleLen)
         {
-            // Error message handling
-            sendErrorResponse(msg, "Invalid array length in read response");
-            return NULL;
+            EDGE_LOG_V(TAG, "Error in group read :: 0x%08x(%s)\n",
+                    readResponse.responseHeader.serviceResult,
+                    UA_StatusCode_name(readResponse.responseHeader.serviceResult));
+            failed = true;
+        }
+        for (size_t i = 0; !failed && i < staleLen; i++)
+        {
+            /* Moved, so the response does not free it */
+            EdgeRequest *request = msg->requests[positions[i]];
+            readRangePages(client, request, &rv[i], &readResponse.results[i]);
+            cacheReadResult(cache, request, attributeId, &readResponse.results[i]);
+            results[positions[i]] = readResponse.results[i];
+            UA_DataValue_init(&readResponse.results[i]);
         }
     }
-    return value;
+
+    if (failed)
+    {
+        sendErrorResponse(msg, "Error in read.");
+    }
+    else
+    {
+        /* Diagnostics of the server are in the order of msg->requests only without cache hits */
+        bool allRead = (staleLen == reqLen);
+        sendReadResponse(msg, attributeId, results, allRead ? readResponse.diagnosticInfos : NULL,
+                allRead ? readResponse.diagnosticInfosSize : 0,
+                readRequest.requestHeader.returnDiagnostics);
+    }
+
+    for (size_t i = 0; !msg->preparedGroup && i < staleLen; i++)
+    {
+        UA_ReadValueId_deleteMembers(&rv[i]);
+    }
+    EdgeFree(rv);
+    EdgeFree(positions);
+    UA_Array_delete(results, reqLen, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    UA_ReadResponse_deleteMembers(&readResponse);
 }
-#endif // CTT_ENABLED
 
 /**
  * @brief readGroup - Executes read operation of single/group nodes
@@ -165,10 +981,27 @@ static void *checkValidation(UA_DataValue *value, const EdgeMessage *msg, UA_Tim
  */
 static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attributeId)
 {
+    if (!hasValidNodeIds(msg))
+    {
+        sendErrorResponseWithCode(msg, "Invalid node id.", STATUS_PARAM_INVALID);
+        return;
+    }
+
+    if (acceptsCachedValues(msg))
+    {
+        EdgeValueCache *cache = getValueCache(client, true);
+        if (cache)
+        {
+            readGroupCached(client, msg, attributeId, cache);
+            return;
+        }
+    }
+
     char errorDesc[ERROR_DESC_LENGTH] = {'\0'};
-    EdgeMessage *resultMsg = NULL;
     size_t reqLen = msg->requestLength;
-    UA_ReadValueId *rv = (UA_ReadValueId *) EdgeMalloc(sizeof(UA_ReadValueId) * reqLen);
+    /* A prepared group has its read value ids built already */
+    UA_ReadValueId *rv = msg->preparedGroup ? msg->preparedGroup->readValueIds :
+            (UA_ReadValueId *) EdgeMalloc(sizeof(UA_ReadValueId) * reqLen);
     if(IS_NULL(rv))
     {
         EDGE_LOG(TAG, "Memory allocation failed.");
@@ -176,14 +1009,9 @@ static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attri
         return;
     }
 
-    for (size_t i = 0; i < reqLen; i++)
+    if (IS_NULL(msg->preparedGroup))
     {
-        EDGE_LOG_V(TAG, "[READGROUP] Node to read :: %s [ns : %d]\n", msg->requests[i]->nodeInfo->valueAlias,
-                msg->requests[i]->nodeInfo->nodeId->nameSpace);
-        UA_ReadValueId_init(&rv[i]);
-        rv[i].attributeId = attributeId;
-        rv[i].nodeId = UA_NODEID_STRING_ALLOC(msg->requests[i]->nodeInfo->nodeId->nameSpace,
-                msg->requests[i]->nodeInfo->valueAlias);
+        fillReadValueIds(msg, attributeId, rv);
     }
 
     UA_ReadRequest readRequest;
@@ -206,9 +1034,10 @@ static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attri
     //UA_RequestHeader_init(&(readRequest.requestHeader));
     //readRequest.requestHeader.returnDiagnostics = 1;
 
-    UA_ReadResponse readResponse = UA_Client_Service_read(client, readRequest);
+    UA_ReadResponse readResponse = readInChunks(client, &readRequest);
 
-    if (readResponse.responseHeader.serviceResult != UA_STATUSCODE_GOOD)
+    if (readResponse.responseHeader.serviceResult != UA_STATUSCODE_GOOD
+            || readResponse.resultsSize != reqLen)
     {
         /* Error response in processing read request */
         EDGE_LOG_V(TAG, "Error in group read :: 0x%08x(%s)\n", readResponse.responseHeader.serviceResult,
@@ -287,122 +1116,210 @@ static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attri
     }
 #endif // CTT_ENABLED
 
-    resultMsg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
-    if(IS_NULL(resultMsg))
+    readMessageRangePages(client, msg, rv, readResponse.results);
+    cacheReadResults(getValueCache(client, false), msg, attributeId, readResponse.results);
+    sendReadResponse(msg, attributeId, readResponse.results, readResponse.diagnosticInfos,
+            readResponse.diagnosticInfosSize, readRequest.requestHeader.returnDiagnostics);
+
+    if (IS_NULL(msg->preparedGroup))
     {
-        EDGE_LOG(TAG, "Error : Malloc failed for resultMsg in Read Group\n");
-        strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-        goto EXIT;
+        deleteReadValueIds(msg, rv);
+        EdgeFree(rv);
     }
+    UA_ReadResponse_deleteMembers(&readResponse);
+    return;
 
-    resultMsg->responses = (EdgeResponse **) EdgeCalloc(reqLen, sizeof(EdgeResponse *));
-    if(IS_NULL(resultMsg->responses))
+    EXIT:
+    /* Free the memory */
+    sendErrorResponse(msg, errorDesc);
+    if (IS_NULL(msg->preparedGroup))
     {
-        EDGE_LOG(TAG, "Error : Malloc failed for responses in Read Group\n");
-        strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-        goto EXIT;
+        deleteReadValueIds(msg, rv);
+        EdgeFree(rv);
     }
+    UA_ReadResponse_deleteMembers(&readResponse);
+}
 
-    resultMsg->responseLength = 0;
-    if (UA_ATTRIBUTEID_VALUE == attributeId) {
-        resultMsg->command = CMD_READ;
-    } else if (UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL == attributeId) {
-        resultMsg->command = CMD_READ_SAMPLING_INTERVAL;
-    }
-    resultMsg->type = GENERAL_RESPONSE;
-    resultMsg->message_id = msg->message_id;
-    resultMsg->endpointInfo = cloneEdgeEndpointInfo(msg->endpointInfo);
-    if(IS_NULL(resultMsg->endpointInfo))
+/**
+ * @brief readBatch - Executes one read operation for the nodes of several request messages
+ * and sends a response for each of them
+ * @param client - Client handle
+ * @param msgs - Request edge messages
+ * @param count - Number of request messages
+ * @param attributeId - Attribute Id to read
+ */
+static void readBatch(UA_Client *client, EdgeMessage **msgs, size_t count, UA_UInt32 attributeId)
+{
+    /* Messages which accept cached values are read on their own, to be served from the cache.
+     * So are messages with an invalid node, to be rejected on their own */
+    size_t totalLen = 0;
+    for (size_t i = 0; i < count; i++)
     {
-        EDGE_LOG(TAG, "Error : EdgeCalloc failed for resultMsg.endpointInfo in Read Group\n");
-        strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-        goto EXIT;
+        if (readsAlone(msgs[i]))
+        {
+            readGroup(client, msgs[i], attributeId);
+            continue;
+        }
+        totalLen += msgs[i]->requestLength;
     }
+    COND_CHECK_NR_MSG((0 == totalLen), "");
 
-    int respIndex = 0;
-    for (int i = 0; i < reqLen; i++)
+    UA_ReadValueId *rv = (UA_ReadValueId *) EdgeMalloc(sizeof(UA_ReadValueId) * totalLen);
+    if(IS_NULL(rv))
     {
-        if (readResponse.results[i].status == UA_STATUSCODE_GOOD)
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        for (size_t i = 0; i < count; i++)
         {
-            UA_Variant val = readResponse.results[i].value;
-
-            EdgeResponse *response = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
-            if (IS_NULL(response))
+            if (!readsAlone(msgs[i]))
             {
-                EDGE_LOG(TAG, "Memory allocation failed\n");
-                strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                goto EXIT;
+                sendErrorResponse(msgs[i], "Memory allocation failed.");
             }
+        }
+        return;
+    }
 
-            response->nodeInfo = cloneEdgeNodeInfo(msg->requests[i]->nodeInfo);
-            if(IS_NULL(response->nodeInfo))
-            {
-                EDGE_LOG(TAG, "Error : Malloc failed for response.Nodeinfo in Read Group\n");
-                strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
-                goto EXIT;
-            }
+    size_t offset = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (readsAlone(msgs[i]))
+        {
+            continue;
+        }
+        fillReadValueIds(msgs[i], attributeId, rv + offset);
+        offset += msgs[i]->requestLength;
+    }
 
-            response->requestId = msg->requests[i]->requestId;
-            response->message = parseResponse(response, val);
-            if (IS_NULL(response->message))
-            {
-                freeEdgeResponse(response);
-                goto EXIT;
-            }
+    UA_ReadRequest readRequest;
+    UA_ReadRequest_init(&readRequest);
+    readRequest.nodesToRead = rv;
+    readRequest.nodesToReadSize = totalLen;
+    #ifdef CTT_ENABLED
+        readRequest.maxAge = 2000;
+    #else
+        readRequest.maxAge = 0;
+    #endif
+    readRequest.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
 
-            /* Check for diagnostic information in read response */
-            response->m_diagnosticInfo = checkDiagnosticInfo(msg->requestLength,
-                    readResponse.diagnosticInfos, readResponse.diagnosticInfosSize,
-                    readRequest.requestHeader.returnDiagnostics);
+    EDGE_LOG_V(TAG, "[READBATCH] %zu messages, %zu nodes\n", count, totalLen);
+    UA_ReadResponse readResponse = readInChunks(client, &readRequest);
 
-            resultMsg->responseLength++;
-            resultMsg->responses[respIndex++] = response;
-        }
-        else
+    if (readResponse.responseHeader.serviceResult != UA_STATUSCODE_GOOD
+            || readResponse.resultsSize != totalLen)
+    {
+        EDGE_LOG_V(TAG, "Error in batch read :: 0x%08x(%s)\n", readResponse.responseHeader.serviceResult,
+                UA_StatusCode_name(readResponse.responseHeader.serviceResult));
+        for (size_t i = 0; i < count; i++)
         {
-            /* Error in read response for a particular node */
-            EDGE_LOG_V(TAG, "Error in group read response for particular node :: 0x%08x(%s)\n",
-                    readResponse.results[i].status, UA_StatusCode_name(readResponse.results[i].status));
-            if(1 == reqLen)
+            if (!readsAlone(msgs[i]))
             {
-                // Error response for the node(only one) in the given read request.
-                snprintf(errorDesc, ERROR_DESC_LENGTH, "Bad service result for the given node");
-                goto EXIT;
+                sendErrorResponse(msgs[i], "Error in read.");
             }
-            snprintf(errorDesc, ERROR_DESC_LENGTH, "Bad service result for the node at position(%d)", i);
-            sendErrorResponse(msg, errorDesc);
         }
     }
-
-    if (reqLen > 1 && resultMsg->responseLength < 1)
+    else
     {
-        EDGE_LOG(TAG, "There are no valid responses.");
-        strncpy(errorDesc, "There are no valid responses.", ERROR_DESC_LENGTH);
-        goto EXIT;
+        /* Split the results back to the request messages */
+        EdgeValueCache *cache = getValueCache(client, false);
+        offset = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (readsAlone(msgs[i]))
+            {
+                continue;
+            }
+            UA_DiagnosticInfo *diagnosticInfos = readResponse.diagnosticInfos;
+            size_t diagnosticInfosSize = readResponse.diagnosticInfosSize;
+            if (diagnosticInfosSize == totalLen)
+            {
+                diagnosticInfos += offset;
+                diagnosticInfosSize = msgs[i]->requestLength;
+            }
+            readMessageRangePages(client, msgs[i], rv + offset, readResponse.results + offset);
+            cacheReadResults(cache, msgs[i], attributeId, readResponse.results + offset);
+            sendReadResponse(msgs[i], attributeId, readResponse.results + offset, diagnosticInfos,
+                    diagnosticInfosSize, readRequest.requestHeader.returnDiagnostics);
+            offset += msgs[i]->requestLength;
+        }
     }
-    /* Adding the read response to receiver Q */
-    add_to_recvQ(resultMsg);
-    for (size_t i = 0; i < reqLen; i++)
+
+    offset = 0;
+    for (size_t i = 0; i < count; i++)
     {
-        UA_NodeId_deleteMembers(&rv[i].nodeId);
+        if (readsAlone(msgs[i]))
+        {
+            continue;
+        }
+        deleteReadValueIds(msgs[i], rv + offset);
+        offset += msgs[i]->requestLength;
     }
-    UA_ReadValueId_deleteMembers(rv);
     EdgeFree(rv);
     UA_ReadResponse_deleteMembers(&readResponse);
-    return;
+}
 
-    EXIT:
-    /* Free the memory */
-    sendErrorResponse(msg, errorDesc);
-    freeEdgeMessage(resultMsg);
-    for (size_t i = 0; i < reqLen; i++)
+/**
+ * @brief readMessages - Executes one read operation for several request messages. The cycle of
+ * polls which share it is answered with a response for each poll
+ * @param client - Client handle
+ * @param msgs - Request edge messages
+ * @param count - Number of request messages
+ * @param attributeId - Attribute Id to read
+ */
+static void readMessages(UA_Client *client, EdgeMessage **msgs, size_t count,
+        UA_UInt32 attributeId)
+{
+    size_t totalCount = 0;
+    for (size_t i = 0; i < count; i++)
     {
-        UA_NodeId_deleteMembers(&rv[i].nodeId);
+        const EdgePreparedGroup *group = msgs[i]->preparedGroup;
+        totalCount += (group && group->partCount > 0) ? group->partCount : 1;
     }
-    UA_ReadValueId_deleteMembers(rv);
-    EdgeFree(rv);
-    UA_ReadResponse_deleteMembers(&readResponse);
+    if (1 == totalCount)
+    {
+        readGroup(client, msgs[0], attributeId);
+        return;
+    }
+    if (totalCount == count)
+    {
+        readBatch(client, msgs, count, attributeId);
+        return;
+    }
+
+    EdgeMessage **expanded = (EdgeMessage **) EdgeCalloc(totalCount, sizeof(EdgeMessage *));
+    EdgeMessage **partArrays = (EdgeMessage **) EdgeCalloc(count, sizeof(EdgeMessage *));
+    if (IS_NULL(expanded) || IS_NULL(partArrays))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        for (size_t i = 0; i < count; i++)
+        {
+            sendErrorResponse(msgs[i], "Memory allocation failed.");
+        }
+        EdgeFree(expanded);
+        EdgeFree(partArrays);
+        return;
+    }
+
+    size_t offset = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t partCount = 0;
+        partArrays[i] = createEdgePreparedPartMessages(msgs[i], &partCount);
+        for (size_t j = 0; j < partCount; j++)
+        {
+            expanded[offset++] = &partArrays[i][j];
+        }
+        if (0 == partCount)
+        {
+            expanded[offset++] = msgs[i];
+        }
+    }
+    readBatch(client, expanded, offset, attributeId);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        EdgeFree(partArrays[i]);
+    }
+    EdgeFree(partArrays);
+    EdgeFree(expanded);
 }
 
 EdgeResult executeRead(UA_Client *client, const EdgeMessage *msg)
@@ -411,15 +1328,37 @@ EdgeResult executeRead(UA_Client *client, const EdgeMessage *msg)
     result.code = STATUS_ERROR;
     VERIFY_NON_NULL_MSG(client, "Client param is NULL in execute READ\n", result);
 
+    EdgeMessage *msgs[1] = { (EdgeMessage *) msg };
     if (CMD_READ == msg->command)
     {
         /* Read value attribute */
-        readGroup(client, msg, UA_ATTRIBUTEID_VALUE);
+        readMessages(client, msgs, 1, UA_ATTRIBUTEID_VALUE);
     }
     else if (CMD_READ_SAMPLING_INTERVAL == msg->command)
     {
         /* Read sampling interval attribute */
-        readGroup(client,msg, UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL);
+        readMessages(client, msgs, 1, UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL);
+    }
+
+    result.code = STATUS_OK;
+    return result;
+}
+
+EdgeResult executeReadBatch(UA_Client *client, EdgeMessage **msgs, size_t count)
+{
+    EdgeResult result;
+    result.code = STATUS_ERROR;
+    VERIFY_NON_NULL_MSG(client, "Client param is NULL in execute READ batch\n", result);
+    VERIFY_NON_NULL_MSG(msgs, "Message param is NULL in execute READ batch\n", result);
+    COND_CHECK_MSG((0 == count), "No message in execute READ batch\n", result);
+
+    if (CMD_READ == msgs[0]->command)
+    {
+        readMessages(client, msgs, count, UA_ATTRIBUTEID_VALUE);
+    }
+    else if (CMD_READ_SAMPLING_INTERVAL == msgs[0]->command)
+    {
+        readMessages(client, msgs, count, UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL);
     }
 
     result.code = STATUS_OK;
@@ -48,6 +48,38 @@ extern "C"
  */
 EdgeResult executeRead(UA_Client *client, const EdgeMessage *msg);
 
+/**
+ * @brief Executes one Read operation for the nodes of several request messages
+ * @remarks All the messages must have the same command. A response is sent for each message
+ * with its own message id.
+ * @param[in]  client Client Handle.
+ * @param[in]  msgs EdgeMessage request data
+ * @param[in]  count Number of messages
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult executeReadBatch(UA_Client *client, EdgeMessage **msgs, size_t count);
+
+/**
+ * @brief Sets whether the results of group reads are delivered in one EdgeFlatResults
+ * @remarks Groups with a value of a type other than the numbers, DateTime, StatusCode,
+ * strings, byte strings, XML elements and GUIDs are answered with EdgeResponses.
+ * @param[in]  flat true to deliver the results in one block
+ */
+void setReadResultLayout(bool flat);
+
+/**
+ * @brief Sends a read request to the server of the client
+ */
+typedef UA_ReadResponse (*edge_read_service_t)(UA_Client *client, const UA_ReadRequest request);
+
+/**
+ * @brief Sets the function which sends the read requests, to test the reads without a server
+ * @param[in]  service Function to be called. NULL restores UA_Client_Service_read().
+ */
+void setReadService(edge_read_service_t service);
+
 #ifdef __cplusplus
 }
 #endif
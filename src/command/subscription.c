@@ -26,8 +26,15 @@
 #include "edge_map.h"
 #include "edge_logger.h"
 #include "edge_malloc.h"
+#include "edge_arena.h"
 #include "message_dispatcher.h"
 #include "edge_opcua_client.h"
+#include "edge_server_capabilities.h"
+#include "edge_value_cache.h"
+#include "edge_report_batch.h"
+#include "ocatomic.h"
+
+#include <stdlib.h>
 
 #ifndef _WIN32
 #include <pthread.h>
@@ -47,6 +54,9 @@
 #define EDGE_UA_MINIMUM_PUBLISHING_TIME (1000)
 #endif
 
+/* Number of monitored items created in one request when subscriptions are restored */
+#define EDGE_UA_RESTORE_BATCH_SIZE (1000)
+
 #define DEFAULT_RETRANSMIT_SEQUENCENUM (2)
 #define GUID_LENGTH (36)
 
@@ -59,6 +69,8 @@ typedef struct subscriptionInfo
     UA_UInt32 subId;
     /* MonitoredItem Id */
     UA_UInt32 monId;
+    /* Index of the monitored item in the requests of msg */
+    int requestIndex;
     /* Context */
     void *hfContext;
 } subscriptionInfo;
@@ -75,6 +87,11 @@ typedef struct clientSubscription
     bool subscription_thread_running;
     /* Subscription list */
     edgeMap *subscriptionList;
+    /* Notifications of the current publish cycle, when they are delivered in batches.
+     * One batch for each subscription request, in the order of their first notification. */
+    EdgeReportBatch *reportBatches;
+    /* Set while a publish task is queued on the executor of the session */
+    volatile uint32_t publishPending;
 } clientSubscription;
 
 typedef struct client_valueAlias
@@ -87,6 +104,9 @@ typedef struct client_valueAlias
 
 static edgeMap *clientSubMap  = NULL;
 
+static bool g_reportBatchEnabled = false;
+static uint32_t g_reportBatchMaxSize = EDGE_UA_REPORT_BATCH_DEFAULT_SIZE;
+
 /**
  * @brief validateMonitoringId - Function that checks whether monitoredItem id
  * is present under the given subscription Id
@@ -136,14 +156,7 @@ static bool hasSubscriptionId(edgeMap *list, UA_UInt32 subId)
 static void* get_subscription_list(UA_Client *client)
 {
     VERIFY_NON_NULL_MSG(clientSubMap, "", NULL);
-    edgeMapNode *temp = clientSubMap->head;
-    while (NULL != temp)
-    {
-        // Check whether its valid client handle and return the subscription details for the client
-        COND_CHECK((temp->key == client), temp->value);
-        temp = temp->next;
-    }
-    return NULL;
+    return getMapElement(clientSubMap, (keyValue) client);
 }
 
 /**
@@ -155,47 +168,23 @@ static void* get_subscription_list(UA_Client *client)
 static keyValue getSubInfo(edgeMap* list, const char *valueAlias)
 {
     VERIFY_NON_NULL_MSG(list, "", NULL);
-    edgeMapNode *temp = list->head;
-    while (temp != NULL)
-    {
-        if (!strcmp(temp->key, valueAlias))
-        {
-            return temp->value;
-        }
-        temp = temp->next;
-    }
-    return NULL;
+    return getMapElement(list, (keyValue) valueAlias);
 }
 
 /**
  * @brief removeSubFromMap - Remove the subscription information from the subscription list
+ * and free the value alias key
  * @param list - subscription list
  * @param valueAlias - value alias
  * @return the removed subscription info
  */
-static edgeMapNode *removeSubFromMap(edgeMap *list, const char *valueAlias)
+static subscriptionInfo *removeSubFromMap(edgeMap *list, const char *valueAlias)
 {
-    edgeMapNode *temp = list->head;
-    edgeMapNode *prev = NULL;
-    while (temp != NULL)
-    {
-        if (!strcmp(temp->key, valueAlias))
-        {
-            if (prev == NULL)
-            {
-                list->head = temp->next;
-            }
-            else
-            {
-                prev->next = temp->next;
-            }
-
-            return temp;
-        }
-        prev = temp;
-        temp = temp->next;
-    }
-    return NULL;
+    keyValue key = NULL;
+    keyValue value = NULL;
+    COND_CHECK((!removeMapElement(list, (keyValue) valueAlias, &key, &value)), NULL);
+    EdgeFree(key);
+    return (subscriptionInfo *) value;
 }
 
 #ifndef ENABLE_SUB_QUEUE
@@ -205,6 +194,12 @@ void sendPublishRequest(UA_Client *client)
 }
 #endif
 
+void setReportBatchConfig(bool enabled, uint32_t maxReports)
+{
+    g_reportBatchEnabled = enabled;
+    g_reportBatchMaxSize = (0 == maxReports) ? EDGE_UA_REPORT_BATCH_DEFAULT_SIZE : maxReports;
+}
+
 /**
  * @brief monitoredItemHandler - Callback function for getting DATACHANGE notifications for subscribed nodes
  * @param client - Client handle
@@ -236,63 +231,41 @@ static void monitoredItemHandler(UA_Client *client, UA_UInt32 monId, UA_DataValu
     subscriptionInfo *subInfo = (subscriptionInfo *) getSubInfo(clientSub->subscriptionList, client_alias->valueAlias);
     VERIFY_NON_NULL_NR_MSG(subInfo, "subscription info received in NULL in monitoredItemHandler\n");
 
-    EdgeMessage *resultMsg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
-    VERIFY_NON_NULL_NR_MSG(resultMsg, "EdgeCalloc FAILED for edgeMessage in monitoredItemHandler\n");
-
-    resultMsg->endpointInfo = cloneEdgeEndpointInfo(subInfo->msg->endpointInfo);
-    if(IS_NULL(resultMsg->endpointInfo))
+    /* Reads which accept a cached value are answered with the latest notification */
+    EdgeValueCache *cache = getValueCache(client_alias->client, false);
+    if (cache)
     {
-        EDGE_LOG(TAG, "Error : EdgeCalloc failed for resultMsg.endpointInfo in monitor item handler\n");
-        goto SUBSCRIPTION_ERROR;
+        UA_NodeId nodeId;
+        if (convertToUANodeId(subInfo->msg->requests[subInfo->requestIndex]->nodeInfo, &nodeId))
+        {
+            updateCachedValue(cache, &nodeId, UA_ATTRIBUTEID_VALUE, value);
+        }
     }
 
-    time_t rawtime;
-    time(&rawtime);
-    resultMsg->serverTime.timeInfo = localtime(&rawtime);
-
-#ifndef _WIN32
-    gettimeofday(&(resultMsg->serverTime.tv), NULL);
-#else
-    getTimeofDay(&(resultMsg->serverTime.tv), NULL);
-#endif
-
-    resultMsg->message_id = subInfo->msg->message_id;
-    resultMsg->type = REPORT;
-    resultMsg->responseLength = 1;
-    resultMsg->responses = (EdgeResponse **) EdgeCalloc(1, sizeof(EdgeResponse*));
-    if(IS_NULL(resultMsg->responses))
+    if (g_reportBatchEnabled)
     {
-        EDGE_LOG(TAG, "Error : Malloc failed for resultMsg.responses in monitor item handler\n");
-        goto SUBSCRIPTION_ERROR;
+        /* Delivered at the end of the publish cycle */
+        addToReportBatch(&clientSub->reportBatches, subInfo->msg, valueAlias, value,
+                g_reportBatchMaxSize);
+        return;
     }
 
-    resultMsg->responses[0] = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
-    if(IS_NULL(resultMsg->responses[0]))
-    {
-        goto SUBSCRIPTION_ERROR;
-    }
+    /* The notification is built in one arena, which freeEdgeMessage() gives back to the pool. */
+    EdgeArena *arena = EdgeArenaAcquire();
 
-    EdgeResponse *response = resultMsg->responses[0];
-    response->nodeInfo = (EdgeNodeInfo *) EdgeCalloc(1, sizeof(EdgeNodeInfo));
-    if(IS_NULL(response->nodeInfo))
+    EdgeMessage *resultMsg = createReportMessage(subInfo->msg, arena, 1);
+    if (IS_NULL(resultMsg))
     {
-        EDGE_LOG(TAG, "Error : Malloc failed for response->nodeInfo in monitor item handler\n");
-        goto SUBSCRIPTION_ERROR;
-    }
-    response->nodeInfo->valueAlias = (char *) EdgeMalloc(strlen(valueAlias) + 1);
-    if(IS_NULL(response->nodeInfo->valueAlias))
-    {
-        EDGE_LOG(TAG, "Error : Malloc failed for response->nodeInfo->valueAlias in monitor item handler\n");
-        goto SUBSCRIPTION_ERROR;
+        EdgeArenaRelease(arena);
+        return;
     }
-    strncpy(response->nodeInfo->valueAlias, valueAlias, strlen(valueAlias)+1);
 
-    response->message = parseResponse(response, value->value);
-    if(IS_NULL(response->message))
+    resultMsg->responses[0] = createReportResponse(arena, valueAlias, value);
+    if(IS_NULL(resultMsg->responses[0]))
     {
-        EDGE_LOG(TAG, "Error : Malloc failed for versatility in monitor item handler\n");
         goto SUBSCRIPTION_ERROR;
     }
+    resultMsg->responseLength = 1;
 
     /* Adding the subscription response to receiver Q */
     add_to_recvQ(resultMsg);
@@ -304,6 +277,24 @@ static void monitoredItemHandler(UA_Client *client, UA_UInt32 monId, UA_DataValu
     freeEdgeMessage(resultMsg);
 }
 
+#ifndef ENABLE_SUB_QUEUE
+/* Publishes on the executor of the session, so it never runs beside another call on the client. */
+static void publishTask(void *data)
+{
+    UA_Client *client = (UA_Client *) data;
+    clientSubscription *clientSub = (clientSubscription*) get_subscription_list(client);
+    COND_CHECK_NR_MSG((IS_NULL(clientSub)), "NULL client subscription in publishTask\n");
+    // A lost session is not published on until it is reconnected.
+    if (clientSub->subscription_thread_running
+            && UA_CLIENTSTATE_DISCONNECTED != UA_Client_getState(client))
+    {
+        sendPublishRequest(client);
+        flushReportBatches(&clientSub->reportBatches);
+    }
+    OC_ATOMIC_STORE(&clientSub->publishPending, 0);
+}
+#endif
+
 static void *subscription_thread_handler(void *ptr)
 {
     EDGE_LOG(TAG, ">>>>>>>>>>>>>>>>>> subscription thread created <<<<<<<<<<<<<<<<<<<<");
@@ -325,7 +316,12 @@ static void *subscription_thread_handler(void *ptr)
          * (EDGE_UA_MINIMUM_PUBLISHING_TIME * 1000) ms */
 
         #ifndef ENABLE_SUB_QUEUE
-        sendPublishRequest(client);
+        // A publish which is still queued behind a slow call is not queued twice.
+        if (OC_ATOMIC_CAS(&clientSub->publishPending, 0, 1)
+                && !submitSessionTask(client, publishTask, client))
+        {
+            OC_ATOMIC_STORE(&clientSub->publishPending, 0);
+        }
         #else
         EdgeMessage *publishMsg = (EdgeMessage *)EdgeCalloc(1, sizeof(EdgeMessage));
         publishMsg->type = SEND_REQUEST;
@@ -351,22 +347,63 @@ static void *subscription_thread_handler(void *ptr)
     return NULL;
 }
 
-static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
+/**
+ * @brief getSubRequest - Gets the subscription settings of a create request
+ * @param msg - Create request
+ * @return subscription request
+ */
+static EdgeSubRequest *getSubRequest(const EdgeMessage *msg)
 {
-    clientSubscription *clientSub = NULL;
-    clientSub = get_subscription_list(client);
-
-    EdgeSubRequest *subReq;
     if (msg->type == SEND_REQUESTS)
     {
         EdgeRequest **req = msg->requests;
-        subReq = req[0]->subMsg;
-    }
-    else
-    {
-        EdgeRequest *req = msg->request;
-        subReq = req->subMsg;
+        return req[0]->subMsg;
     }
+    EdgeRequest *req = msg->request;
+    return req->subMsg;
+}
+
+/**
+ * @brief getSubscriptionSettings - Gets the settings to create a subscription with
+ * @param subReq - Subscription request
+ * @return subscription settings
+ */
+static UA_SubscriptionSettings getSubscriptionSettings(const EdgeSubRequest *subReq)
+{
+    UA_SubscriptionSettings settings =
+    { subReq->publishingInterval, /* .requestedPublishingInterval */
+    subReq->lifetimeCount, /* .requestedLifetimeCount */
+    subReq->maxKeepAliveCount, /* .requestedMaxKeepAliveCount */
+    subReq->maxNotificationsPerPublish, /* .maxNotificationsPerPublish */
+    subReq->publishingEnabled, /* .publishingEnabled */
+    subReq->priority /* .priority */
+    };
+    return settings;
+}
+
+/**
+ * @brief initMonitoredItemRequest - Initializes the request to monitor a node.
+ * The node is checked by hasValidNodeIds() when it is subscribed
+ * @param item - Request to initialize
+ * @param request - Edge request of the node
+ */
+static void initMonitoredItemRequest(UA_MonitoredItemCreateRequest *item, const EdgeRequest *request)
+{
+    UA_MonitoredItemCreateRequest_init(item);
+    convertToUANodeId(request->nodeInfo, &item->itemToMonitor.nodeId);
+    item->itemToMonitor.attributeId = UA_ATTRIBUTEID_VALUE;
+    item->monitoringMode = UA_MONITORINGMODE_REPORTING;
+    item->requestedParameters.samplingInterval = request->subMsg->samplingInterval;
+    item->requestedParameters.discardOldest = true;
+    item->requestedParameters.queueSize = 1;
+}
+
+static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
+{
+    clientSubscription *clientSub = NULL;
+    clientSub = get_subscription_list(client);
+
+    EdgeSubRequest *subReq = getSubRequest(msg);
 
     for (int i = 0; i < msg->requestLength; i++)
     {
@@ -401,15 +438,9 @@ static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
         }
     }
 
+    UA_StatusCode ret = UA_STATUSCODE_GOOD;
     UA_UInt32 subId = 0;
-    UA_SubscriptionSettings settings =
-    { subReq->publishingInterval, /* .requestedPublishingInterval */
-    subReq->lifetimeCount, /* .requestedLifetimeCount */
-    subReq->maxKeepAliveCount, /* .requestedMaxKeepAliveCount */
-    subReq->maxNotificationsPerPublish, /* .maxNotificationsPerPublish */
-    subReq->publishingEnabled, /* .publishingEnabled */
-    subReq->priority /* .priority */
-    };
+    UA_SubscriptionSettings settings = getSubscriptionSettings(subReq);
 
     /* Create a subscription */
     UA_StatusCode retSub = UA_Client_Subscriptions_new(client, settings, &subId);
@@ -494,15 +525,7 @@ static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
 
         EDGE_LOG_V(TAG, "%s, %s, %d", msg->requests[i]->nodeInfo->valueAlias,
                 msg->requests[i]->nodeInfo->nodeId->nodeUri, msg->requests[i]->nodeInfo->nodeId->nameSpace);
-        UA_MonitoredItemCreateRequest_init(&items[i]);
-        items[i].itemToMonitor.nodeId = UA_NODEID_STRING(msg->requests[i]->nodeInfo->nodeId->nameSpace,
-                msg->requests[i]->nodeInfo->valueAlias);
-        items[i].itemToMonitor.attributeId = UA_ATTRIBUTEID_VALUE;
-        items[i].monitoringMode = UA_MONITORINGMODE_REPORTING;
-        items[i].requestedParameters.samplingInterval =
-                msg->requests[i]->subMsg->samplingInterval;
-        items[i].requestedParameters.discardOldest = true;
-        items[i].requestedParameters.queueSize = 1;
+        initMonitoredItemRequest(&items[i], msg->requests[i]);
     }
 
     UA_StatusCode retMon = UA_Client_Subscriptions_addMonitoredItems(client, subId, items, itemSize,
@@ -552,12 +575,29 @@ static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
             }
             clientSub->subscriptionCount = 0;
             clientSub->subscriptionList = NULL;
+            clientSub->reportBatches = NULL;
+            clientSub->publishPending = 0;
             clientSub->serializeMutex = (pthread_mutex_t) PTHREAD_MUTEX_INITIALIZER;
+
+            // Registered before it holds anything, so a failure leaves nothing behind.
+            if (NULL == clientSubMap)
+            {
+                clientSubMap = createMap();
+            }
+            if (IS_NULL(clientSubMap)
+                || !insertMapElement(clientSubMap, (keyValue) client, (keyValue) clientSub))
+            {
+                EDGE_LOG(TAG, "Error : insertMapElement failed for clientSub in create subscription\n");
+                EdgeFree(clientSub);
+                UA_Client_Subscriptions_remove(client, subId);
+                ret = UA_STATUSCODE_BADOUTOFMEMORY;
+                goto EXIT;
+            }
         }
 
         if (IS_NULL(clientSub->subscriptionList))
         {
-            clientSub->subscriptionList = createMap();
+            clientSub->subscriptionList = createStringMap();
         }
         if (clientSub->subscriptionList)
         {
@@ -578,6 +618,7 @@ static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
             subInfo->msg = msgCopy;
             subInfo->subId = subId;
             subInfo->monId = monId[i];
+            subInfo->requestIndex = i;
             subInfo->hfContext = client_alias[i];
             EDGE_LOG_V(TAG, "Inserting MAP ELEMENT valueAlias :: %s \n",
                    msgCopy->requests[i]->nodeInfo->valueAlias);
@@ -591,17 +632,17 @@ static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
 
             strncpy(valueAlias, msgCopy->requests[i]->nodeInfo->valueAlias,
                 strlen(msgCopy->requests[i]->nodeInfo->valueAlias)+1);
-            insertMapElement(clientSub->subscriptionList, (keyValue) valueAlias,
-                             (keyValue) subInfo);
+            if (!insertMapElement(clientSub->subscriptionList, (keyValue) valueAlias,
+                             (keyValue) subInfo))
+            {
+                EdgeFree(valueAlias);
+                EdgeFree(subInfo);
+                EDGE_LOG(TAG, "Error : insertMapElement failed for subInfo in create subscription");
+                goto EXIT;
+            }
         }
     }
 
-    if (NULL == clientSubMap)
-    {
-        clientSubMap = createMap();
-    }
-    insertMapElement(clientSubMap, (keyValue) client, (keyValue) clientSub);
-
     if (0 == clientSub->subscriptionCount)
     {
         /* initiate thread for manually sending publish request. */
@@ -623,7 +664,7 @@ static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
     EdgeFree(itemResults);
     EdgeFree(items);
 
-    return UA_STATUSCODE_GOOD;
+    return ret;
 }
 
 static UA_StatusCode deleteSub(UA_Client *client, const EdgeMessage *msg)
@@ -636,6 +677,9 @@ static UA_StatusCode deleteSub(UA_Client *client, const EdgeMessage *msg)
     subInfo = (subscriptionInfo *) getSubInfo(clientSub->subscriptionList, msg->request->nodeInfo->valueAlias);
     VERIFY_NON_NULL_MSG(subInfo, "NULL subInfo in deleteSub\n", UA_STATUSCODE_BADNOSUBSCRIPTION);
 
+    /* subInfo is freed once the monitored item is removed. */
+    UA_UInt32 subId = subInfo->subId;
+
     EDGE_LOG(TAG, "Deleting following Subscription \n");
     EDGE_LOG_V(TAG, "Node name :: %s\n", (char *)msg->request->nodeInfo->valueAlias);
     EDGE_LOG_V(TAG, "SUB ID :: %d\n", subInfo->subId);
@@ -652,31 +696,25 @@ static UA_StatusCode deleteSub(UA_Client *client, const EdgeMessage *msg)
     else
     {
         EDGE_LOG(TAG, "Monitoring deleted successfully\n\n");
-        edgeMapNode *removed = removeSubFromMap(clientSub->subscriptionList,
+        subscriptionInfo *info = removeSubFromMap(clientSub->subscriptionList,
             msg->request->nodeInfo->valueAlias);
-        if (removed != NULL)
+        if (IS_NOT_NULL(info))
         {
-            subscriptionInfo *info = (subscriptionInfo *) removed->value;
-            if (IS_NOT_NULL(info))
-            {
-                client_valueAlias *alias = (client_valueAlias*) info->hfContext;
-                EdgeFree(alias->valueAlias);
-                EdgeFree(alias);
-                EdgeFree(info->msg);
-                EdgeFree(info);
-            }
-            EdgeFree(removed->key);
-            EdgeFree(removed);
+            client_valueAlias *alias = (client_valueAlias*) info->hfContext;
+            EdgeFree(alias->valueAlias);
+            EdgeFree(alias);
+            EdgeFree(info->msg);
+            EdgeFree(info);
         }
     }
 
-    if (!hasSubscriptionId(clientSub->subscriptionList, subInfo->subId))
+    if (!hasSubscriptionId(clientSub->subscriptionList, subId))
     {
-        EDGE_LOG_V(TAG, "Removing the subscription  SID %d \n", subInfo->subId);
-        UA_StatusCode retVal = UA_Client_Subscriptions_remove(client, subInfo->subId);
+        EDGE_LOG_V(TAG, "Removing the subscription  SID %d \n", subId);
+        UA_StatusCode retVal = UA_Client_Subscriptions_remove(client, subId);
         if (UA_STATUSCODE_GOOD != retVal)
         {
-            EDGE_LOG_V(TAG, "Error in removing subscription  SID %d \n", subInfo->subId);
+            EDGE_LOG_V(TAG, "Error in removing subscription  SID %d \n", subId);
             return retVal;
         }
         clientSub->subscriptionCount--;
@@ -687,6 +725,7 @@ static UA_StatusCode deleteSub(UA_Client *client, const EdgeMessage *msg)
             EDGE_LOG(TAG, "subscription thread destroy\n");
             clientSub->subscription_thread_running = false;
             pthread_join(clientSub->subscription_thread, NULL);
+            flushReportBatches(&clientSub->reportBatches);
         }
     }
 
@@ -937,6 +976,151 @@ static UA_StatusCode rePublish(UA_Client *client, const EdgeMessage *msg)
     return UA_STATUSCODE_GOOD;
 }
 
+/* A monitored item with the id its subscription had on the lost session */
+typedef struct lostMonitoredItem
+{
+    UA_UInt32 lostSubId;
+    subscriptionInfo *subInfo;
+} lostMonitoredItem;
+
+static int compareLostSubId(const void *first, const void *second)
+{
+    UA_UInt32 firstId = ((const lostMonitoredItem *) first)->lostSubId;
+    UA_UInt32 secondId = ((const lostMonitoredItem *) second)->lostSubId;
+    return (firstId > secondId) - (firstId < secondId);
+}
+
+/**
+ * @brief restoreMonitoredItems - Creates the monitored items of one subscription again,
+ * EDGE_UA_RESTORE_BATCH_SIZE items per request, or fewer if the server allows less
+ * @param client - Client handle
+ * @param subId - Id of the new subscription
+ * @param lostItems - Monitored items of the subscription
+ * @param count - Number of monitored items
+ * @return GOOD status on success. Otherwise the first error status
+ */
+static UA_StatusCode restoreMonitoredItems(UA_Client *client, UA_UInt32 subId,
+        lostMonitoredItem *lostItems, size_t count)
+{
+    UA_StatusCode ret = UA_STATUSCODE_GOOD;
+    EdgeServerCapabilities capabilities;
+    getServerCapabilities(client, &capabilities);
+    size_t batchSize = getOperationChunkSize(capabilities.maxMonitoredItemsPerCall,
+            (count < EDGE_UA_RESTORE_BATCH_SIZE) ? count : EDGE_UA_RESTORE_BATCH_SIZE);
+    UA_MonitoredItemCreateRequest *items = (UA_MonitoredItemCreateRequest *) EdgeMalloc(
+            sizeof(UA_MonitoredItemCreateRequest) * batchSize);
+    UA_MonitoredItemHandlingFunction *hfs = (UA_MonitoredItemHandlingFunction *) EdgeMalloc(
+            sizeof(UA_MonitoredItemHandlingFunction) * batchSize);
+    void **contexts = (void **) EdgeMalloc(sizeof(void *) * batchSize);
+    UA_StatusCode *itemResults = (UA_StatusCode *) EdgeMalloc(sizeof(UA_StatusCode) * batchSize);
+    UA_UInt32 *monId = (UA_UInt32 *) EdgeMalloc(sizeof(UA_UInt32) * batchSize);
+    if (IS_NULL(items) || IS_NULL(hfs) || IS_NULL(contexts) || IS_NULL(itemResults) || IS_NULL(monId))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for monitored items in restoreMonitoredItems\n");
+        ret = UA_STATUSCODE_BADOUTOFMEMORY;
+        goto EXIT;
+    }
+
+    for (size_t offset = 0; offset < count; offset += batchSize)
+    {
+        size_t itemSize = (count - offset < batchSize) ? count - offset : batchSize;
+        for (size_t i = 0; i < itemSize; i++)
+        {
+            subscriptionInfo *subInfo = lostItems[offset + i].subInfo;
+            initMonitoredItemRequest(&items[i], subInfo->msg->requests[subInfo->requestIndex]);
+            hfs[i] = &monitoredItemHandler;
+            contexts[i] = subInfo->hfContext;
+            itemResults[i] = UA_STATUSCODE_BADINTERNALERROR;
+            monId[i] = 0;
+        }
+
+        UA_StatusCode retMon = UA_Client_Subscriptions_addMonitoredItems(client, subId, items,
+                itemSize, hfs, contexts, itemResults, monId);
+        for (size_t i = 0; i < itemSize; i++)
+        {
+            subscriptionInfo *subInfo = lostItems[offset + i].subInfo;
+            subInfo->subId = subId;
+            subInfo->monId = monId[i];
+            if (UA_STATUSCODE_GOOD != itemResults[i] || !monId[i])
+            {
+                EDGE_LOG_V(TAG, "Error in restoring monitored item %s :: %s\n",
+                        ((client_valueAlias *) subInfo->hfContext)->valueAlias,
+                        UA_StatusCode_name(itemResults[i]));
+                if (UA_STATUSCODE_GOOD == ret)
+                {
+                    ret = (UA_STATUSCODE_GOOD != retMon) ? retMon : itemResults[i];
+                }
+            }
+        }
+    }
+
+    EXIT:
+    /* Free memory */
+    EdgeFree(monId);
+    EdgeFree(itemResults);
+    EdgeFree(contexts);
+    EdgeFree(hfs);
+    EdgeFree(items);
+    return ret;
+}
+
+UA_StatusCode restoreSubscriptions(UA_Client *client)
+{
+    clientSubscription *clientSub = (clientSubscription*) get_subscription_list(client);
+    COND_CHECK((IS_NULL(clientSub) || IS_NULL(clientSub->subscriptionList)), UA_STATUSCODE_GOOD);
+    size_t count = getMapSize(clientSub->subscriptionList);
+    COND_CHECK((0 == count), UA_STATUSCODE_GOOD);
+
+    /* The lost ids are all taken first, because a new id may be the lost id of another subscription. */
+    lostMonitoredItem *lostItems = (lostMonitoredItem *) EdgeMalloc(sizeof(lostMonitoredItem) * count);
+    VERIFY_NON_NULL_MSG(lostItems, "EdgeMalloc FAILED for lostItems in restoreSubscriptions\n",
+            UA_STATUSCODE_BADOUTOFMEMORY);
+    size_t index = 0;
+    for (edgeMapNode *temp = clientSub->subscriptionList->head; temp != NULL && index < count;
+            temp = temp->next)
+    {
+        lostItems[index].subInfo = (subscriptionInfo *) temp->value;
+        lostItems[index].lostSubId = lostItems[index].subInfo->subId;
+        index++;
+    }
+    count = index;
+    qsort(lostItems, count, sizeof(lostMonitoredItem), compareLostSubId);
+
+    UA_StatusCode ret = UA_STATUSCODE_GOOD;
+    size_t first = 0;
+    while (first < count)
+    {
+        size_t last = first + 1;
+        while (last < count && lostItems[last].lostSubId == lostItems[first].lostSubId)
+        {
+            last++;
+        }
+
+        UA_UInt32 subId = 0;
+        UA_SubscriptionSettings settings = getSubscriptionSettings(
+                getSubRequest(lostItems[first].subInfo->msg));
+        UA_StatusCode retSub = UA_Client_Subscriptions_new(client, settings, &subId);
+        if (!subId)
+        {
+            EDGE_LOG_V(TAG, "Error in restoring subscription SID %u :: %s\n",
+                    lostItems[first].lostSubId, UA_StatusCode_name(retSub));
+            ret = (UA_STATUSCODE_GOOD != ret) ? ret :
+                    ((UA_STATUSCODE_GOOD != retSub) ? retSub : UA_STATUSCODE_BADSUBSCRIPTIONIDINVALID);
+        }
+        else
+        {
+            EDGE_LOG_V(TAG, "Restoring subscription SID %u as SID %u with %zu monitored items\n",
+                    lostItems[first].lostSubId, subId, last - first);
+            UA_StatusCode retMon = restoreMonitoredItems(client, subId, &lostItems[first], last - first);
+            ret = (UA_STATUSCODE_GOOD != ret) ? ret : retMon;
+        }
+        first = last;
+    }
+
+    EdgeFree(lostItems);
+    return ret;
+}
+
 EdgeResult executeSub(UA_Client *client, const EdgeMessage *msg)
 {
     EdgeResult result;
@@ -959,6 +1143,13 @@ EdgeResult executeSub(UA_Client *client, const EdgeMessage *msg)
 
     if (subReq->subType == Edge_Create_Sub)
     {
+        /* A node which does not convert is never sent to the server */
+        if (!hasValidNodeIds(msg))
+        {
+            result.code = STATUS_PARAM_INVALID;
+            return result;
+        }
+
         /* Create Subscription */
         retVal = createSub(client, msg);
     }
@@ -981,6 +1172,11 @@ EdgeResult executeSub(UA_Client *client, const EdgeMessage *msg)
     else if (subReq->subType == Edge_Publish_Sub)
     {
         UA_Client_Subscriptions_manuallySendPublishRequest(client);
+        clientSubscription *clientSub = (clientSubscription *) get_subscription_list(client);
+        if (IS_NOT_NULL(clientSub))
+        {
+            flushReportBatches(&clientSub->reportBatches);
+        }
     }
     #endif
 
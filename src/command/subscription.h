@@ -37,6 +37,9 @@ extern "C"
 {
 #endif
 
+/** Maximum number of notifications in one batched REPORT message, when not configured */
+#define EDGE_UA_REPORT_BATCH_DEFAULT_SIZE (1000)
+
 /**
  * @brief Executes Subscription operation
  * @param[in]  client Client Handle.
@@ -48,6 +51,23 @@ extern "C"
  */
 EdgeResult executeSub(UA_Client *client, const EdgeMessage *msg);
 
+/**
+ * @brief Creates the subscriptions and monitored items of a client again, after its lost
+ * session was reconnected. The monitored items of a subscription are created in batches.
+ * @param[in]  client Client Handle.
+ * @return GOOD status on success. Otherwise the first error status
+ */
+UA_StatusCode restoreSubscriptions(UA_Client *client);
+
+/**
+ * @brief Sets whether the data change notifications of one publish cycle are delivered
+ * together in one REPORT message
+ * @param[in]  enabled true to deliver the notifications in batches
+ * @param[in]  maxReports Maximum number of notifications in one message.
+ * 0 selects #EDGE_UA_REPORT_BATCH_DEFAULT_SIZE.
+ */
+void setReportBatchConfig(bool enabled, uint32_t maxReports);
+
 #ifdef __cplusplus
 }
 #endif
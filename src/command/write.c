@@ -25,41 +25,49 @@
 #include "edge_open62541.h"
 #include "message_dispatcher.h"
 #include "cmd_util.h"
+#include "edge_prepared_group.h"
+#include "edge_server_capabilities.h"
 
 #include <inttypes.h>
+#include <string.h>
 
 #define TAG "write"
 
+static UA_WriteResponse writeService(UA_Client *client, const UA_WriteRequest request)
+{
+    return UA_Client_Service_write(client, request);
+}
+
+static edge_write_service_t g_writeService = writeService;
+
 /**
- * @brief writeGroup - Executes write operation
- * @param client - Client handle
+ * @brief fillWriteValues - Builds the write values of the nodes of the request.
+ * The nodes are checked by hasValidNodeIds() already
  * @param msg - Request Edge Message
+ * @param wv - Write values, one for each node
+ * @param myVariant - Values to write, one for each node
  */
-static void writeGroup(UA_Client *client, const EdgeMessage *msg)
+static void fillWriteValues(const EdgeMessage *msg, UA_WriteValue *wv, UA_Variant *myVariant)
 {
-    size_t reqLen = msg->requestLength;
-    UA_WriteValue *wv = (UA_WriteValue *) EdgeMalloc(sizeof(UA_WriteValue) * reqLen);
-    VERIFY_NON_NULL_NR_MSG(wv, "EdgeMalloc FAILED for UA_WriteValue in wroteGroup\n");
-    UA_Variant *myVariant = (UA_Variant *) EdgeMalloc(sizeof(UA_Variant) * reqLen);
-    if (IS_NULL(myVariant))
-    {
-        EDGE_LOG(TAG, "Error : Malloc failed for myVariant in write group.");
-        EdgeFree(wv);
-        return;
-    }
-
-    for (size_t i = 0; i < reqLen; i++)
+    for (size_t i = 0; i < msg->requestLength; i++)
     {
         EDGE_LOG_V(TAG, "[WRITEGROUP] Node to write :: %s\n", msg->requests[i]->nodeInfo->valueAlias);
         uint32_t Nodeid = (uint32_t)(msg->requests[i]->type);
         uint32_t type = Nodeid - 1;
-        UA_WriteValue_init(&wv[i]);
         UA_Variant_init(&myVariant[i]);
-        /* Attribute Id to write to */
-        wv[i].attributeId = UA_ATTRIBUTEID_VALUE;
-        /* Node id */
-        wv[i].nodeId = UA_NODEID_STRING(msg->requests[i]->nodeInfo->nodeId->nameSpace,
-                msg->requests[i]->nodeInfo->valueAlias);
+        if (msg->preparedGroup)
+        {
+            /* Node id and attribute are built already, and stay owned by the group */
+            wv[i] = msg->preparedGroup->writeValues[i];
+        }
+        else
+        {
+            UA_WriteValue_init(&wv[i]);
+            /* Attribute Id to write to */
+            wv[i].attributeId = UA_ATTRIBUTEID_VALUE;
+            /* Node id */
+            convertToUANodeId(msg->requests[i]->nodeInfo, &wv[i].nodeId);
+        }
         wv[i].value.hasValue = true;
         /* Data type */
         wv[i].value.value.type = &UA_TYPES[type];
@@ -78,52 +86,118 @@ static void writeGroup(UA_Client *client, const EdgeMessage *msg)
         }
         wv[i].value.value = myVariant[i];
     }
+}
 
-    UA_WriteRequest writeRequest;
-    UA_WriteRequest_init(&writeRequest);
-    /* Node information */
-    writeRequest.nodesToWrite = wv;
-    /* Number of nodes to write */
-    writeRequest.nodesToWriteSize = reqLen;
-    //writeRequest.requestHeader.returnDiagnostics = 1;
-
-    /* Execute write operation */
-    UA_WriteResponse writeResponse = UA_Client_Service_write(client, writeRequest);
-    if (writeResponse.responseHeader.serviceResult != UA_STATUSCODE_GOOD)
+/**
+ * @brief writeInChunks - Writes the nodes of the request in chunks of at most MaxNodesPerWrite
+ * of the server, one after another on the session, and collects the status of each node.
+ * Once a chunk fails as a whole, it and the chunks after it are not written, and their nodes
+ * get the status of the failure.
+ * @param client - Client handle
+ * @param writeRequest - Request with all nodes
+ * @param results - Status of each node of the request
+ */
+static void writeInChunks(UA_Client *client, UA_WriteRequest *writeRequest, UA_StatusCode *results)
+{
+    EdgeServerCapabilities capabilities;
+    getServerCapabilities(client, &capabilities);
+    size_t reqLen = writeRequest->nodesToWriteSize;
+    size_t chunkSize = getOperationChunkSize(capabilities.maxNodesPerWrite, reqLen);
+    if (chunkSize < reqLen)
     {
-        /* Error in write request */
-        EDGE_LOG_V(TAG, "Error in write :: 0x%08x(%s)\n", writeResponse.responseHeader.serviceResult,
-                UA_StatusCode_name(writeResponse.responseHeader.serviceResult));
-
-        EdgeFree(wv);
-        for (size_t i = 0; i < reqLen; i++)
-            UA_Variant_deleteMembers(&myVariant[i]);
-        EdgeFree(myVariant);
-
-        UA_WriteResponse_deleteMembers(&writeResponse);
-        return;
+        EDGE_LOG_V(TAG, "[WRITE] %zu nodes in chunks of %zu\n", reqLen, chunkSize);
     }
 
-    EdgeFree(wv);
-    for (size_t i = 0; i < reqLen; i++)
-        UA_Variant_deleteMembers(&myVariant[i]);
-    EdgeFree(myVariant);
+    UA_WriteValue *nodesToWrite = writeRequest->nodesToWrite;
+    size_t offset = 0;
+    for (; offset < reqLen; offset += chunkSize)
+    {
+        size_t chunkLen = getOperationChunkSize((uint32_t) chunkSize, reqLen - offset);
+        writeRequest->nodesToWrite = nodesToWrite + offset;
+        writeRequest->nodesToWriteSize = chunkLen;
+        UA_WriteResponse chunk = g_writeService(client, *writeRequest);
+        UA_StatusCode serviceResult = chunk.responseHeader.serviceResult;
+        if (UA_STATUSCODE_GOOD == serviceResult && chunk.resultsSize != chunkLen)
+        {
+            EDGE_LOG_V(TAG, "Requested(%zu) but received(%zu) write results\n", chunkLen,
+                    chunk.resultsSize);
+            serviceResult = UA_STATUSCODE_BADUNEXPECTEDERROR;
+        }
+        if (UA_STATUSCODE_GOOD != serviceResult)
+        {
+            /* Error in write request */
+            EDGE_LOG_V(TAG, "Error in write :: 0x%08x(%s)\n", serviceResult,
+                    UA_StatusCode_name(serviceResult));
+            for (size_t i = offset; i < reqLen; i++)
+            {
+                results[i] = serviceResult;
+            }
+            UA_WriteResponse_deleteMembers(&chunk);
+            break;
+        }
+        memcpy(results + offset, chunk.results, sizeof(UA_StatusCode) * chunkLen);
+        UA_WriteResponse_deleteMembers(&chunk);
+    }
+    writeRequest->nodesToWrite = nodesToWrite;
+    writeRequest->nodesToWriteSize = reqLen;
+}
 
-    if (reqLen != writeResponse.resultsSize)
+/**
+ * @brief createWriteResponse - Creates the response for one node of the write request
+ * @param request - Request of the node
+ * @param status - Status of the write of the node
+ * @return Response holding the status and its name, NULL if memory allocation failed
+ */
+static EdgeResponse *createWriteResponse(const EdgeRequest *request, UA_StatusCode status)
+{
+    if (UA_STATUSCODE_GOOD != status)
     {
-        EDGE_LOG_V(TAG, "Requested(%d) but received(%d) => %s\n", (int) reqLen, (int)writeResponse.resultsSize,
-                (reqLen < writeResponse.resultsSize) ? "Received more results" : "Received less results");
-        sendErrorResponse(msg, "Error in write operation");
+        /* Error in write response for a particular node */
+        EDGE_LOG_V(TAG, "Error in write response for a particular node :: 0x%08x(%s)\n", status,
+                UA_StatusCode_name(status));
+    }
 
-        UA_WriteResponse_deleteMembers(&writeResponse);
-        return;
+    EdgeResponse *response = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
+    VERIFY_NON_NULL_MSG(response, "EdgeCalloc FAILED for EdgeResponse in Write Group\n", NULL);
+    response->requestId = request->requestId;
+    response->status = status;
+    response->nodeInfo = cloneEdgeNodeInfo(request->nodeInfo);
+    response->result = createEdgeResult((UA_STATUSCODE_GOOD == status) ? STATUS_OK : STATUS_ERROR);
+    /* Diagnostics are not asked for in the write requests */
+    response->m_diagnosticInfo = checkDiagnosticInfo(1, NULL, 0, 0);
+    response->message = (EdgeVersatility *) EdgeCalloc(1, sizeof(EdgeVersatility));
+    if (IS_NOT_NULL(response->message))
+    {
+        response->message->value = (void *) cloneString(UA_StatusCode_name(status));
+        response->message->isArray = false;
+        response->message->arrayLength = 0;
+    }
+    if (IS_NULL(response->nodeInfo) || IS_NULL(response->result)
+        || IS_NULL(response->m_diagnosticInfo) || IS_NULL(response->message)
+        || IS_NULL(response->message->value))
+    {
+        EDGE_LOG(TAG, "Error : Malloc Failed for EdgeResponse in Write Group");
+        freeEdgeResponse(response);
+        return NULL;
     }
+    return response;
+}
 
+/**
+ * @brief sendWriteResponse - Sends the response of the write with one result for each node,
+ * in the order of the request
+ * @param msg - Request Edge Message
+ * @param results - Status of each node of the request
+ */
+static void sendWriteResponse(const EdgeMessage *msg, const UA_StatusCode *results)
+{
+    size_t reqLen = msg->requestLength;
     EdgeMessage *resultMsg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
     if (IS_NULL(resultMsg))
     {
         EDGE_LOG(TAG, "Error : Malloc Failed for resultMsg in Write Group");
-        goto WRITE_ERROR;
+        sendErrorResponse(msg, "Memory allocation failed.");
+        return;
     }
 
     resultMsg->endpointInfo = cloneEdgeEndpointInfo(msg->endpointInfo);
@@ -144,82 +218,78 @@ static void writeGroup(UA_Client *client, const EdgeMessage *msg)
         goto WRITE_ERROR;
     }
 
-    size_t respIndex = 0;
     for (size_t i = 0; i < reqLen; i++)
     {
-        UA_StatusCode code = writeResponse.results[i];
-
-        if (code != UA_STATUSCODE_GOOD)
-        {
-            /* Error in write response for a particular node */
-            EDGE_LOG_V(TAG, "Error in write response for a particular node :: 0x%08x(%s)\n", code,
-                    UA_StatusCode_name(code));
-
-            sendErrorResponse(msg, "Error in write Response");
-
-            if (writeResponse.responseHeader.serviceResult != UA_STATUSCODE_GOOD)
-                continue;
-        }
-        else
+        EdgeResponse *response = createWriteResponse(msg->requests[i], results[i]);
+        if (IS_NULL(response))
         {
-            EdgeResponse *response = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
-            if (IS_NULL(response))
-            {
-                goto WRITE_ERROR;
-            }
-            response->nodeInfo = cloneEdgeNodeInfo(msg->requests[i]->nodeInfo);
-            if (IS_NULL(response->nodeInfo))
-            {
-                EDGE_LOG(TAG, "Error : Malloc Failed for EdgeResponse.NodeInfo in Write Group");
-                freeEdgeResponse(response);
-                goto WRITE_ERROR;
-            }
-            response->requestId = msg->requests[i]->requestId;
-            response->m_diagnosticInfo = checkDiagnosticInfo(msg->requestLength,
-                    writeResponse.diagnosticInfos, writeResponse.diagnosticInfosSize,
-                    writeRequest.requestHeader.returnDiagnostics);
-            if (IS_NULL(response->m_diagnosticInfo))
-            {
-                EDGE_LOG(TAG, "Error : Malloc Failed for EdgeResponse.DagnosticInfo in Write Group");
-                freeEdgeResponse(response);
-                goto WRITE_ERROR;
-            }
-
-            response->message = (EdgeVersatility *) EdgeCalloc(1, sizeof(EdgeVersatility));
-            if (IS_NULL(response->message))
-            {
-                EDGE_LOG(TAG, "Error : Malloc Failed for EdgeVersatility in Write Group");
-                freeEdgeResponse(response);
-                goto WRITE_ERROR;
-            }
-            const char *retCode = UA_StatusCode_name(code);
-            size_t len = strlen(retCode);
-            char *code = (char*) malloc(len+1);
-            strncpy(code, retCode, len+1);
-
-            response->message->value = (void *) code;
-            response->message->isArray = false;
-            response->message->arrayLength = 0;
-
-            resultMsg->responseLength++;
-            resultMsg->responses[respIndex++] = response;
+            goto WRITE_ERROR;
         }
+        resultMsg->responses[resultMsg->responseLength++] = response;
     }
 
-    if (respIndex < 1)
-    {
-        goto WRITE_ERROR;
-    }
     /* Adding the write response to receiver Q */
     add_to_recvQ(resultMsg);
-
-    UA_WriteResponse_deleteMembers(&writeResponse);
     return;
 
     WRITE_ERROR:
     /* Free memory */
     freeEdgeMessage(resultMsg);
-    UA_WriteResponse_deleteMembers(&writeResponse);
+    sendErrorResponse(msg, "Memory allocation failed.");
+}
+
+/**
+ * @brief writeGroup - Executes write operation. Every node gets a response with its status,
+ * whether or not the other nodes are written.
+ * @param client - Client handle
+ * @param msg - Request Edge Message
+ */
+static void writeGroup(UA_Client *client, const EdgeMessage *msg)
+{
+    if (!hasValidNodeIds(msg))
+    {
+        sendErrorResponseWithCode(msg, "Invalid node id.", STATUS_PARAM_INVALID);
+        return;
+    }
+
+    size_t reqLen = msg->requestLength;
+    UA_WriteValue *wv = (UA_WriteValue *) EdgeMalloc(sizeof(UA_WriteValue) * reqLen);
+    UA_Variant *myVariant = (UA_Variant *) EdgeMalloc(sizeof(UA_Variant) * reqLen);
+    UA_StatusCode *results = (UA_StatusCode *) EdgeMalloc(sizeof(UA_StatusCode) * reqLen);
+    if (IS_NULL(wv) || IS_NULL(myVariant) || IS_NULL(results))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed in write group.");
+        sendErrorResponse(msg, "Memory allocation failed.");
+        EdgeFree(wv);
+        EdgeFree(myVariant);
+        EdgeFree(results);
+        return;
+    }
+    fillWriteValues(msg, wv, myVariant);
+
+    UA_WriteRequest writeRequest;
+    UA_WriteRequest_init(&writeRequest);
+    /* Node information */
+    writeRequest.nodesToWrite = wv;
+    /* Number of nodes to write */
+    writeRequest.nodesToWriteSize = reqLen;
+    //writeRequest.requestHeader.returnDiagnostics = 1;
+
+    /* Execute write operation */
+    writeInChunks(client, &writeRequest, results);
+
+    EdgeFree(wv);
+    for (size_t i = 0; i < reqLen; i++)
+        UA_Variant_deleteMembers(&myVariant[i]);
+    EdgeFree(myVariant);
+
+    sendWriteResponse(msg, results);
+    EdgeFree(results);
+}
+
+void setWriteService(edge_write_service_t service)
+{
+    g_writeService = service ? service : writeService;
 }
 
 EdgeResult executeWrite(UA_Client *client, const EdgeMessage *msg)
@@ -48,6 +48,18 @@ extern "C"
  */
 EdgeResult executeWrite(UA_Client *client, const EdgeMessage *msg);
 
+/**
+ * @brief Sends a write request to the server of the client
+ */
+typedef UA_WriteResponse (*edge_write_service_t)(UA_Client *client,
+        const UA_WriteRequest request);
+
+/**
+ * @brief Sets the function which sends the write requests, to test the writes without a server
+ * @param[in]  service Function to be called. NULL restores UA_Client_Service_write().
+ */
+void setWriteService(edge_write_service_t service);
+
 #ifdef __cplusplus
 }
 #endif
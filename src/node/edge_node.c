@@ -383,15 +383,11 @@ static void addReferenceTypeNode(UA_Server *server, uint16_t nsIndex, const Edge
     COND_CHECK_NR_MSG((status != UA_STATUSCODE_GOOD), "+++ UA_Server_addReference failed +++\n");
 }
 
-static keyValue getMethodMapElement(const edgeMap *map, keyValue key)
+static keyValue getMethodMapElement(const edgeMap *map, const UA_String *browseName)
 {
-    edgeMapNode *temp = map->head;
-    while (temp != NULL)
-    {
-        COND_CHECK_MSG((!strcmp(temp->key, key)), "", temp->value);
-        temp = temp->next;
-    }
-    return NULL;
+    VERIFY_NON_NULL_MSG(map, "", NULL);
+    // The string identifier of the node id is not NULL terminated.
+    return getMapElementWithLength(map, (const char *) browseName->data, browseName->length);
 }
 
 static void destroyInputArgs(void **inp, size_t inputSize, const UA_Variant *input)
@@ -426,8 +422,7 @@ static UA_StatusCode methodCallback(UA_Server *server, const UA_NodeId *sessionI
         const UA_NodeId *objectId, void *objectContext, size_t inputSize, const UA_Variant *input,
         size_t outputSize, UA_Variant *output)
 {
-    char *key = (char *) methodId->identifier.string.data;
-    keyValue value = getMethodMapElement(methodNodeMap, (keyValue) key);
+    keyValue value = getMethodMapElement(methodNodeMap, &methodId->identifier.string);
     VERIFY_NON_NULL_MSG(value, "", UA_STATUSCODE_BADMETHODINVALID);
 
     EdgeMethod *method = (EdgeMethod *) value;
@@ -675,13 +670,18 @@ EdgeResult addMethodNode(UA_Server *server, uint16_t nsIndex, const EdgeNodeItem
     {
         EDGE_LOG(TAG, "+++ addMethodNode success +++\n");
         if (NULL == methodNodeMap)
-            methodNodeMap = createMap();
+            methodNodeMap = createStringMap();
 
         char *browseName = (char *) EdgeMalloc(strlen(item->browseName) + 1);
         VERIFY_NON_NULL_MSG(browseName, "EdgeMalloc FAILED for browseName in addMethodNode\n", result);
         strncpy(browseName, item->browseName, strlen(item->browseName));
         browseName[strlen(item->browseName)] = '\0';
-        insertMapElement(methodNodeMap, (void *) browseName, method);
+        if (!insertMapElement(methodNodeMap, (void *) browseName, method))
+        {
+            EDGE_LOG(TAG, "insertMapElement FAILED for browseName in addMethodNode\n");
+            EdgeFree(browseName);
+            return result;
+        }
         methodNodeCount += 1;
     }
     else
@@ -36,6 +36,7 @@ extern "C"
         CA_STATUS_INVALID_PARAM,
         CA_MEMORY_ALLOC_FAILED,
         CA_STATUS_FAILED,
+        CA_STATUS_QUEUE_FULL,
 
     } CAResult_t;
 
@@ -30,9 +30,48 @@
 #include "edge_logger.h"
 
 #include "caqueueingthread.h"
+#include "ocatomic.h"
 
 #define TAG "OIC_CA_QING"
 
+/** Period of re-checking a full queue under CA_QUEUE_OVERFLOW_BLOCK. **/
+#define QUEUE_FULL_WAIT_US (10000)
+
+static void CAQueueingThreadDestroyData(CAQueueingThread_t *thread, u_queue_message_t *message)
+{
+    if (NULL != thread->destroy)
+    {
+        thread->destroy(message->msg, message->size);
+    }
+    else
+    {
+        EdgeFree(message->msg);
+    }
+}
+
+static bool CAQueueingThreadPop(CAQueueingThread_t *thread, u_queue_message_t *message)
+{
+    for (int round = 0; round < 2; round++)
+    {
+        for (uint32_t lane = 0; lane < thread->laneCount; lane++)
+        {
+            if (thread->laneCredits[lane] > 0
+                && u_ringqueue_pop(thread->dataQueues[lane], message))
+            {
+                thread->laneCredits[lane]--;
+                return true;
+            }
+        }
+
+        // Every lane which has data used up its share. Start a new round.
+        for (uint32_t lane = 0; lane < thread->laneCount; lane++)
+        {
+            thread->laneCredits[lane] = thread->laneWeights[lane];
+        }
+    }
+    return false;
+}
+
 static void CAQueueingThreadBaseRoutine(void *threadValue)
 {
     EDGE_LOG( TAG, "message handler main thread start..");
@@ -47,51 +86,72 @@ static void CAQueueingThreadBaseRoutine(void *threadValue)
 
     while (!thread->isStop)
     {
-        // mutex lock
-        oc_mutex_lock(thread->threadMutex);
-
-        // if queue is empty, thread will wait
-        if (!thread->isStop && u_queue_get_size(thread->dataQueue) <= 0)
+        // get data
+        u_queue_message_t message;
+        if (!CAQueueingThreadPop(thread, &message))
         {
-            EDGE_LOG(TAG, "wait..");
+            uint64_t idleWaitUs = 0;
+            if (NULL != thread->idleTask)
+            {
+                idleWaitUs = thread->idleTask(thread->idleContext);
+            }
 
-            // wait
-            oc_cond_wait(thread->threadCond, thread->threadMutex);
+            // mutex lock
+            oc_mutex_lock(thread->threadMutex);
 
-            EDGE_LOG(TAG, "wake up..");
-        }
+            // Producers signal only when this flag is set.
+            // It must be visible before the queue is checked again.
+            OC_ATOMIC_STORE(&thread->waiting, 1);
+
+            // if queue is empty, thread will wait
+            if (!thread->isStop && CAQueueingThreadGetSize(thread) == 0)
+            {
+                EDGE_LOG(TAG, "wait..");
+
+                // wait, but not longer than the idle function asked for
+                if (idleWaitUs > 0)
+                {
+                    oc_cond_wait_for(thread->threadCond, thread->threadMutex, idleWaitUs);
+                }
+                else
+                {
+                    oc_cond_wait(thread->threadCond, thread->threadMutex);
+                }
+
+                EDGE_LOG(TAG, "wake up..");
+            }
+
+            OC_ATOMIC_STORE(&thread->waiting, 0);
 
-        // check stop flag
-        if (thread->isStop)
-        {
             // mutex unlock
             oc_mutex_unlock(thread->threadMutex);
             continue;
         }
 
-        // get data
-        u_queue_message_t *message = u_queue_get_element(thread->dataQueue);
-        // mutex unlock
-        oc_mutex_unlock(thread->threadMutex);
-        if (NULL == message)
+        // wake up the producers waiting for a free slot
+        if (OC_ATOMIC_LOAD(&thread->blockedProducers) > 0)
         {
-            continue;
+            oc_mutex_lock(thread->threadMutex);
+            oc_cond_broadcast(thread->spaceCond);
+            oc_mutex_unlock(thread->threadMutex);
         }
 
         // process data
-        thread->threadTask(message->msg);
-
-        // free
-        if (NULL != thread->destroy)
+        if (NULL != thread->statsTask && 0 != message.timestamp)
         {
-            thread->destroy(message->msg, message->size);
+            uint64_t dequeueTime = oc_get_monotonic_time_us();
+            thread->threadTask(message.msg);
+            uint64_t doneTime = oc_get_monotonic_time_us();
+            thread->statsTask(message.msg, dequeueTime - message.timestamp,
+                              doneTime - dequeueTime, thread->statsContext);
         }
         else
         {
-            EdgeFree(message->msg);
+            thread->threadTask(message.msg);
         }
 
-        EdgeFree(message);
+        // free
+        CAQueueingThreadDestroyData(thread, &message);
     }
 
     oc_mutex_lock(thread->threadMutex);
@@ -103,6 +163,25 @@ static void CAQueueingThreadBaseRoutine(void *threadValue)
 
 CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool_t handle,
                                       CAThreadTask task, CADataDestroyFunction destroy)
+{
+    return CAQueueingThreadInitializeBounded(thread, handle, task, destroy,
+                                             U_RINGQUEUE_DEFAULT_CAPACITY,
+                                             CA_QUEUE_OVERFLOW_BLOCK);
+}
+
+CAResult_t CAQueueingThreadInitializeBounded(CAQueueingThread_t *thread, ca_thread_pool_t handle,
+                                             CAThreadTask task, CADataDestroyFunction destroy,
+                                             uint32_t capacity, CAQueueOverflowPolicy_t policy)
+{
+    const uint32_t weight = 1;
+    return CAQueueingThreadInitializeLanes(thread, handle, task, destroy, capacity, policy,
+                                           1, &weight);
+}
+
+CAResult_t CAQueueingThreadInitializeLanes(CAQueueingThread_t *thread, ca_thread_pool_t handle,
+                                           CAThreadTask task, CADataDestroyFunction destroy,
+                                           uint32_t capacity, CAQueueOverflowPolicy_t policy,
+                                           uint32_t laneCount, const uint32_t *weights)
 {
     if (NULL == thread)
     {
@@ -116,17 +195,49 @@ CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool
         return CA_STATUS_INVALID_PARAM;
     }
 
+    if (0 == laneCount || laneCount > CA_QUEUE_MAX_LANES || NULL == weights)
+    {
+        EDGE_LOG( TAG, "invalid lanes..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
     EDGE_LOG( TAG, "thread initialize..");
 
     // set send thread data
     thread->threadPool = handle;
-    thread->dataQueue = u_queue_create();
+    thread->laneCount = laneCount;
+    bool queuesCreated = true;
+    for (uint32_t lane = 0; lane < CA_QUEUE_MAX_LANES; lane++)
+    {
+        thread->dataQueues[lane] = NULL;
+        thread->laneWeights[lane] = 0;
+        thread->laneCredits[lane] = 0;
+        if (lane < laneCount)
+        {
+            thread->dataQueues[lane] = u_ringqueue_create(capacity);
+            thread->laneWeights[lane] = (weights[lane] > 0) ? weights[lane] : 1;
+            thread->laneCredits[lane] = thread->laneWeights[lane];
+            queuesCreated = queuesCreated && (NULL != thread->dataQueues[lane]);
+        }
+    }
     thread->threadMutex = oc_mutex_new();
     thread->threadCond = oc_cond_new();
+    thread->spaceCond = oc_cond_new();
     thread->isStop = true;
     thread->threadTask = task;
     thread->destroy = destroy;
-    if (NULL == thread->dataQueue || NULL == thread->threadMutex || NULL == thread->threadCond)
+    thread->drop = NULL;
+    thread->overflowPolicy = policy;
+    thread->waiting = 0;
+    thread->blockedProducers = 0;
+    thread->droppedCount = 0;
+    thread->idleTask = NULL;
+    thread->idleContext = NULL;
+    thread->statsTask = NULL;
+    thread->statsContext = NULL;
+    thread->highWaterMark = 0;
+    if (!queuesCreated || NULL == thread->threadMutex || NULL == thread->threadCond
+        || NULL == thread->spaceCond)
     {
         goto ERROR_MEM_FAILURE;
     }
@@ -134,10 +245,13 @@ CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool
     return CA_STATUS_OK;
 
 ERROR_MEM_FAILURE:
-    if (thread->dataQueue)
+    for (uint32_t lane = 0; lane < CA_QUEUE_MAX_LANES; lane++)
     {
-        u_queue_delete(thread->dataQueue);
-        thread->dataQueue = NULL;
+        if (thread->dataQueues[lane])
+        {
+            u_ringqueue_delete(thread->dataQueues[lane]);
+            thread->dataQueues[lane] = NULL;
+        }
     }
     if (thread->threadMutex)
     {
@@ -149,9 +263,71 @@ ERROR_MEM_FAILURE:
         oc_cond_free(thread->threadCond);
         thread->threadCond = NULL;
     }
+    if (thread->spaceCond)
+    {
+        oc_cond_free(thread->spaceCond);
+        thread->spaceCond = NULL;
+    }
     return CA_MEMORY_ALLOC_FAILED;
 }
 
+CAResult_t CAQueueingThreadSetIdleTask(CAQueueingThread_t *thread, CAIdleTask task, void *context)
+{
+    if (NULL == thread)
+    {
+        EDGE_LOG( TAG, "thread instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (false == thread->isStop)
+    {
+        EDGE_LOG( TAG, "queueing thread already running..");
+        return CA_STATUS_FAILED;
+    }
+
+    thread->idleTask = task;
+    thread->idleContext = context;
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAQueueingThreadSetDropFunction(CAQueueingThread_t *thread, CADataDestroyFunction drop)
+{
+    if (NULL == thread)
+    {
+        EDGE_LOG( TAG, "thread instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (false == thread->isStop)
+    {
+        EDGE_LOG( TAG, "queueing thread already running..");
+        return CA_STATUS_FAILED;
+    }
+
+    thread->drop = drop;
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAQueueingThreadSetStatsTask(CAQueueingThread_t *thread, CAStatsTask task, void *context)
+{
+    if (NULL == thread)
+    {
+        EDGE_LOG( TAG, "thread instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (false == thread->isStop)
+    {
+        EDGE_LOG( TAG, "queueing thread already running..");
+        return CA_STATUS_FAILED;
+    }
+
+    thread->statsTask = task;
+    thread->statsContext = context;
+    OC_ATOMIC_STORE(&thread->highWaterMark, 0);
+    return CA_STATUS_OK;
+}
+
 CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread)
 {
     if (NULL == thread)
@@ -194,6 +370,12 @@ CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread)
 }
 
 CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint32_t size)
+{
+    return CAQueueingThreadAddDataToLane(thread, 0, data, size);
+}
+
+CAResult_t CAQueueingThreadAddDataToLane(CAQueueingThread_t *thread, uint32_t lane,
+                                         void *data, uint32_t size)
 {
     if (NULL == thread)
     {
@@ -207,33 +389,112 @@ CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint3
         return CA_STATUS_INVALID_PARAM;
     }
 
-    // create thread data
-    u_queue_message_t *message = (u_queue_message_t *) EdgeMalloc(sizeof(u_queue_message_t));
-
-    if (NULL == message)
+    if (lane >= thread->laneCount)
     {
-        EDGE_LOG( TAG, "memory error!!");
-        return CA_MEMORY_ALLOC_FAILED;
+        EDGE_LOG_V( TAG, "invalid lane %u..", lane);
+        return CA_STATUS_INVALID_PARAM;
     }
 
-    message->msg = data;
-    message->size = size;
+    // add thread data into queue, time stamped only if the timings are wanted
+    u_ringqueue_t *dataQueue = thread->dataQueues[lane];
+    uint64_t timestamp = (NULL != thread->statsTask) ? oc_get_monotonic_time_us() : 0;
+    CAResult_t res = u_ringqueue_push_stamped(dataQueue, data, size, timestamp);
+    while (CA_STATUS_QUEUE_FULL == res)
+    {
+        if (CA_QUEUE_OVERFLOW_REJECT == thread->overflowPolicy)
+        {
+            EDGE_LOG( TAG, "queue is full, data rejected..");
+            return CA_STATUS_QUEUE_FULL;
+        }
+        else if (CA_QUEUE_OVERFLOW_DROP_OLDEST == thread->overflowPolicy)
+        {
+            u_queue_message_t oldest;
+            if (u_ringqueue_pop(dataQueue, &oldest))
+            {
+                EDGE_LOG( TAG, "queue is full, oldest data dropped..");
+                if (NULL != thread->drop)
+                {
+                    thread->drop(oldest.msg, oldest.size);
+                }
+                else
+                {
+                    CAQueueingThreadDestroyData(thread, &oldest);
+                }
+                OC_ATOMIC_FETCH_ADD(&thread->droppedCount, 1);
+            }
+        }
+        else
+        {
+            // mutex lock
+            oc_mutex_lock(thread->threadMutex);
+            if (thread->isStop)
+            {
+                oc_mutex_unlock(thread->threadMutex);
+                EDGE_LOG( TAG, "queue is full and thread is stopped..");
+                return CA_STATUS_QUEUE_FULL;
+            }
 
-    // mutex lock
-    oc_mutex_lock(thread->threadMutex);
+            // wait for a free slot. Timed wait, so a wake up which races with
+            // the registration below only costs one period.
+            OC_ATOMIC_FETCH_ADD(&thread->blockedProducers, 1);
+            if (u_ringqueue_get_size(dataQueue) >=
+                u_ringqueue_get_capacity(dataQueue))
+            {
+                oc_cond_wait_for(thread->spaceCond, thread->threadMutex, QUEUE_FULL_WAIT_US);
+            }
+            OC_ATOMIC_FETCH_SUB(&thread->blockedProducers, 1);
 
-    // add thread data into list
-    u_queue_add_element(thread->dataQueue, message);
+            // mutex unlock
+            oc_mutex_unlock(thread->threadMutex);
+        }
 
-    // notity the thread
-    oc_cond_signal(thread->threadCond);
+        res = u_ringqueue_push_stamped(dataQueue, data, size, timestamp);
+    }
 
-    // mutex unlock
-    oc_mutex_unlock(thread->threadMutex);
+    if (CA_STATUS_OK != res)
+    {
+        EDGE_LOG( TAG, "failed to add data..");
+        return res;
+    }
+
+    if (NULL != thread->statsTask)
+    {
+        uint32_t queued = CAQueueingThreadGetSize(thread);
+        uint32_t highWaterMark = OC_ATOMIC_LOAD(&thread->highWaterMark);
+        while (queued > highWaterMark
+               && !OC_ATOMIC_CAS(&thread->highWaterMark, highWaterMark, queued))
+        {
+            highWaterMark = OC_ATOMIC_LOAD(&thread->highWaterMark);
+        }
+    }
+
+    // notify the thread only if it is waiting for data
+    if (OC_ATOMIC_LOAD(&thread->waiting))
+    {
+        oc_mutex_lock(thread->threadMutex);
+        oc_cond_signal(thread->threadCond);
+        oc_mutex_unlock(thread->threadMutex);
+    }
 
     return CA_STATUS_OK;
 }
 
+uint32_t CAQueueingThreadGetSize(CAQueueingThread_t *thread)
+{
+    if (NULL == thread)
+    {
+        EDGE_LOG( TAG, "thread instance is empty..");
+        return 0;
+    }
+
+    uint32_t size = 0;
+    for (uint32_t lane = 0; lane < thread->laneCount; lane++)
+    {
+        size += u_ringqueue_get_size(thread->dataQueues[lane]);
+    }
+    return size;
+}
+
 CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
 {
     if (NULL == thread)
@@ -247,25 +508,13 @@ CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
     // mutex lock
     oc_mutex_lock(thread->threadMutex);
 
-    // remove all remained list data.
-    while (u_queue_get_size(thread->dataQueue) > 0)
+    // remove all remained queue data.
+    u_queue_message_t message;
+    for (uint32_t lane = 0; lane < thread->laneCount; lane++)
     {
-        // get data
-        u_queue_message_t *message = u_queue_get_element(thread->dataQueue);
-
-        // free
-        if (NULL != message)
+        while (u_ringqueue_pop(thread->dataQueues[lane], &message))
         {
-            if (NULL != thread->destroy)
-            {
-                thread->destroy(message->msg, message->size);
-            }
-            else
-            {
-                EdgeFree(message->msg);
-            }
-
-            EdgeFree(message);
+            CAQueueingThreadDestroyData(thread, &message);
         }
     }
 
@@ -275,13 +524,29 @@ CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
     oc_mutex_free(thread->threadMutex);
     thread->threadMutex = NULL;
     oc_cond_free(thread->threadCond);
+    oc_cond_free(thread->spaceCond);
+    thread->spaceCond = NULL;
 
-    u_queue_delete(thread->dataQueue);
-    thread->dataQueue = NULL;
+    for (uint32_t lane = 0; lane < thread->laneCount; lane++)
+    {
+        u_ringqueue_delete(thread->dataQueues[lane]);
+        thread->dataQueues[lane] = NULL;
+    }
 
     return CA_STATUS_OK;
 }
 
+uint32_t CAQueueingThreadGetHighWaterMark(CAQueueingThread_t *thread)
+{
+    if (NULL == thread)
+    {
+        EDGE_LOG( TAG, "thread instance is empty..");
+        return 0;
+    }
+
+    return OC_ATOMIC_LOAD(&thread->highWaterMark);
+}
+
 CAResult_t CAQueueingThreadStop(CAQueueingThread_t *thread)
 {
     if (NULL == thread)
@@ -300,8 +565,9 @@ CAResult_t CAQueueingThreadStop(CAQueueingThread_t *thread)
         // set stop flag
         thread->isStop = true;
 
-        // notify the thread
+        // notify the thread and the producers blocked on a full queue
         oc_cond_signal(thread->threadCond);
+        oc_cond_broadcast(thread->spaceCond);
 
         oc_cond_wait(thread->threadCond, thread->threadMutex);
 
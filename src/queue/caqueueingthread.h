@@ -31,7 +31,7 @@
 
 #include "cathreadpool.h"
 #include "octhread.h"
-#include "uqueue.h"
+#include "uringqueue.h"
 #include "cacommon.h"
 
 #ifdef __cplusplus
@@ -39,12 +39,39 @@ extern "C"
 {
 #endif
 
+/** Maximum number of priority lanes of a queueing thread. **/
+#define CA_QUEUE_MAX_LANES (4)
+
 /** Thread function to be invoked. **/
 typedef void (*CAThreadTask)(void *threadData);
 
 /** Data destroy function. **/
 typedef void (*CADataDestroyFunction)(void *data, uint32_t size);
 
+/**
+ * Function invoked when the queue becomes empty.
+ * Returns the number of microseconds after which it wants to be invoked again
+ * if no data arrives in the meantime, 0 if it has nothing left to do.
+ **/
+typedef uint64_t (*CAIdleTask)(void *context);
+
+/**
+ * Function invoked after each data is processed, before it is destroyed.
+ * waitUs is the time the data spent in the queue, serviceUs the time the thread task took.
+ **/
+typedef void (*CAStatsTask)(void *data, uint64_t waitUs, uint64_t serviceUs, void *context);
+
+/** Behaviour of CAQueueingThreadAddData when the queue is full. **/
+typedef enum
+{
+    /** Caller waits until the queueing thread frees a slot. **/
+    CA_QUEUE_OVERFLOW_BLOCK = 0,
+    /** Oldest queued data is destroyed to make room for the new data. **/
+    CA_QUEUE_OVERFLOW_DROP_OLDEST,
+    /** New data is not added and CA_STATUS_QUEUE_FULL is returned. **/
+    CA_QUEUE_OVERFLOW_REJECT
+} CAQueueOverflowPolicy_t;
+
 typedef struct
 {
     /** Thread pool of the thread started. **/
@@ -57,10 +84,39 @@ typedef struct
     CAThreadTask threadTask;
     /** Data destroy function. **/
     CADataDestroyFunction destroy;
+    /** Function disposing of data dropped by CA_QUEUE_OVERFLOW_DROP_OLDEST.
+     *  NULL uses destroy. **/
+    CADataDestroyFunction drop;
     /** Variable to inform the thread to stop. **/
     bool isStop;
-    /** Que on which the thread is operating. **/
-    u_queue_t *dataQueue;
+    /** Ques on which the thread is operating, one per lane. Lane 0 has the highest priority. **/
+    u_ringqueue_t *dataQueues[CA_QUEUE_MAX_LANES];
+    /** Number of lanes in use. **/
+    uint32_t laneCount;
+    /** Number of data taken in a row from a lane while lower lanes have data. **/
+    uint32_t laneWeights[CA_QUEUE_MAX_LANES];
+    /** Remaining share of each lane in the current round. Used by the thread only. **/
+    uint32_t laneCredits[CA_QUEUE_MAX_LANES];
+    /** Behaviour when a lane is full. **/
+    CAQueueOverflowPolicy_t overflowPolicy;
+    /** conditional to wake up the producers blocked on a full queue. **/
+    oc_cond spaceCond;
+    /** Set while the thread sleeps on threadCond. **/
+    volatile uint32_t waiting;
+    /** Number of producers sleeping on spaceCond. **/
+    volatile uint32_t blockedProducers;
+    /** Number of data destroyed by CA_QUEUE_OVERFLOW_DROP_OLDEST. **/
+    volatile uint32_t droppedCount;
+    /** Function invoked when the queue becomes empty. **/
+    CAIdleTask idleTask;
+    /** Context passed to idleTask. **/
+    void *idleContext;
+    /** Function receiving the timings of each data. NULL when they are not measured. **/
+    CAStatsTask statsTask;
+    /** Context passed to statsTask. **/
+    void *statsContext;
+    /** Largest number of queued data seen. Only maintained while statsTask is set. **/
+    volatile uint32_t highWaterMark;
 } CAQueueingThread_t;
 
 /**
@@ -74,6 +130,69 @@ typedef struct
 CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool_t handle,
                                       CAThreadTask task, CADataDestroyFunction destroy);
 
+/**
+ * Initializes the queuing thread with a bounded queue.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   handle       thread pool handle created.
+ * @param[in]   task         function to be called for each data.
+ * @param[in]   destroy      function to data destroy.
+ * @param[in]   capacity     maximum number of queued data. 0 selects the default capacity.
+ * @param[in]   policy       behaviour of CAQueueingThreadAddData when the queue is full.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadInitializeBounded(CAQueueingThread_t *thread, ca_thread_pool_t handle,
+                                             CAThreadTask task, CADataDestroyFunction destroy,
+                                             uint32_t capacity, CAQueueOverflowPolicy_t policy);
+
+/**
+ * Initializes the queuing thread with several bounded priority lanes.
+ * The thread always takes the data from the highest lane which has data and share left
+ * in the current round. The share of a lane is its weight, so lower lanes are not starved.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   handle       thread pool handle created.
+ * @param[in]   task         function to be called for each data.
+ * @param[in]   destroy      function to data destroy.
+ * @param[in]   capacity     maximum number of queued data in each lane. 0 selects the default.
+ * @param[in]   policy       behaviour of CAQueueingThreadAddData when a lane is full.
+ * @param[in]   laneCount    number of lanes, 1 to CA_QUEUE_MAX_LANES.
+ * @param[in]   weights      weight of each lane, at least 1. Lane 0 has the highest priority.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadInitializeLanes(CAQueueingThread_t *thread, ca_thread_pool_t handle,
+                                           CAThreadTask task, CADataDestroyFunction destroy,
+                                           uint32_t capacity, CAQueueOverflowPolicy_t policy,
+                                           uint32_t laneCount, const uint32_t *weights);
+
+/**
+ * Sets the function invoked by the queuing thread when the queue becomes empty.
+ * Must be called before the thread is started.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   task         idle function. NULL disables it.
+ * @param[in]   context      context passed to the idle function.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadSetIdleTask(CAQueueingThread_t *thread, CAIdleTask task, void *context);
+
+/**
+ * Sets the function receiving the queue wait and processing time of each data.
+ * Without it the data are not time stamped. Must be called before the thread is started.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   task         statistics function. NULL disables it.
+ * @param[in]   context      context passed to the statistics function.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadSetStatsTask(CAQueueingThread_t *thread, CAStatsTask task, void *context);
+
+/**
+ * Sets the function disposing of the data dropped by CA_QUEUE_OVERFLOW_DROP_OLDEST instead
+ * of the destroy function, so the owner of the data learns about the drop.
+ * It is invoked by the producer whose data made room. Must be called before the thread is started.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   drop         drop function. NULL destroys dropped data.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadSetDropFunction(CAQueueingThread_t *thread, CADataDestroyFunction drop);
+
 /**
  * Start the queuing thread.
  * @param[in]   thread        thread data that needs to be started.
@@ -83,13 +202,40 @@ CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread);
 
 /**
  * Add queuing thread data for new thread.
+ * Ownership of data is taken only when CA_STATUS_OK is returned.
  * @param[in]   thread       thread data for new thread control.
  * @param[in]   data         data that needs to be given for each thread.
  * @param[in]   size         length of the data.
- * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ * @return  CA_STATUS_OK, CA_STATUS_QUEUE_FULL if the queue is full and the policy is
+ *          CA_QUEUE_OVERFLOW_REJECT (or the thread is stopping while blocked)
+ *          or ERROR CODES (CAResult_t error codes in cacommon.h).
  */
 CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint32_t size);
 
+/**
+ * Add queuing thread data to a priority lane.
+ * Ownership of data is taken only when CA_STATUS_OK is returned.
+ * @param[in]   thread       thread data for new thread control.
+ * @param[in]   lane         lane of the data. Lane 0 has the highest priority.
+ * @param[in]   data         data that needs to be given for each thread.
+ * @param[in]   size         length of the data.
+ * @return  same as CAQueueingThreadAddData.
+ */
+CAResult_t CAQueueingThreadAddDataToLane(CAQueueingThread_t *thread, uint32_t lane,
+                                         void *data, uint32_t size);
+
+/**
+ * @param[in]   thread       thread data for each thread.
+ * @return  number of queued data in all the lanes.
+ */
+uint32_t CAQueueingThreadGetSize(CAQueueingThread_t *thread);
+
+/**
+ * @param[in]   thread       thread data for each thread.
+ * @return  largest number of queued data seen since the statistics function was set.
+ */
+uint32_t CAQueueingThreadGetHighWaterMark(CAQueueingThread_t *thread);
+
 /**
  * Stop the queuing thread.
  * @param[in]   thread       thread data that needs to be started.
@@ -0,0 +1,272 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "edge_malloc.h"
+#include "edge_logger.h"
+
+#include "caserialexecutor.h"
+
+#define TAG "OIC_CA_SERIAL"
+
+#ifdef _MSC_VER
+#define CA_THREAD_LOCAL __declspec(thread)
+#else
+#define CA_THREAD_LOCAL __thread
+#endif
+
+struct CASerialTaskNode
+{
+    CASerialTask task;
+    void *data;
+    /** Set for a task of CASerialExecutorRun, which lives on the stack of its caller. **/
+    bool waited;
+    /** Set once a waited task is done, or dropped. **/
+    bool done;
+    /** Set when a waited task is dropped by CASerialExecutorDestroy without running. **/
+    bool dropped;
+    CASerialTaskNode *next;
+};
+
+/** Executor whose tasks the calling thread is running. **/
+static CA_THREAD_LOCAL CASerialExecutor_t *g_drainingExecutor = NULL;
+
+static void CASerialExecutorAppend(CASerialExecutor_t *executor, CASerialTaskNode *node)
+{
+    node->next = NULL;
+    if (NULL == executor->tail)
+    {
+        executor->head = node;
+    }
+    else
+    {
+        executor->tail->next = node;
+    }
+    executor->tail = node;
+}
+
+/**
+ * Runs the queued tasks until the queue is empty. Called with the mutex locked and
+ * draining set. Returns with the mutex unlocked.
+ * The queue may keep growing while the tasks run, as other threads give tasks and return
+ * or wait for them; the calling thread runs those too. Nothing else would run them, as the
+ * executor owns no thread.
+ */
+static void CASerialExecutorDrain(CASerialExecutor_t *executor)
+{
+    CASerialExecutor_t *previous = g_drainingExecutor;
+    g_drainingExecutor = executor;
+
+    while (NULL != executor->head)
+    {
+        CASerialTaskNode *node = executor->head;
+        executor->head = node->next;
+        if (NULL == executor->head)
+        {
+            executor->tail = NULL;
+        }
+        oc_mutex_unlock(executor->mutex);
+
+        node->task(node->data);
+
+        oc_mutex_lock(executor->mutex);
+        if (node->waited)
+        {
+            node->done = true;
+            oc_cond_broadcast(executor->cond);
+        }
+        else
+        {
+            EdgeFree(node);
+        }
+    }
+    executor->draining = false;
+    // CASerialExecutorDestroy waits for the drain to end.
+    oc_cond_broadcast(executor->cond);
+    oc_mutex_unlock(executor->mutex);
+
+    g_drainingExecutor = previous;
+}
+
+CAResult_t CASerialExecutorInitialize(CASerialExecutor_t *executor)
+{
+    if (NULL == executor)
+    {
+        EDGE_LOG(TAG, "parameter error");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    memset(executor, 0, sizeof(CASerialExecutor_t));
+    executor->mutex = oc_mutex_new();
+    executor->cond = oc_cond_new();
+    if (NULL == executor->mutex || NULL == executor->cond)
+    {
+        EDGE_LOG(TAG, "Failed to create the executor mutex or condition");
+        CASerialExecutorDestroy(executor);
+        return CA_STATUS_FAILED;
+    }
+    return CA_STATUS_OK;
+}
+
+CAResult_t CASerialExecutorSubmit(CASerialExecutor_t *executor, CASerialTask task, void *data)
+{
+    if (NULL == executor || NULL == executor->mutex || NULL == task)
+    {
+        EDGE_LOG(TAG, "parameter error");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    CASerialTaskNode *node = (CASerialTaskNode *) EdgeCalloc(1, sizeof(CASerialTaskNode));
+    if (NULL == node)
+    {
+        EDGE_LOG(TAG, "Memory allocation failed for the executor task");
+        return CA_STATUS_FAILED;
+    }
+    node->task = task;
+    node->data = data;
+
+    oc_mutex_lock(executor->mutex);
+    CASerialExecutorAppend(executor, node);
+    if (executor->draining)
+    {
+        oc_mutex_unlock(executor->mutex);
+        return CA_STATUS_OK;
+    }
+    executor->draining = true;
+    CASerialExecutorDrain(executor);
+    return CA_STATUS_OK;
+}
+
+CAResult_t CASerialExecutorRun(CASerialExecutor_t *executor, CASerialTask task, void *data)
+{
+    if (NULL == executor || NULL == executor->mutex || NULL == task)
+    {
+        EDGE_LOG(TAG, "parameter error");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    // Waiting for the executor from one of its own tasks would never end.
+    if (g_drainingExecutor == executor)
+    {
+        task(data);
+        return CA_STATUS_OK;
+    }
+
+    CASerialTaskNode node;
+    memset(&node, 0, sizeof(CASerialTaskNode));
+    node.task = task;
+    node.data = data;
+    node.waited = true;
+
+    oc_mutex_lock(executor->mutex);
+    CASerialExecutorAppend(executor, &node);
+    if (!executor->draining)
+    {
+        executor->draining = true;
+        CASerialExecutorDrain(executor);
+        return node.dropped ? CA_STATUS_FAILED : CA_STATUS_OK;
+    }
+    executor->waiting++;
+    while (!node.done)
+    {
+        oc_cond_wait(executor->cond, executor->mutex);
+    }
+    executor->waiting--;
+    if (0 == executor->waiting)
+    {
+        // CASerialExecutorDestroy waits for the last waiting caller to leave.
+        oc_cond_broadcast(executor->cond);
+    }
+    oc_mutex_unlock(executor->mutex);
+    return node.dropped ? CA_STATUS_FAILED : CA_STATUS_OK;
+}
+
+/**
+ * @brief CASerialExecutorDropQueued - Drops the queued tasks. The tasks of
+ * CASerialExecutorRun live on the stack of their callers, which are told and return.
+ * Called with the mutex locked, if there is one.
+ */
+static void CASerialExecutorDropQueued(CASerialExecutor_t *executor)
+{
+    while (NULL != executor->head)
+    {
+        CASerialTaskNode *node = executor->head;
+        executor->head = node->next;
+        EDGE_LOG(TAG, "Queued task of the executor is dropped");
+        if (node->waited)
+        {
+            node->dropped = true;
+            node->done = true;
+        }
+        else
+        {
+            EdgeFree(node);
+        }
+    }
+    executor->tail = NULL;
+}
+
+CAResult_t CASerialExecutorDestroy(CASerialExecutor_t *executor)
+{
+    if (NULL == executor)
+    {
+        EDGE_LOG(TAG, "parameter error");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (NULL == executor->mutex || NULL == executor->cond)
+    {
+        // Initialization failed, nothing was queued.
+        CASerialExecutorDropQueued(executor);
+    }
+    else
+    {
+        // The running task would wait for its own executor to be destroyed.
+        if (g_drainingExecutor == executor)
+        {
+            EDGE_LOG(TAG, "The executor can not be destroyed by one of its own tasks");
+            return CA_STATUS_FAILED;
+        }
+
+        oc_mutex_lock(executor->mutex);
+        CASerialExecutorDropQueued(executor);
+        oc_cond_broadcast(executor->cond);
+        while (executor->draining || 0 < executor->waiting)
+        {
+            oc_cond_wait(executor->cond, executor->mutex);
+        }
+        oc_mutex_unlock(executor->mutex);
+    }
+
+    if (NULL != executor->cond)
+    {
+        oc_cond_free(executor->cond);
+        executor->cond = NULL;
+    }
+    if (NULL != executor->mutex)
+    {
+        oc_mutex_free(executor->mutex);
+        executor->mutex = NULL;
+    }
+    return CA_STATUS_OK;
+}
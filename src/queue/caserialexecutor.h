@@ -0,0 +1,111 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the serial executor. It runs the tasks given to it one at a time,
+ * in the order they were given, on the threads which give them: the first thread to find
+ * the executor idle runs every queued task until the queue is empty, and the others
+ * return (CASerialExecutorSubmit) or wait for their own task (CASerialExecutorRun).
+ * The executor owns no thread, so many executors can share the workers of a thread pool.
+ */
+
+#ifndef CA_SERIAL_EXECUTOR_H_
+#define CA_SERIAL_EXECUTOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "octhread.h"
+#include "cacommon.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef void (*CASerialTask)(void *data);
+
+typedef struct CASerialTaskNode CASerialTaskNode;
+
+typedef struct
+{
+    /** mutex for synchronization. **/
+    oc_mutex mutex;
+    /** conditional signalled when a waited task is done. **/
+    oc_cond cond;
+    /** First queued task. **/
+    CASerialTaskNode *head;
+    /** Last queued task. **/
+    CASerialTaskNode *tail;
+    /** Set while a thread runs the queued tasks. **/
+    bool draining;
+    /** Number of CASerialExecutorRun callers waiting for their task. **/
+    uint32_t waiting;
+} CASerialExecutor_t;
+
+/**
+ * Initializes the executor.
+ * @param[in]   executor     executor.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CASerialExecutorInitialize(CASerialExecutor_t *executor);
+
+/**
+ * Queues a task and returns. If the executor is idle, the task and the ones queued
+ * meanwhile run on the calling thread before this returns. Those include the tasks other
+ * threads give while it runs, so the call lasts as long as the executor stays busy.
+ * @param[in]   executor     executor.
+ * @param[in]   task         function to be called.
+ * @param[in]   data         data passed to task.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CASerialExecutorSubmit(CASerialExecutor_t *executor, CASerialTask task, void *data);
+
+/**
+ * Runs a task after the tasks queued before it, and returns once it is done.
+ * If the executor is idle, the calling thread also runs the tasks queued after its own
+ * until the queue is empty, as CASerialExecutorSubmit does.
+ * A task which runs on the executor may call this for the same executor; the
+ * nested task then runs at once.
+ * @param[in]   executor     executor.
+ * @param[in]   task         function to be called.
+ * @param[in]   data         data passed to task.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CASerialExecutorRun(CASerialExecutor_t *executor, CASerialTask task, void *data);
+
+/**
+ * Destroys the executor. Tasks which are still queued are dropped without running,
+ * and CASerialExecutorRun returns CA_STATUS_FAILED to the callers waiting for them.
+ * Waits for the running task to end and for those callers to return.
+ * No task may be given to the executor once this is called, and its own tasks may not
+ * call it.
+ * @param[in]   executor     executor.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CASerialExecutorDestroy(CASerialExecutor_t *executor);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* CA_SERIAL_EXECUTOR_H_ */
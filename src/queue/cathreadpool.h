@@ -55,7 +55,8 @@ typedef struct ca_thread_pool
 /**
  * This function creates a newly allocated thread pool.
  *
- * @param num_of_threads The number of worker thread used in this pool.
+ * @param num_of_threads The number of worker thread used in this pool. All of them are
+ *                       started here and live until ::ca_thread_pool_free.
  * @param thread_pool_handle Handle to newly create thread pool.
  * @return Error code, CA_STATUS_OK if success, else error number.
  */
@@ -63,6 +64,8 @@ CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_
 
 /**
  * This function adds a routine to be executed by the thread pool at some future time.
+ * A routine occupies its worker until it returns, so long-running routines must not
+ * outnumber the workers of the pool.
  *
  * @param thread_pool The thread pool structure.
  * @param method The routine to be executed.
@@ -77,6 +80,8 @@ CAResult_t ca_thread_pool_add_task(ca_thread_pool_t thread_pool, ca_thread_func
 
 /**
  * This function removes a routine to be executed by the thread pool.
+ * A routine which has not started yet is not executed. Otherwise this function waits
+ * until the routine returns.
  *
  * @param thread_pool The thread pool structure.
  * @param taskId An unique identifier of task.
@@ -88,7 +93,7 @@ CAResult_t ca_thread_pool_remove_task(ca_thread_pool_t thread_pool, uint32_t tas
 
 /**
  * This function stops all the worker threads (stop & exit). And frees all the allocated memory.
- * Function will return only after joining all threads executing the currently scheduled tasks.
+ * Function will return only after all the scheduled tasks are finished and all threads are joined.
  *
  * @param thread_pool The thread pool structure.
  */
@@ -22,62 +22,250 @@
  * @file
  *
  * This file provides APIs related to thread pool.
+ * A fixed number of worker threads is started when the pool is created. Each worker
+ * owns a task deque. Tasks are handed to the workers round-robin and a worker whose
+ * deque is empty steals from the other workers before going to sleep.
  */
 
 #ifndef _GNU_SOURCE
 #define _GNU_SOURCE
 #endif
 #include <errno.h>
+#include <string.h>
 #include "cathreadpool.h"
-#include "uarraylist.h"
 #include "octhread.h"
+#include "ocatomic.h"
 
-#include "edge_random.h"
 #include "edge_malloc.h"
 #include "edge_logger.h"
 
 #define TAG "UTHREADPOOL"
 
 /**
- * empty struct to represent the details.  This implementation has no data
- * that it needs to keep track of, so it only uses NULL for the internal value.
+ * @def INITIAL_DEQUE_CAPACITY
+ * @brief Number of task slots each worker deque starts with. Doubled when full.
  */
-typedef struct ca_thread_pool_details_t
-{
-    u_arraylist_t* threads_list;
-    oc_mutex list_lock;
-} ca_thread_pool_details_t;
+#define INITIAL_DEQUE_CAPACITY (16)
+
+/**
+ * @def NO_TASK
+ * @brief Task id which is never handed out. Marks an idle worker.
+ */
+#define NO_TASK (0)
 
 /**
- * struct to wrap the pthreads callback properly.  The function pointer for
- * pthreads requires a void* return value, however u_thread_func is a void.
+ * Task waiting in a worker deque.
  */
-typedef struct ca_thread_pool_callback_info_t
+typedef struct ca_thread_pool_task_t
 {
     ca_thread_func func;
     void* data;
-} ca_thread_pool_callback_info_t;
+    uint32_t taskId;
+} ca_thread_pool_task_t;
+
+struct ca_thread_pool_details_t;
 
-typedef struct ca_thread_pool_thread_info_t
+/**
+ * Worker thread and its task deque.
+ * The deque is a circular array guarded by 'lock'. The owner takes tasks from the
+ * head so that its tasks start in the order they were added, thieves take them
+ * from the tail.
+ */
+typedef struct ca_thread_pool_worker_t
 {
     oc_thread thread;
-    uint32_t taskId;
-} ca_thread_pool_thread_info_t;
+    oc_mutex lock;
+    ca_thread_pool_task_t *tasks;
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t count;
+    /** Id of the task being executed, NO_TASK if none. Set under 'lock' when the task is taken. */
+    volatile uint32_t currentTaskId;
+    uint32_t index;
+    struct ca_thread_pool_details_t *details;
+} ca_thread_pool_worker_t;
+
+typedef struct ca_thread_pool_details_t
+{
+    ca_thread_pool_worker_t *workers;
+    uint32_t workerCount;
+    /** Guards sleeping and waking up. Used with taskCond and doneCond. */
+    oc_mutex lock;
+    /** Signalled when a task is added to the pool or the pool is stopped. */
+    oc_cond taskCond;
+    /** Signalled when a task finishes while someone waits in ca_thread_pool_remove_task. */
+    oc_cond doneCond;
+    /** Number of tasks in all the deques. Changed under the lock of the deque. */
+    volatile uint32_t pendingCount;
+    volatile uint32_t idleCount;
+    volatile uint32_t doneWaiters;
+    volatile uint32_t lastTaskId;
+    volatile uint32_t nextWorker;
+    volatile uint32_t stop;
+} ca_thread_pool_details_t;
+
+static bool ca_thread_pool_push_task(ca_thread_pool_details_t *details,
+                                     ca_thread_pool_worker_t *worker,
+                                     const ca_thread_pool_task_t *task)
+{
+    oc_mutex_lock(worker->lock);
+    if (worker->count == worker->capacity)
+    {
+        uint32_t newCapacity = worker->capacity * 2;
+        ca_thread_pool_task_t *newTasks = (ca_thread_pool_task_t *)
+                EdgeMalloc(newCapacity * sizeof(ca_thread_pool_task_t));
+        if (!newTasks)
+        {
+            oc_mutex_unlock(worker->lock);
+            EDGE_LOG(TAG, "Failed to grow the task deque");
+            return false;
+        }
+        for (uint32_t i = 0; i < worker->count; i++)
+        {
+            newTasks[i] = worker->tasks[(worker->head + i) % worker->capacity];
+        }
+        EdgeFree(worker->tasks);
+        worker->tasks = newTasks;
+        worker->capacity = newCapacity;
+        worker->head = 0;
+    }
+    worker->tasks[(worker->head + worker->count) % worker->capacity] = *task;
+    worker->count++;
+    OC_ATOMIC_FETCH_ADD(&details->pendingCount, 1);
+    oc_mutex_unlock(worker->lock);
+    return true;
+}
 
-// passthrough function to convert the pthreads call to a u_thread_func call
-void* ca_thread_pool_pthreads_delegate(void* data)
+// Takes a task out of the deque of 'victim' and marks it as running on 'worker'.
+static bool ca_thread_pool_take_task(ca_thread_pool_details_t *details,
+                                     ca_thread_pool_worker_t *victim,
+                                     ca_thread_pool_worker_t *worker,
+                                     ca_thread_pool_task_t *task)
 {
-    ca_thread_pool_callback_info_t* info = (ca_thread_pool_callback_info_t*)data;
-    info->func(info->data);
-    EdgeFree(info);
+    bool taken = false;
+    oc_mutex_lock(victim->lock);
+    if (victim->count > 0)
+    {
+        if (victim == worker)
+        {
+            *task = victim->tasks[victim->head];
+            victim->head = (victim->head + 1) % victim->capacity;
+        }
+        else
+        {
+            *task = victim->tasks[(victim->head + victim->count - 1) % victim->capacity];
+        }
+        victim->count--;
+        OC_ATOMIC_FETCH_SUB(&details->pendingCount, 1);
+        // Published before the deque is unlocked, so that ca_thread_pool_remove_task
+        // always finds the task either in a deque or running.
+        OC_ATOMIC_STORE(&worker->currentTaskId, task->taskId);
+        taken = true;
+    }
+    oc_mutex_unlock(victim->lock);
+    return taken;
+}
+
+static bool ca_thread_pool_get_task(ca_thread_pool_details_t *details,
+                                    ca_thread_pool_worker_t *worker,
+                                    ca_thread_pool_task_t *task)
+{
+    if (ca_thread_pool_take_task(details, worker, worker, task))
+    {
+        return true;
+    }
+
+    for (uint32_t i = 1; i < details->workerCount; i++)
+    {
+        ca_thread_pool_worker_t *victim =
+                &details->workers[(worker->index + i) % details->workerCount];
+        if (ca_thread_pool_take_task(details, victim, worker, task))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void *ca_thread_pool_worker_routine(void *data)
+{
+    ca_thread_pool_worker_t *worker = (ca_thread_pool_worker_t *) data;
+    ca_thread_pool_details_t *details = worker->details;
+
+    for (;;)
+    {
+        ca_thread_pool_task_t task;
+        if (ca_thread_pool_get_task(details, worker, &task))
+        {
+            task.func(task.data);
+
+            OC_ATOMIC_STORE(&worker->currentTaskId, NO_TASK);
+            if (OC_ATOMIC_LOAD(&details->doneWaiters) > 0)
+            {
+                oc_mutex_lock(details->lock);
+                oc_cond_broadcast(details->doneCond);
+                oc_mutex_unlock(details->lock);
+            }
+            continue;
+        }
+
+        oc_mutex_lock(details->lock);
+        // idleCount is raised before pendingCount is checked, so a task added
+        // in between always sees an idle worker and signals taskCond.
+        OC_ATOMIC_FETCH_ADD(&details->idleCount, 1);
+        while (0 == OC_ATOMIC_LOAD(&details->pendingCount) && !OC_ATOMIC_LOAD(&details->stop))
+        {
+            oc_cond_wait(details->taskCond, details->lock);
+        }
+        OC_ATOMIC_FETCH_SUB(&details->idleCount, 1);
+        bool finished = OC_ATOMIC_LOAD(&details->stop) &&
+                0 == OC_ATOMIC_LOAD(&details->pendingCount);
+        oc_mutex_unlock(details->lock);
+
+        if (finished)
+        {
+            break;
+        }
+    }
     return NULL;
 }
 
-// this implementation doesn't do a thread pool, so this function is essentially
-// a no-op besides creating a valid ca_thread_pool_t object.  It was determined after
-// reading through the existing implementation that the thread-pooling was unnecessary
-// for the posix platforms.  Behavior shouldn't be changed since previously num_of_threads
-// was greater than the number of requested threads.
+// Stops and joins the first 'count' workers and frees the whole pool.
+// Workers leave only when no task is left, so the tasks already added are all run.
+static void ca_thread_pool_destroy(ca_thread_pool_t thread_pool, uint32_t count)
+{
+    ca_thread_pool_details_t *details = thread_pool->details;
+
+    oc_mutex_lock(details->lock);
+    OC_ATOMIC_STORE(&details->stop, 1);
+    oc_cond_broadcast(details->taskCond);
+    oc_mutex_unlock(details->lock);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        ca_thread_pool_worker_t *worker = &details->workers[i];
+        if (worker->thread)
+        {
+            EDGE_LOG_V(TAG, "waiting.. thread: %p", worker->thread);
+            oc_thread_wait(worker->thread);
+            oc_thread_free(worker->thread);
+        }
+    }
+
+    for (uint32_t i = 0; i < details->workerCount; i++)
+    {
+        EdgeFree(details->workers[i].tasks);
+        oc_mutex_free(details->workers[i].lock);
+    }
+
+    oc_cond_free(details->doneCond);
+    oc_cond_free(details->taskCond);
+    oc_mutex_free(details->lock);
+    EdgeFree(details->workers);
+    EdgeFree(details);
+    EdgeFree(thread_pool);
+}
+
 CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_pool)
 {
     EDGE_LOG(TAG, "IN");
@@ -102,40 +290,86 @@ CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_
         return CA_MEMORY_ALLOC_FAILED;
     }
 
-    (*thread_pool)->details = EdgeMalloc(sizeof(struct ca_thread_pool_details_t));
-    if(!(*thread_pool)->details)
+    ca_thread_pool_details_t *details = EdgeCalloc(1, sizeof(struct ca_thread_pool_details_t));
+    if(!details)
     {
         EDGE_LOG(TAG, "Failed to allocate for thread-pool details");
         EdgeFree(*thread_pool);
         *thread_pool=NULL;
         return CA_MEMORY_ALLOC_FAILED;
     }
+    (*thread_pool)->details = details;
 
-    (*thread_pool)->details->list_lock = oc_mutex_new();
-
-    if(!(*thread_pool)->details->list_lock)
+    details->lock = oc_mutex_new();
+    details->taskCond = oc_cond_new();
+    details->doneCond = oc_cond_new();
+    details->workers = EdgeCalloc(num_of_threads, sizeof(ca_thread_pool_worker_t));
+    if (!details->lock || !details->taskCond || !details->doneCond || !details->workers)
     {
-        EDGE_LOG(TAG, "Failed to create thread-pool mutex");
+        EDGE_LOG(TAG, "Failed to create thread-pool resources");
         goto exit;
     }
+    details->workerCount = (uint32_t) num_of_threads;
 
-    (*thread_pool)->details->threads_list = u_arraylist_create();
+    for (uint32_t i = 0; i < details->workerCount; i++)
+    {
+        ca_thread_pool_worker_t *worker = &details->workers[i];
+        worker->lock = oc_mutex_new();
+        worker->tasks = EdgeMalloc(INITIAL_DEQUE_CAPACITY * sizeof(ca_thread_pool_task_t));
+        if (!worker->lock || !worker->tasks)
+        {
+            EDGE_LOG(TAG, "Failed to create worker resources");
+            goto exit;
+        }
+        worker->capacity = INITIAL_DEQUE_CAPACITY;
+        worker->index = i;
+        worker->details = details;
+    }
 
-    if(!(*thread_pool)->details->threads_list)
+    for (uint32_t i = 0; i < details->workerCount; i++)
     {
-        EDGE_LOG(TAG, "Failed to create thread-pool list");
-        if(!oc_mutex_free((*thread_pool)->details->list_lock))
+        ca_thread_pool_worker_t *worker = &details->workers[i];
+        int thrRet = oc_thread_new(&worker->thread, ca_thread_pool_worker_routine, worker);
+        if (thrRet != 0)
         {
-            EDGE_LOG(TAG, "Failed to free thread-pool mutex");
+            EDGE_LOG_V(TAG, "Thread start failed with error %d", thrRet);
+            worker->thread = NULL;
+            ca_thread_pool_destroy(*thread_pool, i);
+            *thread_pool = NULL;
+            return CA_STATUS_FAILED;
         }
-        goto exit;
     }
 
+    EDGE_LOG_V(TAG, "%u workers started", details->workerCount);
     EDGE_LOG(TAG, "OUT");
     return CA_STATUS_OK;
 
 exit:
-    EdgeFree((*thread_pool)->details);
+    if (details->workers)
+    {
+        for (int32_t i = 0; i < num_of_threads; i++)
+        {
+            EdgeFree(details->workers[i].tasks);
+            if (details->workers[i].lock)
+            {
+                oc_mutex_free(details->workers[i].lock);
+            }
+        }
+        EdgeFree(details->workers);
+    }
+    if (details->doneCond)
+    {
+        oc_cond_free(details->doneCond);
+    }
+    if (details->taskCond)
+    {
+        oc_cond_free(details->taskCond);
+    }
+    if (details->lock)
+    {
+        oc_mutex_free(details->lock);
+    }
+    EdgeFree(details);
     EdgeFree(*thread_pool);
     *thread_pool = NULL;
     return CA_STATUS_FAILED;
@@ -152,60 +386,54 @@ CAResult_t ca_thread_pool_add_task(ca_thread_pool_t thread_pool, ca_thread_func
         return CA_STATUS_INVALID_PARAM;
     }
 
-    ca_thread_pool_callback_info_t* info = EdgeMalloc(sizeof(ca_thread_pool_callback_info_t));
-    if(!info)
+    ca_thread_pool_details_t *details = thread_pool->details;
+    if (OC_ATOMIC_LOAD(&details->stop))
     {
-        EDGE_LOG(TAG, "Failed to allocate for memory wrapper");
-        return CA_MEMORY_ALLOC_FAILED;
+        EDGE_LOG(TAG, "thread pool is stopped");
+        return CA_STATUS_FAILED;
     }
 
-    info->func = method;
-    info->data = data;
+    ca_thread_pool_task_t task;
+    task.func = method;
+    task.data = data;
+    do
+    {
+        task.taskId = OC_ATOMIC_FETCH_ADD(&details->lastTaskId, 1) + 1;
+    } while (NO_TASK == task.taskId);
 
-    ca_thread_pool_thread_info_t *threadInfo =
-            (ca_thread_pool_thread_info_t *) EdgeCalloc(1, sizeof(ca_thread_pool_thread_info_t));
-    if (!threadInfo)
+    uint32_t index = OC_ATOMIC_FETCH_ADD(&details->nextWorker, 1) % details->workerCount;
+    if (!ca_thread_pool_push_task(details, &details->workers[index], &task))
     {
-        EDGE_LOG(TAG, "Memory allocation failed");
-        EdgeFree(info);
-        return CA_STATUS_FAILED;
+        return CA_MEMORY_ALLOC_FAILED;
     }
-    threadInfo->taskId = EdgeGetRandom();
-    if (taskId)
+
+    if (OC_ATOMIC_LOAD(&details->idleCount) > 0)
     {
-        *taskId = threadInfo->taskId;
+        oc_mutex_lock(details->lock);
+        oc_cond_signal(details->taskCond);
+        oc_mutex_unlock(details->lock);
     }
 
-    oc_mutex_lock(thread_pool->details->list_lock);
-    bool addResult = u_arraylist_add(thread_pool->details->threads_list, (void*) threadInfo);
-    if (!addResult)
+    if (taskId)
     {
-        // Note that this is considered non-fatal.
-        oc_mutex_unlock(thread_pool->details->list_lock);
-        EDGE_LOG(TAG, "Arraylist add failed");
-        EdgeFree(info);
-        EdgeFree(threadInfo);
-        return CA_STATUS_FAILED;
+        *taskId = task.taskId;
     }
+    EDGE_LOG_V(TAG, "added taskId: %u", task.taskId);
+
+    EDGE_LOG_V(TAG, "Out %s", __func__);
+    return CA_STATUS_OK;
+}
 
-    int thrRet = oc_thread_new(&threadInfo->thread, ca_thread_pool_pthreads_delegate, info);
-    if (thrRet != 0)
+static bool ca_thread_pool_is_running(ca_thread_pool_details_t *details, uint32_t taskId)
+{
+    for (uint32_t i = 0; i < details->workerCount; i++)
     {
-        uint32_t index = 0;
-        if (u_arraylist_get_index(thread_pool->details->threads_list, threadInfo, &index))
+        if (OC_ATOMIC_LOAD(&details->workers[i].currentTaskId) == taskId)
         {
-            u_arraylist_remove(thread_pool->details->threads_list, index);
+            return true;
         }
-        oc_mutex_unlock(thread_pool->details->list_lock);
-        EDGE_LOG_V(TAG, "Thread start failed with error %d", thrRet);
-        EdgeFree(info);
-        return CA_STATUS_FAILED;
     }
-    EDGE_LOG_V(TAG, "created taskId: %u", threadInfo->taskId);
-    oc_mutex_unlock(thread_pool->details->list_lock);
-
-    EDGE_LOG_V(TAG, "Out %s", __func__);
-    return CA_STATUS_OK;
+    return false;
 }
 
 CAResult_t ca_thread_pool_remove_task(ca_thread_pool_t thread_pool, uint32_t taskId)
@@ -218,27 +446,47 @@ CAResult_t ca_thread_pool_remove_task(ca_thread_pool_t thread_pool, uint32_t tas
         return CA_STATUS_FAILED;
     }
 
-    oc_mutex_lock(thread_pool->details->list_lock);
-    for (uint32_t i = 0; i < u_arraylist_length(thread_pool->details->threads_list); ++i)
+    if (NO_TASK == taskId)
     {
-        ca_thread_pool_thread_info_t *threadInfo = (ca_thread_pool_thread_info_t *)
-                u_arraylist_get(thread_pool->details->threads_list, i);
-        if (threadInfo)
+        return CA_STATUS_OK;
+    }
+
+    ca_thread_pool_details_t *details = thread_pool->details;
+
+    // A task which has not started yet is simply taken out of its deque.
+    for (uint32_t i = 0; i < details->workerCount; i++)
+    {
+        ca_thread_pool_worker_t *worker = &details->workers[i];
+        oc_mutex_lock(worker->lock);
+        for (uint32_t j = 0; j < worker->count; j++)
         {
-            if (threadInfo->taskId == taskId)
+            if (worker->tasks[(worker->head + j) % worker->capacity].taskId == taskId)
             {
-                EDGE_LOG_V(TAG, "waiting.. taskId: %u", threadInfo->taskId);
-                oc_thread_wait(threadInfo->thread);
-
-                EDGE_LOG_V(TAG, "removed taskId: %u", threadInfo->taskId);
-                u_arraylist_remove(thread_pool->details->threads_list, i);
-                oc_thread_free(threadInfo->thread);
-                EdgeFree(threadInfo);
-                break;
+                for (uint32_t k = j + 1; k < worker->count; k++)
+                {
+                    worker->tasks[(worker->head + k - 1) % worker->capacity] =
+                            worker->tasks[(worker->head + k) % worker->capacity];
+                }
+                worker->count--;
+                OC_ATOMIC_FETCH_SUB(&details->pendingCount, 1);
+                oc_mutex_unlock(worker->lock);
+                EDGE_LOG_V(TAG, "removed taskId: %u", taskId);
+                return CA_STATUS_OK;
             }
         }
+        oc_mutex_unlock(worker->lock);
+    }
+
+    // Otherwise wait until it is finished.
+    oc_mutex_lock(details->lock);
+    OC_ATOMIC_FETCH_ADD(&details->doneWaiters, 1);
+    while (ca_thread_pool_is_running(details, taskId))
+    {
+        EDGE_LOG_V(TAG, "waiting.. taskId: %u", taskId);
+        oc_cond_wait(details->doneCond, details->lock);
     }
-    oc_mutex_unlock(thread_pool->details->list_lock);
+    OC_ATOMIC_FETCH_SUB(&details->doneWaiters, 1);
+    oc_mutex_unlock(details->lock);
 
     EDGE_LOG_V(TAG, "Out %s", __func__);
     return CA_STATUS_OK;
@@ -254,31 +502,7 @@ void ca_thread_pool_free(ca_thread_pool_t thread_pool)
         return;
     }
 
-    oc_mutex_lock(thread_pool->details->list_lock);
-
-    for (uint32_t i = 0; i < u_arraylist_length(thread_pool->details->threads_list); ++i)
-    {
-        ca_thread_pool_thread_info_t *threadInfo = (ca_thread_pool_thread_info_t *)
-                u_arraylist_get(thread_pool->details->threads_list, i);
-        if (threadInfo)
-        {
-            if (threadInfo->thread)
-            {
-                EDGE_LOG_V(TAG, "waiting.. thread: %p", threadInfo->thread);
-                oc_thread_wait(threadInfo->thread);
-                oc_thread_free(threadInfo->thread);
-            }
-            EdgeFree(threadInfo);
-        }
-    }
-
-    u_arraylist_free(&(thread_pool->details->threads_list));
-
-    oc_mutex_unlock(thread_pool->details->list_lock);
-    oc_mutex_free(thread_pool->details->list_lock);
-
-    EdgeFree(thread_pool->details);
-    EdgeFree(thread_pool);
+    ca_thread_pool_destroy(thread_pool, thread_pool->details->workerCount);
 
     EDGE_LOG_V(TAG, "Out %s", __func__);
 }
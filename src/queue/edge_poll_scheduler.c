@@ -0,0 +1,563 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <string.h>
+#include <time.h>
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#else
+#include "pthread.h"
+#endif
+
+#include "edge_poll_scheduler.h"
+#include "octhread.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+
+#define TAG "poll_scheduler"
+
+#define USECS_PER_MSEC  (1000)
+#define USECS_PER_SEC   (1000000)
+
+/* One added poll. Each keeps its own id and context, also when it shares the cycle of
+ * another poll. */
+typedef struct EdgePollMember
+{
+    uint32_t id;
+    void *context;
+    struct EdgePollMember *next;
+} EdgePollMember;
+
+/* The cycle of the polls with the same key and interval. */
+typedef struct EdgePoll
+{
+    char *key;
+    uint64_t periodUs;
+    /** Monotonic time in microseconds of the next cycle. */
+    uint64_t deadline;
+    /** Polls served by the cycle, the earliest added first. */
+    EdgePollMember *members;
+    /** Context merged from the contexts of all members, NULL while there is one member. */
+    void *merged;
+    EdgePollStatistics stats;
+    struct EdgePoll *next;
+} EdgePoll;
+
+/* A thread which is told to stop leaves without touching the polls, so a new one may
+ * already be running while it is joined. */
+typedef struct EdgePollThread
+{
+    pthread_t thread;
+    bool stop;
+    /** Ids of the polls of the cycle being started. */
+    uint32_t *pollIds;
+    size_t pollIdCapacity;
+    /** Work of the cycles started at once, dispatched without the lock. */
+    void **jobs;
+    size_t jobCount;
+    size_t jobCapacity;
+} EdgePollThread;
+
+static pthread_mutex_t g_pollLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t g_pollCondOnce = PTHREAD_ONCE_INIT;
+static pthread_cond_t g_pollCond;
+static EdgePoll *g_polls = NULL;
+static EdgePollThread *g_pollThread = NULL;
+static uint32_t g_nextPollId = 1;
+
+static edge_poll_cycle_cb_t g_cycleCallback = NULL;
+static edge_poll_dispatch_cb_t g_dispatchCallback = NULL;
+static edge_poll_merge_cb_t g_mergeCallback = NULL;
+static edge_poll_free_cb_t g_freeCallback = NULL;
+
+static void initPollCond(void)
+{
+    pthread_condattr_t condattr;
+    pthread_condattr_init(&condattr);
+#if defined(__ANDROID__) || _POSIX_TIMERS > 0
+    // The deadlines are taken from oc_get_monotonic_time_us(), which reads this clock.
+    pthread_condattr_setclock(&condattr, CLOCK_MONOTONIC);
+#endif
+    pthread_cond_init(&g_pollCond, &condattr);
+    pthread_condattr_destroy(&condattr);
+}
+
+static void freePollContext(void *context)
+{
+    if (g_freeCallback && context)
+    {
+        g_freeCallback(context);
+    }
+}
+
+uint64_t getNextEdgePollDeadline(uint64_t deadline, uint64_t periodUs, uint64_t now,
+        uint64_t *missed)
+{
+    uint64_t passed = 0;
+    if (now >= deadline && periodUs > 0)
+    {
+        passed = (now - deadline) / periodUs;
+        deadline += (passed + 1) * periodUs;
+    }
+    if (missed)
+    {
+        *missed = passed;
+    }
+    return deadline;
+}
+
+static void *getCycleContext(const EdgePoll *poll)
+{
+    return poll->merged ? poll->merged : poll->members->context;
+}
+
+/* Makes room for the ids of the polls of a cycle and for its job. Called with the lock held. */
+static bool reserveCycle(EdgePollThread *self, const EdgePoll *poll, size_t *pollCount)
+{
+    size_t count = 0;
+    for (const EdgePollMember *member = poll->members; member; member = member->next)
+    {
+        count++;
+    }
+    if (count > self->pollIdCapacity)
+    {
+        uint32_t *pollIds = (uint32_t *) EdgeRealloc(self->pollIds, count * sizeof(uint32_t));
+        VERIFY_NON_NULL_MSG(pollIds, "EdgeRealloc FAILED for the ids of a poll\n", false);
+        self->pollIds = pollIds;
+        self->pollIdCapacity = count;
+    }
+    if (self->jobCount == self->jobCapacity)
+    {
+        size_t capacity = (0 == self->jobCapacity) ? 8 : self->jobCapacity * 2;
+        void **jobs = (void **) EdgeRealloc(self->jobs, capacity * sizeof(void *));
+        VERIFY_NON_NULL_MSG(jobs, "EdgeRealloc FAILED for the jobs of the polls\n", false);
+        self->jobs = jobs;
+        self->jobCapacity = capacity;
+    }
+
+    count = 0;
+    for (const EdgePollMember *member = poll->members; member; member = member->next)
+    {
+        self->pollIds[count++] = member->id;
+    }
+    *pollCount = count;
+    return true;
+}
+
+static void runPollCycle(EdgePollThread *self, EdgePoll *poll, uint64_t now)
+{
+    uint64_t missed = 0;
+    poll->deadline = getNextEdgePollDeadline(poll->deadline, poll->periodUs, now, &missed);
+    poll->stats.overruns += missed;
+
+    // Lateness is measured against the latest deadline which passed, the one served now.
+    uint64_t lateness = now - (poll->deadline - poll->periodUs);
+    if (lateness > poll->stats.maxLatenessUs)
+    {
+        poll->stats.maxLatenessUs = lateness;
+    }
+
+    size_t pollCount = 0;
+    void *job = NULL;
+    if (reserveCycle(self, poll, &pollCount) && g_cycleCallback
+            && g_cycleCallback(self->pollIds, pollCount, getCycleContext(poll), &job))
+    {
+        poll->stats.cycles++;
+        if (job)
+        {
+            self->jobs[self->jobCount++] = job;
+        }
+    }
+    else
+    {
+        poll->stats.overruns++;
+        EDGE_LOG_V(TAG, "Cycle of poll %u skipped, the previous one is still running\n",
+                poll->members->id);
+    }
+}
+
+static void waitForDeadline(uint64_t deadline)
+{
+    if (UINT64_MAX == deadline)
+    {
+        pthread_cond_wait(&g_pollCond, &g_pollLock);
+        return;
+    }
+    struct timespec ts;
+    ts.tv_sec = (time_t) (deadline / USECS_PER_SEC);
+    ts.tv_nsec = (long) ((deadline % USECS_PER_SEC) * 1000);
+    pthread_cond_timedwait(&g_pollCond, &g_pollLock, &ts);
+}
+
+/* Dispatching may wait, for a full send queue for example, so it runs without the lock. */
+static void dispatchJobs(EdgePollThread *self, edge_poll_dispatch_cb_t dispatchCallback)
+{
+    pthread_mutex_unlock(&g_pollLock);
+    for (size_t i = 0; i < self->jobCount; i++)
+    {
+        dispatchCallback(self->jobs[i]);
+    }
+    self->jobCount = 0;
+    pthread_mutex_lock(&g_pollLock);
+}
+
+static void *pollThreadRun(void *data)
+{
+    EdgePollThread *self = (EdgePollThread *) data;
+    pthread_mutex_lock(&g_pollLock);
+    while (!self->stop)
+    {
+        uint64_t now = oc_get_monotonic_time_us();
+        uint64_t earliest = UINT64_MAX;
+        for (EdgePoll *poll = g_polls; poll; poll = poll->next)
+        {
+            if (now >= poll->deadline)
+            {
+                runPollCycle(self, poll, now);
+            }
+            if (poll->deadline < earliest)
+            {
+                earliest = poll->deadline;
+            }
+        }
+        if (self->jobCount > 0 && g_dispatchCallback)
+        {
+            // The polls may change meanwhile, so the deadlines are looked at again.
+            dispatchJobs(self, g_dispatchCallback);
+            continue;
+        }
+        self->jobCount = 0;
+        waitForDeadline(earliest);
+    }
+    pthread_mutex_unlock(&g_pollLock);
+    return NULL;
+}
+
+/* Takes the thread out to be joined, once no poll is left. Called with the lock held. */
+static EdgePollThread *stopIdlePollThread(void)
+{
+    EdgePollThread *thread = NULL;
+    if (IS_NULL(g_polls) && g_pollThread)
+    {
+        thread = g_pollThread;
+        thread->stop = true;
+        g_pollThread = NULL;
+        pthread_cond_broadcast(&g_pollCond);
+    }
+    return thread;
+}
+
+static void joinPollThread(EdgePollThread *thread)
+{
+    if (thread)
+    {
+        pthread_join(thread->thread, NULL);
+        EdgeFree(thread->pollIds);
+        EdgeFree(thread->jobs);
+        EdgeFree(thread);
+    }
+}
+
+/* Called with the lock held. */
+static bool startPollThread(void)
+{
+    COND_CHECK((IS_NOT_NULL(g_pollThread)), true);
+    EdgePollThread *thread = (EdgePollThread *) EdgeCalloc(1, sizeof(EdgePollThread));
+    VERIFY_NON_NULL_MSG(thread, "EdgeCalloc FAILED for the poll thread\n", false);
+    if (0 != pthread_create(&thread->thread, NULL, pollThreadRun, thread))
+    {
+        EDGE_LOG(TAG, "Failed to start the poll thread.\n");
+        EdgeFree(thread);
+        return false;
+    }
+    g_pollThread = thread;
+    return true;
+}
+
+void registerEdgePollCallbacks(edge_poll_cycle_cb_t cycleCallback,
+        edge_poll_dispatch_cb_t dispatchCallback, edge_poll_merge_cb_t mergeCallback,
+        edge_poll_free_cb_t freeCallback)
+{
+    pthread_mutex_lock(&g_pollLock);
+    g_cycleCallback = cycleCallback;
+    g_dispatchCallback = dispatchCallback;
+    g_mergeCallback = mergeCallback;
+    g_freeCallback = freeCallback;
+    pthread_mutex_unlock(&g_pollLock);
+}
+
+static EdgePoll *findPoll(const char *key, uint64_t periodUs)
+{
+    for (EdgePoll *poll = g_polls; poll; poll = poll->next)
+    {
+        if (poll->periodUs == periodUs && 0 == strcmp(poll->key, key))
+        {
+            return poll;
+        }
+    }
+    return NULL;
+}
+
+/* Finds the cycle which serves a poll, and the link to the poll in its members. */
+static EdgePoll *findMember(uint32_t pollId, EdgePollMember ***memberLink)
+{
+    for (EdgePoll *poll = g_polls; poll; poll = poll->next)
+    {
+        for (EdgePollMember **link = &poll->members; *link; link = &(*link)->next)
+        {
+            if ((*link)->id == pollId)
+            {
+                if (memberLink)
+                {
+                    *memberLink = link;
+                }
+                return poll;
+            }
+        }
+    }
+    return NULL;
+}
+
+static uint32_t nextPollId(void)
+{
+    uint32_t pollId = g_nextPollId++;
+    if (0 == g_nextPollId)
+    {
+        g_nextPollId = 1;
+    }
+    return pollId;
+}
+
+static void *mergeContexts(void *context, void *added)
+{
+    void *merged = g_mergeCallback ? g_mergeCallback(context, added) : NULL;
+    if (IS_NULL(merged))
+    {
+        EDGE_LOG(TAG, "Failed to merge the poll.\n");
+    }
+    return merged;
+}
+
+/* Merges the contexts of all members, which are more than one. Called with the lock held. */
+static void *mergeMemberContexts(const EdgePoll *poll)
+{
+    void *merged = poll->members->context;
+    for (const EdgePollMember *member = poll->members->next; member; member = member->next)
+    {
+        void *next = mergeContexts(merged, member->context);
+        if (merged != poll->members->context)
+        {
+            freePollContext(merged);
+        }
+        COND_CHECK((IS_NULL(next)), NULL);
+        merged = next;
+    }
+    return merged;
+}
+
+/* Adds a member to the cycle of poll. Called with the lock held. On failure, context is freed. */
+static uint32_t mergePoll(EdgePoll *poll, void *context)
+{
+    EdgePollMember *member = (EdgePollMember *) EdgeCalloc(1, sizeof(EdgePollMember));
+    void *merged = member ? mergeContexts(getCycleContext(poll), context) : NULL;
+    if (IS_NULL(merged))
+    {
+        EdgeFree(member);
+        freePollContext(context);
+        return 0;
+    }
+    freePollContext(poll->merged);
+    poll->merged = merged;
+
+    EdgePollMember **link = &poll->members;
+    while (*link)
+    {
+        link = &(*link)->next;
+    }
+    member->id = nextPollId();
+    member->context = context;
+    *link = member;
+    return member->id;
+}
+
+uint32_t addEdgePoll(const char *key, uint32_t intervalMs, void *context)
+{
+    if (IS_NULL(key) || 0 == intervalMs || IS_NULL(context))
+    {
+        EDGE_LOG(TAG, "Invalid param in addEdgePoll\n");
+        freePollContext(context);
+        return 0;
+    }
+    pthread_once(&g_pollCondOnce, initPollCond);
+
+    uint64_t periodUs = (uint64_t) intervalMs * USECS_PER_MSEC;
+    uint32_t pollId = 0;
+    pthread_mutex_lock(&g_pollLock);
+    EdgePoll *poll = findPoll(key, periodUs);
+    if (poll)
+    {
+        pollId = mergePoll(poll, context);
+        pthread_mutex_unlock(&g_pollLock);
+        EDGE_LOG_V(TAG, "Poll %u shares the cycle of poll %u\n", pollId, poll->members->id);
+        return pollId;
+    }
+
+    poll = (EdgePoll *) EdgeCalloc(1, sizeof(EdgePoll));
+    if (poll)
+    {
+        poll->key = cloneString(key);
+        poll->members = (EdgePollMember *) EdgeCalloc(1, sizeof(EdgePollMember));
+    }
+    if (IS_NULL(poll) || IS_NULL(poll->key) || IS_NULL(poll->members) || !startPollThread())
+    {
+        EDGE_LOG(TAG, "Failed to add the poll.\n");
+        pthread_mutex_unlock(&g_pollLock);
+        if (poll)
+        {
+            EdgeFree(poll->key);
+            EdgeFree(poll->members);
+        }
+        EdgeFree(poll);
+        freePollContext(context);
+        return 0;
+    }
+
+    poll->members->id = nextPollId();
+    poll->members->context = context;
+    poll->periodUs = periodUs;
+    poll->deadline = oc_get_monotonic_time_us();
+    poll->stats.intervalMs = intervalMs;
+    poll->next = g_polls;
+    g_polls = poll;
+    pollId = poll->members->id;
+    pthread_cond_broadcast(&g_pollCond);
+    pthread_mutex_unlock(&g_pollLock);
+
+    EDGE_LOG_V(TAG, "Poll %u added with an interval of %u ms\n", pollId, intervalMs);
+    return pollId;
+}
+
+static void freePoll(EdgePoll *poll)
+{
+    while (poll->members)
+    {
+        EdgePollMember *next = poll->members->next;
+        freePollContext(poll->members->context);
+        EdgeFree(poll->members);
+        poll->members = next;
+    }
+    freePollContext(poll->merged);
+    EdgeFree(poll->key);
+    EdgeFree(poll);
+}
+
+/* Takes a member out of the cycle of poll, which then serves the other members only.
+ * Returns the context which is no longer used, to be freed without the lock. Called with
+ * the lock held. */
+static void *leavePoll(EdgePoll *poll, EdgePollMember **link)
+{
+    EdgePollMember *member = *link;
+    *link = member->next;
+    EdgeFree(member);
+
+    void *merged = poll->members->next ? mergeMemberContexts(poll) : NULL;
+    if (poll->members->next && IS_NULL(merged))
+    {
+        // The cycle serves the earliest added poll alone until the next change.
+        EDGE_LOG(TAG, "Failed to split the poll.\n");
+    }
+    void *unused = poll->merged;
+    poll->merged = merged;
+    return unused;
+}
+
+bool removeEdgePoll(uint32_t pollId)
+{
+    EdgePoll *removed = NULL;
+    void *unusedContext = NULL;
+    void *memberContext = NULL;
+    bool found = false;
+    pthread_mutex_lock(&g_pollLock);
+    EdgePollMember **memberLink = NULL;
+    EdgePoll *poll = findMember(pollId, &memberLink);
+    if (poll && poll->members->next)
+    {
+        memberContext = (*memberLink)->context;
+        unusedContext = leavePoll(poll, memberLink);
+        found = true;
+    }
+    else if (poll)
+    {
+        for (EdgePoll **link = &g_polls; *link; link = &(*link)->next)
+        {
+            if (*link == poll)
+            {
+                removed = poll;
+                *link = removed->next;
+                break;
+            }
+        }
+        found = true;
+    }
+    EdgePollThread *thread = stopIdlePollThread();
+    pthread_mutex_unlock(&g_pollLock);
+
+    joinPollThread(thread);
+    COND_CHECK_MSG((!found), "No such poll in removeEdgePoll\n", false);
+    freePollContext(memberContext);
+    freePollContext(unusedContext);
+    if (removed)
+    {
+        freePoll(removed);
+    }
+    return true;
+}
+
+void removeAllEdgePolls(void)
+{
+    pthread_mutex_lock(&g_pollLock);
+    EdgePoll *polls = g_polls;
+    g_polls = NULL;
+    EdgePollThread *thread = stopIdlePollThread();
+    pthread_mutex_unlock(&g_pollLock);
+
+    joinPollThread(thread);
+    while (polls)
+    {
+        EdgePoll *next = polls->next;
+        freePoll(polls);
+        polls = next;
+    }
+}
+
+bool getEdgePollStatistics(uint32_t pollId, EdgePollStatistics *stats)
+{
+    VERIFY_NON_NULL_MSG(stats, "NULL stats param in getEdgePollStatistics\n", false);
+    pthread_mutex_lock(&g_pollLock);
+    EdgePoll *poll = findMember(pollId, NULL);
+    if (poll)
+    {
+        *stats = poll->stats;
+    }
+    pthread_mutex_unlock(&g_pollLock);
+    return IS_NOT_NULL(poll);
+}
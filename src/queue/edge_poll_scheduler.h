@@ -0,0 +1,149 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_poll_scheduler.h
+ *
+ * @brief This file contains the scheduler of the cyclic polls.
+ *
+ * One thread starts the cycles of all polls. The deadlines of a poll lie on a fixed grid
+ * of its interval from the time it was added, and the thread waits for the earliest one
+ * as an absolute time, so late wake-ups do not shift the later cycles. A poll is added
+ * under a key, and a poll added with the key and interval of an existing one shares its
+ * cycle, which runs with the merged contexts of all polls sharing it. Each poll keeps its
+ * own id, and removing it takes only its context out of the cycle. A cycle is started with
+ * the scheduler locked, and the work it hands back is dispatched once the scheduler is
+ * unlocked, so a cycle which waits does not hold up the other polls. A deadline at which
+ * the previous cycle of the poll is still running, or which passed while the thread was
+ * late, is skipped and counted as an overrun.
+ */
+
+#ifndef EDGE_POLL_SCHEDULER_H
+#define EDGE_POLL_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "opcua_common.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Starts one cycle of a poll. Called by the scheduler thread with the scheduler
+ *        locked, so it must neither call the scheduler nor wait.
+ * @param[in]  pollIds Ids of the polls sharing the cycle, the earliest added first. Their
+ *             contexts are merged in this order.
+ * @param[in]  pollCount Number of polls sharing the cycle.
+ * @param[in]  context Context of the cycle, merged from the contexts of the polls if they
+ *             are more than one.
+ * @param[out] job Work of the cycle, handed to the dispatch callback once the scheduler
+ *             is unlocked. NULL for none.
+ * @return @c true if the cycle started, false if the previous cycle is still running.
+ */
+typedef bool (*edge_poll_cycle_cb_t) (const uint32_t *pollIds, size_t pollCount,
+        void *context, void **job);
+
+/**
+ * @brief Dispatches the work of a cycle. Called by the scheduler thread without the lock,
+ *        so it may wait, but it must not call the scheduler.
+ * @param[in]  job Work of the cycle.
+ */
+typedef void (*edge_poll_dispatch_cb_t) (void *job);
+
+/**
+ * @brief Merges the contexts of polls which share a cycle. Both contexts stay owned by
+ *        the scheduler.
+ * @param[in]  context Context of the cycle.
+ * @param[in]  added Context of another poll.
+ * @return new context serving both, which the scheduler frees, NULL on failure.
+ */
+typedef void *(*edge_poll_merge_cb_t) (void *context, void *added);
+
+/**
+ * @brief Frees the context of a poll.
+ * @param[in]  context Context of the poll.
+ */
+typedef void (*edge_poll_free_cb_t) (void *context);
+
+/**
+ * @brief Registers the callbacks which start and dispatch the cycles, merge and free the
+ *        contexts of the polls.
+ * @param[in]  cycleCallback Callback for starting a cycle
+ * @param[in]  dispatchCallback Callback for the work of a cycle
+ * @param[in]  mergeCallback Callback for merging two contexts
+ * @param[in]  freeCallback Callback for freeing a context
+ */
+void registerEdgePollCallbacks(edge_poll_cycle_cb_t cycleCallback,
+        edge_poll_dispatch_cb_t dispatchCallback, edge_poll_merge_cb_t mergeCallback,
+        edge_poll_free_cb_t freeCallback);
+
+/**
+ * @brief Adds a poll whose first cycle starts at once. A poll with the same key and interval
+ *        as an existing one shares its cycle instead. Starts the scheduler thread if it is
+ *        not running.
+ * @remarks Ownership of context is transferred to the scheduler. On failure it is freed.
+ * @param[in]  key Key of the poll. It is copied.
+ * @param[in]  intervalMs Interval of the poll in milliseconds.
+ * @param[in]  context Context of the poll.
+ * @return id of the poll, 0 if a parameter is invalid or memory allocation failed.
+ */
+uint32_t addEdgePoll(const char *key, uint32_t intervalMs, void *context);
+
+/**
+ * @brief Removes a poll and frees its context. The other polls of its cycle keep running.
+ *        Stops the scheduler thread once no poll is left.
+ * @param[in]  pollId Id of the poll.
+ * @return @c true on success, false if there is no such poll.
+ */
+bool removeEdgePoll(uint32_t pollId);
+
+/**
+ * @brief Removes all polls and stops the scheduler thread.
+ */
+void removeAllEdgePolls(void);
+
+/**
+ * @brief Gets the counters of a poll, which are those of its cycle.
+ * @param[in]  pollId Id of the poll.
+ * @param[out] stats Counters of the poll.
+ * @return @c true on success, false if there is no such poll.
+ */
+bool getEdgePollStatistics(uint32_t pollId, EdgePollStatistics *stats);
+
+/**
+ * @brief Gets the deadline which follows a deadline that is due.
+ * @param[in]  deadline Deadline in microseconds.
+ * @param[in]  periodUs Interval between the deadlines in microseconds.
+ * @param[in]  now Current time in microseconds.
+ * @param[out] missed Number of deadlines after deadline which passed already. May be NULL.
+ * @return first deadline on the grid of deadline and periodUs which lies after now,
+ *         deadline if it lies after now.
+ */
+uint64_t getNextEdgePollDeadline(uint64_t deadline, uint64_t periodUs, uint64_t now,
+        uint64_t *missed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_POLL_SCHEDULER_H
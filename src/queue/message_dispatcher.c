@@ -20,14 +20,15 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #ifndef _WIN32
 #include <pthread.h>
 #include <unistd.h>
 #else
 #include "pthread.h"
+#include <windows.h>
 #endif
 
-#include "uqueue.h"
 #include "cacommon.h"
 #include "cathreadpool.h" /* for thread pool */
 #include "caqueueingthread.h"
@@ -35,9 +36,25 @@
 #include "edge_utils.h"
 #include "edge_malloc.h"
 #include "edge_logger.h"
+#include "edge_map.h"
 
 #define SINGLE_HANDLE
-#define MAX_THREAD_POOL_SIZE    20
+/* Pool workers left over after the send and receive threads, for short tasks. */
+#define SPARE_THREAD_POOL_SIZE  4
+#define MAX_SEND_WORKER_COUNT   16
+
+#define DEFAULT_SEND_QUEUE_CAPACITY     4096
+#define DEFAULT_RECV_QUEUE_CAPACITY     16384
+
+/* Lanes of the send queues. A lane is served this many times in a row while lower lanes wait. */
+#define SEND_LANE_HIGH                  0
+#define SEND_LANE_NORMAL                1
+#define SEND_LANE_BULK                  2
+#define SEND_LANE_COUNT                 3
+static const uint32_t SEND_LANE_WEIGHTS[SEND_LANE_COUNT] = { 8, 4, 1 };
+
+#define MAX_READ_BATCH_MESSAGES         64
+#define DEFAULT_READ_BATCH_MAX_NODES    1000
 
 #define TAG "message_handler"
 
@@ -45,17 +62,161 @@
 static ca_thread_pool_t g_threadPoolHandle = NULL;
 
 // message handler main thread
-static CAQueueingThread_t g_sendThread;
+// Send side is sharded by endpoint address and client session. Requests to one
+// session are always handled by the same thread, so they are processed in order.
+static CAQueueingThread_t g_sendThreads[MAX_SEND_WORKER_COUNT];
+static uint32_t g_sendWorkerCount = 0;
 static CAQueueingThread_t g_receiveThread;
 
 static response_cb_t g_responseCallback = NULL;
 static send_cb_t g_sendCallback = NULL;
+static send_batch_cb_t g_sendBatchCallback = NULL;
+static discard_cb_t g_discardCallback = NULL;
+static session_select_cb_t g_sessionSelectCallback = NULL;
+static session_release_cb_t g_sessionReleaseCallback = NULL;
+
+// READ requests held back by a send thread to be sent in one read service call.
+// Only touched by its send thread.
+typedef struct ReadBatch
+{
+    EdgeMessage *messages[MAX_READ_BATCH_MESSAGES];
+    size_t count;
+    size_t nodeCount;
+    uint64_t deadline;
+} ReadBatch;
+
+static ReadBatch g_readBatches[MAX_SEND_WORKER_COUNT];
+
+// Requests with one message_id which wait in the send queues, keyed by message_id.
+// A cancellation drops the ones queued up to then. The entry goes away with the last of them.
+typedef struct WaitingRequests
+{
+    uint32_t count;
+    uint64_t cancelledSequence;
+} WaitingRequests;
+
+static edgeMap *g_waitingRequests = NULL;
+static uint64_t g_queueSequence = 0;
+static pthread_mutex_t g_cancelMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Queued WRITE requests to one node, keyed by endpoint and node, while writes are coalesced.
+// A request is superseded if a newer one to the node was queued before it is sent, unless a
+// read of the node or a method call to the endpoint was queued in between. The entry goes
+// away with the last of its requests.
+typedef struct PendingWrite
+{
+    uint32_t newest;
+    uint32_t pending;
+    // Newest write queued before a read or method call. It and the older ones are kept.
+    uint32_t fence;
+} PendingWrite;
+
+static edgeMap *g_pendingWrites = NULL;
+static uint32_t g_writeSequence = 0;
+static pthread_mutex_t g_pendingWriteMutex = PTHREAD_MUTEX_INITIALIZER;
+static volatile bool g_coalesceWrites = false;
+
+// Read, write, method, browse and stop requests of one endpoint in the send queues, keyed by
+// endpoint address. A stop waits until the ones queued before it are done on every send
+// thread and lane. The requests queued after a stop are held, in order, until it is done.
+typedef struct EndpointWork
+{
+    uint32_t pending;
+    EdgeMessage **held;
+    size_t heldCount;
+    size_t heldCapacity;
+    // Set while a stop is queued.
+    bool stopping;
+    // Set while a pool task queues the held requests.
+    bool releasing;
+} EndpointWork;
+
+static edgeMap *g_endpointWork = NULL;
+static pthread_mutex_t g_endpointWorkMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Wait and processing time per command, recorded by one queueing thread.
+// The mutex is only contended while the statistics are read.
+typedef struct QueueStatistics
+{
+    pthread_mutex_t mutex;
+    EdgeLatencyHistogram wait[EDGE_STATISTICS_COMMAND_COUNT];
+    EdgeLatencyHistogram service[EDGE_STATISTICS_COMMAND_COUNT];
+} QueueStatistics;
+
+// One per send thread followed by one for the receive thread. NULL when not collected.
+static QueueStatistics *g_queueStatistics = NULL;
+static uint32_t g_queueStatisticsCount = 0;
 
 static pthread_mutex_t g_queueingThreadMutex = PTHREAD_MUTEX_INITIALIZER;
 static bool g_queueingThreadInitialized = false;
 
+static uint32_t g_configuredSendWorkerCount = 0;
+static uint32_t g_sendQueueCapacity = DEFAULT_SEND_QUEUE_CAPACITY;
+static CAQueueOverflowPolicy_t g_sendQueuePolicy = CA_QUEUE_OVERFLOW_REJECT;
+static uint32_t g_recvQueueCapacity = DEFAULT_RECV_QUEUE_CAPACITY;
+static CAQueueOverflowPolicy_t g_recvQueuePolicy = CA_QUEUE_OVERFLOW_BLOCK;
+static uint32_t g_readBatchWindowMs = 0;
+static uint32_t g_readBatchMaxNodes = DEFAULT_READ_BATCH_MAX_NODES;
+static bool g_collectStatistics = false;
+
 static void handleMessage(EdgeMessage *data);
+static void freeQueuedMessage(EdgeMessage *msg);
+static bool addToQueue(CAQueueingThread_t *thread, uint32_t lane, EdgeMessage *msg);
+static uint32_t getSendLane(EdgeMessage *msg);
+static void deleteEndpointWork();
 static void destroyData(void *data, uint32_t size);
+static void dropRequest(void *data, uint32_t size);
+
+static void freeQueueStatistics()
+{
+    if (NULL == g_queueStatistics)
+    {
+        return;
+    }
+    for (uint32_t i = 0; i < g_queueStatisticsCount; i++)
+    {
+        pthread_mutex_destroy(&g_queueStatistics[i].mutex);
+    }
+    EdgeFree(g_queueStatistics);
+    g_queueStatistics = NULL;
+    g_queueStatisticsCount = 0;
+}
+
+static bool createQueueStatistics(uint32_t count)
+{
+    g_queueStatistics = (QueueStatistics *) EdgeCalloc(count, sizeof(QueueStatistics));
+    VERIFY_NON_NULL_MSG(g_queueStatistics, "EdgeCalloc FAILED for queue statistics\n", false);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        pthread_mutex_init(&g_queueStatistics[i].mutex, NULL);
+    }
+    g_queueStatisticsCount = count;
+    return true;
+}
+
+static void recordQueueStatistics(void *data, uint64_t waitUs, uint64_t serviceUs, void *context)
+{
+    EdgeMessage *msg = (EdgeMessage *) data;
+    QueueStatistics *stats = (QueueStatistics *) context;
+    // Reports do not carry a command.
+    EdgeCommand command = (REPORT == msg->type) ? CMD_SUB : msg->command;
+    if ((uint32_t) command >= EDGE_STATISTICS_COMMAND_COUNT)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&stats->mutex);
+    recordEdgeLatency(&stats->wait[command], waitUs);
+    recordEdgeLatency(&stats->service[command], serviceUs);
+    pthread_mutex_unlock(&stats->mutex);
+}
+
+static void getQueueStatistics(CAQueueingThread_t *thread, EdgeQueueStatistics *stats)
+{
+    stats->depth = CAQueueingThreadGetSize(thread);
+    stats->highWaterMark = CAQueueingThreadGetHighWaterMark(thread);
+    stats->droppedCount = thread->droppedCount;
+}
 
 void delete_queue()
 {
@@ -66,12 +227,21 @@ void delete_queue()
             "pthread_mutex_lock() returned (%d)\n.", ret);
         exit(ret);
     }
+    if (!g_queueingThreadInitialized)
+    {
+        // Deleted already by the disconnection of another endpoint.
+        pthread_mutex_unlock(&g_queueingThreadMutex);
+        return;
+    }
 
     // stop thread
     // delete thread data
-    if (NULL != g_sendThread.threadMutex)
+    for (uint32_t i = 0; i < g_sendWorkerCount; i++)
     {
-        CAQueueingThreadStop(&g_sendThread);
+        if (NULL != g_sendThreads[i].threadMutex)
+        {
+            CAQueueingThreadStop(&g_sendThreads[i]);
+        }
     }
 
     // stop thread
@@ -87,9 +257,29 @@ void delete_queue()
         ca_thread_pool_free(g_threadPoolHandle);
         g_threadPoolHandle = NULL;
     }
+    deleteEndpointWork();
 
-    CAQueueingThreadDestroy(&g_sendThread);
+    for (uint32_t i = 0; i < g_sendWorkerCount; i++)
+    {
+        if (NULL != g_sendThreads[i].threadMutex)
+        {
+            CAQueueingThreadDestroy(&g_sendThreads[i]);
+        }
+    }
+    for (uint32_t i = 0; i < g_sendWorkerCount; i++)
+    {
+        // The held READ requests are dropped like the ones left in the queue.
+        ReadBatch *batch = &g_readBatches[i];
+        for (size_t j = 0; j < batch->count; j++)
+        {
+            freeQueuedMessage(batch->messages[j]);
+        }
+        batch->count = 0;
+        batch->nodeCount = 0;
+    }
     CAQueueingThreadDestroy(&g_receiveThread);
+    freeQueueStatistics();
+    g_sendWorkerCount = 0;
 
     g_queueingThreadInitialized = false;
 
@@ -102,9 +292,688 @@ void delete_queue()
     }
 }
 
+// Start, stop, subscription and the other requests which change the state of an endpoint.
+static bool isControlCommand(EdgeCommand command)
+{
+    switch (command)
+    {
+        case CMD_READ:
+        case CMD_READ_SAMPLING_INTERVAL:
+        case CMD_WRITE:
+        case CMD_METHOD:
+        case CMD_BROWSE:
+        case CMD_BROWSE_VIEW:
+            return false;
+        default:
+            return true;
+    }
+}
+
+static uint32_t getSendThreadIndex(EdgeMessage *msg)
+{
+    if (g_sendWorkerCount <= 1 || NULL == msg->endpointInfo
+        || NULL == msg->endpointInfo->endpointUri)
+    {
+        return 0;
+    }
+
+    // The control requests of an endpoint share one send thread, whatever their session.
+    uint32_t sessionIndex = isControlCommand(msg->command) ? 0 : msg->sessionIndex;
+    return (msg->endpointHash + sessionIndex) % g_sendWorkerCount;
+}
+
+static bool isEndpointRequest(EdgeMessage *msg)
+{
+    return (SEND_REQUEST == msg->type || SEND_REQUESTS == msg->type)
+        && NULL != msg->endpointInfo && NULL != msg->endpointInfo->endpointUri;
+}
+
+// Called with g_endpointWorkMutex held. NULL if there is none and create is false.
+static EndpointWork *getEndpointWork(const char *endpointUri, bool create)
+{
+    if (NULL == g_endpointWork && create)
+    {
+        g_endpointWork = createStringMap();
+    }
+    if (NULL == g_endpointWork)
+    {
+        return NULL;
+    }
+
+    EndpointWork *work = (EndpointWork *) getMapElement(g_endpointWork, (keyValue) endpointUri);
+    if (NULL != work || !create)
+    {
+        return work;
+    }
+
+    work = (EndpointWork *) EdgeCalloc(1, sizeof(EndpointWork));
+    char *key = cloneString(endpointUri);
+    if (NULL == work || NULL == key
+        || !insertMapElement(g_endpointWork, (keyValue) key, (keyValue) work))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed for the endpoint requests.");
+        EdgeFree(work);
+        EdgeFree(key);
+        return NULL;
+    }
+    return work;
+}
+
+// Called with g_endpointWorkMutex held. The entry goes away once it is not needed.
+static void removeIdleEndpointWork(const char *endpointUri, EndpointWork *work)
+{
+    if (0 != work->pending || 0 != work->heldCount || work->releasing)
+    {
+        return;
+    }
+    keyValue removedKey = NULL;
+    removeMapElement(g_endpointWork, (keyValue) endpointUri, &removedKey, NULL);
+    EdgeFree(removedKey);
+    EdgeFree(work->held);
+    EdgeFree(work);
+}
+
+// Called with g_endpointWorkMutex held.
+static bool holdEndpointRequest(EndpointWork *work, EdgeMessage *msg)
+{
+    if (work->heldCount == work->heldCapacity)
+    {
+        size_t capacity = (0 == work->heldCapacity) ? 8 : work->heldCapacity * 2;
+        EdgeMessage **held = (EdgeMessage **) EdgeRealloc(work->held,
+                capacity * sizeof(EdgeMessage *));
+        VERIFY_NON_NULL_MSG(held, "Memory allocation failed for the held requests.", false);
+        work->held = held;
+        work->heldCapacity = capacity;
+    }
+    work->held[work->heldCount++] = msg;
+    return true;
+}
+
+// Called with g_endpointWorkMutex held. Whether msg has to wait for the queued requests.
+static bool mustWaitForEndpoint(EndpointWork *work, EdgeMessage *msg)
+{
+    return work->stopping || (CMD_STOP_CLIENT == msg->command && work->pending > 0);
+}
+
+// Called with g_endpointWorkMutex held, before msg is queued.
+static void countEndpointRequest(EndpointWork *work, EdgeMessage *msg)
+{
+    if (CMD_STOP_CLIENT == msg->command)
+    {
+        work->stopping = true;
+    }
+    else if (isControlCommand(msg->command))
+    {
+        // Kept in order by the send thread of the control requests.
+        return;
+    }
+    work->pending++;
+    msg->endpointCounted = 1;
+}
+
+/**
+ * @brief releaseEndpointRequests - Queues the requests held behind a stop, in order, up to
+ * the next stop.
+ * Runs as a pool task, as the queues may block.
+ */
+static void releaseEndpointRequests(void *context)
+{
+    char *endpointUri = (char *) context;
+    while (true)
+    {
+        pthread_mutex_lock(&g_endpointWorkMutex);
+        EndpointWork *work = getEndpointWork(endpointUri, false);
+        if (NULL == work)
+        {
+            pthread_mutex_unlock(&g_endpointWorkMutex);
+            break;
+        }
+        EdgeMessage *msg = (work->heldCount > 0) ? work->held[0] : NULL;
+        if (NULL == msg || mustWaitForEndpoint(work, msg))
+        {
+            work->releasing = false;
+            removeIdleEndpointWork(endpointUri, work);
+            pthread_mutex_unlock(&g_endpointWorkMutex);
+            break;
+        }
+        memmove(work->held, work->held + 1, (work->heldCount - 1) * sizeof(EdgeMessage *));
+        work->heldCount--;
+        countEndpointRequest(work, msg);
+        pthread_mutex_unlock(&g_endpointWorkMutex);
+
+        addToQueue(&g_sendThreads[getSendThreadIndex(msg)], getSendLane(msg), msg);
+    }
+    EdgeFree(endpointUri);
+}
+
+/**
+ * @brief trackEndpointRequest - Counts the request in the requests of its endpoint, or holds
+ * it back while a stop waits for the requests queued before it or is queued itself.
+ * Returns true if the request is held.
+ */
+static bool trackEndpointRequest(EdgeMessage *msg)
+{
+    if (!isEndpointRequest(msg))
+    {
+        return false;
+    }
+
+    bool held = false;
+    pthread_mutex_lock(&g_endpointWorkMutex);
+    EndpointWork *work = getEndpointWork(msg->endpointInfo->endpointUri, true);
+    if (NULL != work)
+    {
+        if (work->heldCount > 0 || work->releasing || mustWaitForEndpoint(work, msg))
+        {
+            held = holdEndpointRequest(work, msg);
+        }
+        else
+        {
+            countEndpointRequest(work, msg);
+        }
+        removeIdleEndpointWork(msg->endpointInfo->endpointUri, work);
+    }
+    pthread_mutex_unlock(&g_endpointWorkMutex);
+    return held;
+}
+
+// The held requests are released once the stop or the last request a stop waits for is done.
+static void untrackEndpointRequest(EdgeMessage *msg)
+{
+    const char *endpointUri = msg->endpointInfo->endpointUri;
+    char *context = NULL;
+    pthread_mutex_lock(&g_endpointWorkMutex);
+    EndpointWork *work = getEndpointWork(endpointUri, false);
+    if (NULL != work && CMD_STOP_CLIENT == msg->command)
+    {
+        work->stopping = false;
+    }
+    if (NULL != work && work->pending > 0 && 0 == --work->pending)
+    {
+        if (work->heldCount > 0 && !work->releasing)
+        {
+            context = cloneString(endpointUri);
+            work->releasing = (NULL != context);
+        }
+        removeIdleEndpointWork(endpointUri, work);
+    }
+    pthread_mutex_unlock(&g_endpointWorkMutex);
+    msg->endpointCounted = 0;
+
+    if (NULL != context && CA_STATUS_OK != ca_thread_pool_add_task(g_threadPoolHandle,
+            releaseEndpointRequests, context, NULL))
+    {
+        EDGE_LOG(TAG, "Failed to add the task releasing the held requests.");
+        releaseEndpointRequests(context);
+    }
+}
+
+// The requests held behind a stop are dropped like the ones left in the queues.
+static void deleteEndpointWork()
+{
+    pthread_mutex_lock(&g_endpointWorkMutex);
+    edgeMap *map = g_endpointWork;
+    g_endpointWork = NULL;
+    pthread_mutex_unlock(&g_endpointWorkMutex);
+    if (NULL == map)
+    {
+        return;
+    }
+
+    for (edgeMapNode *node = map->head; NULL != node; node = node->next)
+    {
+        EndpointWork *work = (EndpointWork *) node->value;
+        for (size_t i = 0; i < work->heldCount; i++)
+        {
+            freeQueuedMessage(work->held[i]);
+        }
+        EdgeFree(work->held);
+        EdgeFree(work);
+        EdgeFree(node->key);
+    }
+    deleteMap(map);
+    EdgeFree(map);
+}
+
+static bool isCoalescableWrite(EdgeMessage *msg)
+{
+    return CMD_WRITE == msg->command && SEND_REQUESTS == msg->type && NULL != msg->requests
+        && 1 == msg->requestLength && NULL != msg->requests[0]
+        && NULL != msg->requests[0]->nodeInfo && NULL != msg->requests[0]->nodeInfo->nodeId
+        && NULL != msg->endpointInfo && NULL != msg->endpointInfo->endpointUri;
+}
+
+// Key of the endpoint and node of a request, for the caller to free.
+static char *makeNodeKey(const EdgeMessage *msg, const EdgeRequest *request)
+{
+    const EdgeNodeInfo *nodeInfo = request->nodeInfo;
+    const char *identifier = nodeInfo->valueAlias ? nodeInfo->valueAlias : nodeInfo->nodeId->nodeId;
+    const char *format = "%s;%u;%d;%d;%s";
+    int length = snprintf(NULL, 0, format, msg->endpointInfo->endpointUri,
+            nodeInfo->nodeId->nameSpace, nodeInfo->nodeId->type, nodeInfo->nodeId->integerNodeId,
+            identifier ? identifier : "");
+    char *key = (length < 0) ? NULL : (char *) EdgeMalloc((size_t) length + 1);
+    if (NULL != key)
+    {
+        snprintf(key, (size_t) length + 1, format, msg->endpointInfo->endpointUri,
+                nodeInfo->nodeId->nameSpace, nodeInfo->nodeId->type,
+                nodeInfo->nodeId->integerNodeId, identifier ? identifier : "");
+    }
+    return key;
+}
+
+// Key of the endpoint and node of a coalescable write, for the caller to free.
+static char *makePendingWriteKey(EdgeMessage *msg)
+{
+    return makeNodeKey(msg, msg->requests[0]);
+}
+
+// Makes msg the newest queued write to its node. msg is sent without coalescing on failure.
+static void addPendingWrite(EdgeMessage *msg)
+{
+    char *key = makePendingWriteKey(msg);
+    VERIFY_NON_NULL_NR_MSG(key, "Memory allocation failed for the pending write.");
+
+    pthread_mutex_lock(&g_pendingWriteMutex);
+    if (NULL == g_pendingWrites)
+    {
+        g_pendingWrites = createStringMap();
+    }
+    PendingWrite *write = (NULL == g_pendingWrites) ? NULL
+        : (PendingWrite *) getMapElement(g_pendingWrites, (keyValue) key);
+    if (NULL == write && NULL != g_pendingWrites)
+    {
+        write = (PendingWrite *) EdgeCalloc(1, sizeof(PendingWrite));
+        if (NULL != write && insertMapElement(g_pendingWrites, (keyValue) key, (keyValue) write))
+        {
+            key = NULL;
+        }
+        else
+        {
+            EdgeFree(write);
+            write = NULL;
+        }
+    }
+    if (NULL != write)
+    {
+        if (0 == ++g_writeSequence)
+        {
+            g_writeSequence = 1;
+        }
+        write->newest = g_writeSequence;
+        write->pending++;
+        msg->writeSequence = g_writeSequence;
+    }
+    pthread_mutex_unlock(&g_pendingWriteMutex);
+    EdgeFree(key);
+}
+
+static bool isSupersededWrite(EdgeMessage *msg)
+{
+    if (0 == msg->writeSequence)
+    {
+        return false;
+    }
+    char *key = makePendingWriteKey(msg);
+    VERIFY_NON_NULL_MSG(key, "Memory allocation failed for the pending write.", false);
+
+    pthread_mutex_lock(&g_pendingWriteMutex);
+    PendingWrite *write = (PendingWrite *) getMapElement(g_pendingWrites, (keyValue) key);
+    bool superseded = (NULL != write && write->newest != msg->writeSequence
+            && msg->writeSequence > write->fence);
+    pthread_mutex_unlock(&g_pendingWriteMutex);
+    EdgeFree(key);
+    return superseded;
+}
+
+static void removePendingWrite(EdgeMessage *msg)
+{
+    char *key = makePendingWriteKey(msg);
+    VERIFY_NON_NULL_NR_MSG(key, "Memory allocation failed for the pending write.");
+
+    pthread_mutex_lock(&g_pendingWriteMutex);
+    PendingWrite *write = (PendingWrite *) getMapElement(g_pendingWrites, (keyValue) key);
+    if (NULL != write && 0 == --write->pending)
+    {
+        keyValue removedKey = NULL;
+        removeMapElement(g_pendingWrites, (keyValue) key, &removedKey, NULL);
+        EdgeFree(removedKey);
+        EdgeFree(write);
+    }
+    pthread_mutex_unlock(&g_pendingWriteMutex);
+    EdgeFree(key);
+    msg->writeSequence = 0;
+}
+
+static bool isWriteFence(const EdgeMessage *msg)
+{
+    return (CMD_READ == msg->command || CMD_READ_SAMPLING_INTERVAL == msg->command
+            || CMD_METHOD == msg->command) && NULL != msg->endpointInfo
+        && NULL != msg->endpointInfo->endpointUri;
+}
+
+// Keeps the queued writes to the node of a request from being superseded. Called with the lock.
+static void fenceNodeWrites(const EdgeMessage *msg, const EdgeRequest *request)
+{
+    if (NULL == request || NULL == request->nodeInfo || NULL == request->nodeInfo->nodeId)
+    {
+        return;
+    }
+    char *key = makeNodeKey(msg, request);
+    PendingWrite *write = (NULL == key) ? NULL
+        : (PendingWrite *) getMapElement(g_pendingWrites, (keyValue) key);
+    if (NULL != write)
+    {
+        write->fence = write->newest;
+    }
+    EdgeFree(key);
+}
+
+// Keeps the writes queued before a read of their node from being superseded, so the read sees
+// them. A method call may act on any node, so it keeps all queued writes to its endpoint.
+static void fencePendingWrites(const EdgeMessage *msg)
+{
+    pthread_mutex_lock(&g_pendingWriteMutex);
+    if (NULL == g_pendingWrites || 0 == getMapSize(g_pendingWrites))
+    {
+        pthread_mutex_unlock(&g_pendingWriteMutex);
+        return;
+    }
+    if (CMD_METHOD == msg->command)
+    {
+        const char *endpointUri = msg->endpointInfo->endpointUri;
+        size_t length = strlen(endpointUri);
+        for (edgeMapNode *node = g_pendingWrites->head; NULL != node; node = node->next)
+        {
+            const char *key = (const char *) node->key;
+            if (0 == strncmp(key, endpointUri, length) && ';' == key[length])
+            {
+                PendingWrite *write = (PendingWrite *) node->value;
+                write->fence = write->newest;
+            }
+        }
+    }
+    else if (SEND_REQUEST == msg->type)
+    {
+        fenceNodeWrites(msg, msg->request);
+    }
+    else
+    {
+        for (size_t i = 0; NULL != msg->requests && i < msg->requestLength; i++)
+        {
+            fenceNodeWrites(msg, msg->requests[i]);
+        }
+    }
+    pthread_mutex_unlock(&g_pendingWriteMutex);
+}
+
+// Stamps the request with the order it is queued in, for the cancellations to find it.
+static void trackWaitingRequest(EdgeMessage *msg)
+{
+    pthread_mutex_lock(&g_cancelMutex);
+    if (NULL == g_waitingRequests)
+    {
+        g_waitingRequests = createMap();
+    }
+    keyValue key = (keyValue) (uintptr_t) msg->message_id;
+    WaitingRequests *waiting = (NULL == g_waitingRequests) ? NULL
+        : (WaitingRequests *) getMapElement(g_waitingRequests, key);
+    if (NULL == waiting && NULL != g_waitingRequests)
+    {
+        waiting = (WaitingRequests *) EdgeCalloc(1, sizeof(WaitingRequests));
+        if (NULL != waiting && !insertMapElement(g_waitingRequests, key, (keyValue) waiting))
+        {
+            EdgeFree(waiting);
+            waiting = NULL;
+        }
+    }
+    if (NULL != waiting)
+    {
+        waiting->count++;
+        msg->queueSequence = ++g_queueSequence;
+    }
+    else
+    {
+        EDGE_LOG(TAG, "Memory allocation failed for the waiting requests.");
+    }
+    pthread_mutex_unlock(&g_cancelMutex);
+}
+
+// The request can not be cancelled any more once it is being sent.
+static void untrackWaitingRequest(EdgeMessage *msg)
+{
+    if (0 == msg->queueSequence)
+    {
+        return;
+    }
+
+    keyValue key = (keyValue) (uintptr_t) msg->message_id;
+    WaitingRequests *waiting = NULL;
+    pthread_mutex_lock(&g_cancelMutex);
+    if (NULL != g_waitingRequests)
+    {
+        waiting = (WaitingRequests *) getMapElement(g_waitingRequests, key);
+    }
+    if (NULL != waiting && 0 == --waiting->count)
+    {
+        removeMapElement(g_waitingRequests, key, NULL, NULL);
+        EdgeFree(waiting);
+        if (0 == getMapSize(g_waitingRequests))
+        {
+            deleteMap(g_waitingRequests);
+            EdgeFree(g_waitingRequests);
+            g_waitingRequests = NULL;
+        }
+    }
+    pthread_mutex_unlock(&g_cancelMutex);
+    msg->queueSequence = 0;
+}
+
+// Gives back the client session chosen for the request when it was queued, and frees it.
+static void freeQueuedMessage(EdgeMessage *msg)
+{
+    if (0 != msg->writeSequence)
+    {
+        removePendingWrite(msg);
+    }
+    if (0 != msg->endpointCounted)
+    {
+        untrackEndpointRequest(msg);
+    }
+    untrackWaitingRequest(msg);
+    if (NULL != g_sessionReleaseCallback
+        && (SEND_REQUEST == msg->type || SEND_REQUESTS == msg->type))
+    {
+        g_sessionReleaseCallback(msg);
+    }
+    freeEdgeMessage(msg);
+}
+
+static bool isBatchableRead(EdgeMessage *msg)
+{
+    return (CMD_READ == msg->command || CMD_READ_SAMPLING_INTERVAL == msg->command)
+        && !msg->sendImmediately && NULL == msg->arena
+        && SEND_REQUESTS == msg->type && NULL != msg->requests && msg->requestLength > 0
+        && msg->requestLength < g_readBatchMaxNodes
+        && NULL != msg->endpointInfo && NULL != msg->endpointInfo->endpointUri;
+}
+
+static bool isCancelledRequest(EdgeMessage *msg)
+{
+    if (0 == msg->queueSequence)
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&g_cancelMutex);
+    WaitingRequests *waiting = (NULL == g_waitingRequests) ? NULL
+        : (WaitingRequests *) getMapElement(g_waitingRequests,
+                (keyValue) (uintptr_t) msg->message_id);
+    bool cancelled = (NULL != waiting && msg->queueSequence <= waiting->cancelledSequence);
+    pthread_mutex_unlock(&g_cancelMutex);
+    return cancelled;
+}
+
+/**
+ * Reports the request through the discard callback if it is cancelled or its deadline passed.
+ * Returns true if the request must not be sent.
+ */
+static bool discardStaleRequest(EdgeMessage *msg)
+{
+    const char *reason = NULL;
+    EdgeStatusCode code = STATUS_ERROR;
+    if (isCancelledRequest(msg))
+    {
+        reason = "Request is cancelled.";
+    }
+    else if (isSupersededWrite(msg))
+    {
+        reason = "Write is superseded by a newer one to the node.";
+        code = STATUS_WRITE_SUPERSEDED;
+    }
+    else if (0 != msg->deadline && oc_get_monotonic_time_us() >= msg->deadline)
+    {
+        reason = "Request deadline expired.";
+    }
+    else
+    {
+        return false;
+    }
+
+    EDGE_LOG_V(TAG, "Message(%u) is dropped. %s\n", msg->message_id, reason);
+    if (NULL != g_discardCallback)
+    {
+        g_discardCallback(msg, code, reason);
+    }
+    return true;
+}
+
+static void flushReadBatch(ReadBatch *batch)
+{
+    // Requests may have been cancelled or expired while they were held.
+    size_t kept = 0;
+    for (size_t i = 0; i < batch->count; i++)
+    {
+        if (discardStaleRequest(batch->messages[i]))
+        {
+            freeQueuedMessage(batch->messages[i]);
+        }
+        else
+        {
+            batch->messages[kept++] = batch->messages[i];
+        }
+    }
+    batch->count = kept;
+
+    if (0 == batch->count)
+    {
+        batch->nodeCount = 0;
+        return;
+    }
+
+    if (1 == batch->count)
+    {
+        handleMessage(batch->messages[0]);
+    }
+    else
+    {
+        for (size_t i = 0; i < batch->count; i++)
+        {
+            untrackWaitingRequest(batch->messages[i]);
+        }
+        g_sendBatchCallback(batch->messages, batch->count);
+    }
+
+    for (size_t i = 0; i < batch->count; i++)
+    {
+        freeQueuedMessage(batch->messages[i]);
+    }
+    batch->count = 0;
+    batch->nodeCount = 0;
+}
+
+/**
+ * Holds the READ request back in the batch of the send thread.
+ * Returns false if msg is not taken. The batch is flushed before msg is taken or
+ * refused, so the requests to an endpoint are still sent in order.
+ */
+static bool addToReadBatch(ReadBatch *batch, EdgeMessage *msg)
+{
+    if (!isBatchableRead(msg))
+    {
+        flushReadBatch(batch);
+        return false;
+    }
+
+    uint64_t now = oc_get_monotonic_time_us();
+    if (batch->count > 0)
+    {
+        EdgeMessage *first = batch->messages[0];
+        if (first->command != msg->command || first->sessionIndex != msg->sessionIndex
+            || batch->nodeCount + msg->requestLength > g_readBatchMaxNodes
+            || now >= batch->deadline
+            || 0 != strcmp(first->endpointInfo->endpointUri, msg->endpointInfo->endpointUri))
+        {
+            flushReadBatch(batch);
+        }
+    }
+
+    // The queue destroys msg after this returns, so the batch takes a moved copy.
+    EdgeMessage *held = moveEdgeMessage(msg);
+    if (NULL == held)
+    {
+        EDGE_LOG(TAG, "Failed to move the message into the read batch.");
+        flushReadBatch(batch);
+        return false;
+    }
+
+    if (0 == batch->count)
+    {
+        batch->deadline = now + (uint64_t) g_readBatchWindowMs * 1000;
+    }
+    batch->messages[batch->count++] = held;
+    batch->nodeCount += held->requestLength;
+
+    if (MAX_READ_BATCH_MESSAGES == batch->count || batch->nodeCount >= g_readBatchMaxNodes)
+    {
+        flushReadBatch(batch);
+    }
+    return true;
+}
+
+// Invoked by the send thread when its queue is empty.
+static uint64_t readBatchIdle(void *context)
+{
+    ReadBatch *batch = (ReadBatch *) context;
+    if (0 == batch->count)
+    {
+        return 0;
+    }
+
+    uint64_t now = oc_get_monotonic_time_us();
+    if (now >= batch->deadline)
+    {
+        flushReadBatch(batch);
+        return 0;
+    }
+    return batch->deadline - now;
+}
+
 static void sendQ_run(void *ptr)
 {
     EdgeMessage *data = (EdgeMessage *) ptr;
+    if (discardStaleRequest(data))
+    {
+        return;
+    }
+
+    if (g_readBatchWindowMs > 0 && NULL != g_sendBatchCallback)
+    {
+        if (addToReadBatch(&g_readBatches[getSendThreadIndex(data)], data))
+        {
+            return;
+        }
+    }
     handleMessage(data);
 }
 
@@ -114,16 +983,100 @@ static void recvQ_run(void *ptr)
     handleMessage(data);
 }
 
-bool add_to_sendQ(EdgeMessage *msg)
+static bool addToQueue(CAQueueingThread_t *thread, uint32_t lane, EdgeMessage *msg)
 {
-    CAQueueingThreadAddData(&g_sendThread, msg, sizeof(EdgeMessage));
+    VERIFY_NON_NULL_MSG(msg, "msg is NULL.", false);
+    if (NULL == thread->dataQueues[0])
+    {
+        EDGE_LOG(TAG, "Queue is not initialized.");
+        freeQueuedMessage(msg);
+        return false;
+    }
+
+    CAResult_t res = CAQueueingThreadAddDataToLane(thread, lane, msg, sizeof(EdgeMessage));
+    if (CA_STATUS_OK != res)
+    {
+        EDGE_LOG_V(TAG, "Failed to add message(%u) to the queue. (%d)\n", msg->message_id, res);
+        freeQueuedMessage(msg);
+        return false;
+    }
     return true;
 }
 
+static uint32_t getSendLane(EdgeMessage *msg)
+{
+    // The control requests of an endpoint share one lane of one send thread, so they run
+    // in the order they are queued. A stop also waits for the other requests queued before
+    // it, see trackEndpointRequest().
+    if (isControlCommand(msg->command))
+    {
+        return SEND_LANE_HIGH;
+    }
+
+    switch (msg->priority)
+    {
+        case EDGE_MESSAGE_PRIORITY_HIGH:
+            return SEND_LANE_HIGH;
+        case EDGE_MESSAGE_PRIORITY_NORMAL:
+            return SEND_LANE_NORMAL;
+        case EDGE_MESSAGE_PRIORITY_BULK:
+            return SEND_LANE_BULK;
+        default:
+            break;
+    }
+
+    switch (msg->command)
+    {
+        case CMD_WRITE:
+        case CMD_METHOD:
+            return SEND_LANE_NORMAL;
+        case CMD_READ:
+        case CMD_READ_SAMPLING_INTERVAL:
+        case CMD_BROWSE:
+        case CMD_BROWSE_VIEW:
+        default:
+            return SEND_LANE_BULK;
+    }
+}
+
+bool add_to_sendQ(EdgeMessage *msg)
+{
+    VERIFY_NON_NULL_MSG(msg, "msg is NULL.", false);
+    if (0 == msg->endpointHash && NULL != msg->endpointInfo
+        && NULL != msg->endpointInfo->endpointUri)
+    {
+        msg->endpointHash = hashEndpointAddress(msg->endpointInfo->endpointUri);
+    }
+    if (NULL != g_sessionSelectCallback)
+    {
+        msg->sessionIndex = g_sessionSelectCallback(msg);
+    }
+    if (msg->timeoutMs > 0 && 0 == msg->deadline)
+    {
+        msg->deadline = oc_get_monotonic_time_us() + (uint64_t) msg->timeoutMs * 1000;
+    }
+    if (g_coalesceWrites && 0 == msg->writeSequence && isCoalescableWrite(msg))
+    {
+        addPendingWrite(msg);
+    }
+    else if (g_coalesceWrites && isWriteFence(msg))
+    {
+        fencePendingWrites(msg);
+    }
+    if (SEND_REQUEST == msg->type || SEND_REQUESTS == msg->type)
+    {
+        trackWaitingRequest(msg);
+    }
+    if (trackEndpointRequest(msg))
+    {
+        return true;
+    }
+    return addToQueue(&g_sendThreads[getSendThreadIndex(msg)], getSendLane(msg), msg);
+}
+
 bool add_to_recvQ(EdgeMessage *msg)
 {
-    CAQueueingThreadAddData(&g_receiveThread, msg, sizeof(EdgeMessage));
-    return true;
+    return addToQueue(&g_receiveThread, 0, msg);
 }
 
 static void handleMessage(EdgeMessage *data)
@@ -131,6 +1084,7 @@ static void handleMessage(EdgeMessage *data)
     if (SEND_REQUEST == data->type || SEND_REQUESTS == data->type)
     {
         // Invoke callback to send request.
+        untrackWaitingRequest(data);
         g_sendCallback(data);
     }
     else if (GENERAL_RESPONSE == data->type || BROWSE_RESPONSE == data->type || REPORT == data->type
@@ -141,6 +1095,192 @@ static void handleMessage(EdgeMessage *data)
     }
 }
 
+static CAQueueOverflowPolicy_t toQueueOverflowPolicy(EdgeQueueOverflowPolicy policy,
+        CAQueueOverflowPolicy_t defaultPolicy)
+{
+    switch (policy)
+    {
+        case EDGE_QUEUE_OVERFLOW_BLOCK:
+            return CA_QUEUE_OVERFLOW_BLOCK;
+        case EDGE_QUEUE_OVERFLOW_DROP_OLDEST:
+            return CA_QUEUE_OVERFLOW_DROP_OLDEST;
+        case EDGE_QUEUE_OVERFLOW_REJECT:
+            return CA_QUEUE_OVERFLOW_REJECT;
+        default:
+            return defaultPolicy;
+    }
+}
+
+static uint32_t getDefaultSendWorkerCount()
+{
+    long count = 1;
+#ifndef _WIN32
+    count = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+    count = (long) sysInfo.dwNumberOfProcessors;
+#endif
+    return (count > 0) ? (uint32_t) count : 1;
+}
+
+void configure_send_workers(uint32_t workerCount)
+{
+    int ret = pthread_mutex_lock(&g_queueingThreadMutex);
+    if(ret != 0)
+    {
+        EDGE_LOG_V(TAG, "Failed to lock the queueing thread mutex. "
+            "pthread_mutex_lock() returned (%d)\n.", ret);
+        exit(ret);
+    }
+
+    g_configuredSendWorkerCount = workerCount;
+
+    ret = pthread_mutex_unlock(&g_queueingThreadMutex);
+    if(ret != 0)
+    {
+        EDGE_LOG_V(TAG, "Failed to unlock the queueing thread mutex. "
+            "pthread_mutex_unlock() returned (%d)\n.", ret);
+        exit(ret);
+    }
+}
+
+void configure_queue(uint32_t sendCapacity, EdgeQueueOverflowPolicy sendPolicy,
+        uint32_t recvCapacity, EdgeQueueOverflowPolicy recvPolicy)
+{
+    int ret = pthread_mutex_lock(&g_queueingThreadMutex);
+    if(ret != 0)
+    {
+        EDGE_LOG_V(TAG, "Failed to lock the queueing thread mutex. "
+            "pthread_mutex_lock() returned (%d)\n.", ret);
+        exit(ret);
+    }
+
+    g_sendQueueCapacity = (sendCapacity > 0) ? sendCapacity : DEFAULT_SEND_QUEUE_CAPACITY;
+    g_sendQueuePolicy = toQueueOverflowPolicy(sendPolicy, CA_QUEUE_OVERFLOW_REJECT);
+    g_recvQueueCapacity = (recvCapacity > 0) ? recvCapacity : DEFAULT_RECV_QUEUE_CAPACITY;
+    g_recvQueuePolicy = toQueueOverflowPolicy(recvPolicy, CA_QUEUE_OVERFLOW_BLOCK);
+
+    ret = pthread_mutex_unlock(&g_queueingThreadMutex);
+    if(ret != 0)
+    {
+        EDGE_LOG_V(TAG, "Failed to unlock the queueing thread mutex. "
+            "pthread_mutex_unlock() returned (%d)\n.", ret);
+        exit(ret);
+    }
+}
+
+void configure_read_batch(uint32_t windowMs, uint32_t maxNodes)
+{
+    int ret = pthread_mutex_lock(&g_queueingThreadMutex);
+    if(ret != 0)
+    {
+        EDGE_LOG_V(TAG, "Failed to lock the queueing thread mutex. "
+            "pthread_mutex_lock() returned (%d)\n.", ret);
+        exit(ret);
+    }
+
+    g_readBatchWindowMs = windowMs;
+    g_readBatchMaxNodes = (maxNodes > 0) ? maxNodes : DEFAULT_READ_BATCH_MAX_NODES;
+
+    ret = pthread_mutex_unlock(&g_queueingThreadMutex);
+    if(ret != 0)
+    {
+        EDGE_LOG_V(TAG, "Failed to unlock the queueing thread mutex. "
+            "pthread_mutex_unlock() returned (%d)\n.", ret);
+        exit(ret);
+    }
+}
+
+void configure_write_coalescing(bool enabled)
+{
+    g_coalesceWrites = enabled;
+}
+
+void configure_statistics(bool enabled)
+{
+    int ret = pthread_mutex_lock(&g_queueingThreadMutex);
+    if(ret != 0)
+    {
+        EDGE_LOG_V(TAG, "Failed to lock the queueing thread mutex. "
+            "pthread_mutex_lock() returned (%d)\n.", ret);
+        exit(ret);
+    }
+
+    g_collectStatistics = enabled;
+
+    ret = pthread_mutex_unlock(&g_queueingThreadMutex);
+    if(ret != 0)
+    {
+        EDGE_LOG_V(TAG, "Failed to unlock the queueing thread mutex. "
+            "pthread_mutex_unlock() returned (%d)\n.", ret);
+        exit(ret);
+    }
+}
+
+bool cancel_request(uint32_t messageId)
+{
+    pthread_mutex_lock(&g_cancelMutex);
+    WaitingRequests *waiting = (NULL == g_waitingRequests) ? NULL
+        : (WaitingRequests *) getMapElement(g_waitingRequests, (keyValue) (uintptr_t) messageId);
+    if (NULL != waiting)
+    {
+        // The requests queued later with the same id, like the next cycles of a poll, stay.
+        waiting->cancelledSequence = g_queueSequence;
+    }
+    pthread_mutex_unlock(&g_cancelMutex);
+    return NULL != waiting;
+}
+
+void get_queue_statistics(EdgeAdapterStatistics *stats)
+{
+    VERIFY_NON_NULL_NR_MSG(stats, "stats is NULL.");
+    memset(stats, 0, sizeof(EdgeAdapterStatistics));
+
+    int ret = pthread_mutex_lock(&g_queueingThreadMutex);
+    if(ret != 0)
+    {
+        EDGE_LOG_V(TAG, "Failed to lock the queueing thread mutex. "
+            "pthread_mutex_lock() returned (%d)\n.", ret);
+        exit(ret);
+    }
+
+    if (g_queueingThreadInitialized)
+    {
+        stats->enabled = (NULL != g_queueStatistics);
+        stats->sendQueueCount = g_sendWorkerCount;
+        for (uint32_t i = 0; i < g_sendWorkerCount; i++)
+        {
+            getQueueStatistics(&g_sendThreads[i], &stats->sendQueues[i]);
+        }
+        getQueueStatistics(&g_receiveThread, &stats->recvQueue);
+    }
+
+    for (uint32_t i = 0; stats->enabled && i <= g_sendWorkerCount; i++)
+    {
+        QueueStatistics *queueStats = &g_queueStatistics[i];
+        bool isSend = (i < g_sendWorkerCount);
+        pthread_mutex_lock(&queueStats->mutex);
+        for (size_t command = 0; command < EDGE_STATISTICS_COMMAND_COUNT; command++)
+        {
+            EdgeCommandStatistics *commandStats = &stats->commands[command];
+            mergeEdgeLatency(isSend ? &commandStats->sendWait : &commandStats->recvWait,
+                    &queueStats->wait[command]);
+            mergeEdgeLatency(isSend ? &commandStats->sendService : &commandStats->recvCallback,
+                    &queueStats->service[command]);
+        }
+        pthread_mutex_unlock(&queueStats->mutex);
+    }
+
+    ret = pthread_mutex_unlock(&g_queueingThreadMutex);
+    if(ret != 0)
+    {
+        EDGE_LOG_V(TAG, "Failed to unlock the queueing thread mutex. "
+            "pthread_mutex_unlock() returned (%d)\n.", ret);
+        exit(ret);
+    }
+}
+
 void init_queue()
 {
     int ret = pthread_mutex_lock(&g_queueingThreadMutex);
@@ -157,36 +1297,81 @@ void init_queue()
         goto EXIT;
     }
 
-    CAResult_t res = ca_thread_pool_init(MAX_THREAD_POOL_SIZE, &g_threadPoolHandle);
+    uint32_t workerCount = (g_configuredSendWorkerCount > 0) ?
+            g_configuredSendWorkerCount : getDefaultSendWorkerCount();
+    if (workerCount > MAX_SEND_WORKER_COUNT)
+    {
+        EDGE_LOG_V(TAG, "Send worker count(%u) is limited to %d.\n", workerCount,
+                MAX_SEND_WORKER_COUNT);
+        workerCount = MAX_SEND_WORKER_COUNT;
+    }
+
+    // Every queueing thread keeps one pool worker busy while it runs.
+    CAResult_t res = ca_thread_pool_init(workerCount + 1 + SPARE_THREAD_POOL_SIZE,
+            &g_threadPoolHandle);
     if (CA_STATUS_OK != res)
     {
         EDGE_LOG(TAG, "thread pool initialize error.");
         goto EXIT;
     }
 
-    // send thread initialize
-    res = CAQueueingThreadInitialize(&g_sendThread, g_threadPoolHandle, sendQ_run, destroyData);
-    if (CA_STATUS_OK != res)
+    if (g_collectStatistics && !createQueueStatistics(workerCount + 1))
     {
-        EDGE_LOG(TAG, "Failed to Initialize send queue thread");
         goto EXIT;
     }
 
-    res = CAQueueingThreadStart(&g_sendThread);
-    if (CA_STATUS_OK != res)
+    // send thread initialize
+    for (g_sendWorkerCount = 0; g_sendWorkerCount < workerCount; g_sendWorkerCount++)
     {
-        EDGE_LOG(TAG, "thread start error(send thread).");
-        goto EXIT;
+        CAQueueingThread_t *sendThread = &g_sendThreads[g_sendWorkerCount];
+        res = CAQueueingThreadInitializeLanes(sendThread, g_threadPoolHandle, sendQ_run,
+                destroyData, g_sendQueueCapacity, g_sendQueuePolicy,
+                SEND_LANE_COUNT, SEND_LANE_WEIGHTS);
+        if (CA_STATUS_OK != res)
+        {
+            EDGE_LOG(TAG, "Failed to Initialize send queue thread");
+            goto EXIT;
+        }
+
+        // A request dropped for a newer one is answered, like a cancelled request.
+        CAQueueingThreadSetDropFunction(sendThread, dropRequest);
+
+        if (g_readBatchWindowMs > 0)
+        {
+            CAQueueingThreadSetIdleTask(sendThread, readBatchIdle,
+                    &g_readBatches[g_sendWorkerCount]);
+        }
+
+        if (g_queueStatistics)
+        {
+            CAQueueingThreadSetStatsTask(sendThread, recordQueueStatistics,
+                    &g_queueStatistics[g_sendWorkerCount]);
+        }
+
+        res = CAQueueingThreadStart(sendThread);
+        if (CA_STATUS_OK != res)
+        {
+            EDGE_LOG(TAG, "thread start error(send thread).");
+            CAQueueingThreadDestroy(sendThread);
+            goto EXIT;
+        }
     }
 
     // receive thread initialize
-    res = CAQueueingThreadInitialize(&g_receiveThread, g_threadPoolHandle, recvQ_run, destroyData);
+    res = CAQueueingThreadInitializeBounded(&g_receiveThread, g_threadPoolHandle, recvQ_run,
+            destroyData, g_recvQueueCapacity, g_recvQueuePolicy);
     if (CA_STATUS_OK != res)
     {
         EDGE_LOG(TAG, "Failed to Initialize receive queue thread");
         goto EXIT;
     }
 
+    if (g_queueStatistics)
+    {
+        CAQueueingThreadSetStatsTask(&g_receiveThread, recordQueueStatistics,
+                &g_queueStatistics[workerCount]);
+    }
+
     res = CAQueueingThreadStart(&g_receiveThread);
     if (CA_STATUS_OK != res)
     {
@@ -212,6 +1397,23 @@ void registerMQCallback(response_cb_t resCallback, send_cb_t sendCallback)
     g_sendCallback = sendCallback;
 }
 
+void registerMQBatchCallback(send_batch_cb_t batchCallback)
+{
+    g_sendBatchCallback = batchCallback;
+}
+
+void registerMQDiscardCallback(discard_cb_t discardCallback)
+{
+    g_discardCallback = discardCallback;
+}
+
+void registerMQSessionCallback(session_select_cb_t selectCallback,
+        session_release_cb_t releaseCallback)
+{
+    g_sessionSelectCallback = selectCallback;
+    g_sessionReleaseCallback = releaseCallback;
+}
+
 static void destroyData(void *data, uint32_t size)
 {
     EDGE_LOG(TAG, "destroyData IN");
@@ -222,6 +1424,19 @@ static void destroyData(void *data, uint32_t size)
 
     EdgeMessage *msg = (EdgeMessage *) data;
     VERIFY_NON_NULL_NR_MSG(msg, "msg is NULL.");
-    freeEdgeMessage(msg);
+    freeQueuedMessage(msg);
     EDGE_LOG(TAG, "destroyData OUT");
 }
+
+static void dropRequest(void *data, uint32_t size)
+{
+    (void) size;
+    EdgeMessage *msg = (EdgeMessage *) data;
+    VERIFY_NON_NULL_NR_MSG(msg, "msg is NULL.");
+    EDGE_LOG_V(TAG, "Message(%u) is dropped. Send queue is full.\n", msg->message_id);
+    if (NULL != g_discardCallback)
+    {
+        g_discardCallback(msg, STATUS_ENQUEUE_ERROR, "Request is dropped, the send queue is full.");
+    }
+    freeQueuedMessage(msg);
+}
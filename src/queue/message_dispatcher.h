@@ -34,19 +34,24 @@
 
 /**
  * @brief Add the EdgeMessage data to receiver Queue to send it to application
+ * @remarks Ownership of msg is transferred to the queue. On failure msg is destroyed.
  * @param[in]  msg EdgeMessage data
  * @return @c true on success, false on failure
- * @retval #true Successful (Queue is empty)
- * @retval #false Failure (Queue is not empty)
+ * @retval #true Successful (Message is queued)
+ * @retval #false Failure (Queue is full or not initialized)
  */
 bool add_to_recvQ(EdgeMessage *msg);
 
 /**
  * @brief Add the EdgeMessage data to send Queue to send it to server for processing
+ * @remarks Ownership of msg is transferred to the queue. On failure msg is destroyed.
+ * The start, stop and subscription requests to an endpoint are sent in order by one send
+ * thread. A stop is held back until the requests to its endpoint queued before it are done,
+ * and the requests queued after it are held back behind it.
  * @param[in]  msg EdgeMessage data
  * @return @c true on success, false on failure
- * @retval #true Successful (Queue is empty)
- * @retval #false Failure (Queue is not empty)
+ * @retval #true Successful (Message is queued)
+ * @retval #false Failure (Queue is full or not initialized)
  */
 bool add_to_sendQ(EdgeMessage *msg);
 
@@ -55,6 +60,71 @@ bool add_to_sendQ(EdgeMessage *msg);
  */
 void delete_queue();
 
+/**
+ * @brief Sets the capacity and the overflow behaviour of the send and receiver queue.
+ * @remarks Takes effect at the next initialization of the queues.
+ * @param[in]  sendCapacity Maximum number of messages in the send queue. 0 selects the default.
+ * @param[in]  sendPolicy Behaviour of add_to_sendQ() when the send queue is full.
+ * @param[in]  recvCapacity Maximum number of messages in the receiver queue. 0 selects the default.
+ * @param[in]  recvPolicy Behaviour of add_to_recvQ() when the receiver queue is full.
+ */
+void configure_queue(uint32_t sendCapacity, EdgeQueueOverflowPolicy sendPolicy,
+        uint32_t recvCapacity, EdgeQueueOverflowPolicy recvPolicy);
+
+/**
+ * @brief Sets the number of send threads.
+ * @remarks Requests are distributed to the send threads by endpoint address.
+ * Takes effect at the next initialization of the queues.
+ * @param[in]  workerCount Number of send threads. 0 selects the number of processors.
+ */
+void configure_send_workers(uint32_t workerCount);
+
+/**
+ * @brief Sets the batching of READ requests.
+ * @remarks READ requests to the same endpoint which arrive within the window are sent
+ * in one read service call through the callback registered by registerMQBatchCallback().
+ * Requests with sendImmediately set are not held back.
+ * Takes effect at the next initialization of the queues.
+ * @param[in]  windowMs Time in milliseconds a READ request may be held back. 0 disables the batching.
+ * @param[in]  maxNodes Number of nodes which sends the batch at once. 0 selects the default.
+ */
+void configure_read_batch(uint32_t windowMs, uint32_t maxNodes);
+
+/**
+ * @brief Sets whether queued WRITE requests to the same node are coalesced.
+ * @remarks Of the WRITE requests with one node to the same endpoint and node which wait in
+ * the send queues, only the newest one is sent. The others are reported through the
+ * callback registered by registerMQDiscardCallback() with STATUS_WRITE_SUPERSEDED.
+ * Writes queued before a read of their node or a method call to their endpoint are
+ * always sent. Applies to the requests queued afterwards.
+ * @param[in]  enabled true to coalesce the writes.
+ */
+void configure_write_coalescing(bool enabled);
+
+/**
+ * @brief Drops the pending requests with the given message id from the send queues.
+ * @remarks The dropped requests are reported through the callback registered by
+ * registerMQDiscardCallback(). Requests already being sent and the requests queued
+ * afterwards with the same id are not affected.
+ * @param[in]  messageId message_id of the requests.
+ * @return @c true if requests with the id are waiting in the send queues, otherwise false.
+ */
+bool cancel_request(uint32_t messageId);
+
+/**
+ * @brief Sets whether the queue wait and processing times are collected.
+ * @remarks Without it the messages are not time stamped.
+ * Takes effect at the next initialization of the queues.
+ * @param[in]  enabled true to collect the timings.
+ */
+void configure_statistics(bool enabled);
+
+/**
+ * @brief Gets the queue depths and the collected timings.
+ * @param[out]  stats Filled with the statistics. The timings are cleared when the queues are deleted.
+ */
+void get_queue_statistics(EdgeAdapterStatistics *stats);
+
 /**
  * @brief Initializes the send and receiver queue.
  * @remarks This request will be ignored if initialization is completed already.
@@ -68,4 +138,27 @@ void init_queue();
  */
 void registerMQCallback(response_cb_t resCallback, send_cb_t sendCallback);
 
+/**
+ * @brief Registers the callback for sending several READ requests together
+ * @param[in]  batchCallback Callback for handling the batched requests
+ */
+void registerMQBatchCallback(send_batch_cb_t batchCallback);
+
+/**
+ * @brief Registers the callback for the requests which are dropped before they are sent,
+ *        because they are cancelled or their deadline passed
+ * @param[in]  discardCallback Callback for handling the dropped requests
+ */
+void registerMQDiscardCallback(discard_cb_t discardCallback);
+
+/**
+ * @brief Registers the callbacks which assign a client session to each queued request and
+ *        take it back once the request is done. Requests to different sessions of an
+ *        endpoint may go to different send threads.
+ * @param[in]  selectCallback Callback for choosing the session of a request
+ * @param[in]  releaseCallback Callback for the requests which are done with their session
+ */
+void registerMQSessionCallback(session_select_cb_t selectCallback,
+        session_release_cb_t releaseCallback);
+
 #endif  // EDGE_MESSAGE_DISPATCHER_H
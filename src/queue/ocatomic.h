@@ -0,0 +1,88 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the atomic operations on 32-bit integers used by the
+ * lock-free queue primitives. All the operations are sequentially consistent.
+ */
+
+#ifndef OC_ATOMIC_H_
+#define OC_ATOMIC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef _MSC_VER
+#include <windows.h>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Size of a cache line. Used to pad the fields which are written by different threads. */
+#define OC_CACHE_LINE_SIZE (64)
+
+#ifdef _MSC_VER
+
+#define OC_ATOMIC_LOAD(ptr) \
+    ((uint32_t) InterlockedCompareExchange((volatile LONG *) (ptr), 0, 0))
+
+#define OC_ATOMIC_STORE(ptr, val) \
+    ((void) InterlockedExchange((volatile LONG *) (ptr), (LONG) (val)))
+
+#define OC_ATOMIC_FETCH_ADD(ptr, val) \
+    ((uint32_t) InterlockedExchangeAdd((volatile LONG *) (ptr), (LONG) (val)))
+
+#define OC_ATOMIC_FETCH_SUB(ptr, val) \
+    ((uint32_t) InterlockedExchangeAdd((volatile LONG *) (ptr), -(LONG) (val)))
+
+static __inline bool OC_ATOMIC_CAS(volatile uint32_t *ptr, uint32_t expected, uint32_t desired)
+{
+    return ((uint32_t) InterlockedCompareExchange((volatile LONG *) ptr,
+            (LONG) desired, (LONG) expected)) == expected;
+}
+
+#else
+
+#define OC_ATOMIC_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+
+#define OC_ATOMIC_STORE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_SEQ_CST)
+
+#define OC_ATOMIC_FETCH_ADD(ptr, val) __atomic_fetch_add((ptr), (val), __ATOMIC_SEQ_CST)
+
+#define OC_ATOMIC_FETCH_SUB(ptr, val) __atomic_fetch_sub((ptr), (val), __ATOMIC_SEQ_CST)
+
+static inline bool OC_ATOMIC_CAS(volatile uint32_t *ptr, uint32_t expected, uint32_t desired)
+{
+    return __atomic_compare_exchange_n(ptr, &expected, desired, false,
+            __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+#endif
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* OC_ATOMIC_H_ */
@@ -361,6 +361,12 @@ struct timespec oc_get_current_time()
 #endif
 }
 
+uint64_t oc_get_monotonic_time_us(void)
+{
+    struct timespec ts = oc_get_current_time();
+    return ((uint64_t) ts.tv_sec * USECS_PER_SEC) + (ts.tv_nsec / NANOSECS_PER_USECS);
+}
+
 void oc_add_microseconds_to_timespec(struct timespec* ts, uint64_t microseconds)
 {
     time_t secPart = microseconds/USECS_PER_SEC;
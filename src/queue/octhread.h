@@ -190,6 +190,14 @@ OCWaitResult_t oc_cond_wait_for(oc_cond cond, oc_mutex mutex, uint64_t microseco
  */
 void oc_cond_free(oc_cond cond);
 
+/**
+ * Gets the time of the monotonic clock used by oc_cond_wait_for().
+ *
+ * @return current time in microseconds. Only the difference of two values is meaningful.
+ *
+ */
+uint64_t oc_get_monotonic_time_us(void);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif /* __cplusplus */
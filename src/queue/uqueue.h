@@ -43,6 +43,8 @@ typedef struct u_queue_message_t
     void *msg;
     /** message size. */
     uint32_t size;
+    /** Time the message was queued in microseconds, 0 if not stamped. Set by the ring queue only. */
+    uint64_t timestamp;
 } u_queue_message_t;
 
 typedef struct u_queue_element_t u_queue_element;
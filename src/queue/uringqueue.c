@@ -0,0 +1,262 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "uringqueue.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "ocatomic.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+
+/**
+ * @def TAG
+ * @brief Logging tag for module name
+ */
+#define TAG "URINGQUEUE"
+
+/**
+ * @def MAX_CAPACITY
+ * @brief Largest supported capacity. Positions are compared with 32-bit signed arithmetic.
+ */
+#define MAX_CAPACITY (1u << 30)
+
+/**
+ * Ring slot. 'sequence' tells the producers and the consumers whose turn it is:
+ * equal to the position when the slot is free for that position,
+ * position + 1 when the slot holds the message for that position.
+ */
+typedef struct
+{
+    volatile uint32_t sequence;
+    void *msg;
+    uint32_t size;
+    uint64_t timestamp;
+} u_ringqueue_cell;
+
+struct u_ringqueue_t
+{
+    /** Slots. Read-only after creation. */
+    u_ringqueue_cell *cells;
+    /** Capacity - 1. */
+    uint32_t mask;
+    char pad0[OC_CACHE_LINE_SIZE];
+    /** Next position to be written by producers. */
+    volatile uint32_t enqueuePos;
+    char pad1[OC_CACHE_LINE_SIZE - sizeof(uint32_t)];
+    /** Next position to be read by consumers. */
+    volatile uint32_t dequeuePos;
+    char pad2[OC_CACHE_LINE_SIZE - sizeof(uint32_t)];
+};
+
+static uint32_t roundUpPowerOfTwo(uint32_t value)
+{
+    uint32_t result = 2;
+    while (result < value)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+
+u_ringqueue_t *u_ringqueue_create(uint32_t capacity)
+{
+    if (0 == capacity)
+    {
+        capacity = U_RINGQUEUE_DEFAULT_CAPACITY;
+    }
+
+    if (capacity > MAX_CAPACITY)
+    {
+        EDGE_LOG_V(TAG, "RingQueueCreate FAIL, capacity %u is too large", capacity);
+        return NULL;
+    }
+
+    u_ringqueue_t *queue = (u_ringqueue_t *) EdgeCalloc(1, sizeof(u_ringqueue_t));
+    if (NULL == queue)
+    {
+        EDGE_LOG(TAG, "RingQueueCreate FAIL");
+        return NULL;
+    }
+
+    capacity = roundUpPowerOfTwo(capacity);
+    queue->cells = (u_ringqueue_cell *) EdgeMalloc(capacity * sizeof(u_ringqueue_cell));
+    if (NULL == queue->cells)
+    {
+        EDGE_LOG(TAG, "RingQueueCreate FAIL, memory allocation failed");
+        EdgeFree(queue);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < capacity; i++)
+    {
+        queue->cells[i].sequence = i;
+        queue->cells[i].msg = NULL;
+        queue->cells[i].size = 0;
+        queue->cells[i].timestamp = 0;
+    }
+    queue->mask = capacity - 1;
+    OC_ATOMIC_STORE(&queue->enqueuePos, 0);
+    OC_ATOMIC_STORE(&queue->dequeuePos, 0);
+
+    return queue;
+}
+
+CAResult_t u_ringqueue_delete(u_ringqueue_t *queue)
+{
+    if (NULL == queue)
+    {
+        EDGE_LOG(TAG, "RingQueueDelete FAIL, Invalid Queue");
+        return CA_STATUS_FAILED;
+    }
+
+    EdgeFree(queue->cells);
+    EdgeFree(queue);
+    return CA_STATUS_OK;
+}
+
+CAResult_t u_ringqueue_push(u_ringqueue_t *queue, void *msg, uint32_t size)
+{
+    return u_ringqueue_push_stamped(queue, msg, size, 0);
+}
+
+CAResult_t u_ringqueue_push_stamped(u_ringqueue_t *queue, void *msg, uint32_t size,
+                                    uint64_t timestamp)
+{
+    if (NULL == queue)
+    {
+        EDGE_LOG(TAG, "RingQueuePush FAIL, Invalid Queue");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    u_ringqueue_cell *cell = NULL;
+    uint32_t pos = OC_ATOMIC_LOAD(&queue->enqueuePos);
+    for (;;)
+    {
+        cell = &queue->cells[pos & queue->mask];
+        uint32_t seq = OC_ATOMIC_LOAD(&cell->sequence);
+        int32_t diff = (int32_t) (seq - pos);
+        if (0 == diff)
+        {
+            // Slot is free for this position. Claim it.
+            if (OC_ATOMIC_CAS(&queue->enqueuePos, pos, pos + 1))
+            {
+                break;
+            }
+            pos = OC_ATOMIC_LOAD(&queue->enqueuePos);
+        }
+        else if (diff < 0)
+        {
+            // Slot still holds the message of the previous lap.
+            return CA_STATUS_QUEUE_FULL;
+        }
+        else
+        {
+            // Another producer claimed this position.
+            pos = OC_ATOMIC_LOAD(&queue->enqueuePos);
+        }
+    }
+
+    cell->msg = msg;
+    cell->size = size;
+    cell->timestamp = timestamp;
+    OC_ATOMIC_STORE(&cell->sequence, pos + 1);
+
+    return CA_STATUS_OK;
+}
+
+bool u_ringqueue_pop(u_ringqueue_t *queue, u_queue_message_t *message)
+{
+    if (NULL == queue || NULL == message)
+    {
+        EDGE_LOG(TAG, "RingQueuePop FAIL, Invalid param");
+        return false;
+    }
+
+    u_ringqueue_cell *cell = NULL;
+    uint32_t pos = OC_ATOMIC_LOAD(&queue->dequeuePos);
+    for (;;)
+    {
+        cell = &queue->cells[pos & queue->mask];
+        uint32_t seq = OC_ATOMIC_LOAD(&cell->sequence);
+        int32_t diff = (int32_t) (seq - (pos + 1));
+        if (0 == diff)
+        {
+            // Slot holds the message for this position. Claim it.
+            if (OC_ATOMIC_CAS(&queue->dequeuePos, pos, pos + 1))
+            {
+                break;
+            }
+            pos = OC_ATOMIC_LOAD(&queue->dequeuePos);
+        }
+        else if (diff < 0)
+        {
+            // Queue is empty or the producer has not finished writing yet.
+            return false;
+        }
+        else
+        {
+            // Another consumer claimed this position.
+            pos = OC_ATOMIC_LOAD(&queue->dequeuePos);
+        }
+    }
+
+    message->msg = cell->msg;
+    message->size = cell->size;
+    message->timestamp = cell->timestamp;
+    // Release the slot for the next lap.
+    OC_ATOMIC_STORE(&cell->sequence, pos + queue->mask + 1);
+
+    return true;
+}
+
+uint32_t u_ringqueue_get_size(u_ringqueue_t *queue)
+{
+    if (NULL == queue)
+    {
+        EDGE_LOG(TAG, "RingQueueGetSize FAIL, Invalid Queue");
+        return 0;
+    }
+
+    uint32_t dequeuePos = OC_ATOMIC_LOAD(&queue->dequeuePos);
+    uint32_t enqueuePos = OC_ATOMIC_LOAD(&queue->enqueuePos);
+    int32_t size = (int32_t) (enqueuePos - dequeuePos);
+    if (size < 0)
+    {
+        return 0;
+    }
+    if ((uint32_t) size > queue->mask + 1)
+    {
+        return queue->mask + 1;
+    }
+    return (uint32_t) size;
+}
+
+uint32_t u_ringqueue_get_capacity(u_ringqueue_t *queue)
+{
+    if (NULL == queue)
+    {
+        EDGE_LOG(TAG, "RingQueueGetCapacity FAIL, Invalid Queue");
+        return 0;
+    }
+
+    return queue->mask + 1;
+}
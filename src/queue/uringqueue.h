@@ -0,0 +1,106 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the APIs for the bounded lock-free ring queue.
+ * Any number of threads may push and pop concurrently. Memory for all the
+ * slots is allocated once at creation, so push and pop never allocate.
+ */
+
+#ifndef U_RING_QUEUE_H_
+#define U_RING_QUEUE_H_
+
+#include "cacommon.h"
+#include "uqueue.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/** Capacity used when zero is requested. */
+#define U_RINGQUEUE_DEFAULT_CAPACITY (4096)
+
+typedef struct u_ringqueue_t u_ringqueue_t;
+
+/**
+ * API to create the ring queue.
+ * @param capacity maximum number of messages. Rounded up to the next power of two.
+ * 0 selects ::U_RINGQUEUE_DEFAULT_CAPACITY.
+ * @return  u_ringqueue_t pointer if Success, NULL otherwise.
+ */
+u_ringqueue_t *u_ringqueue_create(uint32_t capacity);
+
+/**
+ * Deletes the queue. Messages which are still in the queue are not freed.
+ * @param queue pointer to queue.
+ * @return ::CA_STATUS_OK if Success, ::CA_STATUS_FAILED otherwise.
+ */
+CAResult_t u_ringqueue_delete(u_ringqueue_t *queue);
+
+/**
+ * Adds message at the end of the queue.
+ * @param queue pointer to queue.
+ * @param msg pointer to message.
+ * @param size message size.
+ * @return ::CA_STATUS_OK if Success, ::CA_STATUS_QUEUE_FULL if there is no free slot,
+ * ::CA_STATUS_INVALID_PARAM otherwise.
+ */
+CAResult_t u_ringqueue_push(u_ringqueue_t *queue, void *msg, uint32_t size);
+
+/**
+ * Adds message at the end of the queue together with the time it was queued.
+ * The time is given back in u_queue_message_t::timestamp by u_ringqueue_pop().
+ * @param queue pointer to queue.
+ * @param msg pointer to message.
+ * @param size message size.
+ * @param timestamp time in microseconds.
+ * @return same as u_ringqueue_push().
+ */
+CAResult_t u_ringqueue_push_stamped(u_ringqueue_t *queue, void *msg, uint32_t size,
+                                    uint64_t timestamp);
+
+/**
+ * Removes the first message in the queue.
+ * @param queue pointer to queue.
+ * @param[out] message filled with the removed message.
+ * @return true if a message was removed, false if the queue is empty.
+ */
+bool u_ringqueue_pop(u_ringqueue_t *queue, u_queue_message_t *message);
+
+/**
+ * @param queue pointer to queue.
+ * @return number of messages in queue. Approximate while other threads are pushing or popping.
+ */
+uint32_t u_ringqueue_get_size(u_ringqueue_t *queue);
+
+/**
+ * @param queue pointer to queue.
+ * @return maximum number of messages the queue can hold.
+ */
+uint32_t u_ringqueue_get_capacity(u_ringqueue_t *queue);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* U_RING_QUEUE_H_ */
@@ -19,6 +19,10 @@
  ******************************************************************/
 
 #include "edge_opcua_client.h"
+#include "edge_session_table.h"
+#include "edge_session_pool.h"
+#include "edge_server_capabilities.h"
+#include "edge_value_cache.h"
 #include "edge_get_endpoints.h"
 #include "edge_find_servers.h"
 #include "edge_discovery_common.h"
@@ -28,47 +32,39 @@
 #include "method.h"
 #include "message_dispatcher.h"
 #include "subscription.h"
+#include "cmd_util.h"
+#include "octhread.h"
 #include "edge_logger.h"
 #include "edge_utils.h"
 #include "edge_open62541.h"
 #include "edge_list.h"
 #include "edge_map.h"
 #include "edge_malloc.h"
+#include "edge_random.h"
 
 #include <stdio.h>
 #include <inttypes.h>
 
-#define TAG "session_client"
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#else
+#include "pthread.h"
+#include <windows.h>
+#endif
 
-#define MAX_ADDRESS_SIZE (512)
+#define TAG "session_client"
 
-static edgeMap *sessionClientMap = NULL;
-static size_t clientCount = 0;
+/* A reconnect waits in slices of this many milliseconds, to stop soon after a disconnect. */
+#define EDGE_RECONNECT_WAIT_SLICE (100)
 
 static status_cb_t g_statusCallback = NULL;
 
-static void getAddressPort(char *endpoint, char **out)
+static void destroyPoolClient(void *session)
 {
-    UA_String hostName = UA_STRING_NULL, path = UA_STRING_NULL;
-    UA_UInt16 port = 0;
-    UA_String endpointUrlString = UA_STRING((char *) (uintptr_t) endpoint);
-
-    UA_StatusCode parse_retval = UA_parseEndpointUrl(&endpointUrlString, &hostName, &port, &path);
-    COND_CHECK_NR_MSG((parse_retval != UA_STATUSCODE_GOOD), "Server URL is invalid. Unable to get endpoints\n");
-
-    char address[MAX_ADDRESS_SIZE];
-    strncpy(address, (char*) hostName.data, hostName.length);
-    address[hostName.length] = '\0';
-
-    char addr_port[MAX_ADDRESS_SIZE];
-    memset(addr_port, '\0', MAX_ADDRESS_SIZE);
-    int written = snprintf(addr_port, MAX_ADDRESS_SIZE, "%s:%d", address, port);
-    if (written > 0)
-    {
-        *out = (char*) EdgeMalloc(sizeof(char) * (written + 1));
-        strncpy(*out, addr_port, written);
-        (*out)[written] = '\0';
-    }
+    removeServerCapabilities((UA_Client *) session);
+    removeValueCache((UA_Client *) session);
+    UA_Client_delete((UA_Client *) session);
 }
 
 #ifndef ENABLE_SUB_QUEUE
@@ -77,54 +73,69 @@ static keyValue getSessionClient(char *endpoint)
 keyValue getSessionClient(char *endpoint)
 #endif
 {
-    VERIFY_NON_NULL_MSG(sessionClientMap, "sessionClientMap is NULL\n", NULL);
-
     EDGE_LOG_V(TAG, "Endpoint : %s\n", endpoint);
-    char *ep = NULL;
-    getAddressPort(endpoint, &ep);
-    VERIFY_NON_NULL_MSG(ep, "NULL EP received in getSessionClient \n", NULL);
+    EdgeSessionPool *pool = (EdgeSessionPool *) retainEdgeSession(endpoint, 0,
+            retainEdgeSessionPool);
+    COND_CHECK((IS_NULL(pool)), NULL);
+    keyValue client = getEdgeSessionPoolSession(pool, EDGE_SESSION_POOL_SUBSCRIPTION_INDEX);
+    releaseEdgeSessionPool(pool);
+    return client;
+}
 
-    keyValue value = NULL;
-    for(edgeMapNode *temp = sessionClientMap->head; temp != NULL; temp = temp->next)
-    {
-        if (!strcmp(temp->key, ep))
-        {
-            value = temp->value;
-            break;
-        }
-    }
-    EdgeFree(ep);
-    return value;
+// The endpoint hash is computed once when the message is queued.
+static EdgeSessionPool *getMessagePool(EdgeMessage *msg)
+{
+    COND_CHECK((IS_NULL(msg->endpointInfo) || IS_NULL(msg->endpointInfo->endpointUri)), NULL);
+    return (EdgeSessionPool *) retainEdgeSession(msg->endpointInfo->endpointUri,
+            msg->endpointHash, retainEdgeSessionPool);
 }
 
-static edgeMapNode *removeClientFromSessionMap(char *endpoint)
+/**
+ * Gets the client of the session chosen for the message. The pool is retained, so the
+ * client stays valid until the caller releases the pool.
+ */
+static UA_Client *getMessageClient(EdgeMessage *msg, EdgeSessionPool **pool)
 {
-    VERIFY_NON_NULL_MSG(sessionClientMap, "sessionClientMap is NULL\n", NULL);
-    char *ep = NULL;
-    getAddressPort(endpoint, &ep);
-    VERIFY_NON_NULL_MSG(ep, "NULL EP received in removeClientFromSessionMap\n", NULL);
+    *pool = getMessagePool(msg);
+    COND_CHECK((IS_NULL(*pool)), NULL);
+    return (UA_Client *) getEdgeSessionPoolSession(*pool, msg->sessionIndex);
+}
 
-    edgeMapNode *prev = NULL;
-    edgeMapNode *temp = sessionClientMap->head;
-    while (temp != NULL)
+/**
+ * Reads and browses may be served by any session. Writes, method calls and the control
+ * requests of an endpoint all go to one session, so they keep the order they were queued in.
+ */
+static EdgeSessionRequestKind getRequestKind(EdgeCommand command)
+{
+    switch (command)
     {
-        if (!strcmp(temp->key, ep))
-        {
-            if (prev == NULL)
-            {
-                sessionClientMap->head = temp->next;
-            }
-            else
-            {
-                prev->next = temp->next;
-            }
-            break;
-        }
-        prev = temp;
-        temp = temp->next;
+        case CMD_READ:
+        case CMD_READ_SAMPLING_INTERVAL:
+        case CMD_BROWSE:
+        case CMD_BROWSE_VIEW:
+            return EDGE_SESSION_REQUEST_ANY;
+        case CMD_SUB:
+            return EDGE_SESSION_REQUEST_SUBSCRIPTION;
+        default:
+            return EDGE_SESSION_REQUEST_ORDERED;
     }
-    EdgeFree(ep);
-    return temp;
+}
+
+uint32_t selectMessageSession(EdgeMessage *msg)
+{
+    EdgeSessionPool *pool = getMessagePool(msg);
+    COND_CHECK((IS_NULL(pool)), 0);
+    uint32_t index = acquireEdgeSessionIndex(pool, getRequestKind(msg->command));
+    releaseEdgeSessionPool(pool);
+    return index;
+}
+
+void releaseMessageSession(EdgeMessage *msg)
+{
+    EdgeSessionPool *pool = getMessagePool(msg);
+    COND_CHECK_NR_MSG((IS_NULL(pool)), "");
+    releaseEdgeSessionIndex(pool, msg->sessionIndex);
+    releaseEdgeSessionPool(pool);
 }
 
 void setSupportedApplicationTypes(uint8_t supportedTypes)
@@ -132,38 +143,355 @@ void setSupportedApplicationTypes(uint8_t supportedTypes)
     setSupportedApplicationTypesInternal(supportedTypes);
 }
 
+void configureReportBatch(bool enabled, uint32_t maxReports)
+{
+    setReportBatchConfig(enabled, maxReports);
+}
+
+void configureReadResultLayout(bool flat)
+{
+    setReadResultLayout(flat);
+}
+
+/**
+ * Uses the time left until the deadline as the timeout of the next service call on the client.
+ * Returns the timeout to be restored with restoreRequestTimeout().
+ */
+static UA_UInt32 applyRequestTimeout(UA_Client *client, uint64_t deadline)
+{
+    COND_CHECK((IS_NULL(client)), 0);
+    UA_UInt32 timeout = client->config.timeout;
+    if (0 == deadline)
+    {
+        return timeout;
+    }
+
+    uint64_t now = oc_get_monotonic_time_us();
+    uint64_t remainingMs = (deadline > now) ? (deadline - now + 999) / 1000 : 1;
+    client->config.timeout = (remainingMs < UINT32_MAX) ? (UA_UInt32) remainingMs : UINT32_MAX;
+    return timeout;
+}
+
+static void restoreRequestTimeout(UA_Client *client, UA_UInt32 timeout)
+{
+    if (IS_NOT_NULL(client))
+    {
+        client->config.timeout = timeout;
+    }
+}
+
+/* A service call made on the executor of its session. */
+typedef struct ServiceCall
+{
+    UA_Client *client;
+    EdgeMessage *msg;
+    EdgeMessage **msgs;
+    size_t count;
+    uint64_t deadline;
+    EdgeResult (*execute)(UA_Client *client, const EdgeMessage *msg);
+    EdgeResult result;
+} ServiceCall;
+
+static void runServiceCall(void *data)
+{
+    ServiceCall *call = (ServiceCall *) data;
+    UA_UInt32 timeout = applyRequestTimeout(call->client, call->deadline);
+    if (call->msgs)
+    {
+        call->result = executeReadBatch(call->client, call->msgs, call->count);
+    }
+    else
+    {
+        call->result = call->execute(call->client, call->msg);
+    }
+    restoreRequestTimeout(call->client, timeout);
+}
+
+/**
+ * Makes the call on the executor of the session chosen for the message, so no other
+ * thread uses the client meanwhile. Without a session the call reports the missing client.
+ */
+static EdgeResult executeOnSession(EdgeMessage *msg, ServiceCall *call)
+{
+    EdgeSessionPool *pool = NULL;
+    call->client = getMessageClient(msg, &pool);
+    call->result.code = STATUS_ERROR;
+    if (IS_NULL(pool))
+    {
+        runServiceCall(call);
+        return call->result;
+    }
+
+    CASerialExecutorRun(getEdgeSessionExecutor(pool, msg->sessionIndex), runServiceCall, call);
+    releaseEdgeSessionPool(pool);
+    return call->result;
+}
+
+static EdgeResult executeBrowseCall(UA_Client *client, const EdgeMessage *msg)
+{
+    EdgeResult result = { STATUS_OK };
+    executeBrowse(client, (EdgeMessage *) msg);
+    return result;
+}
+
 EdgeResult readNodesFromServer(EdgeMessage *msg)
 {
-    UA_Client *clientHandle = (UA_Client*) getSessionClient(msg->endpointInfo->endpointUri);
-    EdgeResult ret = executeRead(clientHandle, msg);
-    return ret;
+    ServiceCall call = { NULL, msg, NULL, 0, msg->deadline, executeRead, { STATUS_ERROR } };
+    return executeOnSession(msg, &call);
+}
+
+EdgeResult readNodesBatchFromServer(EdgeMessage **msgs, size_t count)
+{
+    // The batch may take as long as its latest deadline. Without a deadline it keeps the default.
+    uint64_t deadline = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (0 == msgs[i]->deadline)
+        {
+            deadline = 0;
+            break;
+        }
+        if (msgs[i]->deadline > deadline)
+        {
+            deadline = msgs[i]->deadline;
+        }
+    }
+    ServiceCall call = { NULL, msgs[0], msgs, count, deadline, NULL, { STATUS_ERROR } };
+    return executeOnSession(msgs[0], &call);
 }
 
 EdgeResult writeNodesInServer(EdgeMessage *msg)
 {
-    UA_Client *clientHandle = (UA_Client*) getSessionClient(msg->endpointInfo->endpointUri);
-    EdgeResult ret = executeWrite(clientHandle, msg);
-    return ret;
+    ServiceCall call = { NULL, msg, NULL, 0, msg->deadline, executeWrite, { STATUS_ERROR } };
+    return executeOnSession(msg, &call);
 }
 
 void browseNodesInServer(EdgeMessage *msg)
 {
-    UA_Client *clientHandle = (UA_Client*) getSessionClient(msg->endpointInfo->endpointUri);
-    executeBrowse(clientHandle, msg);
+    ServiceCall call = { NULL, msg, NULL, 0, msg->deadline, executeBrowseCall, { STATUS_ERROR } };
+    executeOnSession(msg, &call);
 }
 
 EdgeResult callMethodInServer(EdgeMessage *msg)
 {
-    UA_Client *clientHandle = (UA_Client*) getSessionClient(msg->endpointInfo->endpointUri);
-    EdgeResult ret = executeMethod(clientHandle, msg);
-    return ret;
+    ServiceCall call = { NULL, msg, NULL, 0, msg->deadline, executeMethod, { STATUS_ERROR } };
+    return executeOnSession(msg, &call);
+}
+
+void discardRequest(EdgeMessage *msg, EdgeStatusCode code, const char *reason)
+{
+    sendErrorResponseWithCode(msg, (char *) reason, code);
 }
 
 EdgeResult executeSubscriptionInServer(EdgeMessage *msg)
 {
-    UA_Client *clientHandle = (UA_Client*) getSessionClient(msg->endpointInfo->endpointUri);
-    EdgeResult ret = executeSub(clientHandle, msg);
-    return ret;
+    // Subscription calls keep the deadline-free timeout of the client.
+    ServiceCall call = { NULL, msg, NULL, 0, 0, executeSub, { STATUS_ERROR } };
+    return executeOnSession(msg, &call);
+}
+
+/* A task queued on the executor of a session, holding the pool until it has run. */
+typedef struct SessionTask
+{
+    EdgeSessionPool *pool;
+    CASerialTask task;
+    void *data;
+} SessionTask;
+
+static void runSessionTask(void *data)
+{
+    SessionTask *sessionTask = (SessionTask *) data;
+    sessionTask->task(sessionTask->data);
+    releaseEdgeSessionPool(sessionTask->pool);
+    EdgeFree(sessionTask);
+}
+
+bool submitSessionTask(UA_Client *client, CASerialTask task, void *data)
+{
+    VERIFY_NON_NULL_MSG(client, "NULL client param in submitSessionTask\n", false);
+    VERIFY_NON_NULL_MSG(client->endpointUrl.data, "NULL endpointUrl in submitSessionTask\n", false);
+
+    char *endpoint = (char *) EdgeCalloc(client->endpointUrl.length + 1, sizeof(char));
+    VERIFY_NON_NULL_MSG(endpoint, "EdgeCalloc FAILED for endpoint in submitSessionTask\n", false);
+    memcpy(endpoint, client->endpointUrl.data, client->endpointUrl.length);
+    EdgeSessionPool *pool = (EdgeSessionPool *) retainEdgeSession(endpoint, 0, retainEdgeSessionPool);
+    EdgeFree(endpoint);
+
+    uint32_t index = 0;
+    if (!getEdgeSessionIndex(pool, client, &index))
+    {
+        EDGE_LOG(TAG, "The client has no session any more.\n");
+        releaseEdgeSessionPool(pool);
+        return false;
+    }
+
+    SessionTask *sessionTask = (SessionTask *) EdgeMalloc(sizeof(SessionTask));
+    if (IS_NULL(sessionTask))
+    {
+        EDGE_LOG(TAG, "EdgeMalloc FAILED for SessionTask\n");
+        releaseEdgeSessionPool(pool);
+        return false;
+    }
+    sessionTask->pool = pool;
+    sessionTask->task = task;
+    sessionTask->data = data;
+    if (CA_STATUS_OK != CASerialExecutorSubmit(getEdgeSessionExecutor(pool, index),
+            runSessionTask, sessionTask))
+    {
+        EdgeFree(sessionTask);
+        releaseEdgeSessionPool(pool);
+        return false;
+    }
+    return true;
+}
+
+/* A lost session being reconnected. It holds a reference to the pool. */
+typedef struct ReconnectTask
+{
+    EdgeSessionPool *pool;
+    UA_Client *client;
+    uint32_t index;
+    char *endpoint;
+    UA_StatusCode result;
+} ReconnectTask;
+
+static void sleepMs(uint32_t ms)
+{
+#ifndef _WIN32
+    usleep(ms * 1000);
+#else
+    Sleep(ms);
+#endif
+}
+
+// The caller holds a reference to the pool, so it cannot be freed and its address reused.
+static bool isPoolConnected(const char *endpoint, EdgeSessionPool *pool)
+{
+    EdgeSessionPool *current = (EdgeSessionPool *) retainEdgeSession(endpoint, 0,
+            retainEdgeSessionPool);
+    releaseEdgeSessionPool(current);
+    return current == pool;
+}
+
+static void reconnectSession(void *data)
+{
+    ReconnectTask *task = (ReconnectTask *) data;
+    task->result = UA_Client_connect(task->client, task->endpoint);
+    if (UA_STATUSCODE_GOOD != task->result)
+    {
+        return;
+    }
+    // The server may have been restarted with other limits.
+    loadServerCapabilities(task->client);
+
+    UA_StatusCode ret = restoreSubscriptions(task->client);
+    if (UA_STATUSCODE_GOOD != ret)
+    {
+        EDGE_LOG_V(TAG, "Subscriptions of session %u not fully restored :: %s\n", task->index,
+                UA_StatusCode_name(ret));
+    }
+}
+
+static void *reconnect_thread_handler(void *ptr)
+{
+    ReconnectTask *task = (ReconnectTask *) ptr;
+    EdgeSessionPool *pool = task->pool;
+    uint32_t maxAttempts = pool->reconnect.maxAttempts;
+    bool connected = false;
+
+    for (uint32_t attempt = 0; !connected && (0 == maxAttempts || attempt < maxAttempts); attempt++)
+    {
+        uint32_t delay = getEdgeSessionReconnectDelay(pool, attempt, EdgeGetRandom());
+        for (uint32_t waited = 0; waited < delay && isPoolConnected(task->endpoint, pool);
+                waited += EDGE_RECONNECT_WAIT_SLICE)
+        {
+            sleepMs((delay - waited < EDGE_RECONNECT_WAIT_SLICE) ?
+                    delay - waited : EDGE_RECONNECT_WAIT_SLICE);
+        }
+        if (!isPoolConnected(task->endpoint, pool))
+        {
+            EDGE_LOG(TAG, "Endpoint disconnected while reconnecting a session.\n");
+            break;
+        }
+
+        connected = (CA_STATUS_OK == CASerialExecutorRun(getEdgeSessionExecutor(pool,
+                task->index), reconnectSession, task) && UA_STATUSCODE_GOOD == task->result);
+        EDGE_LOG_V(TAG, "Reconnect attempt %u of session %u :: %s\n", attempt + 1, task->index,
+                UA_StatusCode_name(task->result));
+    }
+
+    endEdgeSessionReconnect(pool, task->index);
+    if (!connected && isPoolConnected(task->endpoint, pool))
+    {
+        EDGE_LOG(TAG, "Reconnecting failed. The endpoint is dropped.\n");
+        releaseEdgeSessionPool((EdgeSessionPool *) removeEdgeSession(task->endpoint));
+    }
+    releaseEdgeSessionPool(pool);
+    EdgeFree(task->endpoint);
+    EdgeFree(task);
+    return NULL;
+}
+
+static bool startReconnect(EdgeSessionPool *pool, UA_Client *client, uint32_t index,
+        const char *endpoint)
+{
+    ReconnectTask *task = (ReconnectTask *) EdgeCalloc(1, sizeof(ReconnectTask));
+    VERIFY_NON_NULL_MSG(task, "EdgeCalloc FAILED for ReconnectTask\n", false);
+    task->endpoint = cloneString(endpoint);
+    if (IS_NULL(task->endpoint))
+    {
+        EDGE_LOG(TAG, "cloneString FAILED for the endpoint of ReconnectTask\n");
+        EdgeFree(task);
+        return false;
+    }
+    task->pool = pool;
+    task->client = client;
+    task->index = index;
+
+    retainEdgeSessionPool(pool);
+    pthread_t thread;
+    if (0 != pthread_create(&thread, NULL, &reconnect_thread_handler, (void *) task))
+    {
+        EDGE_LOG(TAG, "Failed to create the reconnect thread.\n");
+        releaseEdgeSessionPool(pool);
+        EdgeFree(task->endpoint);
+        EdgeFree(task);
+        return false;
+    }
+    pthread_detach(thread);
+    return true;
+}
+
+/**
+ * Reconnects the lost session if the endpoint is configured so, else drops the endpoint.
+ * Returns false if the session is being reconnected already, as a failed attempt is
+ * reported as a disconnection again.
+ */
+static bool onSessionLost(UA_Client *client, const char *endpoint)
+{
+    // The endpoint may have been connected again with a new pool of sessions.
+    EdgeSessionPool *pool = (EdgeSessionPool *) retainEdgeSession(endpoint, 0,
+            retainEdgeSessionPool);
+    uint32_t index = 0;
+    bool lost = true;
+    if (getEdgeSessionIndex(pool, client, &index))
+    {
+        if (!pool->reconnect.enabled)
+        {
+            releaseEdgeSessionPool((EdgeSessionPool *) removeEdgeSession(endpoint));
+        }
+        else if (!beginEdgeSessionReconnect(pool, index))
+        {
+            lost = false;
+        }
+        else if (!startReconnect(pool, client, index, endpoint))
+        {
+            endEdgeSessionReconnect(pool, index);
+            releaseEdgeSessionPool((EdgeSessionPool *) removeEdgeSession(endpoint));
+        }
+    }
+    releaseEdgeSessionPool(pool);
+    return lost;
 }
 
 void edgeStatusCallback(UA_Client *client, UA_ClientState clientState)
@@ -178,8 +506,10 @@ void edgeStatusCallback(UA_Client *client, UA_ClientState clientState)
 
         if(clientState == UA_CLIENTSTATE_DISCONNECTED)
         {
-            removeClientFromSessionMap(ep->endpointUri);
-            g_statusCallback(ep, STATUS_DISCONNECTED);
+            if (onSessionLost(client, ep->endpointUri))
+            {
+                g_statusCallback(ep, STATUS_DISCONNECTED);
+            }
         }
         else if(clientState == UA_CLIENTSTATE_CONNECTED)
         {
@@ -188,15 +518,25 @@ void edgeStatusCallback(UA_Client *client, UA_ClientState clientState)
     }
 }
 
-bool connect_client(char *endpoint)
+bool connect_client(char *endpoint, EdgeEndpointConfig *endpointConfig)
 {
     UA_StatusCode retVal;
     UA_ClientConfig config = UA_ClientConfig_default;
     config.stateCallback = edgeStatusCallback;
 
-    UA_Client *m_client = NULL;
-    char *m_port = NULL;
+    uint32_t sessionCount = 1;
+    EdgeSessionPolicy sessionPolicy = EDGE_SESSION_POLICY_ROUND_ROBIN;
+    bool dedicatedSubscriptionSession = false;
+    if (IS_NOT_NULL(endpointConfig) && endpointConfig->sessionCount > 1)
+    {
+        sessionCount = (endpointConfig->sessionCount < EDGE_SESSION_POOL_MAX_SIZE) ?
+                endpointConfig->sessionCount : EDGE_SESSION_POOL_MAX_SIZE;
+        sessionPolicy = endpointConfig->sessionPolicy;
+        dedicatedSubscriptionSession = endpointConfig->dedicatedSubscriptionSession;
+    }
+
     char *m_endpoint = (char*) EdgeCalloc(strlen(endpoint) + 1, sizeof(char));
+    VERIFY_NON_NULL_MSG(m_endpoint, "EdgeCalloc FAILED for m_endpoint in connect_client\n", false);
     strncpy(m_endpoint, endpoint, strlen(endpoint));
 
     printf("connect endpoint :: %s\n", endpoint);
@@ -208,28 +548,55 @@ bool connect_client(char *endpoint)
         return false;
     }
 
-    m_client = UA_Client_new(config);
-    VERIFY_NON_NULL_MSG(m_client, "NULL CLIENT received in connect_client\n", false);
-
-    retVal = UA_Client_connect(m_client, m_endpoint);
-    if (retVal != UA_STATUSCODE_GOOD)
+    EdgeSessionPool *pool = createEdgeSessionPool(sessionCount, sessionPolicy,
+            dedicatedSubscriptionSession, destroyPoolClient);
+    if (IS_NULL(pool))
     {
-        EDGE_LOG_V(TAG, "\n [CLIENT] Unable to connect 0x%08x!\n", retVal);
-        UA_Client_delete(m_client);
         EdgeFree(m_endpoint);
         return false;
     }
+    if (IS_NOT_NULL(endpointConfig) && endpointConfig->autoReconnect)
+    {
+        EdgeSessionReconnect reconnect = { true, endpointConfig->reconnectInitialDelay,
+                endpointConfig->reconnectMaxDelay, endpointConfig->reconnectMaxAttempts };
+        setEdgeSessionReconnect(pool, &reconnect);
+    }
+
+    for (uint32_t i = 0; i < sessionCount; i++)
+    {
+        UA_Client *m_client = UA_Client_new(config);
+        if (IS_NULL(m_client))
+        {
+            EDGE_LOG(TAG, "NULL CLIENT received in connect_client\n");
+            releaseEdgeSessionPool(pool);
+            EdgeFree(m_endpoint);
+            return false;
+        }
+
+        retVal = UA_Client_connect(m_client, m_endpoint);
+        if (retVal != UA_STATUSCODE_GOOD)
+        {
+            EDGE_LOG_V(TAG, "\n [CLIENT] Unable to connect 0x%08x!\n", retVal);
+            UA_Client_delete(m_client);
+            // Deletes the sessions which are connected already.
+            releaseEdgeSessionPool(pool);
+            EdgeFree(m_endpoint);
+            return false;
+        }
+        setEdgeSessionPoolSession(pool, i, m_client);
+        loadServerCapabilities(m_client);
+    }
 
-    EDGE_LOG(TAG, "\n [CLIENT] Client connection successful \n");
-    getAddressPort(m_endpoint, &m_port);
+    EDGE_LOG_V(TAG, "\n [CLIENT] Client connection successful (%u sessions)\n", sessionCount);
 
-    // Add the client to session map
-    if (NULL == sessionClientMap)
+    // Add the sessions to session table
+    if (!addEdgeSession(m_endpoint, pool))
     {
-        sessionClientMap = createMap();
+        EDGE_LOG(TAG, "Failed to add the client to the session table.\n");
+        releaseEdgeSessionPool(pool);
+        EdgeFree(m_endpoint);
+        return false;
     }
-    insertMapElement(sessionClientMap, (keyValue) m_port, (keyValue) m_client);
-    clientCount++;
 
     EdgeEndPointInfo *ep = (EdgeEndPointInfo *) EdgeCalloc(1, sizeof(EdgeEndPointInfo));
     VERIFY_NON_NULL_MSG(ep, "EdgeCalloc FAILED for EdgeEndPointInfo\n", false);
@@ -243,30 +610,17 @@ bool connect_client(char *endpoint)
 
 void disconnect_client(EdgeEndPointInfo *epInfo)
 {
-    edgeMapNode *session = NULL;
-    session = removeClientFromSessionMap(epInfo->endpointUri);
-    if (session)
+    EdgeSessionPool *pool = (EdgeSessionPool *) removeEdgeSession(epInfo->endpointUri);
+    if (pool)
     {
-        if (session->key)
-        {
-            free(session->key);
-            session->key = NULL;
-        }
-        if (session->value)
-        {
-            UA_Client *m_client = (UA_Client*) session->value;
-            UA_Client_delete(m_client);
-            m_client = NULL;
-        }
-        free(session);
-        session = NULL;
-        clientCount--;
+        // Requests still running on other send threads keep their session until they are done.
+        releaseEdgeSessionPool(pool);
         g_statusCallback(epInfo, STATUS_STOP_CLIENT);
 
-        if (0 == clientCount)
+        // Counted under the lock of the session table, as other send threads add and remove
+        // sessions too.
+        if (0 == getEdgeSessionCount())
         {
-            free(sessionClientMap);
-            sessionClientMap = NULL;
             /* Delete all the messages in send and receiver queue */
             delete_queue();
         }
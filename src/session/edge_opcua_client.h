@@ -31,6 +31,7 @@
 
 #include "opcua_common.h"
 #include "command_adapter.h"
+#include "caserialexecutor.h"
 
 #ifdef ENABLE_SUB_QUEUE
 #include "edge_utils.h"
@@ -126,14 +127,28 @@ typedef struct UA_Client {
  */
 void setSupportedApplicationTypes(uint8_t supportedTypes);
 
+/**
+ * @brief Set whether the data change notifications are delivered in batches
+ * @param[in]  enabled true to deliver the notifications of one publish cycle in one message
+ * @param[in]  maxReports maximum number of notifications in one message. 0 selects the default.
+ */
+void configureReportBatch(bool enabled, uint32_t maxReports);
+
+/**
+ * @brief Set whether the results of group reads are delivered in one block
+ * @param[in]  flat true to deliver the results in one EdgeFlatResults
+ */
+void configureReadResultLayout(bool flat);
+
 /**
  * @brief Establishes client connection
  * @param[in]  endpoint Endpoint Uri
+ * @param[in]  endpointConfig Endpoint configuration with the number of sessions to open. May be NULL.
  * @return @c true on success, false in case of error
  * @retval #true Successful
  * @retval #false Error
  */
-bool connect_client(char *endpoint);
+bool connect_client(char *endpoint, EdgeEndpointConfig *endpointConfig);
 
 /**
  * @brief Close the client connection
@@ -180,6 +195,47 @@ EdgeResult client_getEndpoints(char *endpointUri);
  */
 EdgeResult readNodesFromServer(EdgeMessage *msg);
 
+/**
+ * @brief Send the read request data of several messages to server in one request
+ * @param[in]  msgs EdgeMessage request data. All of them have the same endpoint and command.
+ * @param[in]  count Number of messages.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult readNodesBatchFromServer(EdgeMessage **msgs, size_t count);
+
+/**
+ * @brief Sends an error response for a request which is dropped before it was sent
+ * @param[in]  msg EdgeMessage request data
+ * @param[in]  code Result code of the error response
+ * @param[in]  reason Why the request was dropped
+ */
+void discardRequest(EdgeMessage *msg, EdgeStatusCode code, const char *reason);
+
+/**
+ * @brief Chooses the client session which serves a request to be queued
+ * @param[in]  msg EdgeMessage request data
+ * @return index of the session among the sessions of the endpoint
+ */
+uint32_t selectMessageSession(EdgeMessage *msg);
+
+/**
+ * @brief Queues a task on the executor of the session the client belongs to. The task
+ *        never runs beside another call on the client.
+ * @param[in]  client Client handle
+ * @param[in]  task Function to be called
+ * @param[in]  data Data passed to task
+ * @return @c true on success, false if the client has no session or memory allocation failed
+ */
+bool submitSessionTask(UA_Client *client, CASerialTask task, void *data);
+
+/**
+ * @brief Gives back the client session of a request which is done
+ * @param[in]  msg EdgeMessage request data
+ */
+void releaseMessageSession(EdgeMessage *msg);
+
 /**
  * @brief Send the write request data to server
  * @param[in]  msg EdgeMessage request data.
@@ -95,16 +95,7 @@ void printNodeListInServer()
 static void* getNamespaceIndex(const char *namespaceUri)
 {
     VERIFY_NON_NULL_MSG(namespaceMap, "", NULL);
-    edgeMapNode *temp = namespaceMap->head;
-    while (temp != NULL)
-    {
-        char *uri = (char*) temp->key;
-        if (!strcmp(uri, namespaceUri))
-            return temp->value;
-
-        temp = temp->next;
-    }
-    return NULL;
+    return getMapElement(namespaceMap, (keyValue) namespaceUri);
 }
 
 EdgeResult createNamespaceInServer(const char *namespaceUri, const char *rootNodeIdentifier,
@@ -150,8 +141,13 @@ EdgeResult createNamespaceInServer(const char *namespaceUri, const char *rootNod
     strncpy(ns->rootNodeDisplayName, rootNodeDisplayName, strlen(rootNodeDisplayName)+1);
 
     if (namespaceMap == NULL)
-        namespaceMap = createMap();
-    insertMapElement(namespaceMap, (keyValue) namespaceUri, (keyValue) ns);
+        namespaceMap = createStringMap();
+    if (IS_NULL(namespaceMap)
+        || !insertMapElement(namespaceMap, (keyValue) namespaceUri, (keyValue) ns))
+    {
+        EDGE_LOG(TAG, "Failed to add the namespace to the namespace map.");
+        goto NAMESPACE_ERROR;
+    }
     return result;
 
 NAMESPACE_ERROR:
@@ -372,7 +368,12 @@ void stop_server(EdgeEndPointInfo *epInfo)
     UA_ServerConfig_delete(m_serverConfig);
     EDGE_LOG(TAG, "\n ========= [SERVER] Server Stopped ============= \n");
 
-    namespaceMap = NULL;
+    if (namespaceMap)
+    {
+        deleteMap(namespaceMap);
+        EdgeFree(namespaceMap);
+        namespaceMap = NULL;
+    }
     g_statusCallback(epInfo, STATUS_STOP_SERVER);
 }
 
@@ -0,0 +1,235 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#include "edge_server_capabilities.h"
+#include "edge_opcua_client.h"
+#include "edge_map.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+
+#define TAG "server_capabilities"
+
+/* Nodes read at connect time, in the order of the read request. */
+enum
+{
+    CAPABILITY_MAX_BROWSE_CONTINUATION_POINTS = 0,
+    CAPABILITY_MAX_NODES_PER_READ,
+    CAPABILITY_MAX_NODES_PER_WRITE,
+    CAPABILITY_MAX_NODES_PER_METHOD_CALL,
+    CAPABILITY_MAX_NODES_PER_BROWSE,
+    CAPABILITY_MAX_MONITORED_ITEMS_PER_CALL,
+    CAPABILITY_COUNT
+};
+
+static const UA_UInt32 g_capabilityNodes[CAPABILITY_COUNT] =
+{
+    UA_NS0ID_SERVER_SERVERCAPABILITIES_MAXBROWSECONTINUATIONPOINTS,
+    UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERREAD,
+    UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERWRITE,
+    UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERMETHODCALL,
+    UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERBROWSE,
+    UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXMONITOREDITEMSPERCALL
+};
+
+static pthread_rwlock_t g_capabilitiesLock = PTHREAD_RWLOCK_INITIALIZER;
+/* EdgeServerCapabilities keyed by client handle. */
+static edgeMap *g_capabilitiesMap = NULL;
+
+static void initServerCapabilities(EdgeServerCapabilities *capabilities)
+{
+    memset(capabilities, 0, sizeof(EdgeServerCapabilities));
+    // Server's mandatory property. Minimum value assumed.
+    capabilities->maxBrowseContinuationPoints = 1;
+}
+
+static UA_UInt32 getUInt32Value(const UA_DataValue *value, UA_UInt32 defaultValue)
+{
+    if (value->hasStatus && UA_STATUSCODE_GOOD != value->status)
+    {
+        return defaultValue;
+    }
+    COND_CHECK((!value->hasValue || !UA_Variant_isScalar(&value->value)), defaultValue);
+    if (value->value.type == &UA_TYPES[UA_TYPES_UINT32])
+    {
+        return *(UA_UInt32 *) value->value.data;
+    }
+    if (value->value.type == &UA_TYPES[UA_TYPES_UINT16])
+    {
+        return *(UA_UInt16 *) value->value.data;
+    }
+    return defaultValue;
+}
+
+static void readServerCapabilities(UA_Client *client, EdgeServerCapabilities *capabilities)
+{
+    UA_ReadValueId rv[CAPABILITY_COUNT];
+    for (size_t i = 0; i < CAPABILITY_COUNT; i++)
+    {
+        UA_ReadValueId_init(&rv[i]);
+        rv[i].nodeId = UA_NODEID_NUMERIC(0, g_capabilityNodes[i]);
+        rv[i].attributeId = UA_ATTRIBUTEID_VALUE;
+    }
+
+    UA_ReadRequest readRequest;
+    UA_ReadRequest_init(&readRequest);
+    readRequest.nodesToRead = rv;
+    readRequest.nodesToReadSize = CAPABILITY_COUNT;
+    readRequest.timestampsToReturn = UA_TIMESTAMPSTORETURN_NEITHER;
+
+    UA_ReadResponse readResponse = UA_Client_Service_read(client, readRequest);
+    if (UA_STATUSCODE_GOOD != readResponse.responseHeader.serviceResult
+            || CAPABILITY_COUNT != readResponse.resultsSize)
+    {
+        EDGE_LOG_V(TAG, "Failed to read the server capabilities :: %s\n",
+                UA_StatusCode_name(readResponse.responseHeader.serviceResult));
+        UA_ReadResponse_deleteMembers(&readResponse);
+        return;
+    }
+
+    UA_DataValue *results = readResponse.results;
+    UA_UInt32 maxBrowseContinuationPoints = getUInt32Value(
+            &results[CAPABILITY_MAX_BROWSE_CONTINUATION_POINTS],
+            capabilities->maxBrowseContinuationPoints);
+    capabilities->maxBrowseContinuationPoints = (maxBrowseContinuationPoints < UINT16_MAX) ?
+            (uint16_t) maxBrowseContinuationPoints : UINT16_MAX;
+    capabilities->maxNodesPerRead = getUInt32Value(&results[CAPABILITY_MAX_NODES_PER_READ], 0);
+    capabilities->maxNodesPerWrite = getUInt32Value(&results[CAPABILITY_MAX_NODES_PER_WRITE], 0);
+    capabilities->maxNodesPerMethodCall = getUInt32Value(
+            &results[CAPABILITY_MAX_NODES_PER_METHOD_CALL], 0);
+    capabilities->maxNodesPerBrowse = getUInt32Value(&results[CAPABILITY_MAX_NODES_PER_BROWSE], 0);
+    capabilities->maxMonitoredItemsPerCall = getUInt32Value(
+            &results[CAPABILITY_MAX_MONITORED_ITEMS_PER_CALL], 0);
+    UA_ReadResponse_deleteMembers(&readResponse);
+
+    EDGE_LOG_V(TAG, "Server capabilities : read %u, write %u, call %u, browse %u, "
+            "monitored items %u, continuation points %u\n", capabilities->maxNodesPerRead,
+            capabilities->maxNodesPerWrite, capabilities->maxNodesPerMethodCall,
+            capabilities->maxNodesPerBrowse, capabilities->maxMonitoredItemsPerCall,
+            capabilities->maxBrowseContinuationPoints);
+}
+
+bool loadServerCapabilities(UA_Client *client)
+{
+    VERIFY_NON_NULL_MSG(client, "NULL client param in loadServerCapabilities\n", false);
+
+    EdgeServerCapabilities read;
+    initServerCapabilities(&read);
+    readServerCapabilities(client, &read);
+    // The message size is negotiated when connecting, it is no node of the server.
+    read.maxMessageSize = client->connection.remoteConf.maxMessageSize;
+    return setServerCapabilities(client, &read);
+}
+
+bool setServerCapabilities(UA_Client *client, const EdgeServerCapabilities *capabilities)
+{
+    VERIFY_NON_NULL_MSG(client, "NULL client param in setServerCapabilities\n", false);
+    VERIFY_NON_NULL_MSG(capabilities, "NULL capabilities param in setServerCapabilities\n",
+            false);
+
+    EdgeServerCapabilities read = *capabilities;
+    bool loaded = false;
+    pthread_rwlock_wrlock(&g_capabilitiesLock);
+    if (NULL == g_capabilitiesMap)
+    {
+        g_capabilitiesMap = createMap();
+    }
+    if (g_capabilitiesMap)
+    {
+        EdgeServerCapabilities *capabilities = (EdgeServerCapabilities *) getMapElement(
+                g_capabilitiesMap, (keyValue) client);
+        if (capabilities)
+        {
+            *capabilities = read;
+            loaded = true;
+        }
+        else
+        {
+            capabilities = (EdgeServerCapabilities *) EdgeMalloc(sizeof(EdgeServerCapabilities));
+            if (capabilities)
+            {
+                *capabilities = read;
+                loaded = insertMapElement(g_capabilitiesMap, (keyValue) client, capabilities);
+            }
+            if (!loaded)
+            {
+                EdgeFree(capabilities);
+            }
+        }
+    }
+    pthread_rwlock_unlock(&g_capabilitiesLock);
+
+    if (!loaded)
+    {
+        EDGE_LOG(TAG, "Failed to cache the server capabilities.\n");
+    }
+    return loaded;
+}
+
+bool getServerCapabilities(UA_Client *client, EdgeServerCapabilities *capabilities)
+{
+    VERIFY_NON_NULL_MSG(capabilities, "NULL capabilities param in getServerCapabilities\n", false);
+    initServerCapabilities(capabilities);
+    COND_CHECK((IS_NULL(client)), false);
+
+    bool found = false;
+    pthread_rwlock_rdlock(&g_capabilitiesLock);
+    if (g_capabilitiesMap)
+    {
+        EdgeServerCapabilities *cached = (EdgeServerCapabilities *) getMapElement(
+                g_capabilitiesMap, (keyValue) client);
+        if (cached)
+        {
+            *capabilities = *cached;
+            found = true;
+        }
+    }
+    pthread_rwlock_unlock(&g_capabilitiesLock);
+    return found;
+}
+
+void removeServerCapabilities(UA_Client *client)
+{
+    COND_CHECK_NR_MSG((IS_NULL(client)), "");
+
+    keyValue value = NULL;
+    pthread_rwlock_wrlock(&g_capabilitiesLock);
+    if (g_capabilitiesMap && removeMapElement(g_capabilitiesMap, (keyValue) client, NULL, &value)
+            && 0 == getMapSize(g_capabilitiesMap))
+    {
+        deleteMap(g_capabilitiesMap);
+        EdgeFree(g_capabilitiesMap);
+        g_capabilitiesMap = NULL;
+    }
+    pthread_rwlock_unlock(&g_capabilitiesLock);
+    EdgeFree(value);
+}
+
+size_t getOperationChunkSize(uint32_t limit, size_t count)
+{
+    return (0 == limit || count <= limit) ? count : limit;
+}
@@ -0,0 +1,106 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_server_capabilities.h
+ *
+ * @brief This file contains the cache of the server capabilities of the client sessions.
+ *
+ * The ServerCapabilities and OperationLimits of the server are read in one request when
+ * a session is connected, and kept per client handle, so the commands can split their
+ * requests to the limits of the server without asking it again. A limit of 0 means the
+ * server does not limit the operation.
+ */
+
+#ifndef EDGE_SERVER_CAPABILITIES_H
+#define EDGE_SERVER_CAPABILITIES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "open62541.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct EdgeServerCapabilities
+{
+    /** Most nodes in one read request. */
+    uint32_t maxNodesPerRead;
+    /** Most nodes in one write request. */
+    uint32_t maxNodesPerWrite;
+    /** Most methods in one call request. */
+    uint32_t maxNodesPerMethodCall;
+    /** Most monitored items in one create, modify or delete request. */
+    uint32_t maxMonitoredItemsPerCall;
+    /** Most nodes in one browse request. */
+    uint32_t maxNodesPerBrowse;
+    /** Most continuation points the server keeps for one session. 1 if the server does not tell. */
+    uint16_t maxBrowseContinuationPoints;
+    /** Largest message the server accepts on the connection, 0 for no limit. */
+    uint32_t maxMessageSize;
+} EdgeServerCapabilities;
+
+/**
+ * @brief Reads the capabilities of the server the client is connected to, and caches them
+ *        for the client. Capabilities the server does not provide are left without limit.
+ * @param[in]  client Client handle.
+ * @return @c true on success, false if memory allocation failed.
+ */
+bool loadServerCapabilities(UA_Client *client);
+
+/**
+ * @brief Caches capabilities for the client, in place of the ones of its server.
+ * @param[in]  client Client handle.
+ * @param[in]  capabilities Capabilities. They are copied.
+ * @return @c true on success, false if a parameter is invalid or memory allocation failed.
+ */
+bool setServerCapabilities(UA_Client *client, const EdgeServerCapabilities *capabilities);
+
+/**
+ * @brief Gets the cached capabilities of the server of the client.
+ * @param[in]  client Client handle.
+ * @param[out] capabilities Capabilities. Without limits, if none are cached.
+ * @return @c true if the capabilities were cached.
+ */
+bool getServerCapabilities(UA_Client *client, EdgeServerCapabilities *capabilities);
+
+/**
+ * @brief Removes the cached capabilities of the client.
+ * @param[in]  client Client handle.
+ */
+void removeServerCapabilities(UA_Client *client);
+
+/**
+ * @brief Gets the number of operations to send in one request.
+ * @param[in]  limit Limit of the server, 0 for no limit.
+ * @param[in]  count Number of operations left.
+ * @return count, if it is within the limit, else the limit.
+ */
+size_t getOperationChunkSize(uint32_t limit, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_SERVER_CAPABILITIES_H
@@ -0,0 +1,253 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_session_pool.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "ocatomic.h"
+
+#define TAG "session_pool"
+
+static void freeSessionPool(EdgeSessionPool *pool)
+{
+    for (uint32_t i = 0; pool->sessions && i < pool->size; i++)
+    {
+        if (pool->destroy && pool->sessions[i])
+        {
+            pool->destroy(pool->sessions[i]);
+        }
+    }
+    for (uint32_t i = 0; pool->executors && i < pool->size; i++)
+    {
+        CASerialExecutorDestroy(&pool->executors[i]);
+    }
+    EdgeFree(pool->sessions);
+    EdgeFree(pool->executors);
+    EdgeFree((void *) pool->outstanding);
+    EdgeFree((void *) pool->reconnecting);
+    EdgeFree(pool);
+}
+
+EdgeSessionPool *createEdgeSessionPool(uint32_t size, EdgeSessionPolicy policy,
+        bool dedicatedSubscriptionSession, edge_session_destroy_cb_t destroy)
+{
+    COND_CHECK_MSG((0 == size || size > EDGE_SESSION_POOL_MAX_SIZE),
+            "Invalid size param in createEdgeSessionPool\n", NULL);
+
+    EdgeSessionPool *pool = (EdgeSessionPool *) EdgeCalloc(1, sizeof(EdgeSessionPool));
+    VERIFY_NON_NULL_MSG(pool, "EdgeCalloc FAILED for EdgeSessionPool\n", NULL);
+    pool->size = size;
+    pool->policy = policy;
+    pool->dedicatedSubscriptionSession = dedicatedSubscriptionSession && size > 1;
+    pool->refCount = 1;
+    pool->destroy = destroy;
+
+    pool->sessions = (void **) EdgeCalloc(size, sizeof(void *));
+    pool->outstanding = (volatile uint32_t *) EdgeCalloc(size, sizeof(uint32_t));
+    pool->reconnecting = (volatile uint32_t *) EdgeCalloc(size, sizeof(uint32_t));
+    pool->executors = (CASerialExecutor_t *) EdgeCalloc(size, sizeof(CASerialExecutor_t));
+    if (IS_NULL(pool->sessions) || IS_NULL(pool->outstanding) || IS_NULL(pool->reconnecting)
+            || IS_NULL(pool->executors))
+    {
+        EDGE_LOG(TAG, "EdgeCalloc FAILED for the sessions of EdgeSessionPool\n");
+        freeSessionPool(pool);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < size; i++)
+    {
+        if (CA_STATUS_OK != CASerialExecutorInitialize(&pool->executors[i]))
+        {
+            EDGE_LOG(TAG, "CASerialExecutorInitialize FAILED for EdgeSessionPool\n");
+            freeSessionPool(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+void retainEdgeSessionPool(void *pool)
+{
+    VERIFY_NON_NULL_NR_MSG(pool, "NULL pool param in retainEdgeSessionPool\n");
+    OC_ATOMIC_FETCH_ADD(&((EdgeSessionPool *) pool)->refCount, 1);
+}
+
+void releaseEdgeSessionPool(EdgeSessionPool *pool)
+{
+    if (IS_NULL(pool))
+    {
+        return;
+    }
+    if (1 == OC_ATOMIC_FETCH_SUB(&pool->refCount, 1))
+    {
+        freeSessionPool(pool);
+    }
+}
+
+bool setEdgeSessionPoolSession(EdgeSessionPool *pool, uint32_t index, void *session)
+{
+    VERIFY_NON_NULL_MSG(pool, "NULL pool param in setEdgeSessionPoolSession\n", false);
+    COND_CHECK((index >= pool->size), false);
+    pool->sessions[index] = session;
+    return true;
+}
+
+void *getEdgeSessionPoolSession(const EdgeSessionPool *pool, uint32_t index)
+{
+    VERIFY_NON_NULL_MSG(pool, "NULL pool param in getEdgeSessionPoolSession\n", NULL);
+    // The index may be from a pool which the endpoint had before it reconnected.
+    return pool->sessions[(index < pool->size) ? index : 0];
+}
+
+CASerialExecutor_t *getEdgeSessionExecutor(EdgeSessionPool *pool, uint32_t index)
+{
+    VERIFY_NON_NULL_MSG(pool, "NULL pool param in getEdgeSessionExecutor\n", NULL);
+    return &pool->executors[(index < pool->size) ? index : 0];
+}
+
+bool getEdgeSessionIndex(const EdgeSessionPool *pool, const void *session, uint32_t *index)
+{
+    COND_CHECK((IS_NULL(pool) || IS_NULL(session)), false);
+    for (uint32_t i = 0; i < pool->size; i++)
+    {
+        if (pool->sessions[i] == session)
+        {
+            if (index)
+            {
+                *index = i;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool containsEdgeSessionPoolSession(const EdgeSessionPool *pool, const void *session)
+{
+    return getEdgeSessionIndex(pool, session, NULL);
+}
+
+uint32_t acquireEdgeSessionIndex(EdgeSessionPool *pool, EdgeSessionRequestKind kind)
+{
+    VERIFY_NON_NULL_MSG(pool, "NULL pool param in acquireEdgeSessionIndex\n", 0);
+
+    uint32_t index = EDGE_SESSION_POOL_SUBSCRIPTION_INDEX;
+    uint32_t first = (pool->dedicatedSubscriptionSession && pool->size > 1) ? 1 : 0;
+    if (EDGE_SESSION_REQUEST_ORDERED == kind)
+    {
+        index = first;
+    }
+    else if (EDGE_SESSION_REQUEST_ANY == kind && pool->size > 1)
+    {
+        uint32_t count = pool->size - first;
+        uint32_t turn = OC_ATOMIC_FETCH_ADD(&pool->cursor, 1);
+        index = first + turn % count;
+
+        if (EDGE_SESSION_POLICY_LEAST_OUTSTANDING == pool->policy)
+        {
+            // Ties go to the session whose turn it is, so an idle pool still rotates.
+            uint32_t fewest = OC_ATOMIC_LOAD(&pool->outstanding[index]);
+            for (uint32_t i = 1; i < count && fewest > 0; i++)
+            {
+                uint32_t candidate = first + (turn + i) % count;
+                uint32_t outstanding = OC_ATOMIC_LOAD(&pool->outstanding[candidate]);
+                if (outstanding < fewest)
+                {
+                    fewest = outstanding;
+                    index = candidate;
+                }
+            }
+        }
+    }
+
+    OC_ATOMIC_FETCH_ADD(&pool->outstanding[index], 1);
+    return index;
+}
+
+void releaseEdgeSessionIndex(EdgeSessionPool *pool, uint32_t index)
+{
+    VERIFY_NON_NULL_NR_MSG(pool, "NULL pool param in releaseEdgeSessionIndex\n");
+    COND_CHECK_NR_MSG((index >= pool->size), "Invalid index param in releaseEdgeSessionIndex\n");
+
+    // Never below zero, for a request which took its index from an earlier pool.
+    uint32_t outstanding = OC_ATOMIC_LOAD(&pool->outstanding[index]);
+    while (outstanding > 0
+            && !OC_ATOMIC_CAS(&pool->outstanding[index], outstanding, outstanding - 1))
+    {
+        outstanding = OC_ATOMIC_LOAD(&pool->outstanding[index]);
+    }
+}
+
+uint32_t getEdgeSessionOutstanding(const EdgeSessionPool *pool, uint32_t index)
+{
+    COND_CHECK((IS_NULL(pool) || index >= pool->size), 0);
+    return OC_ATOMIC_LOAD(&pool->outstanding[index]);
+}
+
+void setEdgeSessionReconnect(EdgeSessionPool *pool, const EdgeSessionReconnect *reconnect)
+{
+    VERIFY_NON_NULL_NR_MSG(pool, "NULL pool param in setEdgeSessionReconnect\n");
+    VERIFY_NON_NULL_NR_MSG(reconnect, "NULL reconnect param in setEdgeSessionReconnect\n");
+
+    pool->reconnect = *reconnect;
+    if (0 == pool->reconnect.initialDelay)
+    {
+        pool->reconnect.initialDelay = EDGE_SESSION_RECONNECT_INITIAL_DELAY;
+    }
+    if (0 == pool->reconnect.maxDelay)
+    {
+        pool->reconnect.maxDelay = EDGE_SESSION_RECONNECT_MAX_DELAY;
+    }
+    if (pool->reconnect.maxDelay < pool->reconnect.initialDelay)
+    {
+        pool->reconnect.maxDelay = pool->reconnect.initialDelay;
+    }
+}
+
+bool beginEdgeSessionReconnect(EdgeSessionPool *pool, uint32_t index)
+{
+    COND_CHECK((IS_NULL(pool) || index >= pool->size || !pool->reconnect.enabled), false);
+    return OC_ATOMIC_CAS(&pool->reconnecting[index], 0, 1);
+}
+
+void endEdgeSessionReconnect(EdgeSessionPool *pool, uint32_t index)
+{
+    COND_CHECK_NR_MSG((IS_NULL(pool) || index >= pool->size),
+            "Invalid param in endEdgeSessionReconnect\n");
+    OC_ATOMIC_STORE(&pool->reconnecting[index], 0);
+}
+
+uint32_t getEdgeSessionReconnectDelay(const EdgeSessionPool *pool, uint32_t attempt,
+        uint32_t random)
+{
+    VERIFY_NON_NULL_MSG(pool, "NULL pool param in getEdgeSessionReconnectDelay\n", 0);
+
+    uint64_t delay = pool->reconnect.initialDelay;
+    for (uint32_t i = 0; i < attempt && delay < pool->reconnect.maxDelay; i++)
+    {
+        delay *= 2;
+    }
+    if (delay > pool->reconnect.maxDelay)
+    {
+        delay = pool->reconnect.maxDelay;
+    }
+    uint64_t jitter = delay / 2;
+    return (uint32_t) (delay - ((0 == jitter) ? 0 : random % (jitter + 1)));
+}
@@ -0,0 +1,248 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_session_pool.h
+ *
+ * @brief This file contains the pool of client sessions opened to one endpoint.
+ *
+ * A request takes a session index when it is queued and gives it back once it is done,
+ * so the pool knows how many requests each session has outstanding. Subscriptions are
+ * pinned to the first session, and requests which must keep their order to the first
+ * session not kept for subscriptions. Every session has a serial executor, through which all
+ * calls on the session are made, because a session must not be used by two threads at
+ * once. The pool is reference counted: it destroys its sessions when the last reference
+ * is released, so a request which is still running keeps its session alive after the
+ * endpoint was disconnected. A pool may reconnect its lost sessions, waiting longer after
+ * every failed attempt.
+ */
+
+#ifndef EDGE_SESSION_POOL_H
+#define EDGE_SESSION_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "opcua_common.h"
+#include "caserialexecutor.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Most sessions a pool holds. */
+#define EDGE_SESSION_POOL_MAX_SIZE (16)
+
+/** Index of the session which serves the subscriptions. */
+#define EDGE_SESSION_POOL_SUBSCRIPTION_INDEX (0)
+
+/** Delay before the first reconnect attempt in milliseconds, if none is configured. */
+#define EDGE_SESSION_RECONNECT_INITIAL_DELAY (500)
+
+/** Longest delay between reconnect attempts in milliseconds, if none is configured. */
+#define EDGE_SESSION_RECONNECT_MAX_DELAY (30000)
+
+/** How a pool reconnects its lost sessions. */
+typedef struct EdgeSessionReconnect
+{
+    /** Lost sessions are reconnected. */
+    bool enabled;
+    /** Delay before the first attempt in milliseconds. */
+    uint32_t initialDelay;
+    /** Longest delay between attempts in milliseconds. */
+    uint32_t maxDelay;
+    /** Attempts before giving up, 0 for no limit. */
+    uint32_t maxAttempts;
+} EdgeSessionReconnect;
+
+/**
+ * @brief Destroys a session of the pool.
+ * @param[in]  session Session.
+ */
+typedef void (*edge_session_destroy_cb_t) (void *session);
+
+/** Which sessions may serve a request. */
+typedef enum
+{
+    /** Any session, so requests may overtake each other. */
+    EDGE_SESSION_REQUEST_ANY = 0,
+    /** Always the same session, so the requests keep their order. */
+    EDGE_SESSION_REQUEST_ORDERED,
+    /** The session which serves the subscriptions. */
+    EDGE_SESSION_REQUEST_SUBSCRIPTION
+} EdgeSessionRequestKind;
+
+typedef struct EdgeSessionPool
+{
+    /** Number of sessions. */
+    uint32_t size;
+    /** How requests are spread over the sessions. */
+    EdgeSessionPolicy policy;
+    /** The first session only serves subscriptions. */
+    bool dedicatedSubscriptionSession;
+    /** Sessions. NULL until they are set. */
+    void **sessions;
+    /** Serial executor per session. */
+    CASerialExecutor_t *executors;
+    /** Requests queued or running per session. */
+    volatile uint32_t *outstanding;
+    /** Set per session while it is being reconnected. */
+    volatile uint32_t *reconnecting;
+    /** How lost sessions are reconnected. Disabled unless set. */
+    EdgeSessionReconnect reconnect;
+    /** Next session for round robin. */
+    volatile uint32_t cursor;
+    /** References held on the pool. */
+    volatile uint32_t refCount;
+    /** Destroys the sessions along with the pool. */
+    edge_session_destroy_cb_t destroy;
+} EdgeSessionPool;
+
+/**
+ * @brief Creates a pool without sessions. The caller holds the only reference.
+ * @param[in]  size Number of sessions, 1 to EDGE_SESSION_POOL_MAX_SIZE.
+ * @param[in]  policy How requests are spread over the sessions.
+ * @param[in]  dedicatedSubscriptionSession Keep the first session for subscriptions.
+ *             Ignored for a pool of one session.
+ * @param[in]  destroy Destroys the sessions when the pool is freed. May be NULL.
+ * @return pool on success, NULL if a parameter is invalid or memory allocation failed.
+ */
+EdgeSessionPool *createEdgeSessionPool(uint32_t size, EdgeSessionPolicy policy,
+        bool dedicatedSubscriptionSession, edge_session_destroy_cb_t destroy);
+
+/**
+ * @brief Adds a reference to the pool.
+ * @param[in]  pool Pool. It is a void pointer to be usable as retainEdgeSession() callback.
+ */
+void retainEdgeSessionPool(void *pool);
+
+/**
+ * @brief Releases a reference to the pool. The last one destroys the sessions and frees the pool.
+ * @param[in]  pool Pool. NULL is ignored.
+ */
+void releaseEdgeSessionPool(EdgeSessionPool *pool);
+
+/**
+ * @brief Sets a session of the pool.
+ * @param[in]  pool Pool.
+ * @param[in]  index Index of the session.
+ * @param[in]  session Session.
+ * @return @c true on success, false if index is out of range.
+ */
+bool setEdgeSessionPoolSession(EdgeSessionPool *pool, uint32_t index, void *session);
+
+/**
+ * @brief Gets a session of the pool.
+ * @param[in]  pool Pool.
+ * @param[in]  index Index of the session. An index out of range selects the first session.
+ * @return session, NULL if it is not set.
+ */
+void *getEdgeSessionPoolSession(const EdgeSessionPool *pool, uint32_t index);
+
+/**
+ * @brief Gets the executor through which the calls on a session are made.
+ * @param[in]  pool Pool.
+ * @param[in]  index Index of the session. An index out of range selects the first session.
+ * @return executor.
+ */
+CASerialExecutor_t *getEdgeSessionExecutor(EdgeSessionPool *pool, uint32_t index);
+
+/**
+ * @brief Gets the index of a session of the pool.
+ * @param[in]  pool Pool.
+ * @param[in]  session Session.
+ * @param[out] index Index of the session.
+ * @return @c true if the session is one of the pool.
+ */
+bool getEdgeSessionIndex(const EdgeSessionPool *pool, const void *session, uint32_t *index);
+
+/**
+ * @brief Checks whether the session belongs to the pool.
+ * @param[in]  pool Pool.
+ * @param[in]  session Session.
+ * @return @c true if the session is one of the pool.
+ */
+bool containsEdgeSessionPoolSession(const EdgeSessionPool *pool, const void *session);
+
+/**
+ * @brief Chooses the session for a request and counts the request as outstanding on it.
+ *        Requests of any kind are spread over the sessions by the policy of the pool.
+ * @param[in]  pool Pool.
+ * @param[in]  kind Which sessions may serve the request.
+ * @return index of the session.
+ */
+uint32_t acquireEdgeSessionIndex(EdgeSessionPool *pool, EdgeSessionRequestKind kind);
+
+/**
+ * @brief Counts a request chosen by acquireEdgeSessionIndex() as done.
+ * @param[in]  pool Pool.
+ * @param[in]  index Index of the session.
+ */
+void releaseEdgeSessionIndex(EdgeSessionPool *pool, uint32_t index);
+
+/**
+ * @brief Gets the number of requests outstanding on a session.
+ * @param[in]  pool Pool.
+ * @param[in]  index Index of the session.
+ * @return number of requests, 0 if index is out of range.
+ */
+uint32_t getEdgeSessionOutstanding(const EdgeSessionPool *pool, uint32_t index);
+
+/**
+ * @brief Sets how the pool reconnects its lost sessions.
+ * @param[in]  pool Pool.
+ * @param[in]  reconnect Reconnect settings. Delays of 0 select the defaults.
+ */
+void setEdgeSessionReconnect(EdgeSessionPool *pool, const EdgeSessionReconnect *reconnect);
+
+/**
+ * @brief Marks a session as being reconnected.
+ * @param[in]  pool Pool.
+ * @param[in]  index Index of the session.
+ * @return @c true if the caller is to reconnect the session, false if reconnecting is
+ *         disabled, index is out of range or the session is being reconnected already.
+ */
+bool beginEdgeSessionReconnect(EdgeSessionPool *pool, uint32_t index);
+
+/**
+ * @brief Marks a session, for which beginEdgeSessionReconnect() succeeded, as done.
+ * @param[in]  pool Pool.
+ * @param[in]  index Index of the session.
+ */
+void endEdgeSessionReconnect(EdgeSessionPool *pool, uint32_t index);
+
+/**
+ * @brief Gets the delay before a reconnect attempt. The delay doubles with every attempt
+ *        up to the longest delay, and a random part of up to half of it is left out, so
+ *        sessions lost together do not reconnect at the same moment.
+ * @param[in]  pool Pool.
+ * @param[in]  attempt Number of the attempt, starting at 0.
+ * @param[in]  random Random number choosing the delay.
+ * @return delay in milliseconds.
+ */
+uint32_t getEdgeSessionReconnectDelay(const EdgeSessionPool *pool, uint32_t attempt,
+        uint32_t random);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_SESSION_POOL_H
@@ -0,0 +1,143 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#include "edge_session_table.h"
+#include "edge_map.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+
+#define TAG "session_table"
+
+/* Longest host:port accepted, with its NULL terminator. */
+#define MAX_ADDRESS_SIZE (512)
+
+static pthread_rwlock_t g_sessionLock = PTHREAD_RWLOCK_INITIALIZER;
+/* Sessions keyed by the address part of the endpoint URI. */
+static edgeMap *g_sessionMap = NULL;
+
+/* Copies the address part of the endpoint URI to a NULL terminated string. */
+static bool getSessionKey(const char *endpointUri, char *key)
+{
+    size_t length = 0;
+    const char *address = getEndpointAddress(endpointUri, &length);
+    COND_CHECK_MSG((length >= MAX_ADDRESS_SIZE), "Endpoint address is too long\n", false);
+    memcpy(key, address, length);
+    key[length] = '\0';
+    return true;
+}
+
+bool addEdgeSession(const char *endpointUri, void *session)
+{
+    VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri param in addEdgeSession\n", false);
+
+    char address[MAX_ADDRESS_SIZE];
+    COND_CHECK((!getSessionKey(endpointUri, address)), false);
+    char *key = cloneString(address);
+    VERIFY_NON_NULL_MSG(key, "cloneString FAILED for session key\n", false);
+
+    bool added = false;
+    pthread_rwlock_wrlock(&g_sessionLock);
+    if (NULL == g_sessionMap)
+    {
+        g_sessionMap = createStringMap();
+    }
+    if (g_sessionMap)
+    {
+        added = insertMapElement(g_sessionMap, key, session);
+    }
+    pthread_rwlock_unlock(&g_sessionLock);
+
+    if (!added)
+    {
+        EDGE_LOG(TAG, "Failed to add the session for the endpoint address.\n");
+        EdgeFree(key);
+    }
+    return added;
+}
+
+void *getEdgeSession(const char *endpointUri, uint32_t hash)
+{
+    return retainEdgeSession(endpointUri, hash, NULL);
+}
+
+void *retainEdgeSession(const char *endpointUri, uint32_t hash, edge_session_retain_cb_t retain)
+{
+    VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri param in getEdgeSession\n", NULL);
+
+    char address[MAX_ADDRESS_SIZE];
+    COND_CHECK((!getSessionKey(endpointUri, address)), NULL);
+
+    void *session = NULL;
+    pthread_rwlock_rdlock(&g_sessionLock);
+    if (g_sessionMap)
+    {
+        // hashEndpointAddress() hashes the address like the string map does.
+        if (0 == hash)
+        {
+            hash = getMapKeyHash(g_sessionMap, address);
+        }
+        session = getMapElementWithHash(g_sessionMap, address, hash);
+        if (session && retain)
+        {
+            retain(session);
+        }
+    }
+    pthread_rwlock_unlock(&g_sessionLock);
+    return session;
+}
+
+void *removeEdgeSession(const char *endpointUri)
+{
+    VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri param in removeEdgeSession\n", NULL);
+
+    char address[MAX_ADDRESS_SIZE];
+    COND_CHECK((!getSessionKey(endpointUri, address)), NULL);
+
+    keyValue key = NULL;
+    keyValue session = NULL;
+    pthread_rwlock_wrlock(&g_sessionLock);
+    if (g_sessionMap && removeMapElement(g_sessionMap, address, &key, &session)
+        && 0 == getMapSize(g_sessionMap))
+    {
+        deleteMap(g_sessionMap);
+        EdgeFree(g_sessionMap);
+        g_sessionMap = NULL;
+    }
+    pthread_rwlock_unlock(&g_sessionLock);
+
+    EdgeFree(key);
+    return session;
+}
+
+size_t getEdgeSessionCount()
+{
+    pthread_rwlock_rdlock(&g_sessionLock);
+    size_t count = getMapSize(g_sessionMap);
+    pthread_rwlock_unlock(&g_sessionLock);
+    return count;
+}
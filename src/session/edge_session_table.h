@@ -0,0 +1,95 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_session_table.h
+ *
+ * @brief This file contains the table of client sessions, indexed by endpoint address.
+ *
+ * Sessions are keyed by the address part (host:port) of the endpoint URI, so URIs which
+ * differ only in scheme or path share one session. The sessions are kept in a string
+ * edgeMap, whose key hash is the one computed by hashEndpointAddress(), so the caller
+ * can cache it. Lookups do not allocate and can run concurrently. Adding and removing
+ * sessions is serialized.
+ */
+
+#ifndef EDGE_SESSION_TABLE_H
+#define EDGE_SESSION_TABLE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Adds a session for the address of the endpoint URI.
+ * @param[in]  endpointUri Endpoint URI.
+ * @param[in]  session Session.
+ * @return @c true on success, false if the address has a session already or memory allocation failed.
+ */
+bool addEdgeSession(const char *endpointUri, void *session);
+
+/**
+ * @brief Gets the session for the address of the endpoint URI.
+ * @param[in]  endpointUri Endpoint URI.
+ * @param[in]  hash hashEndpointAddress() of endpointUri, or 0 to compute it.
+ * @return session, NULL if there is none.
+ */
+void *getEdgeSession(const char *endpointUri, uint32_t hash);
+
+/**
+ * @brief Callback Function to take a reference on a session found in the table
+ * @param[in]  session Session.
+ */
+typedef void (*edge_session_retain_cb_t) (void *session);
+
+/**
+ * @brief Gets the session for the address of the endpoint URI and retains it while
+ * the table is locked, so a concurrent removeEdgeSession() cannot free it before the
+ * caller is done with it.
+ * @param[in]  endpointUri Endpoint URI.
+ * @param[in]  hash hashEndpointAddress() of endpointUri, or 0 to compute it.
+ * @param[in]  retain Called with the session before it is returned.
+ * @return session, NULL if there is none.
+ */
+void *retainEdgeSession(const char *endpointUri, uint32_t hash, edge_session_retain_cb_t retain);
+
+/**
+ * @brief Removes the session for the address of the endpoint URI.
+ * @param[in]  endpointUri Endpoint URI.
+ * @return session which was removed, NULL if there was none.
+ */
+void *removeEdgeSession(const char *endpointUri);
+
+/**
+ * @brief Gets the number of sessions in the table.
+ * @return Number of sessions.
+ */
+size_t getEdgeSessionCount();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_SESSION_TABLE_H
@@ -0,0 +1,253 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#include "edge_value_cache.h"
+#include "edge_map.h"
+#include "octhread.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+
+#define TAG "value_cache"
+
+/* Longest key : namespace, attribute and the node, separated by ';'. */
+#define VALUE_CACHE_KEY_SIZE (512)
+
+struct EdgeValueCache
+{
+    /* CachedValue keyed by namespace, attribute and node. */
+    edgeMap *values;
+};
+
+typedef struct CachedValue
+{
+    /* Key of the value in the map, owned by the value. */
+    char *key;
+    UA_DataValue value;
+    /* Monotonic time the value was received, in microseconds. */
+    uint64_t time;
+} CachedValue;
+
+static pthread_rwlock_t g_valueCacheLock = PTHREAD_RWLOCK_INITIALIZER;
+/* EdgeValueCache keyed by client handle. */
+static edgeMap *g_valueCacheMap = NULL;
+
+/* The key holds the resolved NodeId, so every identifier type gets a key of its own. */
+static bool makeKey(char *key, const UA_NodeId *nodeId, UA_UInt32 attributeId)
+{
+    int len = -1;
+    switch (nodeId->identifierType)
+    {
+        case UA_NODEIDTYPE_NUMERIC:
+            len = snprintf(key, VALUE_CACHE_KEY_SIZE, "%u;%u;i=%u", nodeId->namespaceIndex,
+                    attributeId, nodeId->identifier.numeric);
+            break;
+        case UA_NODEIDTYPE_STRING:
+            len = snprintf(key, VALUE_CACHE_KEY_SIZE, "%u;%u;s=%.*s", nodeId->namespaceIndex,
+                    attributeId, (int) nodeId->identifier.string.length,
+                    (const char *) nodeId->identifier.string.data);
+            break;
+        case UA_NODEIDTYPE_BYTESTRING:
+            len = snprintf(key, VALUE_CACHE_KEY_SIZE, "%u;%u;b=%.*s", nodeId->namespaceIndex,
+                    attributeId, (int) nodeId->identifier.byteString.length,
+                    (const char *) nodeId->identifier.byteString.data);
+            break;
+        case UA_NODEIDTYPE_GUID:
+        {
+            const UA_Guid *guid = &nodeId->identifier.guid;
+            len = snprintf(key, VALUE_CACHE_KEY_SIZE,
+                    "%u;%u;g=%08x-%04x-%04x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+                    nodeId->namespaceIndex, attributeId, guid->data1, guid->data2, guid->data3,
+                    guid->data4[0], guid->data4[1], guid->data4[2], guid->data4[3],
+                    guid->data4[4], guid->data4[5], guid->data4[6], guid->data4[7]);
+            break;
+        }
+        default:
+            break;
+    }
+    return len > 0 && len < VALUE_CACHE_KEY_SIZE;
+}
+
+static void freeCachedValue(CachedValue *cached)
+{
+    UA_DataValue_deleteMembers(&cached->value);
+    EdgeFree(cached->key);
+    EdgeFree(cached);
+}
+
+static void freeValueCache(EdgeValueCache *cache)
+{
+    if (cache->values)
+    {
+        edgeMapNode *node = cache->values->head;
+        while (node)
+        {
+            edgeMapNode *next = node->next;
+            freeCachedValue((CachedValue *) node->value);
+            node = next;
+        }
+        deleteMap(cache->values);
+        EdgeFree(cache->values);
+    }
+    EdgeFree(cache);
+}
+
+static EdgeValueCache *createValueCache()
+{
+    EdgeValueCache *cache = (EdgeValueCache *) EdgeCalloc(1, sizeof(EdgeValueCache));
+    VERIFY_NON_NULL_MSG(cache, "EdgeCalloc FAILED for EdgeValueCache\n", NULL);
+    cache->values = createStringMap();
+    if (IS_NULL(cache->values))
+    {
+        EDGE_LOG(TAG, "Failed to create the map of EdgeValueCache\n");
+        EdgeFree(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+EdgeValueCache *getValueCache(UA_Client *client, bool create)
+{
+    COND_CHECK((IS_NULL(client)), NULL);
+
+    EdgeValueCache *cache = NULL;
+    pthread_rwlock_rdlock(&g_valueCacheLock);
+    if (g_valueCacheMap)
+    {
+        cache = (EdgeValueCache *) getMapElement(g_valueCacheMap, (keyValue) client);
+    }
+    pthread_rwlock_unlock(&g_valueCacheLock);
+    if (cache || !create)
+    {
+        return cache;
+    }
+
+    pthread_rwlock_wrlock(&g_valueCacheLock);
+    if (NULL == g_valueCacheMap)
+    {
+        g_valueCacheMap = createMap();
+    }
+    if (g_valueCacheMap)
+    {
+        cache = (EdgeValueCache *) getMapElement(g_valueCacheMap, (keyValue) client);
+        if (NULL == cache)
+        {
+            cache = createValueCache();
+            if (cache && !insertMapElement(g_valueCacheMap, (keyValue) client, cache))
+            {
+                freeValueCache(cache);
+                cache = NULL;
+            }
+        }
+    }
+    pthread_rwlock_unlock(&g_valueCacheLock);
+
+    if (IS_NULL(cache))
+    {
+        EDGE_LOG(TAG, "Failed to create the value cache.\n");
+    }
+    return cache;
+}
+
+void updateCachedValue(EdgeValueCache *cache, const UA_NodeId *nodeId, UA_UInt32 attributeId,
+        const UA_DataValue *value)
+{
+    COND_CHECK_NR_MSG((IS_NULL(cache) || IS_NULL(nodeId) || IS_NULL(value)), "");
+    if (!value->hasValue || (value->hasStatus && UA_STATUSCODE_GOOD != value->status))
+    {
+        return;
+    }
+
+    char key[VALUE_CACHE_KEY_SIZE];
+    COND_CHECK_NR_MSG((!makeKey(key, nodeId, attributeId)),
+            "Node identifier too long for the value cache\n");
+
+    CachedValue *cached = (CachedValue *) getMapElement(cache->values, (keyValue) key);
+    if (cached)
+    {
+        UA_DataValue_deleteMembers(&cached->value);
+    }
+    else
+    {
+        cached = (CachedValue *) EdgeCalloc(1, sizeof(CachedValue));
+        VERIFY_NON_NULL_NR_MSG(cached, "EdgeCalloc FAILED for CachedValue\n");
+        cached->key = cloneString(key);
+        if (IS_NULL(cached->key) || !insertMapElement(cache->values, (keyValue) cached->key, cached))
+        {
+            EDGE_LOG(TAG, "Failed to insert the value into the cache.\n");
+            EdgeFree(cached->key);
+            EdgeFree(cached);
+            return;
+        }
+    }
+
+    cached->time = oc_get_monotonic_time_us();
+    if (UA_STATUSCODE_GOOD != UA_DataValue_copy(value, &cached->value))
+    {
+        // Keep no stale value under a new time.
+        removeMapElement(cache->values, (keyValue) key, NULL, NULL);
+        UA_DataValue_init(&cached->value);
+        freeCachedValue(cached);
+    }
+}
+
+bool getCachedValue(EdgeValueCache *cache, const UA_NodeId *nodeId, UA_UInt32 attributeId,
+        double maxAge, UA_DataValue *value)
+{
+    COND_CHECK((IS_NULL(cache) || IS_NULL(nodeId) || IS_NULL(value) || maxAge <= 0), false);
+
+    char key[VALUE_CACHE_KEY_SIZE];
+    COND_CHECK((!makeKey(key, nodeId, attributeId)), false);
+
+    CachedValue *cached = (CachedValue *) getMapElement(cache->values, (keyValue) key);
+    COND_CHECK((IS_NULL(cached)), false);
+
+    double age = (double) (oc_get_monotonic_time_us() - cached->time) / 1000;
+    COND_CHECK((age > maxAge), false);
+    return UA_STATUSCODE_GOOD == UA_DataValue_copy(&cached->value, value);
+}
+
+void removeValueCache(UA_Client *client)
+{
+    COND_CHECK_NR_MSG((IS_NULL(client)), "");
+
+    keyValue cache = NULL;
+    pthread_rwlock_wrlock(&g_valueCacheLock);
+    if (g_valueCacheMap && removeMapElement(g_valueCacheMap, (keyValue) client, NULL, &cache)
+            && 0 == getMapSize(g_valueCacheMap))
+    {
+        deleteMap(g_valueCacheMap);
+        EdgeFree(g_valueCacheMap);
+        g_valueCacheMap = NULL;
+    }
+    pthread_rwlock_unlock(&g_valueCacheLock);
+    if (cache)
+    {
+        freeValueCache((EdgeValueCache *) cache);
+    }
+}
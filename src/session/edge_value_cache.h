@@ -0,0 +1,89 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_value_cache.h
+ *
+ * @brief This file contains the cache of the values last read or reported on a client session.
+ *
+ * A session gets a cache with its first read which accepts a cached value (maxAge).
+ * From then on the values of the reads and of the data change notifications of the
+ * session are kept, keyed by NodeId and attribute, so a later read can take the
+ * nodes whose value is fresh enough from the cache. The age of a value is the time since
+ * it was received. A cache is only used from the executor of its session, so it needs no
+ * lock of its own.
+ */
+
+#ifndef EDGE_VALUE_CACHE_H
+#define EDGE_VALUE_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "open62541.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct EdgeValueCache EdgeValueCache;
+
+/**
+ * @brief Gets the value cache of the client.
+ * @param[in]  client Client handle.
+ * @param[in]  create Creates the cache, if the client has none.
+ * @return cache, NULL if the client has none or memory allocation failed.
+ */
+EdgeValueCache *getValueCache(UA_Client *client, bool create);
+
+/**
+ * @brief Stores a value of a node in the cache. Values without a good status are not kept.
+ * @param[in]  cache Cache.
+ * @param[in]  nodeId NodeId of the node.
+ * @param[in]  attributeId Attribute the value belongs to.
+ * @param[in]  value Value, which is copied.
+ */
+void updateCachedValue(EdgeValueCache *cache, const UA_NodeId *nodeId, UA_UInt32 attributeId,
+        const UA_DataValue *value);
+
+/**
+ * @brief Gets a value of a node from the cache, if it is fresh enough.
+ * @param[in]  cache Cache.
+ * @param[in]  nodeId NodeId of the node.
+ * @param[in]  attributeId Attribute of the value.
+ * @param[in]  maxAge Oldest value accepted, in milliseconds.
+ * @param[out] value Copy of the cached value, to be freed with UA_DataValue_deleteMembers().
+ * @return @c true if the value was found and is not older than maxAge.
+ */
+bool getCachedValue(EdgeValueCache *cache, const UA_NodeId *nodeId, UA_UInt32 attributeId,
+        double maxAge, UA_DataValue *value);
+
+/**
+ * @brief Removes the value cache of the client, with all its values.
+ * @param[in]  client Client handle.
+ */
+void removeValueCache(UA_Client *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_VALUE_CACHE_H
@@ -0,0 +1,261 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#include "edge_arena.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+
+#define TAG "edge_arena"
+
+/** Alignment of every allocation. */
+#define ARENA_ALIGNMENT (16)
+
+#define ARENA_ALIGN_UP(size) (((size) + (ARENA_ALIGNMENT - 1)) & ~((size_t) ARENA_ALIGNMENT - 1))
+
+/** Every allocation is preceded by a header holding its size, for EdgeArenaRealloc(). */
+#define ARENA_HEADER_SIZE ARENA_ALIGN_UP(sizeof(size_t))
+
+typedef struct EdgeArenaSlab
+{
+    struct EdgeArenaSlab *next;
+    /** Usable bytes after the slab header. */
+    size_t capacity;
+    /** Bytes handed out so far. */
+    size_t used;
+} EdgeArenaSlab;
+
+#define ARENA_SLAB_HEADER_SIZE ARENA_ALIGN_UP(sizeof(EdgeArenaSlab))
+
+#define ARENA_SLAB_DATA(slab) ((uint8_t *) (slab) + ARENA_SLAB_HEADER_SIZE)
+
+struct EdgeArena
+{
+    /** First slab. Never freed before the arena itself. */
+    EdgeArenaSlab *first;
+    /** Slab allocations are currently served from. */
+    EdgeArenaSlab *current;
+    /** Sum of the slab capacities. */
+    size_t totalCapacity;
+    /** Link in the pool of released arenas. */
+    struct EdgeArena *nextFree;
+};
+
+static pthread_mutex_t g_poolMutex = PTHREAD_MUTEX_INITIALIZER;
+static EdgeArena *g_pool = NULL;
+static size_t g_poolCount = 0;
+
+/* Slabs are allocated with malloc() directly, as they never leave this file. */
+static EdgeArenaSlab *createSlab(size_t capacity)
+{
+    EdgeArenaSlab *slab = (EdgeArenaSlab *) malloc(ARENA_SLAB_HEADER_SIZE + capacity);
+    VERIFY_NON_NULL_MSG(slab, "malloc FAILED for EdgeArenaSlab\n", NULL);
+    slab->next = NULL;
+    slab->capacity = capacity;
+    slab->used = 0;
+    return slab;
+}
+
+static EdgeArena *createArena()
+{
+    EdgeArena *arena = (EdgeArena *) malloc(sizeof(EdgeArena));
+    VERIFY_NON_NULL_MSG(arena, "malloc FAILED for EdgeArena\n", NULL);
+    arena->first = createSlab(EDGE_ARENA_SLAB_SIZE);
+    if (IS_NULL(arena->first))
+    {
+        free(arena);
+        return NULL;
+    }
+    arena->current = arena->first;
+    arena->totalCapacity = EDGE_ARENA_SLAB_SIZE;
+    arena->nextFree = NULL;
+    return arena;
+}
+
+static void freeSlabs(EdgeArenaSlab *slab)
+{
+    while (slab)
+    {
+        EdgeArenaSlab *next = slab->next;
+        free(slab);
+        slab = next;
+    }
+}
+
+static void resetArena(EdgeArena *arena)
+{
+    if (arena->totalCapacity > EDGE_ARENA_MAX_RETAINED_SIZE)
+    {
+        freeSlabs(arena->first->next);
+        arena->first->next = NULL;
+        arena->totalCapacity = arena->first->capacity;
+    }
+    for (EdgeArenaSlab *slab = arena->first; slab; slab = slab->next)
+    {
+        slab->used = 0;
+    }
+    arena->current = arena->first;
+}
+
+EdgeArena *EdgeArenaAcquire()
+{
+    EdgeArena *arena = NULL;
+    pthread_mutex_lock(&g_poolMutex);
+    if (g_pool)
+    {
+        arena = g_pool;
+        g_pool = arena->nextFree;
+        g_poolCount--;
+    }
+    pthread_mutex_unlock(&g_poolMutex);
+
+    if (IS_NULL(arena))
+    {
+        arena = createArena();
+        VERIFY_NON_NULL_MSG(arena, "createArena FAILED in EdgeArenaAcquire\n", NULL);
+    }
+    arena->nextFree = NULL;
+    return arena;
+}
+
+void EdgeArenaRelease(EdgeArena *arena)
+{
+    if (IS_NULL(arena))
+    {
+        return;
+    }
+
+    resetArena(arena);
+
+    pthread_mutex_lock(&g_poolMutex);
+    if (g_poolCount < EDGE_ARENA_POOL_SIZE)
+    {
+        arena->nextFree = g_pool;
+        g_pool = arena;
+        g_poolCount++;
+        arena = NULL;
+    }
+    pthread_mutex_unlock(&g_poolMutex);
+
+    if (arena)
+    {
+        freeSlabs(arena->first);
+        free(arena);
+    }
+}
+
+void *EdgeArenaAlloc(EdgeArena *arena, size_t size)
+{
+    COND_CHECK((IS_NULL(arena)), EdgeMalloc(size));
+    COND_CHECK((0 == size), NULL);
+    COND_CHECK((size > SIZE_MAX - ARENA_HEADER_SIZE - ARENA_ALIGNMENT), NULL);
+
+    size_t needed = ARENA_HEADER_SIZE + ARENA_ALIGN_UP(size);
+    EdgeArenaSlab *slab = arena->current;
+    while (slab->used + needed > slab->capacity)
+    {
+        if (IS_NULL(slab->next))
+        {
+            size_t capacity = slab->capacity * 2;
+            if (capacity < needed)
+            {
+                capacity = needed;
+            }
+            slab->next = createSlab(capacity);
+            VERIFY_NON_NULL_MSG(slab->next, "createSlab FAILED in EdgeArenaAlloc\n", NULL);
+            arena->totalCapacity += capacity;
+        }
+        slab = slab->next;
+    }
+    arena->current = slab;
+
+    uint8_t *header = ARENA_SLAB_DATA(slab) + slab->used;
+    slab->used += needed;
+    *((size_t *) header) = size;
+    return header + ARENA_HEADER_SIZE;
+}
+
+void *EdgeArenaCalloc(EdgeArena *arena, size_t num, size_t size)
+{
+    COND_CHECK((IS_NULL(arena)), EdgeCalloc(num, size));
+    COND_CHECK((0 == num || 0 == size || num > SIZE_MAX / size), NULL);
+    void *ptr = EdgeArenaAlloc(arena, num * size);
+    if (ptr)
+    {
+        memset(ptr, 0, num * size);
+    }
+    return ptr;
+}
+
+void *EdgeArenaRealloc(EdgeArena *arena, void *ptr, size_t size)
+{
+    COND_CHECK((IS_NULL(arena)), EdgeRealloc(ptr, size));
+    VERIFY_NON_NULL_MSG(ptr, "NULL param ptr in EdgeArenaRealloc\n", NULL);
+    size_t oldSize = *((size_t *) ((uint8_t *) ptr - ARENA_HEADER_SIZE));
+    if (size <= oldSize)
+    {
+        return ptr;
+    }
+
+    void *resized = EdgeArenaAlloc(arena, size);
+    VERIFY_NON_NULL_MSG(resized, "EdgeArenaAlloc FAILED in EdgeArenaRealloc\n", NULL);
+    memcpy(resized, ptr, oldSize);
+    return resized;
+}
+
+bool EdgeArenaContains(const EdgeArena *arena, const void *ptr)
+{
+    COND_CHECK((IS_NULL(arena) || IS_NULL(ptr)), false);
+    for (const EdgeArenaSlab *slab = arena->first; slab; slab = slab->next)
+    {
+        const uint8_t *data = ARENA_SLAB_DATA(slab);
+        if ((const uint8_t *) ptr >= data && (const uint8_t *) ptr < data + slab->used)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void EdgeArenaFree(EdgeArena *arena, void *ptr)
+{
+    if (IS_NULL(arena) && IS_NOT_NULL(ptr))
+    {
+        EdgeFree(ptr);
+    }
+}
+
+char *EdgeArenaCloneString(EdgeArena *arena, const char *str)
+{
+    COND_CHECK((IS_NULL(str)), NULL);
+    size_t size = strlen(str) + 1;
+    char *clone = (char *) EdgeArenaAlloc(arena, size);
+    VERIFY_NON_NULL_MSG(clone, "EdgeArenaAlloc FAILED in EdgeArenaCloneString\n", NULL);
+    memcpy(clone, str, size);
+    return clone;
+}
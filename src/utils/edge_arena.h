@@ -0,0 +1,120 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_arena.h
+ * @brief This file contains the arena allocator used for EdgeMessage graphs.
+ *
+ * An arena hands out memory from a few large slabs and frees all of it at once.
+ * Message builders which take an arena allocate every part of the message from it,
+ * and the message records the arena for freeEdgeMessage() to release. A NULL arena
+ * stands for the heap, so the same builders serve messages which are freed part by part.
+ * Released arenas are kept in a pool and reused by the next message.
+ */
+
+#ifndef EDGE_ARENA_H
+#define EDGE_ARENA_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Size of the first slab of an arena. */
+#define EDGE_ARENA_SLAB_SIZE (4096)
+
+/** Arenas which grew beyond this size give their extra slabs back on release. */
+#define EDGE_ARENA_MAX_RETAINED_SIZE (64 * 1024)
+
+/** Maximum number of released arenas kept in the pool. */
+#define EDGE_ARENA_POOL_SIZE (64)
+
+typedef struct EdgeArena EdgeArena;
+
+/**
+ * @brief Takes an empty arena from the pool, or creates one if the pool is empty.
+ * @return arena on success, NULL if memory allocation failed.
+ */
+EdgeArena *EdgeArenaAcquire();
+
+/**
+ * @brief Frees everything allocated from the arena and gives the arena back to the pool.
+ * @param[in] arena arena. NULL is ignored.
+ */
+void EdgeArenaRelease(EdgeArena *arena);
+
+/**
+ * @brief Allocates memory from the arena. The memory is aligned for any type.
+ * @param[in] arena arena, or NULL to allocate with EdgeMalloc().
+ * @param[in] size size in bytes.
+ * @return memory on success, NULL if memory allocation failed.
+ */
+void *EdgeArenaAlloc(EdgeArena *arena, size_t size);
+
+/**
+ * @brief Allocates zeroed memory for num elements from the arena.
+ * @param[in] arena arena, or NULL to allocate with EdgeCalloc().
+ * @param[in] num number of elements.
+ * @param[in] size size of an element in bytes.
+ * @return memory on success, NULL if memory allocation failed.
+ */
+void *EdgeArenaCalloc(EdgeArena *arena, size_t num, size_t size);
+
+/**
+ * @brief Resizes memory allocated from the arena. The old block is not reused.
+ * @param[in] arena arena, or NULL to resize with EdgeRealloc().
+ * @param[in] ptr memory allocated from the arena.
+ * @param[in] size new size in bytes.
+ * @return memory on success, NULL if memory allocation failed. ptr is untouched then.
+ */
+void *EdgeArenaRealloc(EdgeArena *arena, void *ptr, size_t size);
+
+/**
+ * @brief Frees memory allocated with EdgeArenaAlloc(). Memory of an arena is left to
+ * EdgeArenaRelease().
+ * @param[in] arena arena, or NULL if ptr was allocated with EdgeMalloc().
+ * @param[in] ptr memory. NULL is ignored.
+ */
+void EdgeArenaFree(EdgeArena *arena, void *ptr);
+
+/**
+ * @brief Copies a string into the arena.
+ * @param[in] arena arena, or NULL to allocate with EdgeMalloc().
+ * @param[in] str string.
+ * @return copy on success, NULL if str is NULL or memory allocation failed.
+ */
+char *EdgeArenaCloneString(EdgeArena *arena, const char *str);
+
+/**
+ * @brief Checks whether ptr was allocated from the arena.
+ * @param[in] arena arena.
+ * @param[in] ptr pointer.
+ * @return true if ptr points into the arena.
+ */
+bool EdgeArenaContains(const EdgeArena *arena, const void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif      // EDGE_ARENA_H
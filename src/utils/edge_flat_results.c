@@ -0,0 +1,155 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <string.h>
+
+#include "edge_flat_results.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+
+#define TAG "flat_results"
+
+#define ALIGN_SIZE(size, alignment) (((size) + (alignment) - 1) / (alignment) * (alignment))
+
+/* Bytes of a string in the pool: its length, the bytes and '\0', padded. */
+static size_t getPooledStringSize(size_t length)
+{
+    return ALIGN_SIZE(sizeof(uint32_t) + length + 1, EDGE_FLAT_STRING_ALIGNMENT);
+}
+
+void sizeEdgeFlatValue(EdgeFlatResultsBuilder *builder, size_t elementSize, size_t elementCount)
+{
+    VERIFY_NON_NULL_NR_MSG(builder, "NULL builder in sizeEdgeFlatValue\n");
+    builder->dataSize += ALIGN_SIZE(elementSize * elementCount, EDGE_FLAT_DATA_ALIGNMENT);
+}
+
+void sizeEdgeFlatString(EdgeFlatResultsBuilder *builder, size_t length)
+{
+    VERIFY_NON_NULL_NR_MSG(builder, "NULL builder in sizeEdgeFlatString\n");
+    builder->stringsSize += getPooledStringSize(length);
+}
+
+EdgeFlatResults *createEdgeFlatResults(EdgeFlatResultsBuilder *builder)
+{
+    return createEdgeFlatResultsInArena(NULL, builder);
+}
+
+EdgeFlatResults *createEdgeFlatResultsInArena(EdgeArena *arena, EdgeFlatResultsBuilder *builder)
+{
+    VERIFY_NON_NULL_MSG(builder, "NULL builder in createEdgeFlatResultsInArena\n", NULL);
+    size_t valuesOffset = ALIGN_SIZE(sizeof(EdgeFlatResults), EDGE_FLAT_DATA_ALIGNMENT);
+    size_t dataOffset = valuesOffset
+            + ALIGN_SIZE(sizeof(EdgeFlatValue) * builder->count, EDGE_FLAT_DATA_ALIGNMENT);
+    size_t stringsOffset = dataOffset + builder->dataSize;
+
+    unsigned char *block = (unsigned char *) EdgeArenaAlloc(arena,
+            stringsOffset + builder->stringsSize);
+    VERIFY_NON_NULL_MSG(block, "EdgeMalloc FAILED for the flat results\n", NULL);
+    EdgeFlatResults *results = (EdgeFlatResults *) block;
+    results->count = builder->count;
+    results->values = (EdgeFlatValue *) (block + valuesOffset);
+    memset(results->values, 0, sizeof(EdgeFlatValue) * builder->count);
+    results->data = block + dataOffset;
+    results->dataSize = 0;
+    results->strings = block + stringsOffset;
+    results->stringsSize = 0;
+    builder->results = results;
+    return results;
+}
+
+void *appendEdgeFlatValue(EdgeFlatResultsBuilder *builder, size_t index, size_t elementSize,
+        size_t elementCount)
+{
+    COND_CHECK((IS_NULL(builder) || IS_NULL(builder->results) || index >= builder->count), NULL);
+    EdgeFlatResults *results = builder->results;
+    size_t size = ALIGN_SIZE(elementSize * elementCount, EDGE_FLAT_DATA_ALIGNMENT);
+    COND_CHECK_MSG((results->dataSize + size > builder->dataSize),
+            "Flat value was not sized\n", NULL);
+
+    EdgeFlatValue *value = &results->values[index];
+    value->isString = false;
+    value->elementCount = elementCount;
+    value->offset = results->dataSize;
+    results->dataSize += size;
+    return results->data + value->offset;
+}
+
+bool appendEdgeFlatString(EdgeFlatResultsBuilder *builder, size_t index, const char *str,
+        size_t length)
+{
+    COND_CHECK((IS_NULL(builder) || IS_NULL(builder->results) || index >= builder->count
+            || (IS_NULL(str) && length > 0) || length > UINT32_MAX), false);
+    EdgeFlatResults *results = builder->results;
+    size_t size = getPooledStringSize(length);
+    COND_CHECK_MSG((results->stringsSize + size > builder->stringsSize),
+            "Flat string was not sized\n", false);
+
+    EdgeFlatValue *value = &results->values[index];
+    if (!value->isString || 0 == value->elementCount)
+    {
+        value->isString = true;
+        value->elementCount = 0;
+        value->offset = results->stringsSize;
+    }
+    value->elementCount++;
+
+    unsigned char *pooled = results->strings + results->stringsSize;
+    uint32_t pooledLength = (uint32_t) length;
+    memcpy(pooled, &pooledLength, sizeof(uint32_t));
+    if (length > 0)
+    {
+        memcpy(pooled + sizeof(uint32_t), str, length);
+    }
+    memset(pooled + sizeof(uint32_t) + length, 0, size - sizeof(uint32_t) - length);
+    results->stringsSize += size;
+    return true;
+}
+
+const void *getEdgeFlatValue(const EdgeFlatResults *results, size_t index)
+{
+    COND_CHECK((IS_NULL(results) || index >= results->count), NULL);
+    const EdgeFlatValue *value = &results->values[index];
+    COND_CHECK((0 != value->status || value->isString || 0 == value->elementCount), NULL);
+    return results->data + value->offset;
+}
+
+const char *getEdgeFlatString(const EdgeFlatResults *results, size_t index, size_t *length)
+{
+    COND_CHECK((IS_NULL(results) || index >= results->count || IS_NULL(length)), NULL);
+    const EdgeFlatValue *value = &results->values[index];
+    COND_CHECK((0 != value->status || !value->isString || 0 == value->elementCount), NULL);
+    uint32_t pooledLength = 0;
+    memcpy(&pooledLength, results->strings + value->offset, sizeof(uint32_t));
+    *length = pooledLength;
+    return (const char *) (results->strings + value->offset + sizeof(uint32_t));
+}
+
+const char *getNextEdgeFlatString(const char *str, size_t *length)
+{
+    COND_CHECK((IS_NULL(str) || IS_NULL(length)), NULL);
+    const char *pooled = str - sizeof(uint32_t);
+    uint32_t pooledLength = 0;
+    memcpy(&pooledLength, pooled, sizeof(uint32_t));
+    const char *next = pooled + getPooledStringSize(pooledLength);
+    memcpy(&pooledLength, next, sizeof(uint32_t));
+    *length = pooledLength;
+    return next + sizeof(uint32_t);
+}
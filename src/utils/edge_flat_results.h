@@ -0,0 +1,155 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_flat_results.h
+ *
+ * @brief This file contains the building and reading of EdgeFlatResults.
+ *
+ * The results are built in two passes. The first one adds up the sizes of the values, the
+ * second one copies them into the block, which is allocated at once for the entries, the
+ * data and the string pool.
+ */
+
+#ifndef EDGE_FLAT_RESULTS_H
+#define EDGE_FLAT_RESULTS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "opcua_common.h"
+#include "edge_arena.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Alignment of the values in EdgeFlatResults.data. */
+#define EDGE_FLAT_DATA_ALIGNMENT (8)
+
+/** Alignment of the strings in EdgeFlatResults.strings. */
+#define EDGE_FLAT_STRING_ALIGNMENT (4)
+
+/**
+ * @brief State of the building of EdgeFlatResults.
+ */
+typedef struct EdgeFlatResultsBuilder
+{
+    /** Number of entries. */
+    size_t count;
+
+    /** Bytes needed for the data, added up in the first pass. */
+    size_t dataSize;
+
+    /** Bytes needed for the string pool, added up in the first pass. */
+    size_t stringsSize;
+
+    /** Results, NULL until createEdgeFlatResults(). */
+    EdgeFlatResults *results;
+} EdgeFlatResultsBuilder;
+
+/**
+ * @brief Adds the size of a value of fixed size elements in the first pass.
+ * @param[in]  builder Builder.
+ * @param[in]  elementSize Size of an element.
+ * @param[in]  elementCount Number of elements.
+ */
+void sizeEdgeFlatValue(EdgeFlatResultsBuilder *builder, size_t elementSize, size_t elementCount);
+
+/**
+ * @brief Adds the size of a string in the first pass.
+ * @param[in]  builder Builder.
+ * @param[in]  length Length of the string in bytes.
+ */
+void sizeEdgeFlatString(EdgeFlatResultsBuilder *builder, size_t length);
+
+/**
+ * @brief Allocates the results with the sizes of the first pass. The entries are zeroed.
+ * @param[in]  builder Builder whose count is set.
+ * @return The results, also kept in builder, which are freed with one EdgeFree().
+ *         NULL on failure.
+ */
+EdgeFlatResults *createEdgeFlatResults(EdgeFlatResultsBuilder *builder);
+
+/**
+ * @brief Allocates the results like createEdgeFlatResults(), in an arena.
+ * @param[in]  arena Arena holding the results, NULL for the heap.
+ * @param[in]  builder Builder whose count is set.
+ * @return The results, also kept in builder, which go with the arena. NULL on failure.
+ */
+EdgeFlatResults *createEdgeFlatResultsInArena(EdgeArena *arena, EdgeFlatResultsBuilder *builder);
+
+/**
+ * @brief Reserves the data of the value of an entry in the second pass.
+ * @param[in]  builder Builder.
+ * @param[in]  index Index of the entry.
+ * @param[in]  elementSize Size of an element.
+ * @param[in]  elementCount Number of elements.
+ * @return Memory to copy the elements to, NULL if it was not sized in the first pass.
+ */
+void *appendEdgeFlatValue(EdgeFlatResultsBuilder *builder, size_t index, size_t elementSize,
+        size_t elementCount);
+
+/**
+ * @brief Copies a string of the value of an entry into the string pool in the second pass.
+ *        The strings of an array are appended one after another to the same entry.
+ * @param[in]  builder Builder.
+ * @param[in]  index Index of the entry.
+ * @param[in]  str String, which may hold '\0'.
+ * @param[in]  length Length of str in bytes.
+ * @return @c true on success, false if it was not sized in the first pass.
+ */
+bool appendEdgeFlatString(EdgeFlatResultsBuilder *builder, size_t index, const char *str,
+        size_t length);
+
+/**
+ * @brief Gets the elements of a value of fixed size.
+ * @param[in]  results Results.
+ * @param[in]  index Index of the entry.
+ * @return First element, NULL if the node was not read or its value is in the string pool.
+ */
+const void *getEdgeFlatValue(const EdgeFlatResults *results, size_t index);
+
+/**
+ * @brief Gets the first string of a value in the string pool.
+ * @param[in]  results Results.
+ * @param[in]  index Index of the entry.
+ * @param[out] length Length of the string in bytes.
+ * @return String terminated by '\0', NULL if the node was not read or its value is not
+ *         in the string pool.
+ */
+const char *getEdgeFlatString(const EdgeFlatResults *results, size_t index, size_t *length);
+
+/**
+ * @brief Gets the string after the given one of an array in the string pool.
+ *        Only as many strings as the elementCount of the entry may be taken.
+ * @param[in]  str String of the pool.
+ * @param[out] length Length of the next string in bytes.
+ * @return Next string terminated by '\0'.
+ */
+const char *getNextEdgeFlatString(const char *str, size_t *length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_FLAT_RESULTS_H
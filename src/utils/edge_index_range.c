@@ -0,0 +1,91 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <stdio.h>
+#include <ctype.h>
+
+#include "edge_index_range.h"
+#include "edge_utils.h"
+
+static bool parseIndex(const char **cursor, uint32_t *index)
+{
+    const char *c = *cursor;
+    COND_CHECK((!isdigit((unsigned char) *c)), false);
+    uint64_t value = 0;
+    for (; isdigit((unsigned char) *c); c++)
+    {
+        value = value * 10 + (uint64_t) (*c - '0');
+        COND_CHECK((value > UINT32_MAX), false);
+    }
+    *index = (uint32_t) value;
+    *cursor = c;
+    return true;
+}
+
+bool parseEdgeIndexRange(const char *range, uint32_t *first, uint32_t *last)
+{
+    COND_CHECK((IS_NULL(range) || IS_NULL(first) || IS_NULL(last)), false);
+    const char *cursor = range;
+    COND_CHECK((!parseIndex(&cursor, first)), false);
+    COND_CHECK((':' != *cursor++), false);
+    COND_CHECK((!parseIndex(&cursor, last)), false);
+    return ('\0' == *cursor && *first < *last);
+}
+
+bool formatEdgeIndexRange(uint32_t first, uint32_t last, char *range, size_t size)
+{
+    COND_CHECK((IS_NULL(range) || size < EDGE_INDEX_RANGE_SIZE || first > last), false);
+    if (first == last)
+    {
+        snprintf(range, size, "%u", first);
+    }
+    else
+    {
+        snprintf(range, size, "%u:%u", first, last);
+    }
+    return true;
+}
+
+const char *getEdgeIndexRangeFirstPage(const char *range, char *page, size_t size)
+{
+    uint32_t first = 0;
+    uint32_t last = 0;
+    COND_CHECK((!parseEdgeIndexRange(range, &first, &last)
+            || last - first < EDGE_INDEX_RANGE_FIRST_PAGE), range);
+    COND_CHECK((!formatEdgeIndexRange(first, first + EDGE_INDEX_RANGE_FIRST_PAGE - 1, page, size)),
+            range);
+    return page;
+}
+
+uint32_t getEdgeIndexRangePageSize(uint32_t maxMessageSize, size_t elementSize, uint32_t remaining)
+{
+    COND_CHECK((0 == maxMessageSize), remaining);
+    uint64_t pageSize = EDGE_INDEX_RANGE_FIRST_PAGE;
+    if (elementSize > 0)
+    {
+        pageSize = (maxMessageSize > EDGE_INDEX_RANGE_PAGE_OVERHEAD) ?
+                (maxMessageSize - EDGE_INDEX_RANGE_PAGE_OVERHEAD) / elementSize : 0;
+    }
+    if (0 == pageSize)
+    {
+        pageSize = 1;
+    }
+    return (pageSize < remaining) ? (uint32_t) pageSize : remaining;
+}
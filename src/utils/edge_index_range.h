@@ -0,0 +1,95 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_index_range.h
+ *
+ * @brief This file contains the paging of the index ranges of array reads.
+ *
+ * A read of a one dimensional range "first:last" of more than EDGE_INDEX_RANGE_FIRST_PAGE
+ * elements asks for the first page only. The rest is read in pages which fit into the
+ * message size negotiated with the server, once the size of the elements is known from
+ * the first page. Other ranges are read as they are.
+ */
+
+#ifndef EDGE_INDEX_RANGE_H
+#define EDGE_INDEX_RANGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Elements in the first page of a paged range. */
+#define EDGE_INDEX_RANGE_FIRST_PAGE (256)
+
+/** Size of a buffer which holds any range "first:last". */
+#define EDGE_INDEX_RANGE_SIZE (24)
+
+/** Bytes of a read response which are not the value of the page. */
+#define EDGE_INDEX_RANGE_PAGE_OVERHEAD (1024)
+
+/**
+ * @brief Parses a one dimensional range "first:last".
+ * @param[in]  range Range.
+ * @param[out] first First index.
+ * @param[out] last Last index.
+ * @return @c true if range is one dimensional with first below last.
+ */
+bool parseEdgeIndexRange(const char *range, uint32_t *first, uint32_t *last);
+
+/**
+ * @brief Formats the range of the elements first to last.
+ * @param[in]  first First index.
+ * @param[in]  last Last index.
+ * @param[out] range Range. "first" alone if first equals last.
+ * @param[in]  size Size of range, at least EDGE_INDEX_RANGE_SIZE.
+ * @return @c true on success.
+ */
+bool formatEdgeIndexRange(uint32_t first, uint32_t last, char *range, size_t size);
+
+/**
+ * @brief Gets the range to ask for in the first read of a range.
+ * @param[in]  range Range of the request.
+ * @param[out] page Buffer for the first page.
+ * @param[in]  size Size of page, at least EDGE_INDEX_RANGE_SIZE.
+ * @return page holding the first page if range is paged, else range.
+ */
+const char *getEdgeIndexRangeFirstPage(const char *range, char *page, size_t size);
+
+/**
+ * @brief Gets the number of elements of the pages after the first one.
+ * @param[in]  maxMessageSize Largest message the server accepts, 0 for no limit.
+ * @param[in]  elementSize Encoded size of an element, 0 if it is not known.
+ * @param[in]  remaining Number of elements left to read.
+ * @return remaining without a limit, EDGE_INDEX_RANGE_FIRST_PAGE if the size of the elements
+ *         is not known, else the elements which fit into a message, at least 1.
+ */
+uint32_t getEdgeIndexRangePageSize(uint32_t maxMessageSize, size_t elementSize, uint32_t remaining);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_INDEX_RANGE_H
@@ -67,7 +67,7 @@ Edge_String EdgeStringAlloc(char const src[])
     Edge_String str;
     str.length = strlen(src);
     if(str.length > 0) {
-        str.data = (Edge_Byte*)malloc(str.length);
+        str.data = (Edge_Byte*)EdgeMalloc(str.length);
         // Returns an empty Edge_String if memory allocated fails.
         VERIFY_NON_NULL_MSG(str.data, "EdgeMalloc FAILED IN EdgeStringAlloc\n", EDGE_STRING_NULL);
         memcpy(str.data, src, str.length);
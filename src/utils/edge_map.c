@@ -18,6 +18,8 @@
  *
  ******************************************************************/
 
+#include <string.h>
+
 #include "edge_map.h"
 #include "edge_malloc.h"
 #include "edge_utils.h"
@@ -27,65 +29,329 @@
 // USAGE
 
 /*
- edgeMap* X = createMap();
+ edgeMap* X = createStringMap();
+
+ insertMapElement(X, "10", "arya");
+ insertMapElement(X, "20", "mango");
+ insertMapElement(X, "25", "apple");
 
- insertMapElement(X, 10, "arya");
- insertMapElement(X, 20, "mango");
- insertMapElement(X, 25, "apple");
+ char* ret = (char *)getMapElement(X, "25");
 
- char* ret = (char *)getMapElement(X, 25);
+ for (edgeMapNode *node = X->head; node; node = node->next)
+     printf("%s : %s\n", (char *) node->key, (char *) node->value);
 
  deleteMap(X);
+ EdgeFree(X);
  */
 
-edgeMap *createMap()
+/*
+ * distance is the position of the slot in the probe sequence of its key, counted from 1.
+ * 0 marks an empty slot. A slot of the old index whose node has moved keeps its distance
+ * with a NULL node, so the probe sequences which pass it stay intact.
+ */
+struct edgeMapSlot
+{
+    edgeMapNode *node;
+    uint32_t hash;
+    uint32_t distance;
+};
+
+static edgeMap *createMapWithKeyType(edgeMapKeyType keyType)
 {
-    edgeMap *map = (edgeMap *) EdgeMalloc(sizeof(edgeMap));
-    VERIFY_NON_NULL_MSG(map, "EdgeMalloc FAILED for create edge map\n", NULL);
-    map->head = NULL;
+    edgeMap *map = (edgeMap *) EdgeCalloc(1, sizeof(edgeMap));
+    VERIFY_NON_NULL_MSG(map, "EdgeCalloc FAILED for create edge map\n", NULL);
+    map->keyType = keyType;
     return map;
 }
 
-void insertMapElement(edgeMap *map, keyValue key, keyValue value)
+edgeMap *createMap()
+{
+    return createMapWithKeyType(EDGE_MAP_KEY_POINTER);
+}
+
+edgeMap *createStringMap()
+{
+    return createMapWithKeyType(EDGE_MAP_KEY_STRING);
+}
+
+uint32_t getMapKeyHash(const edgeMap *map, keyValue key)
+{
+    VERIFY_NON_NULL_MSG(map, "NULL map param in getMapKeyHash\n", 0);
+    if (EDGE_MAP_KEY_STRING == map->keyType)
+    {
+        COND_CHECK((NULL == key), 0);
+        return hashData(key, strlen((const char *) key));
+    }
+
+    // Mix the pointer bits. Heap pointers share their low and high bits.
+    uint64_t bits = (uint64_t) (uintptr_t) key;
+    bits ^= bits >> 33;
+    bits *= 0xff51afd7ed558ccdULL;
+    bits ^= bits >> 33;
+    return (uint32_t) bits;
+}
+
+/** Length of a string key which is NULL terminated. */
+#define KEY_TERMINATED SIZE_MAX
+
+static bool isSameKey(const edgeMap *map, keyValue stored, keyValue key, size_t keyLength)
+{
+    if (EDGE_MAP_KEY_STRING == map->keyType)
+    {
+        if (KEY_TERMINATED == keyLength)
+        {
+            return 0 == strcmp((const char *) stored, (const char *) key);
+        }
+        // The stored key is NULL terminated, the looked up one is not.
+        return strnlen((const char *) stored, keyLength + 1) == keyLength
+                && 0 == memcmp(stored, key, keyLength);
+    }
+    return stored == key;
+}
+
+static edgeMapSlot *findSlot(const edgeMap *map, edgeMapSlot *slots, size_t capacity,
+        keyValue key, size_t keyLength, uint32_t hash)
+{
+    if (0 == capacity)
+    {
+        return NULL;
+    }
+
+    size_t mask = capacity - 1;
+    size_t index = hash & mask;
+    // A key is never further from its home slot than the keys it was inserted past.
+    for (uint32_t distance = 1; slots[index].distance >= distance; distance++)
+    {
+        edgeMapSlot *slot = &slots[index];
+        if (slot->node && slot->hash == hash && isSameKey(map, slot->node->key, key, keyLength))
+        {
+            return slot;
+        }
+        index = (index + 1) & mask;
+    }
+    return NULL;
+}
+
+static void insertSlot(edgeMapSlot *slots, size_t capacity, edgeMapNode *node, uint32_t hash)
+{
+    size_t mask = capacity - 1;
+    size_t index = hash & mask;
+    edgeMapSlot entry = { node, hash, 1 };
+    while (0 != slots[index].distance)
+    {
+        // Robin Hood: the entry further from its home slot takes the slot.
+        if (slots[index].distance < entry.distance)
+        {
+            edgeMapSlot displaced = slots[index];
+            slots[index] = entry;
+            entry = displaced;
+        }
+        entry.distance++;
+        index = (index + 1) & mask;
+    }
+    slots[index] = entry;
+}
+
+static void removeSlot(edgeMapSlot *slots, size_t capacity, edgeMapSlot *slot)
+{
+    // Shift the following entries of the probe sequence one slot back.
+    size_t mask = capacity - 1;
+    size_t index = (size_t) (slot - slots);
+    size_t next = (index + 1) & mask;
+    while (slots[next].distance > 1)
+    {
+        slots[index] = slots[next];
+        slots[index].distance--;
+        index = next;
+        next = (next + 1) & mask;
+    }
+    memset(&slots[index], 0, sizeof(edgeMapSlot));
+}
+
+static void migrateSlots(edgeMap *map, size_t count)
+{
+    while (map->oldSlots && count > 0 && map->migrated < map->oldCapacity)
+    {
+        edgeMapSlot *slot = &map->oldSlots[map->migrated++];
+        if (slot->node)
+        {
+            insertSlot(map->slots, map->capacity, slot->node, slot->hash);
+            slot->node = NULL;
+        }
+        count--;
+    }
+
+    if (map->oldSlots && map->migrated == map->oldCapacity)
+    {
+        EdgeFree(map->oldSlots);
+        map->oldSlots = NULL;
+        map->oldCapacity = 0;
+        map->migrated = 0;
+    }
+}
+
+static bool growMap(edgeMap *map)
+{
+    // Finish the previous growth first. The current index is at most 3/4 full.
+    migrateSlots(map, map->oldCapacity);
+
+    size_t capacity = (0 == map->capacity) ? EDGE_MAP_INITIAL_CAPACITY : map->capacity * 2;
+    edgeMapSlot *slots = (edgeMapSlot *) EdgeCalloc(capacity, sizeof(edgeMapSlot));
+    VERIFY_NON_NULL_MSG(slots, "EdgeCalloc FAILED for edge map slots\n", false);
+
+    map->oldSlots = map->slots;
+    map->oldCapacity = map->capacity;
+    map->migrated = 0;
+    map->slots = slots;
+    map->capacity = capacity;
+    if (NULL == map->oldSlots)
+    {
+        map->oldCapacity = 0;
+    }
+    return true;
+}
+
+static edgeMapSlot *findMapSlot(const edgeMap *map, keyValue key, size_t keyLength,
+        uint32_t hash, bool *isOld)
+{
+    edgeMapSlot *slot = findSlot(map, map->slots, map->capacity, key, keyLength, hash);
+    *isOld = false;
+    if (NULL == slot && map->oldSlots)
+    {
+        slot = findSlot(map, map->oldSlots, map->oldCapacity, key, keyLength, hash);
+        *isOld = true;
+    }
+    return slot;
+}
+
+bool insertMapElement(edgeMap *map, keyValue key, keyValue value)
 {
+    VERIFY_NON_NULL_MSG(map, "NULL map param in insertMapElement\n", false);
+    COND_CHECK_MSG((EDGE_MAP_KEY_STRING == map->keyType && NULL == key),
+            "NULL key param in insertMapElement\n", false);
+
+    uint32_t hash = getMapKeyHash(map, key);
+    bool isOld = false;
+    COND_CHECK_MSG((NULL != findMapSlot(map, key, KEY_TERMINATED, hash, &isOld)),
+            "Key exists already in insertMapElement\n", false);
+
+    // Grow at 3/4 load so the probe sequences stay short.
+    if ((map->size + 1) * 4 > map->capacity * 3)
+    {
+        COND_CHECK_MSG((!growMap(map)), "Failed to grow the map\n", false);
+    }
+
     edgeMapNode *node = (edgeMapNode *) EdgeMalloc(sizeof(edgeMapNode));
-    VERIFY_NON_NULL_NR_MSG(node, "EdgeMalloc failed for insert map element\n");
+    VERIFY_NON_NULL_MSG(node, "EdgeMalloc failed for insert map element\n", false);
     node->key = key;
     node->value = value;
     node->next = NULL;
-
-    edgeMapNode *temp = map->head;
-
-    if (temp == NULL)
+    node->prev = map->tail;
+    if (map->tail)
     {
-        // Adding first node in the map.
-        map->head = node;
+        map->tail->next = node;
     }
     else
     {
-        // Iterate till the end of the map and append.
-        while (temp->next != NULL)
-            temp = temp->next;
-
-        temp->next = node;
+        // Adding first node in the map.
+        map->head = node;
     }
+    map->tail = node;
+    map->size++;
+
+    insertSlot(map->slots, map->capacity, node, hash);
+    migrateSlots(map, EDGE_MAP_MIGRATION_STEP);
+    return true;
 }
 
-keyValue getMapElement(edgeMap *map, keyValue key)
+keyValue getMapElementWithHash(const edgeMap *map, keyValue key, uint32_t hash)
 {
-    edgeMapNode *temp = map->head;
+    VERIFY_NON_NULL_MSG(map, "NULL map param in getMapElement\n", NULL);
+    COND_CHECK((EDGE_MAP_KEY_STRING == map->keyType && NULL == key), NULL);
 
-    while (temp != NULL)
+    bool isOld = false;
+    edgeMapSlot *slot = findMapSlot(map, key, KEY_TERMINATED, hash, &isOld);
+    return slot ? slot->node->value : NULL;
+}
+
+keyValue getMapElement(const edgeMap *map, keyValue key)
+{
+    VERIFY_NON_NULL_MSG(map, "NULL map param in getMapElement\n", NULL);
+    COND_CHECK((EDGE_MAP_KEY_STRING == map->keyType && NULL == key), NULL);
+    return getMapElementWithHash(map, key, getMapKeyHash(map, key));
+}
+
+keyValue getMapElementWithLength(const edgeMap *map, const char *key, size_t length)
+{
+    VERIFY_NON_NULL_MSG(map, "NULL map param in getMapElementWithLength\n", NULL);
+    COND_CHECK((EDGE_MAP_KEY_STRING != map->keyType || NULL == key), NULL);
+
+    bool isOld = false;
+    edgeMapSlot *slot = findMapSlot(map, (keyValue) key, length, hashData(key, length), &isOld);
+    return slot ? slot->node->value : NULL;
+}
+
+bool removeMapElement(edgeMap *map, keyValue key, keyValue *removedKey, keyValue *removedValue)
+{
+    VERIFY_NON_NULL_MSG(map, "NULL map param in removeMapElement\n", false);
+    COND_CHECK((EDGE_MAP_KEY_STRING == map->keyType && NULL == key), false);
+
+    bool isOld = false;
+    edgeMapSlot *slot = findMapSlot(map, key, KEY_TERMINATED, getMapKeyHash(map, key), &isOld);
+    COND_CHECK((NULL == slot), false);
+
+    edgeMapNode *node = slot->node;
+    if (isOld)
     {
-        COND_CHECK((temp->key == key), temp->value);
-        temp = temp->next;
+        // The old index is only read until it is dropped. Keep the probe sequences intact.
+        slot->node = NULL;
+    }
+    else
+    {
+        removeSlot(map->slots, map->capacity, slot);
     }
 
-    return NULL;
+    if (node->prev)
+    {
+        node->prev->next = node->next;
+    }
+    else
+    {
+        map->head = node->next;
+    }
+    if (node->next)
+    {
+        node->next->prev = node->prev;
+    }
+    else
+    {
+        map->tail = node->prev;
+    }
+    map->size--;
+
+    if (removedKey)
+    {
+        *removedKey = node->key;
+    }
+    if (removedValue)
+    {
+        *removedValue = node->value;
+    }
+    EdgeFree(node);
+
+    migrateSlots(map, EDGE_MAP_MIGRATION_STEP);
+    return true;
+}
+
+size_t getMapSize(const edgeMap *map)
+{
+    COND_CHECK((NULL == map), 0);
+    return map->size;
 }
 
 void deleteMap(edgeMap *map)
 {
+    VERIFY_NON_NULL_NR_MSG(map, "NULL map param in deleteMap\n");
     edgeMapNode *temp = map->head;
     edgeMapNode *xtemp;
 
@@ -96,5 +362,9 @@ void deleteMap(edgeMap *map)
         temp = xtemp;
     }
 
-    map->head = NULL;
+    EdgeFree(map->slots);
+    EdgeFree(map->oldSlots);
+    edgeMapKeyType keyType = map->keyType;
+    memset(map, 0, sizeof(edgeMap));
+    map->keyType = keyType;
 }
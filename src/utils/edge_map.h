@@ -21,19 +21,49 @@
 /**
  * @file edge_map.h
  * @brief This file contains APIs for generic key-value pairs.
+ *
+ * The map keeps its nodes in a list in insertion order, for iteration, and finds them
+ * through an open addressing index with Robin Hood probing. When the index grows, the
+ * entries move to the bigger index a few at a time with the following insertions and
+ * removals, so no single call pays for rehashing the whole map.
+ * Keys and values are not copied and stay owned by the caller.
+ * The map is not thread safe. Lookups do not modify it, so they may run concurrently
+ * as long as nothing is inserted or removed.
  */
 
 #ifndef EDGE_MAP_H_
 #define EDGE_MAP_H_
 
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+/** Number of index slots of a map after its first insertion. */
+#define EDGE_MAP_INITIAL_CAPACITY (16)
+
+/** Number of old index slots moved to the new index by each insertion or removal while the map grows. */
+#define EDGE_MAP_MIGRATION_STEP (8)
+
 /** Generic pointer to represent key/value.*/
 typedef void *keyValue;
 
+/**
+ * @brief How the keys of a map are compared.
+ */
+typedef enum
+{
+    /** Keys are equal if they are the same pointer. */
+    EDGE_MAP_KEY_POINTER = 0,
+
+    /** Keys are NULL terminated strings, equal if their content is equal. */
+    EDGE_MAP_KEY_STRING
+} edgeMapKeyType;
+
 /**
  * @brief Structure for a node in the list of generic key-value pairs.
  */
@@ -47,32 +77,71 @@ typedef struct edgeMapNode
 
     /** Next node in list.*/
     struct edgeMapNode *next;
+
+    /** Previous node in list.*/
+    struct edgeMapNode *prev;
 } edgeMapNode;
 
+/** Slot of the index of a map. */
+typedef struct edgeMapSlot edgeMapSlot;
+
 /**
- * @brief Structure which holds the head pointer of a generic key-value pairs list.
- * @remarks This structure is used to hold head pointer of a list.
+ * @brief Structure which holds the nodes of a map and their index.
+ * @remarks Iterate from head following the next pointers. A node may be removed
+ * during the iteration once its next pointer has been read.
  */
 typedef struct edgeMap
 {
-    /** Map Head.*/
+    /** Map Head, the node inserted first.*/
     edgeMapNode *head;
+
+    /** Node inserted last.*/
+    edgeMapNode *tail;
+
+    /** Number of nodes.*/
+    size_t size;
+
+    /** How the keys are compared.*/
+    edgeMapKeyType keyType;
+
+    /** Index of the nodes.*/
+    edgeMapSlot *slots;
+
+    /** Number of slots in the index. Always a power of two.*/
+    size_t capacity;
+
+    /** Index the nodes are being moved out of while the map grows, NULL otherwise.*/
+    edgeMapSlot *oldSlots;
+
+    /** Number of slots in the old index.*/
+    size_t oldCapacity;
+
+    /** Number of old slots moved to the new index so far.*/
+    size_t migrated;
 } edgeMap;
 
 /**
- * @brief API for creating a map for storing edge nodes.
+ * @brief API for creating a map for storing edge nodes. Keys are compared as pointers.
  * @remarks This API will allocate memory required.
  * @return a pointer to the created map, otherwise a null pointer if the memory is insufficient.
  */
 edgeMap *createMap();
 
+/**
+ * @brief API for creating a map whose keys are strings compared by their content.
+ * @remarks This API will allocate memory required.
+ * @return a pointer to the created map, otherwise a null pointer if the memory is insufficient.
+ */
+edgeMap *createStringMap();
+
 /**
  * @brief Insert a key-value pair into the map.
  * @param[in]  map Pointer to an edgeMap created using createMap().
- * @param[in]  key Generic key.
+ * @param[in]  key Generic key. Must stay valid while it is in the map.
  * @param[in]  value Generic value.
+ * @return @c true on success, false if the key is in the map already or memory allocation failed.
  */
-void insertMapElement(edgeMap *map, keyValue key, keyValue value);
+bool insertMapElement(edgeMap *map, keyValue key, keyValue value);
 
 /**
  * @brief Get the element value of the given key from the map.
@@ -80,10 +149,56 @@ void insertMapElement(edgeMap *map, keyValue key, keyValue value);
  * @param[in]  key Generic key.
  * @return Value of given key on success, otherwise null.
  */
-keyValue getMapElement(edgeMap *map, keyValue key);
+keyValue getMapElement(const edgeMap *map, keyValue key);
+
+/**
+ * @brief Get the hash of a key as computed by the map, to be reused with getMapElementWithHash().
+ * @param[in]  map Pointer to an edgeMap created using createMap().
+ * @param[in]  key Generic key.
+ * @return 32-bit hash value.
+ */
+uint32_t getMapKeyHash(const edgeMap *map, keyValue key);
+
+/**
+ * @brief Get the element value of the given key whose hash is known already.
+ * @param[in]  map Pointer to an edgeMap created using createMap().
+ * @param[in]  key Generic key.
+ * @param[in]  hash getMapKeyHash() of the key.
+ * @return Value of given key on success, otherwise null.
+ */
+keyValue getMapElementWithHash(const edgeMap *map, keyValue key, uint32_t hash);
+
+/**
+ * @brief Get the element value of a string key which is not NULL terminated. The key is
+ * looked up where it is, without being copied.
+ * @param[in]  map Pointer to an edgeMap created using createStringMap().
+ * @param[in]  key Characters of the key.
+ * @param[in]  length Number of characters of the key.
+ * @return Value of given key on success, otherwise null. Also null if the keys of the map
+ * are no strings.
+ */
+keyValue getMapElementWithLength(const edgeMap *map, const char *key, size_t length);
+
+/**
+ * @brief Remove the element of the given key from the map.
+ * @param[in]  map Pointer to an edgeMap created using createMap().
+ * @param[in]  key Generic key.
+ * @param[out]  removedKey Key stored in the map, for the caller to free. May be NULL.
+ * @param[out]  removedValue Value of the key. May be NULL.
+ * @return @c true if the key was in the map, otherwise false.
+ */
+bool removeMapElement(edgeMap *map, keyValue key, keyValue *removedKey, keyValue *removedValue);
+
+/**
+ * @brief Get the number of elements in the map.
+ * @param[in]  map Pointer to an edgeMap created using createMap().
+ * @return Number of elements. 0 if map is NULL.
+ */
+size_t getMapSize(const edgeMap *map);
 
 /**
  * @brief Delete and free memory used by the edge util map.
+ * @remarks Keys and values are not freed. The map itself is not freed and can be reused.
  * @param[in]  map Pointer to an edgeMap created using createMap().
  */
 void deleteMap(edgeMap *map);
@@ -151,6 +151,16 @@ Edge_String *convertToEdgeString(UA_String *uaStr)
     return value;
 }
 
+bool convertToEdgeStringInArena(EdgeArena *arena, UA_String *uaStr, Edge_String *out)
+{
+    VERIFY_NON_NULL_MSG(uaStr, "UA String param is NULL in convertToEdgeStringInArena\n", false);
+    out->length = uaStr->length;
+    out->data = (uint8_t *) EdgeArenaCalloc(arena, out->length + 1, sizeof(uint8_t));
+    VERIFY_NON_NULL_MSG(out->data, "Memory allocation failed.", false);
+    memcpy(out->data, uaStr->data, out->length);
+    return true;
+}
+
 EdgeApplicationType convertToEdgeApplicationType(UA_ApplicationType appType)
 {
     // Setting SERVER as default application type. ****
@@ -180,29 +190,23 @@ void convertGuidToString(UA_Guid guid, char **out)
             guid.data4[3], guid.data4[4], guid.data4[5], guid.data4[6], guid.data4[7]);
 }
 
-Edge_NodeId *convertToEdgeNodeIdType(UA_NodeId *nodeId)
+Edge_NodeId *convertToEdgeNodeIdTypeInArena(EdgeArena *arena, UA_NodeId *nodeId)
 {
     VERIFY_NON_NULL_MSG(nodeId, "Node ID param is NULL in convertToEdgeNodeIdType\n", NULL);
-    Edge_NodeId *edgeNodeId = (Edge_NodeId *) EdgeCalloc(1, sizeof(Edge_NodeId));
+    Edge_NodeId *edgeNodeId = (Edge_NodeId *) EdgeArenaCalloc(arena, 1, sizeof(Edge_NodeId));
     VERIFY_NON_NULL_MSG(edgeNodeId, "Memory allocation failed", NULL);
 
     edgeNodeId->namespaceIndex = nodeId->namespaceIndex;
     edgeNodeId->identifierType = nodeId->identifierType;
+    bool converted = true;
     if(nodeId->identifierType == UA_NODEIDTYPE_NUMERIC)
     {
         edgeNodeId->identifier.numeric = nodeId->identifier.numeric;
     }
     else if(nodeId->identifierType == UA_NODEIDTYPE_STRING)
     {
-        Edge_String *edgeStr = convertToEdgeString(&nodeId->identifier.string);
-        if(IS_NULL(edgeStr))
-        {
-            EDGE_LOG_V(TAG, "Failed to convert the Node Id of type (%d).", nodeId->identifierType);
-            EdgeFree(edgeNodeId);
-            return NULL;
-        }
-        edgeNodeId->identifier.string = *edgeStr;
-        EdgeFree(edgeStr);
+        converted = convertToEdgeStringInArena(arena, &nodeId->identifier.string,
+                &edgeNodeId->identifier.string);
     }
     else if(nodeId->identifierType == UA_NODEIDTYPE_GUID)
     {
@@ -211,20 +215,24 @@ Edge_NodeId *convertToEdgeNodeIdType(UA_NodeId *nodeId)
     else
     {
         // For UA_NODEIDTYPE_BYTESTRING
-        Edge_String *edgeStr = convertToEdgeString(&nodeId->identifier.byteString);
-        if(IS_NULL(edgeStr))
-        {
-            EDGE_LOG_V(TAG, "Failed to convert the Node Id of type (%d).", nodeId->identifierType);
-            EdgeFree(edgeNodeId);
-            return NULL;
-        }
-        edgeNodeId->identifier.byteString = *edgeStr;
-        EdgeFree(edgeStr);
+        converted = convertToEdgeStringInArena(arena, &nodeId->identifier.byteString,
+                &edgeNodeId->identifier.byteString);
     }
 
+    if (!converted)
+    {
+        EDGE_LOG_V(TAG, "Failed to convert the Node Id of type (%d).", nodeId->identifierType);
+        EdgeArenaFree(arena, edgeNodeId);
+        return NULL;
+    }
     return edgeNodeId;
 }
 
+Edge_NodeId *convertToEdgeNodeIdType(UA_NodeId *nodeId)
+{
+    return convertToEdgeNodeIdTypeInArena(NULL, nodeId);
+}
+
 EdgeNodeId *getEdgeNodeId(UA_NodeId *node)
 {
     VERIFY_NON_NULL_MSG(node, "NodeID Parameter is NULL\n", NULL);
@@ -495,6 +503,93 @@ size_t get_size(int type, bool isArray)
     return size[type-1];
 }
 
+EdgeVersatility *cloneEdgeVersatilityByType(const EdgeVersatility *srcVersatility, int type)
+{
+    return cloneEdgeVersatilityByTypeInArena(NULL, srcVersatility, type);
+}
+
+EdgeVersatility *cloneEdgeVersatilityByTypeInArena(EdgeArena *arena,
+        const EdgeVersatility *srcVersatility, int type)
+{
+    VERIFY_NON_NULL_MSG(srcVersatility, "NULL param in cloneEdgeVersatilityByType\n", NULL);
+    EdgeVersatility *cloneVersatility = (EdgeVersatility*) EdgeArenaCalloc(arena, 1,
+            sizeof(EdgeVersatility));
+    VERIFY_NON_NULL_MSG(cloneVersatility, "EdgeCalloc failed in cloneEdgeVersatilityByType\n", NULL);
+
+    cloneVersatility->arrayLength = srcVersatility->arrayLength;
+    cloneVersatility->isArray = srcVersatility->isArray;
+    void *val = srcVersatility->value;
+    size_t size = get_size(type, srcVersatility->isArray);
+    if (srcVersatility->isArray == false)
+    {
+        // Scalar
+        if (type == UA_NS0ID_STRING || type == UA_NS0ID_BYTESTRING)
+        {
+            size_t len = strlen((char *) srcVersatility->value);
+            cloneVersatility->value = (void *) EdgeArenaCalloc(arena, 1, len+1);
+            if(IS_NULL(cloneVersatility->value))
+            {
+                goto CLONE_ERROR;
+            }
+
+            strncpy(cloneVersatility->value, (char*) srcVersatility->value, len+1);
+        }
+        else
+        {
+            cloneVersatility->value = (void *) EdgeArenaCalloc(arena, 1, size);
+            if(IS_NULL(cloneVersatility->value))
+            {
+                goto CLONE_ERROR;
+            }
+            memcpy(cloneVersatility->value, val, size);
+        }
+    }
+    else
+    {
+        // Array
+        if (type == UA_NS0ID_STRING || type == UA_NS0ID_BYTESTRING)
+        {
+            char **srcVal = (char**) srcVersatility->value;
+            cloneVersatility->value = EdgeArenaCalloc(arena, srcVersatility->arrayLength,
+                    sizeof(char*));
+            if(IS_NULL(cloneVersatility->value))
+            {
+                goto CLONE_ERROR;
+            }
+
+            char **dstVal = (char **) cloneVersatility->value;
+            size_t len;
+            for (int j = 0; j < srcVersatility->arrayLength; j++)
+            {
+                len = strlen(srcVal[j]);
+                dstVal[j] = (char*) EdgeArenaCalloc(arena, 1, sizeof(char) * (len+1));
+                if(IS_NULL(dstVal[j]))
+                {
+                    goto CLONE_ERROR;
+                }
+                strncpy(dstVal[j], srcVal[j], len+1);
+            }
+        }
+        else
+        {
+            cloneVersatility->value = EdgeArenaCalloc(arena, srcVersatility->arrayLength, size);
+            if(IS_NULL(cloneVersatility->value))
+            {
+                goto CLONE_ERROR;
+            }
+            memcpy(cloneVersatility->value, val, get_size(type, true) * srcVersatility->arrayLength);
+        }
+    }
+    return cloneVersatility;
+
+CLONE_ERROR:
+    if (IS_NULL(arena))
+    {
+        freeEdgeVersatilityByType(cloneVersatility, type);
+    }
+    return NULL;
+}
+
 EdgeMessage* cloneEdgeMessage(EdgeMessage *msg)
 {
     VERIFY_NON_NULL_MSG(msg, "NULL param EdgeMessage in cloneEdgeMessage\n", NULL);
@@ -514,6 +609,10 @@ EdgeMessage* cloneEdgeMessage(EdgeMessage *msg)
 
     clone->requestLength = msg->requestLength;
     clone->message_id = msg->message_id;
+    clone->priority = msg->priority;
+    clone->timeoutMs = msg->timeoutMs;
+    clone->sendImmediately = msg->sendImmediately;
+    clone->deadline = msg->deadline;
 
     if (msg->browseParam)
     {
@@ -536,6 +635,17 @@ EdgeMessage* cloneEdgeMessage(EdgeMessage *msg)
                 goto CLONE_ERROR;
             }
 
+            clone->request->requestId = msg->request->requestId;
+            clone->request->maxAge = msg->request->maxAge;
+            clone->request->attributeId = msg->request->attributeId;
+            if (msg->request->indexRange)
+            {
+                clone->request->indexRange = cloneString(msg->request->indexRange);
+                if(IS_NULL(clone->request->indexRange))
+                {
+                    goto CLONE_ERROR;
+                }
+            }
             if (msg->request->nodeInfo)
             {
                 clone->request->nodeInfo = cloneEdgeNodeInfo(msg->request->nodeInfo);
@@ -581,6 +691,17 @@ EdgeMessage* cloneEdgeMessage(EdgeMessage *msg)
                 goto CLONE_ERROR;
             }
 
+            clone->requests[i]->requestId = msg->requests[i]->requestId;
+            clone->requests[i]->maxAge = msg->requests[i]->maxAge;
+            clone->requests[i]->attributeId = msg->requests[i]->attributeId;
+            if (msg->requests[i]->indexRange)
+            {
+                clone->requests[i]->indexRange = cloneString(msg->requests[i]->indexRange);
+                if(IS_NULL(clone->requests[i]->indexRange))
+                {
+                    goto CLONE_ERROR;
+                }
+            }
             if (msg->requests[i]->nodeInfo)
             {
                 clone->requests[i]->nodeInfo = cloneEdgeNodeInfo(msg->requests[i]->nodeInfo);
@@ -596,83 +717,12 @@ EdgeMessage* cloneEdgeMessage(EdgeMessage *msg)
                 // EdgeVersatility
                 if (msg->requests[i]->value)
                 {
-                    EdgeVersatility *srcVersatility = (EdgeVersatility *) msg->requests[i]->value;
-                    clone->requests[i]->value = (EdgeVersatility*) EdgeCalloc(1, sizeof(EdgeVersatility));
+                    clone->requests[i]->value = cloneEdgeVersatilityByType(
+                            (EdgeVersatility *) msg->requests[i]->value, msg->requests[i]->type);
                     if(IS_NULL(clone->requests[i]->value))
                     {
                         goto CLONE_ERROR;
                     }
-
-                    EdgeVersatility* cloneVersatility = (EdgeVersatility*) clone->requests[i]->value;
-                    if (srcVersatility->isArray == false)
-                    {
-                        // Scalar
-                        void *val = srcVersatility->value;
-
-                        cloneVersatility->arrayLength = srcVersatility->arrayLength;
-                        cloneVersatility->isArray = srcVersatility->isArray;
-                        size_t size = get_size(msg->requests[i]->type, srcVersatility->isArray);
-                        if (msg->requests[i]->type == UA_NS0ID_STRING || msg->requests[i]->type == UA_NS0ID_BYTESTRING)
-                        {
-                            size_t len = strlen((char *) srcVersatility->value);
-                            cloneVersatility->value = (void *) EdgeCalloc(1, len+1);
-                            if(IS_NULL(cloneVersatility->value))
-                            {
-                                goto CLONE_ERROR;
-                            }
-
-                            strncpy(cloneVersatility->value, (char*) srcVersatility->value, len+1);
-                        }
-                        else
-                        {
-                            cloneVersatility->value = (void *) EdgeCalloc(1, size);
-                            if(IS_NULL(cloneVersatility->value))
-                            {
-                                goto CLONE_ERROR;
-                            }
-                            memcpy(cloneVersatility->value, val, size);
-                        }
-                    }
-                    else
-                    {
-                        // Array
-                        void *val = srcVersatility->value;
-
-                        cloneVersatility->arrayLength = srcVersatility->arrayLength;
-                        cloneVersatility->isArray = srcVersatility->isArray;
-                        size_t size = get_size(msg->requests[i]->type, srcVersatility->isArray);
-                        if (msg->requests[i]->type == UA_NS0ID_STRING || msg->requests[i]->type == UA_NS0ID_BYTESTRING)
-                        {
-                            char **srcVal = (char**) srcVersatility->value;
-                            cloneVersatility->value = EdgeCalloc(srcVersatility->arrayLength, sizeof(char*));
-                            if(IS_NULL(cloneVersatility->value))
-                            {
-                                goto CLONE_ERROR;
-                            }
-
-                            char **dstVal = (char **) cloneVersatility->value;
-                            size_t len;
-                            for (int j = 0; j < srcVersatility->arrayLength; j++)
-                            {
-                                len = strlen(srcVal[j]);
-                                dstVal[j] = (char*) EdgeCalloc(1, sizeof(char) * (len+1));
-                                if(IS_NULL(dstVal[j]))
-                                {
-                                    goto CLONE_ERROR;
-                                }
-                                strncpy(dstVal[j], srcVal[j], len+1);
-                            }
-                        }
-                        else
-                        {
-                            cloneVersatility->value = EdgeCalloc(srcVersatility->arrayLength, size);
-                            if(IS_NULL(cloneVersatility->value))
-                            {
-                                goto CLONE_ERROR;
-                            }
-                            memcpy(cloneVersatility->value, val, get_size(msg->requests[i]->type, true) * srcVersatility->arrayLength);
-                        }
-                    }
                 }
             }
             else if (msg->command == CMD_SUB)
@@ -696,6 +746,64 @@ CLONE_ERROR:
     return NULL;
 }
 
+static bool parseGuid(const char *str, UA_Guid *guid)
+{
+    unsigned int data4[8];
+    int read = 0;
+    COND_CHECK((GUID_LENGTH != strlen(str)), false);
+    COND_CHECK((11 != sscanf(str, "%08x-%04hx-%04hx-%02x%02x-%02x%02x%02x%02x%02x%02x%n",
+            &guid->data1, &guid->data2, &guid->data3, &data4[0], &data4[1], &data4[2],
+            &data4[3], &data4[4], &data4[5], &data4[6], &data4[7], &read)
+            || GUID_LENGTH != read), false);
+    for (int i = 0; i < 8; i++)
+    {
+        guid->data4[i] = (UA_Byte) data4[i];
+    }
+    return true;
+}
+
+bool convertToUANodeId(const EdgeNodeInfo *nodeInfo, UA_NodeId *nodeId)
+{
+    VERIFY_NON_NULL_MSG(nodeInfo, "NULL nodeInfo in convertToUANodeId\n", false);
+    VERIFY_NON_NULL_MSG(nodeInfo->nodeId, "NULL nodeInfo->nodeId in convertToUANodeId\n", false);
+    VERIFY_NON_NULL_MSG(nodeId, "NULL nodeId in convertToUANodeId\n", false);
+
+    const EdgeNodeId *edgeNodeId = nodeInfo->nodeId;
+    UA_NodeId_init(nodeId);
+    nodeId->namespaceIndex = edgeNodeId->nameSpace;
+    if (EDGE_INTEGER == edgeNodeId->type && 0 != edgeNodeId->integerNodeId)
+    {
+        nodeId->identifierType = UA_NODEIDTYPE_NUMERIC;
+        nodeId->identifier.numeric = (UA_UInt32) edgeNodeId->integerNodeId;
+        return true;
+    }
+
+    if (EDGE_UUID == edgeNodeId->type || EDGE_BYTESTRING == edgeNodeId->type)
+    {
+        const char *identifier = edgeNodeId->nodeId ? edgeNodeId->nodeId : nodeInfo->valueAlias;
+        VERIFY_NON_NULL_MSG(identifier, "No identifier in convertToUANodeId\n", false);
+        if (EDGE_UUID == edgeNodeId->type)
+        {
+            nodeId->identifierType = UA_NODEIDTYPE_GUID;
+            COND_CHECK_MSG((!parseGuid(identifier, &nodeId->identifier.guid)),
+                    "Malformed GUID in convertToUANodeId\n", false);
+            return true;
+        }
+        nodeId->identifierType = UA_NODEIDTYPE_BYTESTRING;
+        nodeId->identifier.byteString.length = strlen(identifier);
+        nodeId->identifier.byteString.data = (UA_Byte *) identifier;
+        return true;
+    }
+
+    /* String NodeIds, and numeric ones of zeroed EdgeNodeIds, keep using the alias */
+    const char *identifier = nodeInfo->valueAlias ? nodeInfo->valueAlias : edgeNodeId->nodeId;
+    VERIFY_NON_NULL_MSG(identifier, "No identifier in convertToUANodeId\n", false);
+    nodeId->identifierType = UA_NODEIDTYPE_STRING;
+    nodeId->identifier.string.length = strlen(identifier);
+    nodeId->identifier.string.data = (UA_Byte *) identifier;
+    return true;
+}
+
 char getCharacterNodeIdType(uint32_t type)
 {
     char nodeType;
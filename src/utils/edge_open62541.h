@@ -71,6 +71,15 @@ char *convertUAStringToString(UA_String *uaStr);
  */
 Edge_String *convertToEdgeString(UA_String *uaStr);
 
+/**
+ * @brief Copies string of type UA_String into an Edge_String, NULL terminated.
+ * @param[in]  arena Arena holding the data, NULL for the heap.
+ * @param[in]  uaStr Data to be converted.
+ * @param[out] out Converted string.
+ * @return @c true on success.
+ */
+bool convertToEdgeStringInArena(EdgeArena *arena, UA_String *uaStr, Edge_String *out);
+
 /**
  * @brief Converts UA_ApplicationType to EdgeApplicationType.
  * @param[in]  appType Application type as in open62541 library.
@@ -101,6 +110,14 @@ void convertGuidToString(UA_Guid guid, char **out);
  */
 Edge_NodeId *convertToEdgeNodeIdType(UA_NodeId *nodeId);
 
+/**
+ * @brief Converts UA_NodeId to Edge_NodeId in an arena.
+ * @param[in]  arena Arena holding the result, NULL for the heap.
+ * @param[in]  nodeId NodeId to be converted.
+ * @return Converted NodeId on success. Otherwise null.
+ */
+Edge_NodeId *convertToEdgeNodeIdTypeInArena(EdgeArena *arena, UA_NodeId *nodeId);
+
 /**
  * @brief Converts UA_NodeId to EdgeNodeId.
  * @remarks Allocated memory should be freed by the caller.
@@ -110,6 +127,18 @@ Edge_NodeId *convertToEdgeNodeIdType(UA_NodeId *nodeId);
  */
 EdgeNodeId *getEdgeNodeId(UA_NodeId *node);
 
+/**
+ * @brief Converts the EdgeNodeId of a node to UA_NodeId by its type.
+ * @remarks Numeric NodeIds take integerNodeId. GUID and ByteString NodeIds take
+ * EdgeNodeId.nodeId, in the forms given by getEdgeNodeId(), or else valueAlias. String
+ * NodeIds, and numeric ones without an integerNodeId, take valueAlias, or else EdgeNodeId.nodeId.
+ * The identifier of a String or ByteString NodeId points into nodeInfo, it must not be freed.
+ * @param[in]  nodeInfo Node information.
+ * @param[out]  nodeId Converted NodeId.
+ * @return @c true on success, false if the identifier is missing or malformed.
+ */
+bool convertToUANodeId(const EdgeNodeInfo *nodeInfo, UA_NodeId *nodeId);
+
 /**
  * @brief De-allocates the memory consumed by EdgeArgument and its members.
  * @remarks Both EdgeArgument and its members should have been allocated dynamically.
@@ -125,6 +154,25 @@ void freeEdgeArgument(EdgeArgument *arg);
  */
 void freeEdgeVersatilityByType(EdgeVersatility *versatileValue, int type);
 
+/**
+ * @brief Clones EdgeVersatility object and its value.
+ * @remarks Allocated memory should be freed by the caller with freeEdgeVersatilityByType().
+ * @param[in]  srcVersatility EdgeVersatility object to be cloned.
+ * @param[in]  type Type of the value in EdgeVersatility.
+ * @return Cloned EdgeVersatility object on success. Otherwise null.
+ */
+EdgeVersatility *cloneEdgeVersatilityByType(const EdgeVersatility *srcVersatility, int type);
+
+/**
+ * @brief Clones EdgeVersatility object and its value into an arena.
+ * @param[in]  arena Arena holding the clone, NULL for the heap.
+ * @param[in]  srcVersatility EdgeVersatility object to be cloned.
+ * @param[in]  type Type of the value in EdgeVersatility.
+ * @return Cloned EdgeVersatility object on success. Otherwise null.
+ */
+EdgeVersatility *cloneEdgeVersatilityByTypeInArena(EdgeArena *arena,
+        const EdgeVersatility *srcVersatility, int type);
+
 /**
  * @brief Checks whether the given node class is valid & supported by open62541.
  * @param[in]  nodeClass Represents the node class.
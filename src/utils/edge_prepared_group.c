@@ -0,0 +1,318 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_prepared_group.h"
+#include "edge_open62541.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "edge_arena.h"
+#include "edge_index_range.h"
+#include "ocatomic.h"
+
+#define TAG "prepared_group"
+
+static void freePreparedGroup(EdgePreparedGroup *group)
+{
+    size_t count = group->msg ? group->msg->requestLength : 0;
+    for (size_t i = 0; group->readValueIds && i < count; i++)
+    {
+        UA_ReadValueId_deleteMembers(&group->readValueIds[i]);
+    }
+    for (size_t i = 0; group->writeValues && i < count; i++)
+    {
+        UA_NodeId_deleteMembers(&group->writeValues[i].nodeId);
+    }
+    EdgeFree(group->readValueIds);
+    EdgeFree(group->writeValues);
+    EdgeFree(group->partLengths);
+    EdgeFree(group->partIds);
+    if (group->msg)
+    {
+        freeEdgeMessage(group->msg);
+    }
+    EdgeFree(group);
+}
+
+static bool getGroupAttributeId(EdgeCommand command, UA_UInt32 *attributeId)
+{
+    if (CMD_READ == command || CMD_WRITE == command)
+    {
+        *attributeId = UA_ATTRIBUTEID_VALUE;
+        return true;
+    }
+    if (CMD_READ_SAMPLING_INTERVAL == command)
+    {
+        *attributeId = UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL;
+        return true;
+    }
+    return false;
+}
+
+static bool buildGroupNodeId(const EdgeRequest *request, UA_NodeId *nodeId)
+{
+    UA_NodeId borrowed;
+    COND_CHECK((!convertToUANodeId(request->nodeInfo, &borrowed)), false);
+    return (UA_STATUSCODE_GOOD == UA_NodeId_copy(&borrowed, nodeId));
+}
+
+static bool buildGroupNodes(EdgePreparedGroup *group)
+{
+    EdgeMessage *msg = group->msg;
+    if (CMD_WRITE == msg->command)
+    {
+        group->writeValues = (UA_WriteValue *) EdgeCalloc(msg->requestLength, sizeof(UA_WriteValue));
+        VERIFY_NON_NULL_MSG(group->writeValues, "EdgeCalloc FAILED for UA_WriteValue\n", false);
+        for (size_t i = 0; i < msg->requestLength; i++)
+        {
+            UA_WriteValue_init(&group->writeValues[i]);
+            group->writeValues[i].attributeId = group->attributeId;
+            COND_CHECK((!buildGroupNodeId(msg->requests[i], &group->writeValues[i].nodeId)), false);
+        }
+        return true;
+    }
+
+    group->readValueIds = (UA_ReadValueId *) EdgeCalloc(msg->requestLength, sizeof(UA_ReadValueId));
+    VERIFY_NON_NULL_MSG(group->readValueIds, "EdgeCalloc FAILED for UA_ReadValueId\n", false);
+    for (size_t i = 0; i < msg->requestLength; i++)
+    {
+        const EdgeRequest *request = msg->requests[i];
+        UA_ReadValueId *rv = &group->readValueIds[i];
+        UA_ReadValueId_init(rv);
+        rv->attributeId = (request->attributeId > 0) ? request->attributeId : group->attributeId;
+        COND_CHECK((!buildGroupNodeId(request, &rv->nodeId)), false);
+        if (request->indexRange)
+        {
+            char page[EDGE_INDEX_RANGE_SIZE];
+            rv->indexRange = UA_STRING_ALLOC(getEdgeIndexRangeFirstPage(request->indexRange,
+                    page, sizeof(page)));
+            COND_CHECK((IS_NULL(rv->indexRange.data)), false);
+        }
+    }
+    return true;
+}
+
+EdgePreparedGroup *createEdgePreparedGroup(EdgeMessage *msg)
+{
+    VERIFY_NON_NULL_MSG(msg, "NULL msg param in createEdgePreparedGroup\n", NULL);
+    COND_CHECK_MSG((SEND_REQUESTS != msg->type || IS_NULL(msg->requests) || 0 == msg->requestLength),
+            "No requests to prepare in createEdgePreparedGroup\n", NULL);
+    for (size_t i = 0; i < msg->requestLength; i++)
+    {
+        COND_CHECK_MSG((IS_NULL(msg->requests[i])), "NULL request in createEdgePreparedGroup\n", NULL);
+    }
+
+    UA_UInt32 attributeId = 0;
+    COND_CHECK_MSG((!getGroupAttributeId(msg->command, &attributeId)),
+            "Invalid command in createEdgePreparedGroup\n", NULL);
+
+    EdgePreparedGroup *group = (EdgePreparedGroup *) EdgeCalloc(1, sizeof(EdgePreparedGroup));
+    VERIFY_NON_NULL_MSG(group, "EdgeCalloc FAILED for EdgePreparedGroup\n", NULL);
+    group->attributeId = attributeId;
+    group->refCount = 1;
+
+    group->msg = cloneEdgeMessage(msg);
+    if (IS_NULL(group->msg) || !buildGroupNodes(group))
+    {
+        EDGE_LOG(TAG, "Failed to prepare the nodes of the group.\n");
+        freePreparedGroup(group);
+        return NULL;
+    }
+    EDGE_LOG_V(TAG, "Prepared group of %zu nodes\n", msg->requestLength);
+    return group;
+}
+
+static size_t appendGroupParts(size_t *partLengths, const EdgePreparedGroup *group)
+{
+    if (0 == group->partCount)
+    {
+        partLengths[0] = group->msg->requestLength;
+        return 1;
+    }
+    memcpy(partLengths, group->partLengths, group->partCount * sizeof(size_t));
+    return group->partCount;
+}
+
+bool setEdgePreparedGroupParts(EdgePreparedGroup *group, const EdgePreparedGroup *first,
+        const EdgePreparedGroup *second)
+{
+    VERIFY_NON_NULL_MSG(group, "NULL group param in setEdgePreparedGroupParts\n", false);
+    VERIFY_NON_NULL_MSG(first, "NULL first param in setEdgePreparedGroupParts\n", false);
+    VERIFY_NON_NULL_MSG(second, "NULL second param in setEdgePreparedGroupParts\n", false);
+
+    size_t count = (first->partCount ? first->partCount : 1)
+            + (second->partCount ? second->partCount : 1);
+    size_t *partLengths = (size_t *) EdgeCalloc(count, sizeof(size_t));
+    uint32_t *partIds = (uint32_t *) EdgeCalloc(count, sizeof(uint32_t));
+    if (IS_NULL(partLengths) || IS_NULL(partIds))
+    {
+        EDGE_LOG(TAG, "EdgeCalloc FAILED for the parts of a group\n");
+        EdgeFree(partLengths);
+        EdgeFree(partIds);
+        return false;
+    }
+    size_t offset = appendGroupParts(partLengths, first);
+    appendGroupParts(partLengths + offset, second);
+
+    EdgeFree(group->partLengths);
+    EdgeFree(group->partIds);
+    group->partLengths = partLengths;
+    group->partIds = partIds;
+    group->partCount = count;
+    return true;
+}
+
+bool setEdgePreparedGroupPartIds(EdgePreparedGroup *group, const uint32_t *partIds,
+        size_t count)
+{
+    VERIFY_NON_NULL_MSG(group, "NULL group param in setEdgePreparedGroupPartIds\n", false);
+    COND_CHECK((0 == group->partCount), true);
+    COND_CHECK_MSG((IS_NULL(partIds) || count != group->partCount),
+            "Ids do not match the parts in setEdgePreparedGroupPartIds\n", false);
+    memcpy(group->partIds, partIds, count * sizeof(uint32_t));
+    return true;
+}
+
+EdgeMessage *createEdgePreparedPartMessages(const EdgeMessage *msg, size_t *count)
+{
+    VERIFY_NON_NULL_MSG(count, "NULL count param in createEdgePreparedPartMessages\n", NULL);
+    *count = 0;
+    COND_CHECK((IS_NULL(msg) || IS_NULL(msg->preparedGroup)), NULL);
+    const EdgePreparedGroup *group = msg->preparedGroup;
+    COND_CHECK((0 == group->partCount), NULL);
+
+    EdgeMessage *parts = (EdgeMessage *) EdgeCalloc(group->partCount, sizeof(EdgeMessage));
+    VERIFY_NON_NULL_MSG(parts, "EdgeCalloc FAILED for the parts of a message\n", NULL);
+    size_t offset = 0;
+    for (size_t i = 0; i < group->partCount; i++)
+    {
+        // A part is a plain message of its requests, which are still owned by the group.
+        parts[i] = *msg;
+        parts[i].requests = msg->requests + offset;
+        parts[i].requestLength = group->partLengths[i];
+        parts[i].message_id = group->partIds[i];
+        parts[i].preparedGroup = NULL;
+        parts[i].arena = NULL;
+        offset += group->partLengths[i];
+    }
+    *count = group->partCount;
+    return parts;
+}
+
+void retainEdgePreparedGroup(EdgePreparedGroup *group)
+{
+    VERIFY_NON_NULL_NR_MSG(group, "NULL group param in retainEdgePreparedGroup\n");
+    OC_ATOMIC_FETCH_ADD(&group->refCount, 1);
+}
+
+void releaseEdgePreparedGroup(EdgePreparedGroup *group)
+{
+    if (IS_NULL(group))
+    {
+        return;
+    }
+    if (1 == OC_ATOMIC_FETCH_SUB(&group->refCount, 1))
+    {
+        freePreparedGroup(group);
+    }
+}
+
+static bool setPreparedValues(EdgeMessage *msg, const EdgeMessage *prepared, void **values,
+        const size_t *valueCounts)
+{
+    size_t count = prepared->requestLength;
+    msg->requests = (EdgeRequest **) EdgeArenaCalloc(msg->arena, count, sizeof(EdgeRequest *));
+    EdgeRequest *requests = (EdgeRequest *) EdgeArenaCalloc(msg->arena, count,
+            sizeof(EdgeRequest));
+    COND_CHECK_MSG((IS_NULL(msg->requests) || IS_NULL(requests)),
+            "EdgeCalloc FAILED for the requests of a prepared group\n", false);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t valueCount = valueCounts ? valueCounts[i] : 1;
+        COND_CHECK_MSG((IS_NULL(values[i]) || 0 == valueCount),
+                "Missing value for a node of a prepared group\n", false);
+
+        EdgeVersatility value;
+        value.value = values[i];
+        value.isArray = (valueCount > 1);
+        value.arrayLength = value.isArray ? valueCount : 0;
+
+        // Node and type are shared with the group, only the value is the execution's own.
+        requests[i] = *prepared->requests[i];
+        requests[i].value = cloneEdgeVersatilityByTypeInArena(msg->arena, &value,
+                requests[i].type);
+        VERIFY_NON_NULL_MSG(requests[i].value, "Failed to copy a value of a prepared group\n", false);
+        msg->requests[i] = &requests[i];
+    }
+    return true;
+}
+
+EdgeMessage *createEdgePreparedMessage(EdgePreparedGroup *group, void **values,
+        const size_t *valueCounts)
+{
+    VERIFY_NON_NULL_MSG(group, "NULL group param in createEdgePreparedMessage\n", NULL);
+    const EdgeMessage *prepared = group->msg;
+
+    /* Values to write are copied into an arena along with the message, which
+     * freeEdgeMessage() releases. Other messages are moved by the read batching of the
+     * send queue, so they are allocated on their own. */
+    bool copyValues = (CMD_WRITE == prepared->command && IS_NOT_NULL(values));
+    EdgeArena *arena = NULL;
+    if (copyValues)
+    {
+        arena = EdgeArenaAcquire();
+        VERIFY_NON_NULL_MSG(arena, "EdgeArenaAcquire FAILED in createEdgePreparedMessage\n", NULL);
+    }
+
+    EdgeMessage *msg = (EdgeMessage *) EdgeArenaCalloc(arena, 1, sizeof(EdgeMessage));
+    if (IS_NULL(msg))
+    {
+        EDGE_LOG(TAG, "EdgeCalloc FAILED for the message of a prepared group\n");
+        if (arena)
+        {
+            EdgeArenaRelease(arena);
+        }
+        return NULL;
+    }
+    msg->arena = arena;
+    msg->type = prepared->type;
+    msg->command = prepared->command;
+    msg->endpointInfo = prepared->endpointInfo;
+    msg->requests = prepared->requests;
+    msg->requestLength = prepared->requestLength;
+    msg->message_id = prepared->message_id;
+    msg->priority = prepared->priority;
+    msg->timeoutMs = prepared->timeoutMs;
+    msg->sendImmediately = prepared->sendImmediately;
+
+    if (copyValues)
+    {
+        if (!setPreparedValues(msg, prepared, values, valueCounts))
+        {
+            EdgeArenaRelease(arena);
+            return NULL;
+        }
+    }
+
+    retainEdgePreparedGroup(group);
+    msg->preparedGroup = group;
+    return msg;
+}
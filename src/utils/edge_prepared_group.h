@@ -0,0 +1,143 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_prepared_group.h
+ *
+ * @brief This file contains the read and write groups prepared to be executed repeatedly.
+ *
+ * A group keeps a copy of the message it was prepared from, with the read value ids or
+ * write values of its nodes built already. Every execution queues a small message which
+ * shares the endpoint, the requests and the built nodes of the group, so it needs neither
+ * node name parsing nor a copy of the nodes. The group is reference
+ * counted: a queued execution keeps it alive until its message is freed.
+ */
+
+#ifndef EDGE_PREPARED_GROUP_H
+#define EDGE_PREPARED_GROUP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "opcua_common.h"
+#include "open62541.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct EdgePreparedGroup
+{
+    /** Copy of the message the group was prepared from. Shared by every execution. */
+    EdgeMessage *msg;
+    /** Attribute the nodes are read or written, unless their request names another one. */
+    UA_UInt32 attributeId;
+    /** Read value ids of the nodes in the order of the requests. NULL for a write group. */
+    UA_ReadValueId *readValueIds;
+    /** Write values of the nodes in the order of the requests, without their value.
+     *  NULL for a read group. */
+    UA_WriteValue *writeValues;
+    /** Number of requests of each poll merged into the group, in the order of the requests.
+     *  NULL unless the group serves the shared cycle of several polls. */
+    size_t *partLengths;
+    /** Id of the poll of each part, which its responses carry. Set by each cycle. */
+    uint32_t *partIds;
+    /** Number of parts, 0 unless the group serves the shared cycle of several polls. */
+    size_t partCount;
+    /** References held by the application and by the queued executions. */
+    volatile uint32_t refCount;
+};
+
+typedef struct EdgePreparedGroup EdgePreparedGroup;
+
+/**
+ * @brief Prepares a read or write message. The caller holds the only reference.
+ * @param[in]  msg CMD_READ, CMD_READ_SAMPLING_INTERVAL or CMD_WRITE message with its
+ *             requests. It is copied.
+ * @return group on success, NULL if msg can not be prepared or memory allocation failed.
+ */
+EdgePreparedGroup *createEdgePreparedGroup(EdgeMessage *msg);
+
+/**
+ * @brief Makes the parts of a merged group from the groups it was merged from, whose
+ *        requests it holds one after the other.
+ * @param[in]  group Merged group.
+ * @param[in]  first Group whose requests come first. It may be a merged group itself.
+ * @param[in]  second Group whose requests follow.
+ * @return @c true on success, false if memory allocation failed.
+ */
+bool setEdgePreparedGroupParts(EdgePreparedGroup *group, const EdgePreparedGroup *first,
+        const EdgePreparedGroup *second);
+
+/**
+ * @brief Sets the ids of the polls the parts of the group answer, before it is executed.
+ *        Must not be called while an execution of the group is queued.
+ * @param[in]  group Group.
+ * @param[in]  partIds Id of the poll of each part.
+ * @param[in]  count Number of ids.
+ * @return @c true on success, false if the group has parts but not count of them.
+ */
+bool setEdgePreparedGroupPartIds(EdgePreparedGroup *group, const uint32_t *partIds,
+        size_t count);
+
+/**
+ * @brief Gets a message for each part of an execution of a merged group, which holds the
+ *        requests of the part and carries the id of its poll.
+ * @remarks The messages share the members of msg, so they are freed with EdgeFree() on
+ *          the returned array only, before msg is.
+ * @param[in]  msg Message of an execution of the group.
+ * @param[out] count Number of parts.
+ * @return array of count messages, NULL if the group of msg has no parts or memory
+ *         allocation failed.
+ */
+EdgeMessage *createEdgePreparedPartMessages(const EdgeMessage *msg, size_t *count);
+
+/**
+ * @brief Adds a reference to the group.
+ * @param[in]  group Group.
+ */
+void retainEdgePreparedGroup(EdgePreparedGroup *group);
+
+/**
+ * @brief Releases a reference to the group. The last one frees it.
+ * @param[in]  group Group. NULL is ignored.
+ */
+void releaseEdgePreparedGroup(EdgePreparedGroup *group);
+
+/**
+ * @brief Creates the message of one execution of the group. The message holds a reference
+ *        to the group, which freeEdgeMessage() releases.
+ * @param[in]  group Group.
+ * @param[in]  values Values to write, one per request, or NULL to write the values the group
+ *             was prepared with. Ignored for a read group. They are copied.
+ * @param[in]  valueCounts Number of elements of each value, 1 for a scalar. May be NULL if
+ *             all values are scalars.
+ * @return message on success, NULL if memory allocation failed.
+ */
+EdgeMessage *createEdgePreparedMessage(EdgePreparedGroup *group, void **values,
+        const size_t *valueCounts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_PREPARED_GROUP_H
@@ -30,6 +30,8 @@
 #include "edge_open62541.h"
 #include "edge_logger.h"
 #include "edge_malloc.h"
+#include "edge_arena.h"
+#include "edge_prepared_group.h"
 
 #define TAG "edge_utils"
 
@@ -78,6 +80,46 @@ char *cloneString(const char *str)
     return clone;
 }
 
+#define FNV_OFFSET_BASIS (2166136261u)
+#define FNV_PRIME (16777619u)
+
+uint32_t hashData(const void *data, size_t length)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    COND_CHECK((NULL == data), hash);
+
+    const unsigned char *bytes = (const unsigned char *) data;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+const char *getEndpointAddress(const char *endpointUri, size_t *length)
+{
+    VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri param in getEndpointAddress\n", NULL);
+    VERIFY_NON_NULL_MSG(length, "NULL length param in getEndpointAddress\n", NULL);
+
+    // Skip the scheme. Ex: 'opc.tcp://'
+    const char *address = strstr(endpointUri, "://");
+    address = (NULL == address) ? endpointUri : address + 3;
+
+    // Address ends at the beginning of the path.
+    *length = strcspn(address, "/");
+    return address;
+}
+
+uint32_t hashEndpointAddress(const char *endpointUri)
+{
+    VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri param in hashEndpointAddress\n", 0);
+
+    size_t length = 0;
+    const char *address = getEndpointAddress(endpointUri, &length);
+    return hashData(address, length);
+}
+
 void *cloneData(const void *src, int lenInbytes)
 {
     VERIFY_NON_NULL_MSG(src, "", NULL);
@@ -168,16 +210,25 @@ EdgeSubRequest* cloneSubRequest(EdgeSubRequest* subReq)
     return clone;
 }
 
-EdgeEndpointConfig *cloneEdgeEndpointConfig(EdgeEndpointConfig *config)
+static EdgeEndpointConfig *cloneEndpointConfigInArena(EdgeArena *arena,
+        EdgeEndpointConfig *config)
 {
     VERIFY_NON_NULL_MSG(config, "NULL config patram in cloneEdgeEndpointConfig\n", NULL);
-    EdgeEndpointConfig *clone = (EdgeEndpointConfig *) EdgeCalloc(1, sizeof(EdgeEndpointConfig));
+    EdgeEndpointConfig *clone = (EdgeEndpointConfig *) EdgeArenaCalloc(arena, 1,
+            sizeof(EdgeEndpointConfig));
     VERIFY_NON_NULL_MSG(clone, "EdgeCallc failed for clone in cloneEdgeEndpointConfig\n", NULL);
     clone->requestTimeout = config->requestTimeout;
     clone->bindPort = config->bindPort;
+    clone->sessionCount = config->sessionCount;
+    clone->sessionPolicy = config->sessionPolicy;
+    clone->dedicatedSubscriptionSession = config->dedicatedSubscriptionSession;
+    clone->autoReconnect = config->autoReconnect;
+    clone->reconnectInitialDelay = config->reconnectInitialDelay;
+    clone->reconnectMaxDelay = config->reconnectMaxDelay;
+    clone->reconnectMaxAttempts = config->reconnectMaxAttempts;
     if (config->serverName)
     {
-        clone->serverName = cloneString(config->serverName);
+        clone->serverName = EdgeArenaCloneString(arena, config->serverName);
         if (!clone->serverName)
         {
             goto CLONE_ERROR;
@@ -186,7 +237,7 @@ EdgeEndpointConfig *cloneEdgeEndpointConfig(EdgeEndpointConfig *config)
 
     if (config->bindAddress)
     {
-        clone->bindAddress = cloneString(config->bindAddress);
+        clone->bindAddress = EdgeArenaCloneString(arena, config->bindAddress);
         if (!clone->bindAddress)
         {
             goto CLONE_ERROR;
@@ -195,21 +246,31 @@ EdgeEndpointConfig *cloneEdgeEndpointConfig(EdgeEndpointConfig *config)
 
     return clone;
 
-    CLONE_ERROR: freeEdgeEndpointConfig(clone);
+    CLONE_ERROR:
+    if (IS_NULL(arena))
+    {
+        freeEdgeEndpointConfig(clone);
+    }
     return NULL;
 }
 
-EdgeApplicationConfig *cloneEdgeApplicationConfig(EdgeApplicationConfig *config)
+EdgeEndpointConfig *cloneEdgeEndpointConfig(EdgeEndpointConfig *config)
+{
+    return cloneEndpointConfigInArena(NULL, config);
+}
+
+static EdgeApplicationConfig *cloneApplicationConfigInArena(EdgeArena *arena,
+        EdgeApplicationConfig *config)
 {
     VERIFY_NON_NULL_MSG(config, "NULL cofig patram in cloneEdgeApplicationConfig\n", NULL);
-    EdgeApplicationConfig *clone = (EdgeApplicationConfig *) EdgeCalloc(1,
+    EdgeApplicationConfig *clone = (EdgeApplicationConfig *) EdgeArenaCalloc(arena, 1,
             sizeof(EdgeApplicationConfig));
     VERIFY_NON_NULL_MSG(clone, "EdgeCalloc FAILED for clone in cloneEdgeApplicationConfig\n", NULL);
     clone->applicationType = config->applicationType;
 
     if (config->applicationUri)
     {
-        clone->applicationUri = cloneString(config->applicationUri);
+        clone->applicationUri = EdgeArenaCloneString(arena, config->applicationUri);
         if (!clone->applicationUri)
         {
             goto CLONE_ERROR;
@@ -218,7 +279,7 @@ EdgeApplicationConfig *cloneEdgeApplicationConfig(EdgeApplicationConfig *config)
 
     if (config->productUri)
     {
-        clone->productUri = cloneString(config->productUri);
+        clone->productUri = EdgeArenaCloneString(arena, config->productUri);
         if (!clone->productUri)
         {
             goto CLONE_ERROR;
@@ -227,7 +288,7 @@ EdgeApplicationConfig *cloneEdgeApplicationConfig(EdgeApplicationConfig *config)
 
     if (config->applicationName)
     {
-        clone->applicationName = cloneString(config->applicationName);
+        clone->applicationName = EdgeArenaCloneString(arena, config->applicationName);
         if (!clone->applicationName)
         {
             goto CLONE_ERROR;
@@ -236,7 +297,7 @@ EdgeApplicationConfig *cloneEdgeApplicationConfig(EdgeApplicationConfig *config)
 
     if (config->gatewayServerUri)
     {
-        clone->gatewayServerUri = cloneString(config->gatewayServerUri);
+        clone->gatewayServerUri = EdgeArenaCloneString(arena, config->gatewayServerUri);
         if (!clone->gatewayServerUri)
         {
             goto CLONE_ERROR;
@@ -245,7 +306,7 @@ EdgeApplicationConfig *cloneEdgeApplicationConfig(EdgeApplicationConfig *config)
 
     if (config->discoveryProfileUri)
     {
-        clone->discoveryProfileUri = cloneString(config->discoveryProfileUri);
+        clone->discoveryProfileUri = EdgeArenaCloneString(arena, config->discoveryProfileUri);
         if (!clone->discoveryProfileUri)
         {
             goto CLONE_ERROR;
@@ -253,7 +314,8 @@ EdgeApplicationConfig *cloneEdgeApplicationConfig(EdgeApplicationConfig *config)
     }
 
     clone->discoveryUrlsSize = config->discoveryUrlsSize;
-    clone->discoveryUrls = (char **) EdgeCalloc(config->discoveryUrlsSize, sizeof(char *));
+    clone->discoveryUrls = (char **) EdgeArenaCalloc(arena, config->discoveryUrlsSize,
+            sizeof(char *));
     if (!clone->discoveryUrls)
     {
         goto CLONE_ERROR;
@@ -263,7 +325,7 @@ EdgeApplicationConfig *cloneEdgeApplicationConfig(EdgeApplicationConfig *config)
     {
         if (config->discoveryUrls[i])
         {
-            clone->discoveryUrls[i] = cloneString(config->discoveryUrls[i]);
+            clone->discoveryUrls[i] = EdgeArenaCloneString(arena, config->discoveryUrls[i]);
             if (!clone->discoveryUrls[i])
             {
                 goto CLONE_ERROR;
@@ -273,10 +335,19 @@ EdgeApplicationConfig *cloneEdgeApplicationConfig(EdgeApplicationConfig *config)
 
     return clone;
 
-    CLONE_ERROR: freeEdgeApplicationConfig(clone);
+    CLONE_ERROR:
+    if (IS_NULL(arena))
+    {
+        freeEdgeApplicationConfig(clone);
+    }
     return NULL;
 }
 
+EdgeApplicationConfig *cloneEdgeApplicationConfig(EdgeApplicationConfig *config)
+{
+    return cloneApplicationConfigInArena(NULL, config);
+}
+
 void freeEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo)
 {
     VERIFY_NON_NULL_NR_MSG(endpointInfo, "NULL param endpointinfo in cloneEdgeEndpointInfo\n");
@@ -288,17 +359,18 @@ void freeEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo)
     EdgeFree(endpointInfo);
 }
 
-EdgeEndPointInfo *cloneEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo)
+EdgeEndPointInfo *cloneEdgeEndpointInfoInArena(EdgeArena *arena, EdgeEndPointInfo *endpointInfo)
 {
     VERIFY_NON_NULL_MSG(endpointInfo, "NULL param endpointinfo in cloneEdgeEndpointInfo\n", NULL);
-    EdgeEndPointInfo *clone = (EdgeEndPointInfo *) EdgeCalloc(1, sizeof(EdgeEndPointInfo));
+    EdgeEndPointInfo *clone = (EdgeEndPointInfo *) EdgeArenaCalloc(arena, 1,
+            sizeof(EdgeEndPointInfo));
     VERIFY_NON_NULL_MSG(clone, "EdgeCalloc failed for clone in cloneEdgeEndpointInfo\n", NULL);
     clone->securityMode = endpointInfo->securityMode;
     clone->securityLevel = endpointInfo->securityLevel;
 
     if (endpointInfo->endpointUri)
     {
-        clone->endpointUri = cloneString(endpointInfo->endpointUri);
+        clone->endpointUri = EdgeArenaCloneString(arena, endpointInfo->endpointUri);
         if (!clone->endpointUri)
         {
             goto CLONE_ERROR;
@@ -307,7 +379,7 @@ EdgeEndPointInfo *cloneEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo)
 
     if (endpointInfo->securityPolicyUri)
     {
-        clone->securityPolicyUri = cloneString(endpointInfo->securityPolicyUri);
+        clone->securityPolicyUri = EdgeArenaCloneString(arena, endpointInfo->securityPolicyUri);
         if (!clone->securityPolicyUri)
         {
             goto CLONE_ERROR;
@@ -316,7 +388,7 @@ EdgeEndPointInfo *cloneEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo)
 
     if (endpointInfo->transportProfileUri)
     {
-        clone->transportProfileUri = cloneString(endpointInfo->transportProfileUri);
+        clone->transportProfileUri = EdgeArenaCloneString(arena, endpointInfo->transportProfileUri);
         if (!clone->transportProfileUri)
         {
             goto CLONE_ERROR;
@@ -325,7 +397,7 @@ EdgeEndPointInfo *cloneEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo)
 
     if (endpointInfo->endpointConfig)
     {
-        clone->endpointConfig = cloneEdgeEndpointConfig(endpointInfo->endpointConfig);
+        clone->endpointConfig = cloneEndpointConfigInArena(arena, endpointInfo->endpointConfig);
         if (!clone->endpointConfig)
         {
             goto CLONE_ERROR;
@@ -334,7 +406,7 @@ EdgeEndPointInfo *cloneEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo)
 
     if (endpointInfo->appConfig)
     {
-        clone->appConfig = cloneEdgeApplicationConfig(endpointInfo->appConfig);
+        clone->appConfig = cloneApplicationConfigInArena(arena, endpointInfo->appConfig);
         if (!clone->appConfig)
         {
             goto CLONE_ERROR;
@@ -343,10 +415,19 @@ EdgeEndPointInfo *cloneEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo)
 
     return clone;
 
-    CLONE_ERROR: freeEdgeEndpointInfo(clone);
+    CLONE_ERROR:
+    if (IS_NULL(arena))
+    {
+        freeEdgeEndpointInfo(clone);
+    }
     return NULL;
 }
 
+EdgeEndPointInfo *cloneEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo)
+{
+    return cloneEdgeEndpointInfoInArena(NULL, endpointInfo);
+}
+
 void freeEdgeBrowseResult(EdgeBrowseResult *browseResult, int browseResultLength)
 {
     VERIFY_NON_NULL_NR_MSG(browseResult, "NULL param browse result in freeEdgeBrowseResult\n");
@@ -402,6 +483,7 @@ void freeEdgeRequest(EdgeRequest *req)
 {
     VERIFY_NON_NULL_NR_MSG(req, "NULL param request in freeEdgeRequest\n");
     EdgeFree(req->value);
+    EdgeFree(req->indexRange);
     EdgeFree(req->subMsg);
     freeEdgeMethodRequestParams(req->methodParams);
     freeEdgeNodeInfo(req->nodeInfo);
@@ -473,16 +555,49 @@ void freeEdgeResponses(EdgeResponse **responses, int responseLength)
 void freeEdgeMessage(EdgeMessage *msg)
 {
     VERIFY_NON_NULL_NR_MSG(msg, "NULL param EdgeMessage in freeEdgeMessage\n");
+    if (msg->preparedGroup)
+    {
+        // The endpoint and the requests belong to the prepared group.
+        EdgePreparedGroup *group = msg->preparedGroup;
+        if (msg->arena)
+        {
+            EdgeArenaRelease(msg->arena);
+        }
+        else
+        {
+            EdgeFree(msg);
+        }
+        releaseEdgePreparedGroup(group);
+        return;
+    }
+    if (msg->arena)
+    {
+        // The whole message lives in the arena.
+        EdgeArenaRelease(msg->arena);
+        return;
+    }
     freeEdgeEndpointInfo(msg->endpointInfo);
     freeEdgeRequest(msg->request);
     freeEdgeRequests(msg->requests, msg->requestLength);
     freeEdgeResponses(msg->responses, msg->responseLength);
+    EdgeFree(msg->flatResults);
     EdgeFree(msg->result);
     EdgeFree(msg->browseParam);
     freeEdgeBrowseResult(msg->browseResult, msg->browseResultLength);
     EdgeFree(msg);
 }
 
+EdgeMessage *moveEdgeMessage(EdgeMessage *msg)
+{
+    VERIFY_NON_NULL_MSG(msg, "NULL param EdgeMessage in moveEdgeMessage\n", NULL);
+    COND_CHECK_MSG((NULL != msg->arena), "Message in an arena in moveEdgeMessage\n", NULL);
+    EdgeMessage *moved = (EdgeMessage *) EdgeMalloc(sizeof(EdgeMessage));
+    VERIFY_NON_NULL_MSG(moved, "EdgeMalloc failed for EdgeMessage in moveEdgeMessage\n", NULL);
+    *moved = *msg;
+    memset(msg, 0, sizeof(EdgeMessage));
+    return moved;
+}
+
 EdgeResult *createEdgeResult(EdgeStatusCode code)
 {
     EdgeResult *result = (EdgeResult *) EdgeCalloc(1, sizeof(EdgeResult));
@@ -491,19 +606,19 @@ EdgeResult *createEdgeResult(EdgeStatusCode code)
     return result;
 }
 
-EdgeNodeId *cloneEdgeNodeId(EdgeNodeId *nodeId)
+static EdgeNodeId *cloneNodeIdInArena(EdgeArena *arena, EdgeNodeId *nodeId)
 {
     VERIFY_NON_NULL_MSG(nodeId, "NULL param nodeID in cloneEdgeNodeId\n", NULL);
-    EdgeNodeId *clone = (EdgeNodeId *) EdgeCalloc(1, sizeof(EdgeNodeId));
+    EdgeNodeId *clone = (EdgeNodeId *) EdgeArenaCalloc(arena, 1, sizeof(EdgeNodeId));
     VERIFY_NON_NULL_MSG(clone, "EdgeCAlloc FAILED for clone in cloneEdgeNodeId\n", NULL);
 
     clone->nameSpace = nodeId->nameSpace;
     if (nodeId->nodeUri)
     {
-        clone->nodeUri = cloneString(nodeId->nodeUri);
+        clone->nodeUri = EdgeArenaCloneString(arena, nodeId->nodeUri);
         if (!clone->nodeUri)
         {
-            EdgeFree(clone);
+            EdgeArenaFree(arena, clone);
             return NULL;
         }
     }
@@ -511,11 +626,11 @@ EdgeNodeId *cloneEdgeNodeId(EdgeNodeId *nodeId)
     clone->type = nodeId->type;
     if (nodeId->nodeId)
     {
-        clone->nodeId = cloneString(nodeId->nodeId);
+        clone->nodeId = EdgeArenaCloneString(arena, nodeId->nodeId);
         if (!clone->nodeId)
         {
-            EdgeFree(clone->nodeUri);
-            EdgeFree(clone);
+            EdgeArenaFree(arena, clone->nodeUri);
+            EdgeArenaFree(arena, clone);
             return NULL;
         }
     }
@@ -524,41 +639,49 @@ EdgeNodeId *cloneEdgeNodeId(EdgeNodeId *nodeId)
     return clone;
 }
 
-EdgeNodeInfo *cloneEdgeNodeInfo(EdgeNodeInfo *nodeInfo)
+EdgeNodeId *cloneEdgeNodeId(EdgeNodeId *nodeId)
+{
+    return cloneNodeIdInArena(NULL, nodeId);
+}
+
+EdgeNodeInfo *cloneEdgeNodeInfoInArena(EdgeArena *arena, EdgeNodeInfo *nodeInfo)
 {
     VERIFY_NON_NULL_MSG(nodeInfo, "NULL param nodeinfo in cloneEdgeNodeInfo\n", NULL);
-    EdgeNodeInfo *clone = (EdgeNodeInfo *) EdgeCalloc(1, sizeof(EdgeNodeInfo));
+    EdgeNodeInfo *clone = (EdgeNodeInfo *) EdgeArenaCalloc(arena, 1, sizeof(EdgeNodeInfo));
     VERIFY_NON_NULL_MSG(clone, "EdgeCalloc FAILED for clone in cloneEdgeNodeInfo\n", NULL);
 
     if (nodeInfo->methodName)
     {
-        clone->methodName = cloneString(nodeInfo->methodName);
+        clone->methodName = EdgeArenaCloneString(arena, nodeInfo->methodName);
         if (!clone->methodName)
         {
-            EdgeFree(clone);
+            EdgeArenaFree(arena, clone);
             return NULL;
         }
     }
 
     if (nodeInfo->nodeId)
     {
-        clone->nodeId = cloneEdgeNodeId(nodeInfo->nodeId);
+        clone->nodeId = cloneNodeIdInArena(arena, nodeInfo->nodeId);
         if (!clone->nodeId)
         {
-            EdgeFree(clone->methodName);
-            EdgeFree(clone);
+            EdgeArenaFree(arena, clone->methodName);
+            EdgeArenaFree(arena, clone);
             return NULL;
         }
     }
 
     if (nodeInfo->valueAlias)
     {
-        clone->valueAlias = cloneString(nodeInfo->valueAlias);
+        clone->valueAlias = EdgeArenaCloneString(arena, nodeInfo->valueAlias);
         if (!clone->valueAlias)
         {
-            freeEdgeNodeId(clone->nodeId);
-            EdgeFree(clone->methodName);
-            EdgeFree(clone);
+            if (IS_NULL(arena))
+            {
+                freeEdgeNodeId(clone->nodeId);
+            }
+            EdgeArenaFree(arena, clone->methodName);
+            EdgeArenaFree(arena, clone);
             return NULL;
         }
     }
@@ -566,6 +689,11 @@ EdgeNodeInfo *cloneEdgeNodeInfo(EdgeNodeInfo *nodeInfo)
     return clone;
 }
 
+EdgeNodeInfo *cloneEdgeNodeInfo(EdgeNodeInfo *nodeInfo)
+{
+    return cloneEdgeNodeInfoInArena(NULL, nodeInfo);
+}
+
 EdgeNodeIdType getEdgeNodeIdType(char type)
 {
     EdgeNodeIdType edgeNodeType = EDGE_INTEGER;
@@ -580,3 +708,66 @@ EdgeNodeIdType getEdgeNodeIdType(char type)
     
     return edgeNodeType;
 }
+
+/* Each power of two above LATENCY_LINEAR_LIMIT is split into 2^LATENCY_SUB_BUCKET_BITS buckets. */
+#define LATENCY_SUB_BUCKET_BITS (2)
+#define LATENCY_LINEAR_LIMIT (1 << LATENCY_SUB_BUCKET_BITS)
+
+size_t getEdgeLatencyBucket(uint64_t durationUs)
+{
+    if (durationUs < LATENCY_LINEAR_LIMIT)
+    {
+        return (size_t) durationUs;
+    }
+
+    int msb = 63;
+    while (0 == (durationUs & ((uint64_t) 1 << msb)))
+    {
+        msb--;
+    }
+    size_t subBucket = (size_t) (durationUs >> (msb - LATENCY_SUB_BUCKET_BITS))
+            & (LATENCY_LINEAR_LIMIT - 1);
+    size_t bucket = ((size_t) (msb - LATENCY_SUB_BUCKET_BITS + 1) << LATENCY_SUB_BUCKET_BITS)
+            + subBucket;
+    return (bucket < EDGE_LATENCY_HISTOGRAM_BUCKETS) ? bucket : EDGE_LATENCY_HISTOGRAM_BUCKETS - 1;
+}
+
+uint64_t getEdgeLatencyBucketLowerBound(size_t bucket)
+{
+    if (bucket < LATENCY_LINEAR_LIMIT)
+    {
+        return bucket;
+    }
+
+    int shift = (int) (bucket >> LATENCY_SUB_BUCKET_BITS) - 1;
+    uint64_t mantissa = LATENCY_LINEAR_LIMIT + (bucket & (LATENCY_LINEAR_LIMIT - 1));
+    return mantissa << shift;
+}
+
+void recordEdgeLatency(EdgeLatencyHistogram *histogram, uint64_t durationUs)
+{
+    VERIFY_NON_NULL_NR_MSG(histogram, "NULL param histogram in recordEdgeLatency\n");
+    histogram->count++;
+    histogram->totalUs += durationUs;
+    if (durationUs > histogram->maxUs)
+    {
+        histogram->maxUs = durationUs;
+    }
+    histogram->buckets[getEdgeLatencyBucket(durationUs)]++;
+}
+
+void mergeEdgeLatency(EdgeLatencyHistogram *target, const EdgeLatencyHistogram *source)
+{
+    VERIFY_NON_NULL_NR_MSG(target, "NULL param target in mergeEdgeLatency\n");
+    VERIFY_NON_NULL_NR_MSG(source, "NULL param source in mergeEdgeLatency\n");
+    target->count += source->count;
+    target->totalUs += source->totalUs;
+    if (source->maxUs > target->maxUs)
+    {
+        target->maxUs = source->maxUs;
+    }
+    for (size_t i = 0; i < EDGE_LATENCY_HISTOGRAM_BUCKETS; i++)
+    {
+        target->buckets[i] += source->buckets[i];
+    }
+}
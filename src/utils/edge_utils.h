@@ -27,6 +27,7 @@
 #define EDGE_UTILS_H_
 
 #include "edge_logger.h"
+#include "edge_arena.h"
 #include "opcua_common.h"
 
 #ifdef __cplusplus
@@ -75,6 +76,31 @@ void logCurrentTimeStamp();
  */
 char *cloneString(const char *str);
 
+/**
+ * @brief Computes the FNV-1a hash of the given data.
+ * @param[in]  data Data to be hashed.
+ * @param[in]  length Length of the data in bytes.
+ * @return 32-bit hash value.
+ */
+uint32_t hashData(const void *data, size_t length);
+
+/**
+ * @brief Finds the address part (host:port) of an endpoint URI without copying it.
+ * @param[in]  endpointUri Endpoint URI. Ex: opc.tcp://localhost:12686/edge-opc-server
+ * @param[out]  length Length of the address in bytes.
+ * @return Pointer to the address inside endpointUri. NULL if a parameter is NULL.
+ */
+const char *getEndpointAddress(const char *endpointUri, size_t *length);
+
+/**
+ * @brief Computes the hash of the address part (host:port) of an endpoint URI.
+ * @remarks URIs which differ only in scheme or path get the same hash,
+ * so that they map to the same client session.
+ * @param[in]  endpointUri Endpoint URI. Ex: opc.tcp://localhost:12686/edge-opc-server
+ * @return 32-bit hash value. 0 if endpointUri is NULL.
+ */
+uint32_t hashEndpointAddress(const char *endpointUri);
+
 /**
  * @brief Clones data of a specified length.
  * @remarks Allocated memory should be freed by the caller.
@@ -213,6 +239,16 @@ void freeEdgeResponses(EdgeResponse **responses, int responseLength);
  */
 void freeEdgeMessage(EdgeMessage *msg);
 
+/**
+ * @brief Moves EdgeMessage to a new allocation, along with the ownership of all its members.
+ * @remarks msg is left zeroed, so freeEdgeMessage() on it frees the structure only.
+ *          A message in an arena can not be moved, because the arena holds the structure.
+ * @param[in]  msg Pointer to EdgeMessage which needs to be moved.
+ * @return Pointer to the moved EdgeMessage, NULL if msg is in an arena or memory
+ *         allocation failed. msg is unchanged then.
+ */
+EdgeMessage *moveEdgeMessage(EdgeMessage *msg);
+
 /**
  * @brief De-allocates the memory consumed by EdgeDevice and its members.
  * @remarks Both EdgeDevice and its members should have been allocated dynamically.
@@ -252,6 +288,14 @@ EdgeApplicationConfig *cloneEdgeApplicationConfig(EdgeApplicationConfig *config)
  */
 EdgeEndPointInfo *cloneEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo);
 
+/**
+ * @brief Clones EdgeEndPointInfo object into an arena.
+ * @param[in]  arena Arena holding the clone, NULL for the heap.
+ * @param[in]  endpointInfo EdgeEndPointInfo object to be cloned.
+ * @return Cloned EdgeEndPointInfo object on success. Otherwise null.
+ */
+EdgeEndPointInfo *cloneEdgeEndpointInfoInArena(EdgeArena *arena, EdgeEndPointInfo *endpointInfo);
+
 /**
  * @brief Creates an EdgeResult object with the given status code.
  * @remarks Allocated memory should be freed by the caller.
@@ -276,6 +320,14 @@ EdgeNodeId *cloneEdgeNodeId(EdgeNodeId *nodeId);
  */
 EdgeNodeInfo *cloneEdgeNodeInfo(EdgeNodeInfo *nodeInfo);
 
+/**
+ * @brief Clones EdgeNodeInfo object into an arena.
+ * @param[in]  arena Arena holding the clone, NULL for the heap.
+ * @param[in]  nodeInfo EdgeNodeInfo object to be cloned.
+ * @return Cloned EdgeNodeInfo object on success. Otherwise null.
+ */
+EdgeNodeInfo *cloneEdgeNodeInfoInArena(EdgeArena *arena, EdgeNodeInfo *nodeInfo);
+
 /**
  * @brief To get the enum equivalent for the given node type.
  * @param[in]  type Type of node id.
@@ -283,6 +335,35 @@ EdgeNodeInfo *cloneEdgeNodeInfo(EdgeNodeInfo *nodeInfo);
  */
 EdgeNodeIdType getEdgeNodeIdType(char type);
 
+/**
+ * @brief Adds a duration to a latency histogram.
+ * @remarks Not thread safe. Callers serialize the updates of one histogram.
+ * @param[in]  histogram Histogram to update.
+ * @param[in]  durationUs Duration in microseconds.
+ */
+void recordEdgeLatency(EdgeLatencyHistogram *histogram, uint64_t durationUs);
+
+/**
+ * @brief Adds all the durations of a latency histogram to another one.
+ * @param[in]  target Histogram to update.
+ * @param[in]  source Histogram to add.
+ */
+void mergeEdgeLatency(EdgeLatencyHistogram *target, const EdgeLatencyHistogram *source);
+
+/**
+ * @brief To get the bucket of a latency histogram which counts the given duration.
+ * @param[in]  durationUs Duration in microseconds.
+ * @return Index of the bucket.
+ */
+size_t getEdgeLatencyBucket(uint64_t durationUs);
+
+/**
+ * @brief To get the shortest duration counted by a bucket of a latency histogram.
+ * @param[in]  bucket Index of the bucket.
+ * @return Duration in microseconds.
+ */
+uint64_t getEdgeLatencyBucketLowerBound(size_t bucket);
+
 #ifdef __cplusplus
 }
 #endif
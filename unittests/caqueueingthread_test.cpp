@@ -0,0 +1,276 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include "caqueueingthread.h"
+#include "cathreadpool.h"
+#include "octhread.h"
+
+#define MAX_RECORDED 32
+
+static int g_processed[MAX_RECORDED];
+static volatile int g_processedCount = 0;
+
+static void recordTask(void *data)
+{
+    if (g_processedCount < MAX_RECORDED)
+    {
+        g_processed[g_processedCount] = *(int *) data;
+    }
+    g_processedCount++;
+}
+
+static void noDestroy(void *data, uint32_t size)
+{
+    (void) data;
+    (void) size;
+}
+
+class CAQueueingThreadF : public testing::Test {
+public:
+    CAQueueingThreadF() :
+      testing::Test(),
+      pool(NULL)
+  {
+  }
+
+protected:
+    virtual void SetUp()
+    {
+        g_processedCount = 0;
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &pool));
+    }
+
+    virtual void TearDown()
+    {
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadStop(&thread));
+        ca_thread_pool_free(pool);
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadDestroy(&thread));
+    }
+
+    void waitProcessed(int count)
+    {
+        for (int retry = 0; retry < 100 && g_processedCount < count; retry++)
+        {
+            usleep(10 * 1000);
+        }
+    }
+
+    ca_thread_pool_t pool;
+    CAQueueingThread_t thread;
+};
+
+TEST(CAQueueingThread, InvalidLanes)
+{
+    ca_thread_pool_t pool;
+    ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &pool));
+
+    CAQueueingThread_t thread;
+    uint32_t weights[CA_QUEUE_MAX_LANES + 1] = { 1, 1, 1, 1, 1 };
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingThreadInitializeLanes(&thread, pool, recordTask,
+            noDestroy, 8, CA_QUEUE_OVERFLOW_REJECT, 0, weights));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingThreadInitializeLanes(&thread, pool, recordTask,
+            noDestroy, 8, CA_QUEUE_OVERFLOW_REJECT, CA_QUEUE_MAX_LANES + 1, weights));
+
+    ca_thread_pool_free(pool);
+}
+
+TEST_F(CAQueueingThreadF, LaneOutOfRange)
+{
+    const uint32_t weights[2] = { 1, 1 };
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitializeLanes(&thread, pool, recordTask,
+            noDestroy, 8, CA_QUEUE_OVERFLOW_REJECT, 2, weights));
+
+    int value = 0;
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingThreadAddDataToLane(&thread, 2, &value,
+            sizeof(value)));
+}
+
+TEST_F(CAQueueingThreadF, LaneFull)
+{
+    const uint32_t weights[2] = { 1, 1 };
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitializeLanes(&thread, pool, recordTask,
+            noDestroy, 2, CA_QUEUE_OVERFLOW_REJECT, 2, weights));
+
+    // Each lane has its own capacity.
+    int value = 0;
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddDataToLane(&thread, 1, &value, sizeof(value)));
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddDataToLane(&thread, 1, &value, sizeof(value)));
+    EXPECT_EQ(CA_STATUS_QUEUE_FULL, CAQueueingThreadAddDataToLane(&thread, 1, &value,
+            sizeof(value)));
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddDataToLane(&thread, 0, &value, sizeof(value)));
+    EXPECT_EQ(static_cast<uint32_t>(3), CAQueueingThreadGetSize(&thread));
+}
+
+TEST_F(CAQueueingThreadF, WeightedLanes)
+{
+    const uint32_t weights[2] = { 2, 1 };
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitializeLanes(&thread, pool, recordTask,
+            noDestroy, 8, CA_QUEUE_OVERFLOW_REJECT, 2, weights));
+
+    // Queued before the thread starts, so the whole order is decided by the lanes.
+    int low[4] = { 10, 11, 12, 13 };
+    int high[4] = { 0, 1, 2, 3 };
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddDataToLane(&thread, 1, &low[i], sizeof(int)));
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddDataToLane(&thread, 0, &high[i], sizeof(int)));
+    }
+
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadStart(&thread));
+    waitProcessed(8);
+    ASSERT_EQ(8, g_processedCount);
+
+    const int expected[8] = { 0, 1, 10, 2, 3, 11, 12, 13 };
+    for (int i = 0; i < 8; i++)
+    {
+        EXPECT_EQ(expected[i], g_processed[i]);
+    }
+}
+
+static int g_dropped[MAX_RECORDED];
+static int g_droppedCount = 0;
+
+static void recordDrop(void *data, uint32_t size)
+{
+    (void) size;
+    if (g_droppedCount < MAX_RECORDED)
+    {
+        g_dropped[g_droppedCount] = *(int *) data;
+    }
+    g_droppedCount++;
+}
+
+TEST_F(CAQueueingThreadF, DropFunction)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitializeBounded(&thread, pool, recordTask,
+            noDestroy, 2, CA_QUEUE_OVERFLOW_DROP_OLDEST));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadSetDropFunction(&thread, recordDrop));
+
+    // The oldest data goes to the drop function to make room.
+    g_droppedCount = 0;
+    int values[3] = { 0, 1, 2 };
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&thread, &values[i], sizeof(int)));
+    }
+    ASSERT_EQ(1, g_droppedCount);
+    EXPECT_EQ(0, g_dropped[0]);
+    EXPECT_EQ(static_cast<uint32_t>(1), thread.droppedCount);
+
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadStart(&thread));
+    waitProcessed(2);
+    ASSERT_EQ(2, g_processedCount);
+    EXPECT_EQ(1, g_processed[0]);
+    EXPECT_EQ(2, g_processed[1]);
+
+    EXPECT_EQ(CA_STATUS_FAILED, CAQueueingThreadSetDropFunction(&thread, NULL));
+}
+
+static volatile int g_idleCalls = 0;
+static uint64_t g_idleDeadline = 0;
+
+static uint64_t idleTask(void *context)
+{
+    (void) context;
+    g_idleCalls++;
+    if (0 == g_idleDeadline)
+    {
+        return 0;
+    }
+
+    uint64_t now = oc_get_monotonic_time_us();
+    if (now >= g_idleDeadline)
+    {
+        g_idleDeadline = 0;
+        return 0;
+    }
+    return g_idleDeadline - now;
+}
+
+TEST_F(CAQueueingThreadF, IdleTask)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitialize(&thread, pool, recordTask, noDestroy));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadSetIdleTask(&thread, idleTask, NULL));
+
+    g_idleCalls = 0;
+    g_idleDeadline = oc_get_monotonic_time_us() + 20 * 1000;
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadStart(&thread));
+
+    // The thread wakes up by itself when the time asked by the idle task has passed.
+    for (int retry = 0; retry < 100 && 0 != g_idleDeadline; retry++)
+    {
+        usleep(10 * 1000);
+    }
+    EXPECT_EQ(static_cast<uint64_t>(0), g_idleDeadline);
+    EXPECT_GE(g_idleCalls, 2);
+
+    EXPECT_EQ(CA_STATUS_FAILED, CAQueueingThreadSetIdleTask(&thread, NULL, NULL));
+}
+
+static volatile int g_statsCalls = 0;
+static volatile uint64_t g_statsServiceUs = 0;
+
+static void sleepTask(void *data)
+{
+    (void) data;
+    usleep(5 * 1000);
+}
+
+static void statsTask(void *data, uint64_t waitUs, uint64_t serviceUs, void *context)
+{
+    (void) data;
+    (void) waitUs;
+    (void) context;
+    g_statsServiceUs = serviceUs;
+    g_statsCalls++;
+}
+
+TEST_F(CAQueueingThreadF, StatsTask)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitialize(&thread, pool, sleepTask, noDestroy));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadSetStatsTask(&thread, statsTask, NULL));
+
+    // Queued before the thread runs, so all of them are in the queue at once.
+    int values[3] = { 0, 1, 2 };
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&thread, &values[i], sizeof(int)));
+    }
+    EXPECT_EQ(static_cast<uint32_t>(3), CAQueueingThreadGetHighWaterMark(&thread));
+
+    g_statsCalls = 0;
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadStart(&thread));
+    for (int retry = 0; retry < 100 && g_statsCalls < 3; retry++)
+    {
+        usleep(10 * 1000);
+    }
+    EXPECT_EQ(3, g_statsCalls);
+    EXPECT_GE(g_statsServiceUs, static_cast<uint64_t>(5 * 1000));
+    EXPECT_EQ(static_cast<uint32_t>(3), CAQueueingThreadGetHighWaterMark(&thread));
+
+    EXPECT_EQ(CA_STATUS_FAILED, CAQueueingThreadSetStatsTask(&thread, NULL, NULL));
+}
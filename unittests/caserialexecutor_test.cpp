@@ -0,0 +1,242 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "caserialexecutor.h"
+#include "ocatomic.h"
+
+#define MAX_RECORDED 32
+#define THREAD_COUNT 4
+#define RUNS_PER_THREAD 200
+
+static int g_processed[MAX_RECORDED];
+static int g_processedCount = 0;
+
+static volatile uint32_t g_running = 0;
+static volatile uint32_t g_overlaps = 0;
+static int g_total = 0;
+
+static void recordTask(void *data)
+{
+    if (g_processedCount < MAX_RECORDED)
+    {
+        g_processed[g_processedCount] = *(int *) data;
+    }
+    g_processedCount++;
+}
+
+static void countTask(void *data)
+{
+    (void) data;
+    if (OC_ATOMIC_FETCH_ADD(&g_running, 1) != 0)
+    {
+        OC_ATOMIC_FETCH_ADD(&g_overlaps, 1);
+    }
+    g_total++;
+    OC_ATOMIC_FETCH_SUB(&g_running, 1);
+}
+
+static void *runTasks(void *data)
+{
+    CASerialExecutor_t *executor = (CASerialExecutor_t *) data;
+    for (int i = 0; i < RUNS_PER_THREAD; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, CASerialExecutorRun(executor, countTask, NULL));
+    }
+    return NULL;
+}
+
+static void nestedTask(void *data)
+{
+    static int value = 2;
+    recordTask(&value);
+    EXPECT_EQ(CA_STATUS_OK, CASerialExecutorRun((CASerialExecutor_t *) data, recordTask, &value));
+}
+
+static volatile uint32_t g_blockStarted = 0;
+static volatile uint32_t g_blockReleased = 0;
+static volatile uint32_t g_runReturned = 0;
+static CAResult_t g_runResult = CA_STATUS_OK;
+
+// Keeps the executor busy until g_blockReleased is set.
+static void blockTask(void *data)
+{
+    (void) data;
+    OC_ATOMIC_FETCH_ADD(&g_blockStarted, 1);
+    while (0 == OC_ATOMIC_LOAD(&g_blockReleased))
+    {
+        usleep(1000);
+    }
+}
+
+static void *submitBlockTask(void *data)
+{
+    EXPECT_EQ(CA_STATUS_OK, CASerialExecutorSubmit((CASerialExecutor_t *) data, blockTask, NULL));
+    return NULL;
+}
+
+static void *runRecordTask(void *data)
+{
+    static int value = 1;
+    g_runResult = CASerialExecutorRun((CASerialExecutor_t *) data, recordTask, &value);
+    OC_ATOMIC_FETCH_ADD(&g_runReturned, 1);
+    return NULL;
+}
+
+static void *destroyExecutor(void *data)
+{
+    EXPECT_EQ(CA_STATUS_OK, CASerialExecutorDestroy((CASerialExecutor_t *) data));
+    return NULL;
+}
+
+// Waits up to a second for the condition.
+static bool waitFor(bool (*condition)(CASerialExecutor_t *), CASerialExecutor_t *executor)
+{
+    for (int i = 0; i < 1000; i++)
+    {
+        if (condition(executor))
+        {
+            return true;
+        }
+        usleep(1000);
+    }
+    return false;
+}
+
+static bool isBlockStarted(CASerialExecutor_t *executor)
+{
+    (void) executor;
+    return 0 != OC_ATOMIC_LOAD(&g_blockStarted);
+}
+
+static bool isRunReturned(CASerialExecutor_t *executor)
+{
+    (void) executor;
+    return 0 != OC_ATOMIC_LOAD(&g_runReturned);
+}
+
+static bool hasWaitingRun(CASerialExecutor_t *executor)
+{
+    oc_mutex_lock(executor->mutex);
+    bool waiting = (1 == executor->waiting);
+    oc_mutex_unlock(executor->mutex);
+    return waiting;
+}
+
+class CASerialExecutorF : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        g_processedCount = 0;
+        ASSERT_EQ(CA_STATUS_OK, CASerialExecutorInitialize(&executor));
+    }
+
+    virtual void TearDown()
+    {
+        EXPECT_EQ(CA_STATUS_OK, CASerialExecutorDestroy(&executor));
+    }
+
+    CASerialExecutor_t executor;
+};
+
+TEST_F(CASerialExecutorF, SubmitRunsWhenIdle)
+{
+    int values[3] = { 1, 2, 3 };
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, CASerialExecutorSubmit(&executor, recordTask, &values[i]));
+        EXPECT_EQ(i + 1, g_processedCount);
+    }
+    EXPECT_EQ(1, g_processed[0]);
+    EXPECT_EQ(3, g_processed[2]);
+}
+
+TEST_F(CASerialExecutorF, RunIsSerialized)
+{
+    pthread_t threads[THREAD_COUNT];
+    g_running = 0;
+    g_overlaps = 0;
+    g_total = 0;
+    for (int i = 0; i < THREAD_COUNT; i++)
+    {
+        ASSERT_EQ(0, pthread_create(&threads[i], NULL, runTasks, &executor));
+    }
+    for (int i = 0; i < THREAD_COUNT; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    EXPECT_EQ(0u, g_overlaps);
+    EXPECT_EQ(THREAD_COUNT * RUNS_PER_THREAD, g_total);
+}
+
+TEST_F(CASerialExecutorF, NestedRun)
+{
+    EXPECT_EQ(CA_STATUS_OK, CASerialExecutorRun(&executor, nestedTask, &executor));
+    EXPECT_EQ(2, g_processedCount);
+}
+
+TEST(CASerialExecutor, InvalidParam)
+{
+    CASerialExecutor_t executor;
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CASerialExecutorInitialize(NULL));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CASerialExecutorSubmit(NULL, recordTask, NULL));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CASerialExecutorRun(NULL, recordTask, NULL));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CASerialExecutorDestroy(NULL));
+
+    ASSERT_EQ(CA_STATUS_OK, CASerialExecutorInitialize(&executor));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CASerialExecutorSubmit(&executor, NULL, NULL));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CASerialExecutorRun(&executor, NULL, NULL));
+    EXPECT_EQ(CA_STATUS_OK, CASerialExecutorDestroy(&executor));
+}
+
+TEST(CASerialExecutor, DestroyDropsQueuedTasks)
+{
+    CASerialExecutor_t executor;
+    pthread_t submitter, runner, destroyer;
+    int value = 3;
+    g_processedCount = 0;
+    g_blockStarted = 0;
+    g_blockReleased = 0;
+    g_runReturned = 0;
+    ASSERT_EQ(CA_STATUS_OK, CASerialExecutorInitialize(&executor));
+
+    ASSERT_EQ(0, pthread_create(&submitter, NULL, submitBlockTask, &executor));
+    ASSERT_TRUE(waitFor(isBlockStarted, &executor));
+    ASSERT_EQ(0, pthread_create(&runner, NULL, runRecordTask, &executor));
+    ASSERT_TRUE(waitFor(hasWaitingRun, &executor));
+    // A queued task which nobody waits for.
+    ASSERT_EQ(CA_STATUS_OK, CASerialExecutorSubmit(&executor, recordTask, &value));
+    ASSERT_EQ(0, pthread_create(&destroyer, NULL, destroyExecutor, &executor));
+
+    // The waiting caller returns as soon as its task is dropped, and Destroy waits for the
+    // running task.
+    EXPECT_TRUE(waitFor(isRunReturned, &executor));
+    EXPECT_EQ(CA_STATUS_FAILED, g_runResult);
+    OC_ATOMIC_STORE(&g_blockReleased, 1);
+    pthread_join(submitter, NULL);
+    pthread_join(runner, NULL);
+    pthread_join(destroyer, NULL);
+    EXPECT_EQ(0, g_processedCount);
+    EXPECT_TRUE(NULL == executor.mutex);
+}
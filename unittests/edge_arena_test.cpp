@@ -0,0 +1,164 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include "edge_arena.h"
+#include "edge_malloc.h"
+
+TEST(EdgeArena, Alloc)
+{
+    EdgeArena *arena = EdgeArenaAcquire();
+    ASSERT_TRUE(arena != NULL);
+
+    EXPECT_TRUE(EdgeArenaAlloc(arena, 0) == NULL);
+
+    char *first = (char *) EdgeArenaAlloc(arena, 3);
+    char *second = (char *) EdgeArenaAlloc(arena, 40);
+    ASSERT_TRUE(first != NULL);
+    ASSERT_TRUE(second != NULL);
+    EXPECT_EQ(0u, ((uintptr_t) first) % 16);
+    EXPECT_EQ(0u, ((uintptr_t) second) % 16);
+    EXPECT_TRUE(second >= first + 3);
+    EXPECT_TRUE(EdgeArenaContains(arena, first));
+    EXPECT_TRUE(EdgeArenaContains(arena, second + 39));
+
+    int onStack = 0;
+    EXPECT_FALSE(EdgeArenaContains(arena, &onStack));
+    EXPECT_FALSE(EdgeArenaContains(NULL, first));
+
+    EdgeArenaRelease(arena);
+}
+
+TEST(EdgeArena, Grow)
+{
+    EdgeArena *arena = EdgeArenaAcquire();
+    ASSERT_TRUE(arena != NULL);
+
+    // Larger than the first slab.
+    char *big = (char *) EdgeArenaAlloc(arena, 3 * EDGE_ARENA_SLAB_SIZE);
+    ASSERT_TRUE(big != NULL);
+    memset(big, 0xAB, 3 * EDGE_ARENA_SLAB_SIZE);
+    EXPECT_TRUE(EdgeArenaContains(arena, big + 3 * EDGE_ARENA_SLAB_SIZE - 1));
+
+    for (int i = 0; i < 1000; i++)
+    {
+        ASSERT_TRUE(EdgeArenaAlloc(arena, 100) != NULL);
+    }
+
+    EdgeArenaRelease(arena);
+}
+
+TEST(EdgeArena, Realloc)
+{
+    EdgeArena *arena = EdgeArenaAcquire();
+    ASSERT_TRUE(arena != NULL);
+
+    char *ptr = (char *) EdgeArenaAlloc(arena, 8);
+    ASSERT_TRUE(ptr != NULL);
+    strcpy(ptr, "arena");
+
+    EXPECT_EQ(ptr, EdgeArenaRealloc(arena, ptr, 4));
+
+    char *resized = (char *) EdgeArenaRealloc(arena, ptr, 64);
+    ASSERT_TRUE(resized != NULL);
+    EXPECT_STREQ("arena", resized);
+
+    EdgeArenaRelease(arena);
+}
+
+TEST(EdgeArena, Calloc)
+{
+    EdgeArena *arena = EdgeArenaAcquire();
+    ASSERT_TRUE(arena != NULL);
+
+    // Reuses a dirty slab, so the zeroing is visible.
+    memset(EdgeArenaAlloc(arena, 64), 0xAB, 64);
+    EdgeArenaRelease(arena);
+    arena = EdgeArenaAcquire();
+    ASSERT_TRUE(arena != NULL);
+
+    int *zeroed = (int *) EdgeArenaCalloc(arena, 8, sizeof(int));
+    ASSERT_TRUE(zeroed != NULL);
+    EXPECT_TRUE(EdgeArenaContains(arena, zeroed));
+    for (int i = 0; i < 8; i++)
+    {
+        EXPECT_EQ(0, zeroed[i]);
+    }
+    EXPECT_TRUE(EdgeArenaCalloc(arena, SIZE_MAX, 2) == NULL);
+
+    char *str = EdgeArenaCloneString(arena, "arena");
+    ASSERT_TRUE(str != NULL);
+    EXPECT_TRUE(EdgeArenaContains(arena, str));
+    EXPECT_STREQ("arena", str);
+    EXPECT_TRUE(EdgeArenaCloneString(arena, NULL) == NULL);
+
+    // Arena memory is left alone.
+    EdgeArenaFree(arena, str);
+
+    EdgeArenaRelease(arena);
+}
+
+TEST(EdgeArena, Heap)
+{
+    EdgeArena *arena = EdgeArenaAcquire();
+    ASSERT_TRUE(arena != NULL);
+
+    // Without an arena the builders use the heap.
+    char *ptr = (char *) EdgeArenaAlloc(NULL, 4);
+    ASSERT_TRUE(ptr != NULL);
+    EXPECT_FALSE(EdgeArenaContains(arena, ptr));
+    strcpy(ptr, "abc");
+    ptr = (char *) EdgeArenaRealloc(NULL, ptr, 128);
+    ASSERT_TRUE(ptr != NULL);
+    EXPECT_STREQ("abc", ptr);
+    EdgeArenaFree(NULL, ptr);
+
+    int *zeroed = (int *) EdgeArenaCalloc(NULL, 8, sizeof(int));
+    ASSERT_TRUE(zeroed != NULL);
+    EXPECT_EQ(0, zeroed[7]);
+    EdgeArenaFree(NULL, zeroed);
+
+    char *str = EdgeArenaCloneString(NULL, "heap");
+    ASSERT_TRUE(str != NULL);
+    EXPECT_STREQ("heap", str);
+    EdgeArenaFree(NULL, str);
+
+    EdgeArenaRelease(arena);
+}
+
+TEST(EdgeArena, Pool)
+{
+    EdgeArena *arena = EdgeArenaAcquire();
+    ASSERT_TRUE(arena != NULL);
+    ASSERT_TRUE(EdgeArenaAlloc(arena, 100) != NULL);
+    EdgeArenaRelease(arena);
+
+    // The released arena is reused, empty.
+    EdgeArena *reused = EdgeArenaAcquire();
+    EXPECT_EQ(arena, reused);
+    void *ptr = EdgeArenaAlloc(reused, 100);
+    EXPECT_TRUE(EdgeArenaContains(reused, ptr));
+    EXPECT_FALSE(EdgeArenaContains(reused, (char *) ptr + 200));
+
+    EdgeArenaRelease(NULL);
+    EdgeArenaRelease(reused);
+}
@@ -0,0 +1,101 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+#include "edge_flat_results.h"
+#include "edge_malloc.h"
+
+TEST(EdgeFlatResults, FixedValuesAndStrings)
+{
+    double doubles[3] = {1.5, 2.5, 3.5};
+    int32_t scalar = -7;
+    EdgeFlatResultsBuilder builder;
+    memset(&builder, 0, sizeof(builder));
+    builder.count = 4;
+    sizeEdgeFlatValue(&builder, sizeof(double), 3);
+    sizeEdgeFlatValue(&builder, sizeof(int32_t), 1);
+    sizeEdgeFlatString(&builder, 5);
+    sizeEdgeFlatString(&builder, 0);
+    sizeEdgeFlatString(&builder, 3);
+    EXPECT_EQ(32u, builder.dataSize);
+    EXPECT_EQ(12u + 8u + 8u, builder.stringsSize);
+
+    EdgeFlatResults *results = createEdgeFlatResults(&builder);
+    ASSERT_TRUE(NULL != results);
+    EXPECT_EQ(4u, results->count);
+
+    void *data = appendEdgeFlatValue(&builder, 0, sizeof(double), 3);
+    ASSERT_TRUE(NULL != data);
+    memcpy(data, doubles, sizeof(doubles));
+    data = appendEdgeFlatValue(&builder, 1, sizeof(int32_t), 1);
+    ASSERT_TRUE(NULL != data);
+    memcpy(data, &scalar, sizeof(scalar));
+    EXPECT_TRUE(appendEdgeFlatString(&builder, 2, "hello", 5));
+    EXPECT_TRUE(appendEdgeFlatString(&builder, 3, "", 0));
+    EXPECT_TRUE(appendEdgeFlatString(&builder, 3, "a\0b", 3));
+    // Nothing is left of the sizes of the first pass.
+    EXPECT_TRUE(NULL == appendEdgeFlatValue(&builder, 1, sizeof(int32_t), 1));
+    EXPECT_FALSE(appendEdgeFlatString(&builder, 2, "x", 1));
+    EXPECT_EQ(builder.dataSize, results->dataSize);
+    EXPECT_EQ(builder.stringsSize, results->stringsSize);
+
+    const double *values = (const double *) getEdgeFlatValue(results, 0);
+    ASSERT_TRUE(NULL != values);
+    EXPECT_EQ(3u, results->values[0].elementCount);
+    EXPECT_DOUBLE_EQ(3.5, values[2]);
+    EXPECT_EQ(-7, *(const int32_t *) getEdgeFlatValue(results, 1));
+    EXPECT_TRUE(NULL == getEdgeFlatValue(results, 2));
+
+    size_t length = 0;
+    EXPECT_STREQ("hello", getEdgeFlatString(results, 2, &length));
+    EXPECT_EQ(5u, length);
+    EXPECT_TRUE(NULL == getEdgeFlatString(results, 0, &length));
+
+    EXPECT_EQ(2u, results->values[3].elementCount);
+    const char *str = getEdgeFlatString(results, 3, &length);
+    ASSERT_TRUE(NULL != str);
+    EXPECT_EQ(0u, length);
+    str = getNextEdgeFlatString(str, &length);
+    EXPECT_EQ(3u, length);
+    EXPECT_EQ(0, memcmp("a\0b", str, 4));
+
+    EdgeFree(results);
+}
+
+TEST(EdgeFlatResults, NodeNotRead)
+{
+    EdgeFlatResultsBuilder builder;
+    memset(&builder, 0, sizeof(builder));
+    builder.count = 1;
+    EdgeFlatResults *results = createEdgeFlatResults(&builder);
+    ASSERT_TRUE(NULL != results);
+    results->values[0].status = 0x80340000;
+
+    size_t length = 0;
+    EXPECT_TRUE(NULL == getEdgeFlatValue(results, 0));
+    EXPECT_TRUE(NULL == getEdgeFlatString(results, 0, &length));
+    EXPECT_TRUE(NULL == getEdgeFlatValue(results, 1));
+    EXPECT_TRUE(NULL == getEdgeFlatValue(NULL, 0));
+    EdgeFree(results);
+}
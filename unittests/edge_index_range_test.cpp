@@ -0,0 +1,73 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include "edge_index_range.h"
+
+TEST(EdgeIndexRange, Parse)
+{
+    uint32_t first = 0;
+    uint32_t last = 0;
+    EXPECT_TRUE(parseEdgeIndexRange("65024:65535", &first, &last));
+    EXPECT_EQ(65024u, first);
+    EXPECT_EQ(65535u, last);
+
+    EXPECT_FALSE(parseEdgeIndexRange("5", &first, &last));
+    EXPECT_FALSE(parseEdgeIndexRange("5:5", &first, &last));
+    EXPECT_FALSE(parseEdgeIndexRange("6:5", &first, &last));
+    EXPECT_FALSE(parseEdgeIndexRange("1:2,3:4", &first, &last));
+    EXPECT_FALSE(parseEdgeIndexRange(":4", &first, &last));
+    EXPECT_FALSE(parseEdgeIndexRange("0:4294967296", &first, &last));
+    EXPECT_FALSE(parseEdgeIndexRange(NULL, &first, &last));
+}
+
+TEST(EdgeIndexRange, Format)
+{
+    char range[EDGE_INDEX_RANGE_SIZE];
+    EXPECT_TRUE(formatEdgeIndexRange(0, 4294967295u, range, sizeof(range)));
+    EXPECT_STREQ("0:4294967295", range);
+    EXPECT_TRUE(formatEdgeIndexRange(7, 7, range, sizeof(range)));
+    EXPECT_STREQ("7", range);
+    EXPECT_FALSE(formatEdgeIndexRange(8, 7, range, sizeof(range)));
+    EXPECT_FALSE(formatEdgeIndexRange(0, 7, range, 4));
+}
+
+TEST(EdgeIndexRange, FirstPage)
+{
+    char page[EDGE_INDEX_RANGE_SIZE];
+    EXPECT_STREQ("1000:1255", getEdgeIndexRangeFirstPage("1000:65535", page, sizeof(page)));
+
+    // Short and multi-dimensional ranges are read as they are.
+    const char *shortRange = "0:255";
+    EXPECT_EQ(shortRange, getEdgeIndexRangeFirstPage(shortRange, page, sizeof(page)));
+    const char *matrix = "0:999,1:2";
+    EXPECT_EQ(matrix, getEdgeIndexRangeFirstPage(matrix, page, sizeof(page)));
+}
+
+TEST(EdgeIndexRange, PageSize)
+{
+    // Without a message size limit, the rest is read at once.
+    EXPECT_EQ(60000u, getEdgeIndexRangePageSize(0, 8, 60000));
+    EXPECT_EQ(8064u, getEdgeIndexRangePageSize(65536, 8, 60000));
+    EXPECT_EQ(100u, getEdgeIndexRangePageSize(65536, 8, 100));
+    EXPECT_EQ((uint32_t) EDGE_INDEX_RANGE_FIRST_PAGE, getEdgeIndexRangePageSize(65536, 0, 60000));
+    EXPECT_EQ(1u, getEdgeIndexRangePageSize(512, 8, 60000));
+}
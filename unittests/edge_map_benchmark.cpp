@@ -0,0 +1,77 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <iostream>
+
+extern "C"
+{
+#include "edge_map.h"
+#include "edge_malloc.h"
+#include "edge_utils.h"
+#include "octhread.h"
+}
+
+// Times the lookups of a string map from 10 to 100k entries. It is no unit test and is built
+// as its own target, so that the test run is not slowed down by it.
+TEST(EdgeMapBenchmark, StringMapLookup)
+{
+    const int sizes[] = { 10, 100, 1000, 10000, 100000 };
+    const int lookups = 1000000;
+    char name[32];
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        edgeMap *map = createStringMap();
+        ASSERT_TRUE(map != NULL);
+        char **keys = (char **) EdgeCalloc(sizes[s], sizeof(char *));
+        ASSERT_TRUE(keys != NULL);
+        for (int i = 0; i < sizes[s]; i++)
+        {
+            snprintf(name, sizeof(name), "ns=2;s=Node%d", i);
+            keys[i] = cloneString(name);
+            ASSERT_TRUE(keys[i] != NULL);
+            ASSERT_TRUE(insertMapElement(map, (keyValue) keys[i], (keyValue) keys[i]));
+        }
+
+        int found = 0;
+        uint64_t start = oc_get_monotonic_time_us();
+        for (int i = 0; i < lookups; i++)
+        {
+            found += (getMapElement(map, (keyValue) keys[i % sizes[s]]) != NULL);
+        }
+        uint64_t elapsed = oc_get_monotonic_time_us() - start;
+        EXPECT_EQ(lookups, found);
+        std::cout << sizes[s] << " entries: " << (elapsed * 1000.0 / lookups) << " ns/lookup"
+                << std::endl;
+
+        deleteMap(map);
+        EdgeFree(map);
+        for (int i = 0; i < sizes[s]; i++)
+        {
+            EdgeFree(keys[i]);
+        }
+        EdgeFree(keys);
+    }
+}
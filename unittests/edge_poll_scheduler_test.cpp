@@ -0,0 +1,232 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include "edge_poll_scheduler.h"
+#include "ocatomic.h"
+
+static volatile uint32_t g_cycles = 0;
+static volatile uint32_t g_merged = 0;
+static volatile uint32_t g_freed = 0;
+static bool g_cycleStarts = true;
+static int g_mergedContexts[8];
+static void *volatile g_cycleContext = NULL;
+static uint32_t g_cyclePollIds[4];
+static volatile size_t g_cyclePollCount = 0;
+static volatile uint32_t g_dispatched = 0;
+static volatile bool g_dispatchedUnlocked = false;
+
+static bool countCycle(const uint32_t *pollIds, size_t pollCount, void *context, void **job)
+{
+    for (size_t i = 0; i < pollCount && i < 4; i++)
+    {
+        g_cyclePollIds[i] = pollIds[i];
+    }
+    g_cyclePollCount = pollCount;
+    g_cycleContext = context;
+    OC_ATOMIC_FETCH_ADD(&g_cycles, 1);
+    *job = g_cycleStarts ? context : NULL;
+    return g_cycleStarts;
+}
+
+static void dispatchJob(void *job)
+{
+    (void) job;
+    // Takes the lock of the scheduler, which would not return if it was held.
+    EdgePollStatistics stats;
+    getEdgePollStatistics(g_cyclePollIds[0], &stats);
+    g_dispatchedUnlocked = true;
+    OC_ATOMIC_FETCH_ADD(&g_dispatched, 1);
+}
+
+static void *mergeContext(void *context, void *added)
+{
+    (void) context;
+    (void) added;
+    uint32_t merged = OC_ATOMIC_FETCH_ADD(&g_merged, 1);
+    return &g_mergedContexts[merged % 8];
+}
+
+// Waits up to a second for a cycle with the context.
+static bool waitForCycleContext(void *context)
+{
+    g_cycleContext = NULL;
+    for (int i = 0; i < 100 && g_cycleContext != context; i++)
+    {
+        usleep(10 * 1000);
+    }
+    return g_cycleContext == context;
+}
+
+static void countFree(void *context)
+{
+    (void) context;
+    OC_ATOMIC_FETCH_ADD(&g_freed, 1);
+}
+
+class EdgePollSchedulerF : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        g_cycles = 0;
+        g_merged = 0;
+        g_freed = 0;
+        g_cycleStarts = true;
+        g_cyclePollCount = 0;
+        g_dispatched = 0;
+        g_dispatchedUnlocked = false;
+        registerEdgePollCallbacks(countCycle, dispatchJob, mergeContext, countFree);
+    }
+
+    virtual void TearDown()
+    {
+        removeAllEdgePolls();
+    }
+
+    int contexts[3];
+};
+
+TEST(EdgePollScheduler, NextDeadline)
+{
+    uint64_t missed = 1;
+    EXPECT_EQ(1000u, getNextEdgePollDeadline(1000, 100, 999, &missed));
+    EXPECT_EQ(0u, missed);
+    EXPECT_EQ(1100u, getNextEdgePollDeadline(1000, 100, 1000, &missed));
+    EXPECT_EQ(0u, missed);
+    // The deadlines stay on their grid when the thread wakes up late.
+    EXPECT_EQ(1400u, getNextEdgePollDeadline(1000, 100, 1350, &missed));
+    EXPECT_EQ(3u, missed);
+    EXPECT_EQ(1100u, getNextEdgePollDeadline(1000, 100, 1099, NULL));
+}
+
+TEST_F(EdgePollSchedulerF, CyclesOnInterval)
+{
+    uint32_t pollId = addEdgePoll("opc.tcp://localhost:4840", 20, &contexts[0]);
+    ASSERT_NE(0u, pollId);
+    usleep(210 * 1000);
+
+    EdgePollStatistics stats;
+    ASSERT_TRUE(getEdgePollStatistics(pollId, &stats));
+    EXPECT_EQ(20u, stats.intervalMs);
+    // Only a lower bound, as a loaded machine may run the cycles late and skip some.
+    EXPECT_GE(stats.cycles, 2u);
+    EXPECT_EQ(stats.cycles, OC_ATOMIC_LOAD(&g_cycles));
+
+    EXPECT_TRUE(removeEdgePoll(pollId));
+    EXPECT_EQ(1u, g_freed);
+    EXPECT_FALSE(removeEdgePoll(pollId));
+    EXPECT_FALSE(getEdgePollStatistics(pollId, &stats));
+}
+
+TEST_F(EdgePollSchedulerF, SameKeyAndIntervalMerged)
+{
+    uint32_t first = addEdgePoll("opc.tcp://localhost:4840", 1000, &contexts[0]);
+    uint32_t second = addEdgePoll("opc.tcp://localhost:4840", 1000, &contexts[1]);
+    uint32_t other = addEdgePoll("opc.tcp://localhost:4840", 500, &contexts[2]);
+    ASSERT_NE(0u, first);
+    ASSERT_NE(0u, second);
+    EXPECT_NE(first, second);
+    EXPECT_NE(first, other);
+    EXPECT_EQ(1u, g_merged);
+    EXPECT_EQ(0u, g_freed);
+
+    // The cycle is shared, so are its counters.
+    EdgePollStatistics firstStats;
+    EdgePollStatistics secondStats;
+    ASSERT_TRUE(getEdgePollStatistics(first, &firstStats));
+    ASSERT_TRUE(getEdgePollStatistics(second, &secondStats));
+    EXPECT_EQ(1000u, secondStats.intervalMs);
+
+    // Removing one poll frees its context and the merged one, the other keeps running.
+    EXPECT_TRUE(removeEdgePoll(first));
+    EXPECT_EQ(2u, g_freed);
+    EXPECT_FALSE(getEdgePollStatistics(first, &firstStats));
+    EXPECT_TRUE(getEdgePollStatistics(second, &secondStats));
+    EXPECT_FALSE(removeEdgePoll(first));
+
+    EXPECT_TRUE(removeEdgePoll(second));
+    EXPECT_TRUE(removeEdgePoll(other));
+    EXPECT_EQ(4u, g_freed);
+}
+
+TEST_F(EdgePollSchedulerF, SharedCycleRunsMergedContext)
+{
+    uint32_t first = addEdgePoll("opc.tcp://localhost:4840", 20, &contexts[0]);
+    uint32_t second = addEdgePoll("opc.tcp://localhost:4840", 20, &contexts[1]);
+    uint32_t third = addEdgePoll("opc.tcp://localhost:4840", 20, &contexts[2]);
+    ASSERT_NE(0u, third);
+    EXPECT_EQ(2u, g_merged);
+    // The merged context of the first two is replaced by that of all three.
+    EXPECT_EQ(1u, g_freed);
+    EXPECT_TRUE(waitForCycleContext(&g_mergedContexts[1]));
+    // The cycle serves every poll sharing it, in the order their contexts are merged.
+    ASSERT_EQ(3u, g_cyclePollCount);
+    EXPECT_EQ(first, g_cyclePollIds[0]);
+    EXPECT_EQ(second, g_cyclePollIds[1]);
+    EXPECT_EQ(third, g_cyclePollIds[2]);
+
+    // The contexts left are merged again, and one left runs with its own.
+    EXPECT_TRUE(removeEdgePoll(second));
+    EXPECT_EQ(3u, g_merged);
+    EXPECT_TRUE(removeEdgePoll(first));
+    EXPECT_EQ(3u, g_merged);
+    EXPECT_TRUE(waitForCycleContext(&contexts[2]));
+    EXPECT_EQ(1u, g_cyclePollCount);
+    EXPECT_EQ(third, g_cyclePollIds[0]);
+    EXPECT_TRUE(removeEdgePoll(third));
+    EXPECT_EQ(6u, g_freed);
+}
+
+TEST_F(EdgePollSchedulerF, JobDispatchedWithoutTheLock)
+{
+    uint32_t pollId = addEdgePoll("opc.tcp://localhost:4840", 20, &contexts[0]);
+    ASSERT_NE(0u, pollId);
+    for (int i = 0; i < 100 && 0 == OC_ATOMIC_LOAD(&g_dispatched); i++)
+    {
+        usleep(10 * 1000);
+    }
+    EXPECT_TRUE(g_dispatchedUnlocked);
+    EXPECT_TRUE(removeEdgePoll(pollId));
+}
+
+TEST_F(EdgePollSchedulerF, RunningCycleCountsAsOverrun)
+{
+    g_cycleStarts = false;
+    uint32_t pollId = addEdgePoll("opc.tcp://localhost:4840", 20, &contexts[0]);
+    ASSERT_NE(0u, pollId);
+    usleep(110 * 1000);
+
+    EdgePollStatistics stats;
+    ASSERT_TRUE(getEdgePollStatistics(pollId, &stats));
+    EXPECT_EQ(0u, stats.cycles);
+    EXPECT_GE(stats.overruns, 4u);
+}
+
+TEST_F(EdgePollSchedulerF, InvalidParam)
+{
+    EXPECT_EQ(0u, addEdgePoll(NULL, 20, &contexts[0]));
+    EXPECT_EQ(0u, addEdgePoll("opc.tcp://localhost:4840", 0, &contexts[0]));
+    EXPECT_EQ(0u, addEdgePoll("opc.tcp://localhost:4840", 20, NULL));
+    EXPECT_FALSE(getEdgePollStatistics(1, NULL));
+    EXPECT_FALSE(removeEdgePoll(0));
+}
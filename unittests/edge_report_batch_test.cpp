@@ -0,0 +1,189 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <vector>
+
+extern "C"
+{
+#include "opcua_manager.h"
+#include "edge_report_batch.h"
+#include "message_dispatcher.h"
+#include "edge_utils.h"
+#include "edge_malloc.h"
+}
+
+#define TEST_ENDPOINT "opc.tcp://localhost:12686/edge-opc-server"
+
+// A REPORT received, with the value of each notification.
+struct ReceivedReport
+{
+    EdgeMessageType type;
+    uint32_t messageId;
+    std::vector<int32_t> values;
+};
+
+static pthread_mutex_t g_receivedMutex = PTHREAD_MUTEX_INITIALIZER;
+static std::vector<ReceivedReport> g_received;
+
+static void recordReport(EdgeMessage *msg)
+{
+    ReceivedReport received;
+    received.type = msg->type;
+    received.messageId = msg->message_id;
+    for (size_t i = 0; i < msg->responseLength; i++)
+    {
+        received.values.push_back(*(int32_t *) msg->responses[i]->message->value);
+    }
+    pthread_mutex_lock(&g_receivedMutex);
+    g_received.push_back(received);
+    pthread_mutex_unlock(&g_receivedMutex);
+}
+
+static size_t getReceivedCount()
+{
+    pthread_mutex_lock(&g_receivedMutex);
+    size_t received = g_received.size();
+    pthread_mutex_unlock(&g_receivedMutex);
+    return received;
+}
+
+// Waits up to a second for the reports, then a little longer for any report too many.
+static bool waitForReports(size_t count)
+{
+    for (int i = 0; i < 100 && getReceivedCount() < count; i++)
+    {
+        usleep(10 * 1000);
+    }
+    usleep(20 * 1000);
+    return getReceivedCount() == count;
+}
+
+// A subscription request of the given message id.
+static EdgeMessage *createSubMessage(uint32_t messageId)
+{
+    EdgeMessage *msg = createEdgeAttributeMessage(TEST_ENDPOINT, 2, CMD_READ);
+    msg->message_id = messageId;
+    return msg;
+}
+
+class EdgeReportBatchF : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        g_received.clear();
+        batches = NULL;
+        registerMQCallback(recordReport, onSendMessage);
+        init_queue();
+    }
+
+    virtual void TearDown()
+    {
+        flushReportBatches(&batches);
+        delete_queue();
+        registerMQCallback(onResponseMessage, onSendMessage);
+    }
+
+    // Adds a notification of the Int32 value.
+    void notify(const EdgeMessage *request, int32_t value, size_t maxSize)
+    {
+        UA_DataValue dataValue;
+        UA_DataValue_init(&dataValue);
+        UA_Variant_setScalarCopy(&dataValue.value, &value, &UA_TYPES[UA_TYPES_INT32]);
+        dataValue.hasValue = true;
+        addToReportBatch(&batches, request, "alias", &dataValue, maxSize);
+        UA_DataValue_deleteMembers(&dataValue);
+    }
+
+    static void expectReport(const ReceivedReport &report, uint32_t messageId, int32_t first,
+            size_t count)
+    {
+        EXPECT_EQ(REPORT, report.type);
+        EXPECT_EQ(messageId, report.messageId);
+        ASSERT_EQ(count, report.values.size());
+        for (size_t i = 0; i < count; i++)
+        {
+            EXPECT_EQ(first + (int32_t) i, report.values[i]);
+        }
+    }
+
+    EdgeReportBatch *batches;
+};
+
+TEST_F(EdgeReportBatchF, FullBatchIsDeliveredAtOnce)
+{
+    EdgeMessage *request = createSubMessage(7);
+    for (int32_t value = 1; value <= 7; value++)
+    {
+        notify(request, value, 3);
+    }
+
+    // Two full batches are delivered during the publish cycle, the rest at its end.
+    ASSERT_TRUE(waitForReports(2));
+    EXPECT_TRUE(batches != NULL);
+    flushReportBatches(&batches);
+    EXPECT_TRUE(batches == NULL);
+    ASSERT_TRUE(waitForReports(3));
+    expectReport(g_received[0], 7, 1, 3);
+    expectReport(g_received[1], 7, 4, 3);
+    expectReport(g_received[2], 7, 7, 1);
+    destroyEdgeMessage(request);
+}
+
+TEST_F(EdgeReportBatchF, BatchIsDeliveredAtTheEndOfThePublishCycle)
+{
+    EdgeMessage *request = createSubMessage(8);
+    notify(request, 1, 100);
+    notify(request, 2, 100);
+
+    ASSERT_TRUE(waitForReports(0));
+    flushReportBatches(&batches);
+    ASSERT_TRUE(waitForReports(1));
+    expectReport(g_received[0], 8, 1, 2);
+
+    // The next publish cycle starts with no batch.
+    flushReportBatches(&batches);
+    EXPECT_TRUE(waitForReports(1));
+    destroyEdgeMessage(request);
+}
+
+TEST_F(EdgeReportBatchF, EachSubscriptionRequestHasItsOwnBatch)
+{
+    EdgeMessage *first = createSubMessage(11);
+    EdgeMessage *second = createSubMessage(12);
+    notify(second, 1, 100);
+    notify(first, 10, 100);
+    notify(second, 2, 100);
+    notify(first, 11, 100);
+    notify(second, 3, 100);
+
+    // The batches are delivered in the order of their first notification.
+    flushReportBatches(&batches);
+    ASSERT_TRUE(waitForReports(2));
+    expectReport(g_received[0], 12, 1, 3);
+    expectReport(g_received[1], 11, 10, 2);
+    destroyEdgeMessage(first);
+    destroyEdgeMessage(second);
+}
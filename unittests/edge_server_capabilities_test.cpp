@@ -0,0 +1,69 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include "edge_server_capabilities.h"
+
+TEST(EdgeServerCapabilities, NotCached)
+{
+    int client;
+    EdgeServerCapabilities capabilities;
+    EXPECT_FALSE(getServerCapabilities((UA_Client *) &client, &capabilities));
+
+    // Without limits, but the one continuation point every server has.
+    EXPECT_EQ(0u, capabilities.maxNodesPerRead);
+    EXPECT_EQ(0u, capabilities.maxNodesPerWrite);
+    EXPECT_EQ(0u, capabilities.maxNodesPerBrowse);
+    EXPECT_EQ(1u, capabilities.maxBrowseContinuationPoints);
+
+    removeServerCapabilities((UA_Client *) &client);
+    EXPECT_FALSE(getServerCapabilities(NULL, &capabilities));
+    EXPECT_FALSE(getServerCapabilities((UA_Client *) &client, NULL));
+    EXPECT_FALSE(loadServerCapabilities(NULL));
+}
+
+TEST(EdgeServerCapabilities, Set)
+{
+    int client;
+    EdgeServerCapabilities capabilities;
+    memset(&capabilities, 0, sizeof(capabilities));
+    capabilities.maxNodesPerRead = 100;
+    capabilities.maxNodesPerWrite = 10;
+    EXPECT_TRUE(setServerCapabilities((UA_Client *) &client, &capabilities));
+
+    EdgeServerCapabilities cached;
+    EXPECT_TRUE(getServerCapabilities((UA_Client *) &client, &cached));
+    EXPECT_EQ(100u, cached.maxNodesPerRead);
+    EXPECT_EQ(10u, cached.maxNodesPerWrite);
+
+    removeServerCapabilities((UA_Client *) &client);
+    EXPECT_FALSE(getServerCapabilities((UA_Client *) &client, &cached));
+    EXPECT_FALSE(setServerCapabilities(NULL, &capabilities));
+    EXPECT_FALSE(setServerCapabilities((UA_Client *) &client, NULL));
+}
+
+TEST(EdgeServerCapabilities, OperationChunkSize)
+{
+    EXPECT_EQ(20000u, getOperationChunkSize(0, 20000));
+    EXPECT_EQ(1000u, getOperationChunkSize(1000, 20000));
+    EXPECT_EQ(999u, getOperationChunkSize(1000, 999));
+    EXPECT_EQ(0u, getOperationChunkSize(1000, 0));
+}
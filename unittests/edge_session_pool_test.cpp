@@ -0,0 +1,198 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include "edge_session_pool.h"
+
+static int g_destroyedSessions = 0;
+
+static void destroySession(void *session)
+{
+    (void) session;
+    g_destroyedSessions++;
+}
+
+TEST(EdgeSessionPool, RoundRobin)
+{
+    EdgeSessionPool *pool = createEdgeSessionPool(3, EDGE_SESSION_POLICY_ROUND_ROBIN, false, NULL);
+    ASSERT_TRUE(pool != NULL);
+
+    EXPECT_EQ(0u, acquireEdgeSessionIndex(pool, EDGE_SESSION_REQUEST_ANY));
+    EXPECT_EQ(1u, acquireEdgeSessionIndex(pool, EDGE_SESSION_REQUEST_ANY));
+    EXPECT_EQ(2u, acquireEdgeSessionIndex(pool, EDGE_SESSION_REQUEST_ANY));
+    EXPECT_EQ(0u, acquireEdgeSessionIndex(pool, EDGE_SESSION_REQUEST_ANY));
+    EXPECT_EQ(2u, getEdgeSessionOutstanding(pool, 0));
+
+    releaseEdgeSessionIndex(pool, 0);
+    releaseEdgeSessionIndex(pool, 0);
+    // The count never drops below zero.
+    releaseEdgeSessionIndex(pool, 0);
+    EXPECT_EQ(0u, getEdgeSessionOutstanding(pool, 0));
+    releaseEdgeSessionPool(pool);
+}
+
+TEST(EdgeSessionPool, LeastOutstanding)
+{
+    EdgeSessionPool *pool = createEdgeSessionPool(3, EDGE_SESSION_POLICY_LEAST_OUTSTANDING,
+            false, NULL);
+    ASSERT_TRUE(pool != NULL);
+
+    uint32_t busy = acquireEdgeSessionIndex(pool, EDGE_SESSION_REQUEST_ANY);
+    for (int i = 0; i < 10; i++)
+    {
+        uint32_t index = acquireEdgeSessionIndex(pool, EDGE_SESSION_REQUEST_ANY);
+        releaseEdgeSessionIndex(pool, index);
+        EXPECT_NE(busy, index);
+    }
+    EXPECT_EQ(1u, getEdgeSessionOutstanding(pool, busy));
+    releaseEdgeSessionPool(pool);
+}
+
+TEST(EdgeSessionPool, DedicatedSubscriptionSession)
+{
+    EdgeSessionPool *pool = createEdgeSessionPool(3, EDGE_SESSION_POLICY_ROUND_ROBIN, true, NULL);
+    ASSERT_TRUE(pool != NULL);
+
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_NE(0u, acquireEdgeSessionIndex(pool, EDGE_SESSION_REQUEST_ANY));
+        EXPECT_EQ(0u, acquireEdgeSessionIndex(pool, EDGE_SESSION_REQUEST_SUBSCRIPTION));
+    }
+    releaseEdgeSessionPool(pool);
+
+    // A single session serves everything.
+    pool = createEdgeSessionPool(1, EDGE_SESSION_POLICY_ROUND_ROBIN, true, NULL);
+    ASSERT_TRUE(pool != NULL);
+    EXPECT_EQ(0u, acquireEdgeSessionIndex(pool, EDGE_SESSION_REQUEST_ANY));
+    EXPECT_EQ(0u, acquireEdgeSessionIndex(pool, EDGE_SESSION_REQUEST_SUBSCRIPTION));
+    releaseEdgeSessionPool(pool);
+}
+
+TEST(EdgeSessionPool, OrderedRequestsShareOneSession)
+{
+    EdgeSessionPool *pool = createEdgeSessionPool(3, EDGE_SESSION_POLICY_LEAST_OUTSTANDING,
+            false, NULL);
+    ASSERT_TRUE(pool != NULL);
+
+    // The ordered requests stay on their session however busy it is, the others move on.
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(0u, acquireEdgeSessionIndex(pool, EDGE_SESSION_REQUEST_ORDERED));
+    }
+    EXPECT_NE(0u, acquireEdgeSessionIndex(pool, EDGE_SESSION_REQUEST_ANY));
+    EXPECT_EQ(4u, getEdgeSessionOutstanding(pool, 0));
+    releaseEdgeSessionPool(pool);
+
+    // They do not take the session kept for the subscriptions.
+    pool = createEdgeSessionPool(3, EDGE_SESSION_POLICY_ROUND_ROBIN, true, NULL);
+    ASSERT_TRUE(pool != NULL);
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(1u, acquireEdgeSessionIndex(pool, EDGE_SESSION_REQUEST_ORDERED));
+    }
+    releaseEdgeSessionPool(pool);
+
+    pool = createEdgeSessionPool(1, EDGE_SESSION_POLICY_ROUND_ROBIN, true, NULL);
+    ASSERT_TRUE(pool != NULL);
+    EXPECT_EQ(0u, acquireEdgeSessionIndex(pool, EDGE_SESSION_REQUEST_ORDERED));
+    releaseEdgeSessionPool(pool);
+}
+
+TEST(EdgeSessionPool, Sessions)
+{
+    int sessions[2];
+    g_destroyedSessions = 0;
+    EdgeSessionPool *pool = createEdgeSessionPool(2, EDGE_SESSION_POLICY_ROUND_ROBIN, false,
+            destroySession);
+    ASSERT_TRUE(pool != NULL);
+    EXPECT_TRUE(setEdgeSessionPoolSession(pool, 0, &sessions[0]));
+    EXPECT_TRUE(setEdgeSessionPoolSession(pool, 1, &sessions[1]));
+    EXPECT_FALSE(setEdgeSessionPoolSession(pool, 2, &sessions[1]));
+
+    EXPECT_EQ(&sessions[1], getEdgeSessionPoolSession(pool, 1));
+    EXPECT_EQ(&sessions[0], getEdgeSessionPoolSession(pool, 5));
+    EXPECT_TRUE(containsEdgeSessionPoolSession(pool, &sessions[1]));
+    EXPECT_FALSE(containsEdgeSessionPoolSession(pool, &g_destroyedSessions));
+
+    // The sessions are destroyed with the last reference.
+    retainEdgeSessionPool(pool);
+    releaseEdgeSessionPool(pool);
+    EXPECT_EQ(0, g_destroyedSessions);
+    releaseEdgeSessionPool(pool);
+    EXPECT_EQ(2, g_destroyedSessions);
+}
+
+TEST(EdgeSessionPool, Reconnect)
+{
+    EdgeSessionPool *pool = createEdgeSessionPool(2, EDGE_SESSION_POLICY_ROUND_ROBIN, false, NULL);
+    ASSERT_TRUE(pool != NULL);
+
+    // Disabled unless set.
+    EXPECT_FALSE(beginEdgeSessionReconnect(pool, 0));
+
+    EdgeSessionReconnect reconnect = { true, 0, 0, 0 };
+    setEdgeSessionReconnect(pool, &reconnect);
+    EXPECT_EQ((uint32_t) EDGE_SESSION_RECONNECT_INITIAL_DELAY, pool->reconnect.initialDelay);
+    EXPECT_EQ((uint32_t) EDGE_SESSION_RECONNECT_MAX_DELAY, pool->reconnect.maxDelay);
+
+    // One reconnect per session at a time.
+    EXPECT_TRUE(beginEdgeSessionReconnect(pool, 0));
+    EXPECT_FALSE(beginEdgeSessionReconnect(pool, 0));
+    EXPECT_TRUE(beginEdgeSessionReconnect(pool, 1));
+    EXPECT_FALSE(beginEdgeSessionReconnect(pool, 2));
+    endEdgeSessionReconnect(pool, 0);
+    EXPECT_TRUE(beginEdgeSessionReconnect(pool, 0));
+    releaseEdgeSessionPool(pool);
+}
+
+TEST(EdgeSessionPool, ReconnectDelay)
+{
+    EdgeSessionPool *pool = createEdgeSessionPool(1, EDGE_SESSION_POLICY_ROUND_ROBIN, false, NULL);
+    ASSERT_TRUE(pool != NULL);
+    EdgeSessionReconnect reconnect = { true, 100, 1000, 0 };
+    setEdgeSessionReconnect(pool, &reconnect);
+
+    // Without jitter the delay doubles up to the longest delay.
+    EXPECT_EQ(100u, getEdgeSessionReconnectDelay(pool, 0, 0));
+    EXPECT_EQ(200u, getEdgeSessionReconnectDelay(pool, 1, 0));
+    EXPECT_EQ(800u, getEdgeSessionReconnectDelay(pool, 3, 0));
+    EXPECT_EQ(1000u, getEdgeSessionReconnectDelay(pool, 4, 0));
+    EXPECT_EQ(1000u, getEdgeSessionReconnectDelay(pool, 1000, 0));
+
+    // Jitter leaves out up to half of the delay.
+    for (uint32_t random = 0; random < 1000; random += 7)
+    {
+        uint32_t delay = getEdgeSessionReconnectDelay(pool, 2, random);
+        EXPECT_LE(200u, delay);
+        EXPECT_GE(400u, delay);
+    }
+    releaseEdgeSessionPool(pool);
+}
+
+TEST(EdgeSessionPool, InvalidParam)
+{
+    EXPECT_TRUE(createEdgeSessionPool(0, EDGE_SESSION_POLICY_ROUND_ROBIN, false, NULL) == NULL);
+    EXPECT_TRUE(createEdgeSessionPool(EDGE_SESSION_POOL_MAX_SIZE + 1,
+            EDGE_SESSION_POLICY_ROUND_ROBIN, false, NULL) == NULL);
+    EXPECT_EQ(0u, acquireEdgeSessionIndex(NULL, EDGE_SESSION_REQUEST_ANY));
+    EXPECT_TRUE(getEdgeSessionPoolSession(NULL, 0) == NULL);
+    releaseEdgeSessionPool(NULL);
+}
@@ -0,0 +1,87 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+
+#include "edge_session_table.h"
+#include "edge_utils.h"
+
+#define SESSION_COUNT 100
+
+TEST(EdgeSessionTable, AddGetRemove)
+{
+    int session = 0;
+    ASSERT_TRUE(addEdgeSession("opc.tcp://localhost:12686/edge-opc-server", &session));
+    EXPECT_EQ(1u, getEdgeSessionCount());
+
+    EXPECT_EQ(&session, getEdgeSession("opc.tcp://localhost:12686/edge-opc-server", 0));
+    // Sessions are shared by the URIs with the same address.
+    EXPECT_EQ(&session, getEdgeSession("opc.tcp://localhost:12686", 0));
+    EXPECT_EQ(&session, getEdgeSession("opc.tcp://localhost:12686/other-path",
+            hashEndpointAddress("opc.tcp://localhost:12686/other-path")));
+    EXPECT_TRUE(getEdgeSession("opc.tcp://localhost:12687/edge-opc-server", 0) == NULL);
+
+    EXPECT_EQ(&session, removeEdgeSession("opc.tcp://localhost:12686"));
+    EXPECT_EQ(0u, getEdgeSessionCount());
+    EXPECT_TRUE(getEdgeSession("opc.tcp://localhost:12686/edge-opc-server", 0) == NULL);
+    EXPECT_TRUE(removeEdgeSession("opc.tcp://localhost:12686") == NULL);
+}
+
+TEST(EdgeSessionTable, Duplicate)
+{
+    int first = 0, second = 0;
+    ASSERT_TRUE(addEdgeSession("opc.tcp://localhost:12686/edge-opc-server", &first));
+    EXPECT_FALSE(addEdgeSession("opc.tcp://localhost:12686/other-path", &second));
+    EXPECT_EQ(&first, getEdgeSession("opc.tcp://localhost:12686", 0));
+    EXPECT_EQ(&first, removeEdgeSession("opc.tcp://localhost:12686"));
+}
+
+TEST(EdgeSessionTable, Grow)
+{
+    int sessions[SESSION_COUNT];
+    char uri[64];
+    for (int i = 0; i < SESSION_COUNT; ++i)
+    {
+        snprintf(uri, sizeof(uri), "opc.tcp://plc%d:4840/server", i);
+        ASSERT_TRUE(addEdgeSession(uri, &sessions[i]));
+    }
+    EXPECT_EQ(static_cast<size_t>(SESSION_COUNT), getEdgeSessionCount());
+
+    for (int i = 0; i < SESSION_COUNT; ++i)
+    {
+        snprintf(uri, sizeof(uri), "opc.tcp://plc%d:4840", i);
+        EXPECT_EQ(&sessions[i], getEdgeSession(uri, 0));
+    }
+    for (int i = 0; i < SESSION_COUNT; ++i)
+    {
+        snprintf(uri, sizeof(uri), "opc.tcp://plc%d:4840", i);
+        EXPECT_EQ(&sessions[i], removeEdgeSession(uri));
+    }
+    EXPECT_EQ(0u, getEdgeSessionCount());
+}
+
+TEST(EdgeSessionTable, InvalidParam)
+{
+    int session = 0;
+    EXPECT_FALSE(addEdgeSession(NULL, &session));
+    EXPECT_TRUE(getEdgeSession(NULL, 0) == NULL);
+    EXPECT_TRUE(removeEdgeSession(NULL) == NULL);
+}
@@ -0,0 +1,131 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <unistd.h>
+
+#include "edge_value_cache.h"
+
+static UA_DataValue createValue(UA_Int32 *data, UA_StatusCode status)
+{
+    UA_DataValue value;
+    memset(&value, 0, sizeof(value));
+    value.hasValue = true;
+    value.value.data = data;
+    value.hasStatus = (UA_STATUSCODE_GOOD != status);
+    value.status = status;
+    return value;
+}
+
+TEST(EdgeValueCache, CreatedOnDemand)
+{
+    int client;
+    EXPECT_EQ(NULL, getValueCache((UA_Client *) &client, false));
+    EdgeValueCache *cache = getValueCache((UA_Client *) &client, true);
+    ASSERT_NE((EdgeValueCache *) NULL, cache);
+    EXPECT_EQ(cache, getValueCache((UA_Client *) &client, false));
+    EXPECT_EQ(cache, getValueCache((UA_Client *) &client, true));
+
+    removeValueCache((UA_Client *) &client);
+    EXPECT_EQ(NULL, getValueCache((UA_Client *) &client, false));
+    EXPECT_EQ(NULL, getValueCache(NULL, true));
+}
+
+TEST(EdgeValueCache, MaxAge)
+{
+    int client;
+    UA_Int32 data = 42;
+    EdgeValueCache *cache = getValueCache((UA_Client *) &client, true);
+    ASSERT_NE((EdgeValueCache *) NULL, cache);
+
+    UA_NodeId counter = UA_NODEID_STRING(2, (char *) "Counter");
+    UA_NodeId otherNamespace = UA_NODEID_STRING(3, (char *) "Counter");
+    UA_DataValue value = createValue(&data, UA_STATUSCODE_GOOD);
+    UA_DataValue cached;
+    EXPECT_FALSE(getCachedValue(cache, &counter, UA_ATTRIBUTEID_VALUE, 1000, &cached));
+    updateCachedValue(cache, &counter, UA_ATTRIBUTEID_VALUE, &value);
+
+    ASSERT_TRUE(getCachedValue(cache, &counter, UA_ATTRIBUTEID_VALUE, 1000, &cached));
+    EXPECT_EQ(&data, cached.value.data);
+    UA_DataValue_deleteMembers(&cached);
+
+    // Other namespace, attribute or no maxAge.
+    EXPECT_FALSE(getCachedValue(cache, &otherNamespace, UA_ATTRIBUTEID_VALUE, 1000, &cached));
+    EXPECT_FALSE(getCachedValue(cache, &counter, UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL, 1000,
+            &cached));
+    EXPECT_FALSE(getCachedValue(cache, &counter, UA_ATTRIBUTEID_VALUE, 0, &cached));
+
+    usleep(20 * 1000);
+    EXPECT_FALSE(getCachedValue(cache, &counter, UA_ATTRIBUTEID_VALUE, 10, &cached));
+    EXPECT_TRUE(getCachedValue(cache, &counter, UA_ATTRIBUTEID_VALUE, 1000, &cached));
+    UA_DataValue_deleteMembers(&cached);
+
+    removeValueCache((UA_Client *) &client);
+}
+
+TEST(EdgeValueCache, BadValueNotKept)
+{
+    int client;
+    UA_Int32 data = 7;
+    EdgeValueCache *cache = getValueCache((UA_Client *) &client, true);
+    ASSERT_NE((EdgeValueCache *) NULL, cache);
+
+    UA_NodeId missing = UA_NODEID_STRING(2, (char *) "Missing");
+    UA_DataValue value = createValue(&data, UA_STATUSCODE_BADNODEIDUNKNOWN);
+    UA_DataValue cached;
+    updateCachedValue(cache, &missing, UA_ATTRIBUTEID_VALUE, &value);
+    EXPECT_FALSE(getCachedValue(cache, &missing, UA_ATTRIBUTEID_VALUE, 1000, &cached));
+
+    value = createValue(&data, UA_STATUSCODE_GOOD);
+    value.hasValue = false;
+    updateCachedValue(cache, &missing, UA_ATTRIBUTEID_VALUE, &value);
+    EXPECT_FALSE(getCachedValue(cache, &missing, UA_ATTRIBUTEID_VALUE, 1000, &cached));
+
+    removeValueCache((UA_Client *) &client);
+}
+
+TEST(EdgeValueCache, KeyedByNodeId)
+{
+    int client;
+    UA_Int32 data = 3;
+    EdgeValueCache *cache = getValueCache((UA_Client *) &client, true);
+    ASSERT_NE((EdgeValueCache *) NULL, cache);
+
+    // Same identifier text with another identifier type is another node.
+    UA_NodeId string = UA_NODEID_STRING(2, (char *) "1001");
+    UA_NodeId byteString = UA_NODEID_BYTESTRING(2, (char *) "1001");
+    UA_NodeId numeric = UA_NODEID_NUMERIC(2, 1001);
+    UA_DataValue value = createValue(&data, UA_STATUSCODE_GOOD);
+    UA_DataValue cached;
+    updateCachedValue(cache, &numeric, UA_ATTRIBUTEID_VALUE, &value);
+    EXPECT_FALSE(getCachedValue(cache, &string, UA_ATTRIBUTEID_VALUE, 1000, &cached));
+    EXPECT_FALSE(getCachedValue(cache, &byteString, UA_ATTRIBUTEID_VALUE, 1000, &cached));
+
+    UA_NodeId sameNumeric = UA_NODEID_NUMERIC(2, 1001);
+    ASSERT_TRUE(getCachedValue(cache, &sameNumeric, UA_ATTRIBUTEID_VALUE, 1000, &cached));
+    EXPECT_EQ(&data, cached.value.data);
+    UA_DataValue_deleteMembers(&cached);
+
+    EXPECT_FALSE(getCachedValue(cache, NULL, UA_ATTRIBUTEID_VALUE, 1000, &cached));
+
+    removeValueCache((UA_Client *) &client);
+}
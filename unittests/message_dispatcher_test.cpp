@@ -0,0 +1,502 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include "message_dispatcher.h"
+#include "edge_utils.h"
+#include "edge_malloc.h"
+}
+
+#define TEST_ENDPOINT "opc.tcp://localhost:12686/edge-opc-server"
+#define MAX_SENT 64
+
+static pthread_mutex_t g_sentMutex = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t g_sent[MAX_SENT];
+static size_t g_sentCount = 0;
+static uint32_t g_blockedId = 0;
+static volatile bool g_blocked = false;
+static uint32_t g_nextSession = 0;
+static bool g_spreadSessions = true;
+static uint32_t g_discarded[MAX_SENT];
+static EdgeStatusCode g_discardedCodes[MAX_SENT];
+static size_t g_discardedCount = 0;
+
+static void recordSent(EdgeMessage *msg)
+{
+    while (msg->message_id == g_blockedId && g_blocked)
+    {
+        usleep(1000);
+    }
+    pthread_mutex_lock(&g_sentMutex);
+    if (g_sentCount < MAX_SENT)
+    {
+        g_sent[g_sentCount++] = msg->message_id;
+    }
+    pthread_mutex_unlock(&g_sentMutex);
+}
+
+// Nodes of the messages of each batch, by message_id.
+static std::vector<std::vector<std::pair<uint32_t, std::string> > > g_batches;
+
+static void recordBatch(EdgeMessage **msgs, size_t count)
+{
+    std::vector<std::pair<uint32_t, std::string> > batch;
+    for (size_t i = 0; i < count; i++)
+    {
+        batch.push_back(std::make_pair(msgs[i]->message_id,
+                std::string(msgs[i]->requests[0]->nodeInfo->nodeId->nodeId)));
+    }
+    pthread_mutex_lock(&g_sentMutex);
+    g_batches.push_back(batch);
+    pthread_mutex_unlock(&g_sentMutex);
+}
+
+static size_t getBatchCount()
+{
+    pthread_mutex_lock(&g_sentMutex);
+    size_t count = g_batches.size();
+    pthread_mutex_unlock(&g_sentMutex);
+    return count;
+}
+
+static void ignoreResponse(EdgeMessage *msg)
+{
+    (void) msg;
+}
+
+static void recordDiscarded(EdgeMessage *msg, EdgeStatusCode code, const char *reason)
+{
+    (void) reason;
+    pthread_mutex_lock(&g_sentMutex);
+    if (g_discardedCount < MAX_SENT)
+    {
+        g_discardedCodes[g_discardedCount] = code;
+        g_discarded[g_discardedCount++] = msg->message_id;
+    }
+    pthread_mutex_unlock(&g_sentMutex);
+}
+
+// Spreads the reads over the sessions and keeps the other requests on the first one, like
+// the client does.
+static uint32_t selectSession(EdgeMessage *msg)
+{
+    if (!g_spreadSessions || (CMD_READ != msg->command && CMD_BROWSE != msg->command))
+    {
+        return 0;
+    }
+    return ++g_nextSession % 4;
+}
+
+static size_t getSentCount()
+{
+    pthread_mutex_lock(&g_sentMutex);
+    size_t count = g_sentCount;
+    pthread_mutex_unlock(&g_sentMutex);
+    return count;
+}
+
+// Waits up to a second for the requests to be sent.
+static bool waitForSent(size_t count)
+{
+    for (int i = 0; i < 100 && getSentCount() < count; i++)
+    {
+        usleep(10 * 1000);
+    }
+    return getSentCount() >= count;
+}
+
+// Position of the request in the order the requests were sent, -1 if it was not sent.
+static int getSentPosition(uint32_t messageId)
+{
+    int position = -1;
+    pthread_mutex_lock(&g_sentMutex);
+    for (size_t i = 0; i < g_sentCount; i++)
+    {
+        if (g_sent[i] == messageId)
+        {
+            position = (int) i;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_sentMutex);
+    return position;
+}
+
+static EdgeMessage *createRequest(uint32_t messageId, EdgeCommand command,
+        EdgeMessagePriority priority)
+{
+    EdgeMessage *msg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
+    msg->endpointInfo = (EdgeEndPointInfo *) EdgeCalloc(1, sizeof(EdgeEndPointInfo));
+    msg->endpointInfo->endpointUri = cloneString(TEST_ENDPOINT);
+    msg->type = SEND_REQUEST;
+    msg->command = command;
+    msg->message_id = messageId;
+    msg->priority = priority;
+    return msg;
+}
+
+static EdgeRequest *createNodeRequest(uint16_t nameSpace, const char *node)
+{
+    EdgeRequest *request = (EdgeRequest *) EdgeCalloc(1, sizeof(EdgeRequest));
+    request->nodeInfo = (EdgeNodeInfo *) EdgeCalloc(1, sizeof(EdgeNodeInfo));
+    request->nodeInfo->nodeId = (EdgeNodeId *) EdgeCalloc(1, sizeof(EdgeNodeId));
+    request->nodeInfo->nodeId->nameSpace = nameSpace;
+    request->nodeInfo->nodeId->type = EDGE_STRING;
+    request->nodeInfo->nodeId->nodeId = cloneString(node);
+    return request;
+}
+
+// A request to one node of the test endpoint. Method calls are single requests.
+static EdgeMessage *createNodeMessage(uint32_t messageId, EdgeCommand command, const char *node,
+        uint16_t nameSpace = 2)
+{
+    EdgeMessage *msg = createRequest(messageId, command, EDGE_MESSAGE_PRIORITY_DEFAULT);
+    if (CMD_METHOD == command)
+    {
+        msg->request = createNodeRequest(nameSpace, node);
+        return msg;
+    }
+    msg->type = SEND_REQUESTS;
+    msg->requests = (EdgeRequest **) EdgeCalloc(1, sizeof(EdgeRequest *));
+    msg->requests[0] = createNodeRequest(nameSpace, node);
+    msg->requestLength = 1;
+    return msg;
+}
+
+static bool wasDiscarded(uint32_t messageId, EdgeStatusCode code)
+{
+    bool discarded = false;
+    pthread_mutex_lock(&g_sentMutex);
+    for (size_t i = 0; i < g_discardedCount; i++)
+    {
+        discarded = discarded || (g_discarded[i] == messageId && g_discardedCodes[i] == code);
+    }
+    pthread_mutex_unlock(&g_sentMutex);
+    return discarded;
+}
+
+// Waits up to a second for the requests to be sent or discarded.
+static bool waitForDone(size_t count)
+{
+    for (int i = 0; i < 100; i++)
+    {
+        pthread_mutex_lock(&g_sentMutex);
+        size_t done = g_sentCount + g_discardedCount;
+        pthread_mutex_unlock(&g_sentMutex);
+        if (done >= count)
+        {
+            return true;
+        }
+        usleep(10 * 1000);
+    }
+    return false;
+}
+
+class MessageDispatcherF : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        g_sentCount = 0;
+        g_discardedCount = 0;
+        g_blockedId = 0;
+        g_blocked = false;
+        g_nextSession = 0;
+        g_spreadSessions = true;
+        registerMQCallback(ignoreResponse, recordSent);
+        registerMQDiscardCallback(recordDiscarded);
+        registerMQSessionCallback(selectSession, NULL);
+        configure_send_workers(4);
+        init_queue();
+    }
+
+    virtual void TearDown()
+    {
+        g_blocked = false;
+        delete_queue();
+        configure_write_coalescing(false);
+        registerMQDiscardCallback(NULL);
+        registerMQSessionCallback(NULL, NULL);
+        configure_send_workers(0);
+    }
+};
+
+TEST_F(MessageDispatcherF, ControlRequestsKeepOrderWhateverTheirPriority)
+{
+    EXPECT_TRUE(add_to_sendQ(createRequest(1, CMD_START_CLIENT, EDGE_MESSAGE_PRIORITY_BULK)));
+    EXPECT_TRUE(add_to_sendQ(createRequest(2, CMD_SUB, EDGE_MESSAGE_PRIORITY_NORMAL)));
+    EXPECT_TRUE(add_to_sendQ(createRequest(3, CMD_STOP_CLIENT, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+    EXPECT_TRUE(add_to_sendQ(createRequest(4, CMD_START_CLIENT, EDGE_MESSAGE_PRIORITY_HIGH)));
+
+    ASSERT_TRUE(waitForSent(4));
+    for (uint32_t id = 1; id <= 4; id++)
+    {
+        EXPECT_EQ((int) id - 1, getSentPosition(id));
+    }
+}
+
+TEST_F(MessageDispatcherF, StopWaitsForEarlierRequestsOnEverySendThread)
+{
+    g_blockedId = 1;
+    g_blocked = true;
+    EXPECT_TRUE(add_to_sendQ(createRequest(1, CMD_READ, EDGE_MESSAGE_PRIORITY_BULK)));
+    EXPECT_TRUE(add_to_sendQ(createRequest(2, CMD_WRITE, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+    EXPECT_TRUE(add_to_sendQ(createRequest(3, CMD_STOP_CLIENT, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+    EXPECT_TRUE(add_to_sendQ(createRequest(4, CMD_START_CLIENT, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+    EXPECT_TRUE(add_to_sendQ(createRequest(5, CMD_READ, EDGE_MESSAGE_PRIORITY_HIGH)));
+
+    // The write does not wait for the read, but the stop does.
+    ASSERT_TRUE(waitForSent(1));
+    usleep(50 * 1000);
+    EXPECT_EQ(0, getSentPosition(2));
+    EXPECT_EQ(-1, getSentPosition(3));
+    EXPECT_EQ(-1, getSentPosition(4));
+    EXPECT_EQ(-1, getSentPosition(5));
+
+    g_blocked = false;
+    ASSERT_TRUE(waitForSent(5));
+    EXPECT_LT(getSentPosition(1), getSentPosition(3));
+    EXPECT_LT(getSentPosition(3), getSentPosition(4));
+    EXPECT_LT(getSentPosition(3), getSentPosition(5));
+}
+
+TEST_F(MessageDispatcherF, StopQueuedBehindAStopWaitsForTheRequestsBetween)
+{
+    g_blockedId = 1;
+    g_blocked = true;
+    EXPECT_TRUE(add_to_sendQ(createRequest(1, CMD_READ, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+    EXPECT_TRUE(add_to_sendQ(createRequest(2, CMD_STOP_CLIENT, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+    EXPECT_TRUE(add_to_sendQ(createRequest(3, CMD_READ, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+    EXPECT_TRUE(add_to_sendQ(createRequest(4, CMD_STOP_CLIENT, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+
+    g_blocked = false;
+    ASSERT_TRUE(waitForSent(4));
+    EXPECT_EQ(0, getSentPosition(1));
+    EXPECT_EQ(1, getSentPosition(2));
+    EXPECT_EQ(2, getSentPosition(3));
+    EXPECT_EQ(3, getSentPosition(4));
+}
+
+TEST_F(MessageDispatcherF, WritesKeepTheirOrderButReadsMayOvertakeThem)
+{
+    g_blockedId = 1;
+    g_blocked = true;
+    EXPECT_TRUE(add_to_sendQ(createRequest(1, CMD_WRITE, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+    EXPECT_TRUE(add_to_sendQ(createRequest(2, CMD_READ, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+    EXPECT_TRUE(add_to_sendQ(createRequest(3, CMD_METHOD, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+    EXPECT_TRUE(add_to_sendQ(createRequest(4, CMD_WRITE, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+    EXPECT_TRUE(add_to_sendQ(createRequest(5, CMD_READ, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+
+    // The reads are served by other sessions, the method call and the write wait.
+    ASSERT_TRUE(waitForSent(2));
+    usleep(50 * 1000);
+    EXPECT_NE(-1, getSentPosition(2));
+    EXPECT_NE(-1, getSentPosition(5));
+    EXPECT_EQ(-1, getSentPosition(3));
+    EXPECT_EQ(-1, getSentPosition(4));
+
+    g_blocked = false;
+    ASSERT_TRUE(waitForSent(5));
+    EXPECT_EQ(2, getSentPosition(1));
+    EXPECT_EQ(3, getSentPosition(3));
+    EXPECT_EQ(4, getSentPosition(4));
+}
+
+TEST_F(MessageDispatcherF, CancelDropsOnlyTheRequestsQueuedBefore)
+{
+    g_spreadSessions = false;
+    g_blockedId = 1;
+    g_blocked = true;
+    EXPECT_TRUE(add_to_sendQ(createRequest(1, CMD_READ, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+    EXPECT_TRUE(add_to_sendQ(createRequest(7, CMD_READ, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+    EXPECT_TRUE(cancel_request(7));
+    // The next execution of a prepared group or a poll reuses the id.
+    EXPECT_TRUE(add_to_sendQ(createRequest(7, CMD_READ, EDGE_MESSAGE_PRIORITY_DEFAULT)));
+    EXPECT_FALSE(cancel_request(8));
+
+    g_blocked = false;
+    ASSERT_TRUE(waitForSent(2));
+    usleep(20 * 1000);
+    EXPECT_EQ(2u, getSentCount());
+    EXPECT_EQ(0, getSentPosition(1));
+    EXPECT_EQ(1, getSentPosition(7));
+    ASSERT_EQ(1u, g_discardedCount);
+    EXPECT_EQ(7u, g_discarded[0]);
+
+    // Nothing waits with the id any more.
+    EXPECT_FALSE(cancel_request(7));
+}
+
+TEST_F(MessageDispatcherF, CoalescedWritesSendTheNewestToANode)
+{
+    configure_write_coalescing(true);
+    g_blockedId = 1;
+    g_blocked = true;
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(1, CMD_WRITE, "Busy")));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(2, CMD_WRITE, "Speed")));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(3, CMD_WRITE, "Speed")));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(4, CMD_WRITE, "Speed")));
+
+    g_blocked = false;
+    ASSERT_TRUE(waitForDone(4));
+    usleep(20 * 1000);
+    // Each write is answered with its own id, only the newest one is sent.
+    EXPECT_EQ(2u, getSentCount());
+    EXPECT_EQ(0, getSentPosition(1));
+    EXPECT_EQ(1, getSentPosition(4));
+    EXPECT_EQ(2u, g_discardedCount);
+    EXPECT_TRUE(wasDiscarded(2, STATUS_WRITE_SUPERSEDED));
+    EXPECT_TRUE(wasDiscarded(3, STATUS_WRITE_SUPERSEDED));
+}
+
+TEST_F(MessageDispatcherF, CoalescedWritesToOtherNodesAreAllSent)
+{
+    configure_write_coalescing(true);
+    g_blockedId = 1;
+    g_blocked = true;
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(1, CMD_WRITE, "Busy")));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(2, CMD_WRITE, "Speed")));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(3, CMD_WRITE, "Torque")));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(4, CMD_WRITE, "Speed", 3)));
+
+    g_blocked = false;
+    ASSERT_TRUE(waitForSent(4));
+    usleep(20 * 1000);
+    EXPECT_EQ(0u, g_discardedCount);
+    for (uint32_t id = 1; id <= 4; id++)
+    {
+        EXPECT_EQ((int) id - 1, getSentPosition(id));
+    }
+}
+
+TEST_F(MessageDispatcherF, CoalescedWritesAreKeptForAReadOrMethodCallBetween)
+{
+    configure_write_coalescing(true);
+    g_blockedId = 1;
+    g_blocked = true;
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(1, CMD_WRITE, "Busy")));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(2, CMD_WRITE, "Speed")));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(3, CMD_READ, "Speed")));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(4, CMD_WRITE, "Speed")));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(5, CMD_METHOD, "Reset")));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(6, CMD_WRITE, "Speed")));
+    // A read of another node does not keep the write.
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(7, CMD_READ, "Torque")));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(8, CMD_WRITE, "Speed")));
+
+    g_blocked = false;
+    ASSERT_TRUE(waitForDone(8));
+    usleep(20 * 1000);
+    EXPECT_EQ(7u, getSentCount());
+    ASSERT_EQ(1u, g_discardedCount);
+    EXPECT_TRUE(wasDiscarded(6, STATUS_WRITE_SUPERSEDED));
+    EXPECT_LT(getSentPosition(2), getSentPosition(4));
+    EXPECT_LT(getSentPosition(4), getSentPosition(5));
+    EXPECT_LT(getSentPosition(5), getSentPosition(8));
+}
+
+class MessageDispatcherBatchF : public MessageDispatcherF {
+protected:
+    virtual void SetUp()
+    {
+        MessageDispatcherF::SetUp();
+        delete_queue();
+        g_batches.clear();
+        g_spreadSessions = false;
+        registerMQBatchCallback(recordBatch);
+        configure_read_batch(200, 0);
+        init_queue();
+    }
+
+    virtual void TearDown()
+    {
+        MessageDispatcherF::TearDown();
+        configure_read_batch(0, 0);
+        registerMQBatchCallback(NULL);
+    }
+};
+
+TEST_F(MessageDispatcherBatchF, ReadsWithinTheWindowAreSentInOneBatch)
+{
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(1, CMD_READ, "Speed")));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(2, CMD_READ, "Torque")));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(3, CMD_READ, "Speed")));
+
+    // Held back for the window, then each message keeps its own id and node.
+    usleep(50 * 1000);
+    EXPECT_EQ(0u, getBatchCount());
+    for (int i = 0; i < 100 && 0 == getBatchCount(); i++)
+    {
+        usleep(10 * 1000);
+    }
+    ASSERT_EQ(1u, getBatchCount());
+    ASSERT_EQ(3u, g_batches[0].size());
+    EXPECT_EQ(1u, g_batches[0][0].first);
+    EXPECT_EQ("Speed", g_batches[0][0].second);
+    EXPECT_EQ(2u, g_batches[0][1].first);
+    EXPECT_EQ("Torque", g_batches[0][1].second);
+    EXPECT_EQ(3u, g_batches[0][2].first);
+    EXPECT_EQ("Speed", g_batches[0][2].second);
+    EXPECT_EQ(0u, getSentCount());
+}
+
+TEST_F(MessageDispatcherBatchF, ReadToSendImmediatelyIsNotHeldBack)
+{
+    EdgeMessage *msg = createNodeMessage(1, CMD_READ, "Speed");
+    msg->sendImmediately = true;
+    EXPECT_TRUE(add_to_sendQ(msg));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(2, CMD_READ, "Torque")));
+
+    ASSERT_TRUE(waitForSent(1));
+    EXPECT_EQ(0, getSentPosition(1));
+    EXPECT_EQ(0u, getBatchCount());
+
+    // A single held read is sent on its own once the window is over.
+    ASSERT_TRUE(waitForSent(2));
+    EXPECT_EQ(1, getSentPosition(2));
+    EXPECT_EQ(0u, getBatchCount());
+}
+
+TEST_F(MessageDispatcherBatchF, ReadWhichExpiresWhileHeldIsDiscarded)
+{
+    EdgeMessage *msg = createNodeMessage(1, CMD_READ, "Speed");
+    msg->timeoutMs = 1;
+    EXPECT_TRUE(add_to_sendQ(msg));
+    EXPECT_TRUE(add_to_sendQ(createNodeMessage(2, CMD_READ, "Torque")));
+
+    // The batch is sent once the window is over, without the expired read.
+    for (int i = 0; i < 100 && 0 == getBatchCount() && 0 == getSentCount(); i++)
+    {
+        usleep(10 * 1000);
+    }
+    usleep(20 * 1000);
+    EXPECT_TRUE(wasDiscarded(1, STATUS_ERROR));
+    EXPECT_EQ(-1, getSentPosition(1));
+    EXPECT_EQ(0u, getBatchCount());
+    ASSERT_TRUE(waitForSent(1));
+    EXPECT_EQ(0, getSentPosition(2));
+}
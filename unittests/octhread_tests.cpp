@@ -565,3 +565,184 @@ TEST(ConditionTests, TC_07_WAITDURATION)
 
     oc_cond_free(sharedCond);
 }
+
+TEST(ThreadPoolTests, TC_01_INVALID)
+{
+    ca_thread_pool_t mythreadpool;
+
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, ca_thread_pool_init(0, &mythreadpool));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, ca_thread_pool_init(3, NULL));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, ca_thread_pool_add_task(NULL, NULL, NULL, NULL));
+    EXPECT_EQ(CA_STATUS_FAILED, ca_thread_pool_remove_task(NULL, 1));
+}
+
+typedef struct _countStruct
+{
+    oc_mutex mutex;
+    int count;
+} _countStruct;
+
+static void countFunc(void *context)
+{
+    _countStruct *pData = (_countStruct *) context;
+
+    oc_mutex_lock(pData->mutex);
+    pData->count++;
+    oc_mutex_unlock(pData->mutex);
+}
+
+TEST(ThreadPoolTests, TC_02_RUN_ALL)
+{
+    const int TASK_COUNT = 1000;
+    ca_thread_pool_t mythreadpool;
+
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_init(4, &mythreadpool));
+
+    _countStruct pData = {oc_mutex_new(), 0};
+
+    uint32_t lastTaskId = 0;
+    for (int i = 0; i < TASK_COUNT; i++)
+    {
+        uint32_t taskId = 0;
+        EXPECT_EQ(CA_STATUS_OK,
+                  ca_thread_pool_add_task(mythreadpool, countFunc, &pData, &taskId));
+        EXPECT_NE(lastTaskId, taskId);
+        lastTaskId = taskId;
+    }
+
+    // All the tasks added before are run before the workers are joined.
+    ca_thread_pool_free(mythreadpool);
+
+    EXPECT_EQ(TASK_COUNT, pData.count);
+
+    oc_mutex_free(pData.mutex);
+}
+
+typedef struct _blockStruct
+{
+    volatile bool started;
+    volatile bool release;
+    volatile bool finished;
+} _blockStruct;
+
+static void blockFunc(void *context)
+{
+    _blockStruct *pData = (_blockStruct *) context;
+
+    pData->started = true;
+    while (!pData->release)
+    {
+        usleep(MINIMAL_LOOP_SLEEP * USECS_PER_MSEC);
+    }
+    pData->finished = true;
+}
+
+static void releaseFunc(void *context)
+{
+    _blockStruct *pData = (_blockStruct *) context;
+
+    usleep(MINIMAL_EXTRA_SLEEP * USECS_PER_MSEC);
+    pData->release = true;
+}
+
+TEST(ThreadPoolTests, TC_03_REMOVE_RUNNING)
+{
+    ca_thread_pool_t mythreadpool;
+
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_init(2, &mythreadpool));
+
+    _blockStruct pData = {false, false, false};
+
+    uint32_t taskId = 0;
+    EXPECT_EQ(CA_STATUS_OK,
+              ca_thread_pool_add_task(mythreadpool, blockFunc, &pData, &taskId));
+    while (!pData.started)
+    {
+        usleep(MINIMAL_LOOP_SLEEP * USECS_PER_MSEC);
+    }
+    EXPECT_EQ(CA_STATUS_OK,
+              ca_thread_pool_add_task(mythreadpool, releaseFunc, &pData, NULL));
+
+    // Waits for the running task to return.
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_remove_task(mythreadpool, taskId));
+    EXPECT_TRUE(pData.finished);
+
+    ca_thread_pool_free(mythreadpool);
+}
+
+TEST(ThreadPoolTests, TC_04_REMOVE_QUEUED)
+{
+    ca_thread_pool_t mythreadpool;
+
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &mythreadpool));
+
+    _blockStruct blocker = {false, false, false};
+    _countStruct pData = {oc_mutex_new(), 0};
+
+    EXPECT_EQ(CA_STATUS_OK,
+              ca_thread_pool_add_task(mythreadpool, blockFunc, &blocker, NULL));
+    while (!blocker.started)
+    {
+        usleep(MINIMAL_LOOP_SLEEP * USECS_PER_MSEC);
+    }
+
+    // The only worker is busy, so this task stays queued and can be removed.
+    uint32_t taskId = 0;
+    EXPECT_EQ(CA_STATUS_OK,
+              ca_thread_pool_add_task(mythreadpool, countFunc, &pData, &taskId));
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_remove_task(mythreadpool, taskId));
+
+    blocker.release = true;
+    ca_thread_pool_free(mythreadpool);
+
+    EXPECT_TRUE(blocker.finished);
+    EXPECT_EQ(0, pData.count);
+
+    oc_mutex_free(pData.mutex);
+}
+
+TEST(ThreadPoolTests, TC_05_STEAL)
+{
+    const int WORKER_COUNT = 4;
+    ca_thread_pool_t mythreadpool;
+
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_init(WORKER_COUNT, &mythreadpool));
+
+    // Tasks are handed out round-robin, so every second task lands behind a
+    // blocked worker and has to be stolen by another one.
+    _blockStruct blockers[WORKER_COUNT / 2];
+    _countStruct pData = {oc_mutex_new(), 0};
+    for (int i = 0; i < WORKER_COUNT / 2; i++)
+    {
+        blockers[i].started = false;
+        blockers[i].release = false;
+        blockers[i].finished = false;
+        EXPECT_EQ(CA_STATUS_OK,
+                  ca_thread_pool_add_task(mythreadpool, blockFunc, &blockers[i], NULL));
+        EXPECT_EQ(CA_STATUS_OK,
+                  ca_thread_pool_add_task(mythreadpool, countFunc, &pData, NULL));
+    }
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK,
+                  ca_thread_pool_add_task(mythreadpool, countFunc, &pData, NULL));
+    }
+
+    int count = 0;
+    for (int retry = 0; retry < 100 && count < 100 + WORKER_COUNT / 2; retry++)
+    {
+        usleep(MINIMAL_LOOP_SLEEP * USECS_PER_MSEC);
+        oc_mutex_lock(pData.mutex);
+        count = pData.count;
+        oc_mutex_unlock(pData.mutex);
+    }
+    EXPECT_EQ(100 + WORKER_COUNT / 2, count);
+
+    for (int i = 0; i < WORKER_COUNT / 2; i++)
+    {
+        blockers[i].release = true;
+    }
+    ca_thread_pool_free(mythreadpool);
+
+    oc_mutex_free(pData.mutex);
+}
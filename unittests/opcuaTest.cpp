@@ -82,6 +82,7 @@ static bool readNodeFlag = true;
 static bool browseNodeFlag = false;
 static bool methodCallFlag = false;
 static bool errorCallFlag = false;
+static bool readResponseFlag = false;
 
 char node_arr[46][30] =
 {
@@ -175,6 +176,10 @@ extern "C"
 
     static void response_msg_cb(EdgeMessage *data)
     {
+        if (data->command == CMD_READ)
+        {
+            readResponseFlag = true;
+        }
         if (data->type == GENERAL_RESPONSE)
         {
             int len = data->responseLength;
@@ -742,10 +747,10 @@ static void configureCallbacks()
     PRINT("-----INITIALIZING CALLBACKS-----");
 
     EXPECT_EQ(NULL == config, true);
-    config = (EdgeConfigure *) EdgeMalloc(sizeof(EdgeConfigure));
+    config = (EdgeConfigure *) EdgeCalloc(1, sizeof(EdgeConfigure));
     EXPECT_EQ(NULL == config, false);
 
-    config->recvCallback = (ReceivedMessageCallback *) EdgeMalloc(sizeof(ReceivedMessageCallback));
+    config->recvCallback = (ReceivedMessageCallback *) EdgeCalloc(1, sizeof(ReceivedMessageCallback));
     EXPECT_EQ(NULL == config->recvCallback, false);
 
     config->recvCallback->resp_msg_cb = response_msg_cb;
@@ -901,6 +906,40 @@ static void browseNode()
     browseNodeFlag = false;
 }
 
+static void browseNodeMove()
+{
+    int  maxReferencesPerNode = 0;
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_BROWSE);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeNodeInfo* nodeInfo = createEdgeNodeInfoForNodeId(EDGE_INTEGER, EDGE_NODEID_ROOTFOLDER,
+            SYSTEM_NAMESPACE_INDEX);
+    EdgeBrowseParameter param = {DIRECTION_FORWARD, maxReferencesPerNode};
+    insertBrowseParameter(&msg, nodeInfo, param);
+
+    EXPECT_EQ(browseNodeFlag, false);
+    /* The message is destroyed by the stack */
+    EdgeResult result = sendRequestMove(msg);
+    EXPECT_EQ(result.code, STATUS_OK);
+    sleep(1);
+
+    /* Wait some time and check whether browse callback is received */
+    EXPECT_EQ(browseNodeFlag, true);
+    browseNodeFlag = false;
+}
+
+static void browseNodeMoveWithoutBrowseParam()
+{
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_BROWSE);
+    EXPECT_EQ(NULL != msg, true);
+    /* The rejected message is destroyed by the stack */
+    EdgeResult result = sendRequestMove(msg);
+    ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
+
+    result = sendRequestMove(NULL);
+    ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
+}
+
 static void browseNodes()
 {
     int  maxReferencesPerNode = 0;
@@ -3444,6 +3483,55 @@ TEST_F(OPC_clientTests , ClientRead_N4)
     EXPECT_EQ(startClientFlag, false);
 }
 
+TEST_F(OPC_clientTests , ClientReadExpired_N)
+{
+    /* Reads are held back for the batch window, which lasts longer than the timeout below */
+    EdgeQueueConfigure queueConfig;
+    memset(&queueConfig, 0, sizeof(queueConfig));
+    queueConfig.readBatchWindowMs = 200;
+    configureQueue(&queueConfig);
+
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    msg = createEdgeAttributeMessage(endpointUri, 2, CMD_READ);
+    EXPECT_EQ(NULL != msg, true);
+    insertReadAccessNode(&msg, node_arr[0]);
+    insertReadAccessNode(&msg, node_arr[1]);
+
+    /* The read expires while it is held, and is dropped without being sent */
+    msg->timeoutMs = 1;
+    errorCallFlag = false;
+    readResponseFlag = false;
+    res = sendRequest(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+    destroyEdgeMessage(msg);
+    sleep(1);
+
+    EXPECT_EQ(readResponseFlag, false);
+    EXPECT_EQ(errorCallFlag, true);
+    errorCallFlag = false;
+
+    /* Nothing is pending with this id */
+    res = cancelRequest(0);
+    EXPECT_EQ(res.code, STATUS_ERROR);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+
+    memset(&queueConfig, 0, sizeof(queueConfig));
+    configureQueue(&queueConfig);
+}
+
 TEST_F(OPC_clientTests , ClientWrite_P1)
 {
     EXPECT_EQ(startClientFlag, false);
@@ -3619,6 +3707,7 @@ TEST_F(OPC_clientTests , ClientBrowse_P)
     destroyEdgeMessage(msg);
 
     browseNode();
+    browseNodeMove();
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
@@ -3779,6 +3868,7 @@ TEST_F(OPC_clientTests , ClientBrowse_N5)
     destroyEdgeMessage(msg);
 
     browseNodeWithoutBrowseParam();
+    browseNodeMoveWithoutBrowseParam();
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
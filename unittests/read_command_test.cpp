@@ -0,0 +1,308 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+
+extern "C"
+{
+#include "opcua_manager.h"
+#include "read.h"
+#include "message_dispatcher.h"
+#include "edge_server_capabilities.h"
+#include "edge_utils.h"
+#include "edge_malloc.h"
+}
+
+#define TEST_ENDPOINT "opc.tcp://localhost:12686/edge-opc-server"
+
+// A response received for a request message, with the requestId and value of each node.
+struct ReceivedResponse
+{
+    EdgeMessageType type;
+    uint32_t messageId;
+    std::vector<int> requestIds;
+    std::vector<int32_t> values;
+};
+
+static pthread_mutex_t g_receivedMutex = PTHREAD_MUTEX_INITIALIZER;
+static std::vector<ReceivedResponse> g_received;
+static std::vector<size_t> g_readCallSizes;
+static UA_StatusCode g_readServiceResult = UA_STATUSCODE_GOOD;
+static int g_fakeClient;
+
+// Answers every node "NodeN" with the Int32 value N.
+static UA_ReadResponse fakeRead(UA_Client *client, const UA_ReadRequest request)
+{
+    (void) client;
+    g_readCallSizes.push_back(request.nodesToReadSize);
+    UA_ReadResponse response;
+    UA_ReadResponse_init(&response);
+    response.responseHeader.serviceResult = g_readServiceResult;
+    if (UA_STATUSCODE_GOOD != g_readServiceResult)
+    {
+        return response;
+    }
+    response.results = (UA_DataValue *) UA_Array_new(request.nodesToReadSize,
+            &UA_TYPES[UA_TYPES_DATAVALUE]);
+    response.resultsSize = request.nodesToReadSize;
+    for (size_t i = 0; i < request.nodesToReadSize; i++)
+    {
+        const UA_String *name = &request.nodesToRead[i].nodeId.identifier.string;
+        char node[32] = { 0 };
+        memcpy(node, name->data, (name->length < sizeof(node)) ? name->length : sizeof(node) - 1);
+        UA_Int32 value = atoi(node + strlen("Node"));
+        UA_Variant_setScalarCopy(&response.results[i].value, &value, &UA_TYPES[UA_TYPES_INT32]);
+        response.results[i].hasValue = true;
+        response.results[i].status = UA_STATUSCODE_GOOD;
+        response.results[i].sourceTimestamp = UA_DateTime_now();
+        response.results[i].hasSourceTimestamp = true;
+        response.results[i].serverTimestamp = UA_DateTime_now();
+        response.results[i].hasServerTimestamp = true;
+    }
+    return response;
+}
+
+static void recordResponse(EdgeMessage *msg)
+{
+    ReceivedResponse received;
+    received.type = msg->type;
+    received.messageId = msg->message_id;
+    for (size_t i = 0; GENERAL_RESPONSE == msg->type && i < msg->responseLength; i++)
+    {
+        EdgeResponse *response = msg->responses[i];
+        received.requestIds.push_back(response->requestId);
+        received.values.push_back(*(int32_t *) response->message->value);
+    }
+    pthread_mutex_lock(&g_receivedMutex);
+    g_received.push_back(received);
+    pthread_mutex_unlock(&g_receivedMutex);
+}
+
+// Waits up to a second for the responses.
+static bool waitForResponses(size_t count)
+{
+    for (int i = 0; i < 100; i++)
+    {
+        pthread_mutex_lock(&g_receivedMutex);
+        size_t received = g_received.size();
+        pthread_mutex_unlock(&g_receivedMutex);
+        if (received >= count)
+        {
+            return true;
+        }
+        usleep(10 * 1000);
+    }
+    return false;
+}
+
+static const ReceivedResponse *findResponse(uint32_t messageId)
+{
+    for (size_t i = 0; i < g_received.size(); i++)
+    {
+        if (g_received[i].messageId == messageId)
+        {
+            return &g_received[i];
+        }
+    }
+    return NULL;
+}
+
+// A read of count nodes "Node<first>" and up, whose requestIds are their numbers. count > 1.
+static EdgeMessage *createReadMessage(uint32_t messageId, int first, int count)
+{
+    EdgeMessage *msg = createEdgeAttributeMessage(TEST_ENDPOINT, count, CMD_READ);
+    for (int i = 0; i < count; i++)
+    {
+        char node[32];
+        snprintf(node, sizeof(node), "{2;S;v=0}Node%d", first + i);
+        insertReadAccessNode(&msg, node);
+        msg->requests[i]->requestId = first + i;
+    }
+    msg->message_id = messageId;
+    return msg;
+}
+
+class ReadCommandF : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        g_received.clear();
+        g_readCallSizes.clear();
+        g_readServiceResult = UA_STATUSCODE_GOOD;
+        setReadService(fakeRead);
+        registerMQCallback(recordResponse, onSendMessage);
+        init_queue();
+    }
+
+    virtual void TearDown()
+    {
+        delete_queue();
+        registerMQCallback(onResponseMessage, onSendMessage);
+        setReadService(NULL);
+        removeServerCapabilities(client());
+    }
+
+    UA_Client *client()
+    {
+        return (UA_Client *) &g_fakeClient;
+    }
+
+    void setMaxNodesPerRead(uint32_t maxNodesPerRead)
+    {
+        EdgeServerCapabilities capabilities;
+        memset(&capabilities, 0, sizeof(capabilities));
+        capabilities.maxNodesPerRead = maxNodesPerRead;
+        ASSERT_TRUE(setServerCapabilities(client(), &capabilities));
+    }
+
+    // Reads the nodes "Node1" to "Node<count>" and checks that they are answered in order.
+    void readNodes(uint32_t messageId, int count)
+    {
+        EdgeMessage *msg = createReadMessage(messageId, 1, count);
+        EXPECT_EQ(STATUS_OK, executeRead(client(), msg).code);
+        destroyEdgeMessage(msg);
+
+        ASSERT_TRUE(waitForResponses(1));
+        const ReceivedResponse *response = findResponse(messageId);
+        ASSERT_TRUE(response != NULL);
+        EXPECT_EQ(GENERAL_RESPONSE, response->type);
+        ASSERT_EQ((size_t) count, response->values.size());
+        for (int i = 0; i < count; i++)
+        {
+            EXPECT_EQ(i + 1, response->requestIds[i]);
+            EXPECT_EQ(i + 1, response->values[i]);
+        }
+    }
+};
+
+TEST_F(ReadCommandF, BatchAnswersEachMessageWithItsOwnNodes)
+{
+    EdgeMessage *msgs[3] = { createReadMessage(11, 1, 2), createReadMessage(12, 3, 2),
+            createReadMessage(13, 5, 3) };
+    EXPECT_EQ(STATUS_OK, executeReadBatch(client(), msgs, 3).code);
+
+    // One service call reads the nodes of all the messages.
+    ASSERT_TRUE(waitForResponses(3));
+    ASSERT_EQ(1u, g_readCallSizes.size());
+    EXPECT_EQ(7u, g_readCallSizes[0]);
+
+    int node = 1;
+    for (uint32_t messageId = 11; messageId <= 13; messageId++)
+    {
+        const ReceivedResponse *response = findResponse(messageId);
+        ASSERT_TRUE(response != NULL);
+        EXPECT_EQ(GENERAL_RESPONSE, response->type);
+        ASSERT_EQ(msgs[messageId - 11]->requestLength, response->values.size());
+        for (size_t i = 0; i < response->values.size(); i++, node++)
+        {
+            EXPECT_EQ(node, response->requestIds[i]);
+            EXPECT_EQ(node, response->values[i]);
+        }
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        destroyEdgeMessage(msgs[i]);
+    }
+}
+
+TEST_F(ReadCommandF, FailedBatchAnswersEachMessageWithAnError)
+{
+    g_readServiceResult = UA_STATUSCODE_BADTIMEOUT;
+    EdgeMessage *msgs[2] = { createReadMessage(21, 1, 2), createReadMessage(22, 3, 2) };
+    EXPECT_EQ(STATUS_OK, executeReadBatch(client(), msgs, 2).code);
+
+    ASSERT_TRUE(waitForResponses(2));
+    usleep(20 * 1000);
+    EXPECT_EQ(2u, g_received.size());
+    for (uint32_t messageId = 21; messageId <= 22; messageId++)
+    {
+        const ReceivedResponse *response = findResponse(messageId);
+        ASSERT_TRUE(response != NULL);
+        EXPECT_EQ(ERROR_RESPONSE, response->type);
+    }
+    destroyEdgeMessage(msgs[0]);
+    destroyEdgeMessage(msgs[1]);
+}
+
+TEST_F(ReadCommandF, ReadOfAMultipleOfMaxNodesPerReadIsSplitIntoFullChunks)
+{
+    setMaxNodesPerRead(3);
+    readNodes(31, 6);
+
+    ASSERT_EQ(2u, g_readCallSizes.size());
+    EXPECT_EQ(3u, g_readCallSizes[0]);
+    EXPECT_EQ(3u, g_readCallSizes[1]);
+}
+
+TEST_F(ReadCommandF, ReadSplitLeavesTheRemainderToTheLastChunk)
+{
+    setMaxNodesPerRead(3);
+    readNodes(32, 7);
+
+    ASSERT_EQ(3u, g_readCallSizes.size());
+    EXPECT_EQ(3u, g_readCallSizes[0]);
+    EXPECT_EQ(3u, g_readCallSizes[1]);
+    EXPECT_EQ(1u, g_readCallSizes[2]);
+}
+
+TEST_F(ReadCommandF, ReadWithinMaxNodesPerReadIsNotSplit)
+{
+    setMaxNodesPerRead(3);
+    readNodes(33, 3);
+
+    ASSERT_EQ(1u, g_readCallSizes.size());
+    EXPECT_EQ(3u, g_readCallSizes[0]);
+}
+
+TEST_F(ReadCommandF, ChunkedBatchAnswersEachMessageWithItsOwnNodes)
+{
+    setMaxNodesPerRead(2);
+    EdgeMessage *msgs[2] = { createReadMessage(41, 1, 3), createReadMessage(42, 4, 2) };
+    EXPECT_EQ(STATUS_OK, executeReadBatch(client(), msgs, 2).code);
+
+    // The 5 nodes of the batch are read in chunks, the chunks do not follow the messages.
+    ASSERT_TRUE(waitForResponses(2));
+    ASSERT_EQ(3u, g_readCallSizes.size());
+    EXPECT_EQ(2u, g_readCallSizes[0]);
+    EXPECT_EQ(2u, g_readCallSizes[1]);
+    EXPECT_EQ(1u, g_readCallSizes[2]);
+
+    int node = 1;
+    for (uint32_t messageId = 41; messageId <= 42; messageId++)
+    {
+        const ReceivedResponse *response = findResponse(messageId);
+        ASSERT_TRUE(response != NULL);
+        EXPECT_EQ(GENERAL_RESPONSE, response->type);
+        ASSERT_EQ(msgs[messageId - 41]->requestLength, response->values.size());
+        for (size_t i = 0; i < response->values.size(); i++, node++)
+        {
+            EXPECT_EQ(node, response->requestIds[i]);
+            EXPECT_EQ(node, response->values[i]);
+        }
+    }
+    destroyEdgeMessage(msgs[0]);
+    destroyEdgeMessage(msgs[1]);
+}
@@ -0,0 +1,210 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include "uringqueue.h"
+#include "octhread.h"
+
+#define PRODUCER_COUNT 4
+#define ITEMS_PER_PRODUCER 10000
+
+class URingQueueF : public testing::Test {
+public:
+    URingQueueF() :
+      testing::Test(),
+      queue(NULL)
+  {
+  }
+
+protected:
+    virtual void SetUp()
+    {
+        queue = u_ringqueue_create(8);
+        ASSERT_TRUE(queue != NULL);
+    }
+
+    virtual void TearDown()
+    {
+        EXPECT_EQ(CA_STATUS_OK, u_ringqueue_delete(queue));
+    }
+
+    u_ringqueue_t *queue;
+};
+
+TEST(URingQueue, Base)
+{
+    u_ringqueue_t *queue = u_ringqueue_create(16);
+    ASSERT_TRUE(queue != NULL);
+
+    EXPECT_EQ(static_cast<uint32_t>(16), u_ringqueue_get_capacity(queue));
+    EXPECT_EQ(static_cast<uint32_t>(0), u_ringqueue_get_size(queue));
+
+    EXPECT_EQ(CA_STATUS_OK, u_ringqueue_delete(queue));
+}
+
+TEST(URingQueue, FreeNull)
+{
+    EXPECT_EQ(CA_STATUS_FAILED, u_ringqueue_delete(NULL));
+}
+
+TEST(URingQueue, DefaultCapacity)
+{
+    u_ringqueue_t *queue = u_ringqueue_create(0);
+    ASSERT_TRUE(queue != NULL);
+
+    EXPECT_EQ(static_cast<uint32_t>(U_RINGQUEUE_DEFAULT_CAPACITY), u_ringqueue_get_capacity(queue));
+
+    EXPECT_EQ(CA_STATUS_OK, u_ringqueue_delete(queue));
+}
+
+TEST(URingQueue, CapacityRoundUp)
+{
+    u_ringqueue_t *queue = u_ringqueue_create(100);
+    ASSERT_TRUE(queue != NULL);
+
+    EXPECT_EQ(static_cast<uint32_t>(128), u_ringqueue_get_capacity(queue));
+
+    EXPECT_EQ(CA_STATUS_OK, u_ringqueue_delete(queue));
+}
+
+TEST_F(URingQueueF, PopEmpty)
+{
+    u_queue_message_t message;
+    EXPECT_FALSE(u_ringqueue_pop(queue, &message));
+}
+
+TEST_F(URingQueueF, Order)
+{
+    int values[8];
+    for (int i = 0; i < 8; ++i)
+    {
+        values[i] = i;
+        EXPECT_EQ(CA_STATUS_OK, u_ringqueue_push(queue, &values[i], sizeof(int)));
+    }
+    ASSERT_EQ(static_cast<uint32_t>(8), u_ringqueue_get_size(queue));
+
+    for (int i = 0; i < 8; ++i)
+    {
+        u_queue_message_t message;
+        ASSERT_TRUE(u_ringqueue_pop(queue, &message));
+        EXPECT_EQ(&values[i], message.msg);
+        EXPECT_EQ(sizeof(int), message.size);
+    }
+    ASSERT_EQ(static_cast<uint32_t>(0), u_ringqueue_get_size(queue));
+}
+
+TEST_F(URingQueueF, Full)
+{
+    int dummy = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(CA_STATUS_OK, u_ringqueue_push(queue, &dummy, sizeof(dummy)));
+    }
+
+    EXPECT_EQ(CA_STATUS_QUEUE_FULL, u_ringqueue_push(queue, &dummy, sizeof(dummy)));
+
+    u_queue_message_t message;
+    ASSERT_TRUE(u_ringqueue_pop(queue, &message));
+    EXPECT_EQ(CA_STATUS_OK, u_ringqueue_push(queue, &dummy, sizeof(dummy)));
+}
+
+TEST_F(URingQueueF, WrapAround)
+{
+    int values[3];
+    for (int lap = 0; lap < 1000; ++lap)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            EXPECT_EQ(CA_STATUS_OK, u_ringqueue_push(queue, &values[i], sizeof(int)));
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            u_queue_message_t message;
+            ASSERT_TRUE(u_ringqueue_pop(queue, &message));
+            EXPECT_EQ(&values[i], message.msg);
+        }
+    }
+    ASSERT_EQ(static_cast<uint32_t>(0), u_ringqueue_get_size(queue));
+}
+
+typedef struct
+{
+    u_ringqueue_t *queue;
+    uintptr_t producerId;
+} ProducerArg;
+
+static void *produce(void *data)
+{
+    ProducerArg *arg = (ProducerArg *) data;
+    for (uintptr_t i = 0; i < ITEMS_PER_PRODUCER; ++i)
+    {
+        // Encode the producer and the sequence number in the message pointer.
+        void *msg = (void *) ((arg->producerId << 24) | (i + 1));
+        while (CA_STATUS_OK != u_ringqueue_push(arg->queue, msg, 1))
+        {
+        }
+    }
+    return NULL;
+}
+
+TEST(URingQueue, MultiProducer)
+{
+    u_ringqueue_t *queue = u_ringqueue_create(64);
+    ASSERT_TRUE(queue != NULL);
+
+    oc_thread threads[PRODUCER_COUNT];
+    ProducerArg args[PRODUCER_COUNT];
+    for (int i = 0; i < PRODUCER_COUNT; ++i)
+    {
+        args[i].queue = queue;
+        args[i].producerId = i;
+        ASSERT_EQ(OC_THREAD_SUCCESS, oc_thread_new(&threads[i], produce, &args[i]));
+    }
+
+    // Messages of each producer must come out in the order they went in.
+    uintptr_t lastSeen[PRODUCER_COUNT] = { 0 };
+    int received = 0;
+    while (received < PRODUCER_COUNT * ITEMS_PER_PRODUCER)
+    {
+        u_queue_message_t message;
+        if (!u_ringqueue_pop(queue, &message))
+        {
+            continue;
+        }
+        uintptr_t value = (uintptr_t) message.msg;
+        uintptr_t producerId = value >> 24;
+        uintptr_t seq = value & 0xFFFFFF;
+        ASSERT_LT(producerId, static_cast<uintptr_t>(PRODUCER_COUNT));
+        EXPECT_EQ(lastSeen[producerId] + 1, seq);
+        lastSeen[producerId] = seq;
+        received++;
+    }
+
+    for (int i = 0; i < PRODUCER_COUNT; ++i)
+    {
+        EXPECT_EQ(OC_THREAD_SUCCESS, oc_thread_wait(threads[i]));
+        EXPECT_EQ(OC_THREAD_SUCCESS, oc_thread_free(threads[i]));
+        EXPECT_EQ(static_cast<uintptr_t>(ITEMS_PER_PRODUCER), lastSeen[i]);
+    }
+    EXPECT_EQ(static_cast<uint32_t>(0), u_ringqueue_get_size(queue));
+
+    EXPECT_EQ(CA_STATUS_OK, u_ringqueue_delete(queue));
+}
@@ -34,10 +34,13 @@ extern "C"
 #include "uqueue.h"
 #include "uarraylist.h"
 #include "test_common.h"
+#include "edge_prepared_group.h"
 }
 
 #define PRINT(str) std::cout<<str<<std::endl
 
+#define MAP_TEST_SIZE 1000
+
 edgeMap *sampleMap;
 
 class OPC_utilMap: public ::testing::Test
@@ -145,6 +148,139 @@ TEST_F(OPC_utilMap , deleteMap_P)
     EXPECT_EQ(sampleMap->head == NULL, true);
 }
 
+TEST_F(OPC_utilMap , stringMap_P)
+{
+    sampleMap = createStringMap();
+    EXPECT_EQ(sampleMap == NULL, false);
+
+    char key[8] = "key1";
+    EXPECT_EQ(insertMapElement(sampleMap, (keyValue) "key1", (keyValue) "value1"), true);
+    EXPECT_EQ(insertMapElement(sampleMap, (keyValue) "key2", (keyValue) "value2"), true);
+    // String keys are compared by content, not by pointer.
+    EXPECT_EQ((char * )getMapElement(sampleMap, (keyValue) key), "value1");
+    EXPECT_EQ(insertMapElement(sampleMap, (keyValue) key, (keyValue) "value3"), false);
+    EXPECT_EQ(getMapSize(sampleMap), 2u);
+
+    deleteMap(sampleMap);
+    EXPECT_EQ(getMapSize(sampleMap), 0u);
+    EdgeFree(sampleMap);
+}
+
+TEST_F(OPC_utilMap , removeMapElement_P)
+{
+    sampleMap = createMap();
+
+    static int values[MAP_TEST_SIZE];
+    for (int i = 0; i < MAP_TEST_SIZE; i++)
+    {
+        EXPECT_EQ(insertMapElement(sampleMap, (keyValue) &values[i], (keyValue) &values[i]), true);
+    }
+    EXPECT_EQ(getMapSize(sampleMap), (size_t) MAP_TEST_SIZE);
+
+    keyValue removedKey = NULL;
+    keyValue removedValue = NULL;
+    for (int i = 0; i < MAP_TEST_SIZE; i += 2)
+    {
+        EXPECT_EQ(removeMapElement(sampleMap, (keyValue) &values[i], &removedKey, &removedValue), true);
+        EXPECT_EQ(removedKey, (keyValue) &values[i]);
+        EXPECT_EQ(removedValue, (keyValue) &values[i]);
+    }
+    EXPECT_EQ(removeMapElement(sampleMap, (keyValue) &values[0], NULL, NULL), false);
+    EXPECT_EQ(getMapSize(sampleMap), (size_t) MAP_TEST_SIZE / 2);
+
+    for (int i = 0; i < MAP_TEST_SIZE; i++)
+    {
+        keyValue expected = (i % 2) ? (keyValue) &values[i] : NULL;
+        EXPECT_EQ(getMapElement(sampleMap, (keyValue) &values[i]), expected);
+    }
+
+    deleteMap(sampleMap);
+    EdgeFree(sampleMap);
+}
+
+TEST_F(OPC_utilMap , mapIterationOrder_P)
+{
+    sampleMap = createStringMap();
+
+    const char *keys[] = { "key6", "key1", "key3", "key2" };
+    for (size_t i = 0; i < 4; i++)
+    {
+        insertMapElement(sampleMap, (keyValue) keys[i], (keyValue) keys[i]);
+    }
+    removeMapElement(sampleMap, (keyValue) "key1", NULL, NULL);
+
+    // The elements are iterated in insertion order.
+    edgeMapNode *temp = sampleMap->head;
+    EXPECT_EQ(strcmp((char *) temp->key, "key6"), 0);
+    temp = temp->next;
+    EXPECT_EQ(strcmp((char *) temp->key, "key3"), 0);
+    temp = temp->next;
+    EXPECT_EQ(strcmp((char *) temp->key, "key2"), 0);
+    EXPECT_EQ(temp->next == NULL, true);
+    EXPECT_EQ(sampleMap->tail == temp, true);
+
+    deleteMap(sampleMap);
+    EdgeFree(sampleMap);
+}
+
+TEST_F(OPC_utilMap , mapManyElements_P)
+{
+    const int count = 10000;
+    char name[32];
+
+    sampleMap = createStringMap();
+    char **keys = (char **) EdgeCalloc(count, sizeof(char *));
+    ASSERT_EQ(keys == NULL, false);
+    for (int i = 0; i < count; i++)
+    {
+        snprintf(name, sizeof(name), "ns=2;s=Node%d", i);
+        keys[i] = cloneString(name);
+        ASSERT_EQ(keys[i] == NULL, false);
+        EXPECT_EQ(insertMapElement(sampleMap, (keyValue) keys[i], (keyValue) keys[i]), true);
+    }
+
+    // Keys are compared by content, so a copy of a key finds its element.
+    for (int i = 0; i < count; i++)
+    {
+        snprintf(name, sizeof(name), "ns=2;s=Node%d", i);
+        EXPECT_EQ(getMapElement(sampleMap, (keyValue) name), (keyValue) keys[i]);
+    }
+    EXPECT_EQ(getMapElement(sampleMap, (keyValue) "ns=2;s=Node-1") == NULL, true);
+    EXPECT_EQ(insertMapElement(sampleMap, (keyValue) keys[count / 2], (keyValue) keys[0]), false);
+    EXPECT_EQ(getMapElement(sampleMap, (keyValue) keys[count / 2]), (keyValue) keys[count / 2]);
+
+    deleteMap(sampleMap);
+    EdgeFree(sampleMap);
+    for (int i = 0; i < count; i++)
+    {
+        EdgeFree(keys[i]);
+    }
+    EdgeFree(keys);
+}
+
+TEST_F(OPC_utilMap , mapLookupWithLength_P)
+{
+    char key[] = "ns=2;s=Method";
+    sampleMap = createStringMap();
+    EXPECT_EQ(insertMapElement(sampleMap, (keyValue) key, (keyValue) key), true);
+
+    // The looked up characters need no NULL terminator.
+    const char *name = "ns=2;s=Methods";
+    EXPECT_EQ(getMapElementWithLength(sampleMap, name, strlen(key)), (keyValue) key);
+    EXPECT_EQ(getMapElementWithLength(sampleMap, name, strlen(name)) == NULL, true);
+    EXPECT_EQ(getMapElementWithLength(sampleMap, name, strlen(key) - 1) == NULL, true);
+    EXPECT_EQ(getMapElementWithLength(sampleMap, NULL, 0) == NULL, true);
+
+    edgeMap *pointerMap = createMap();
+    EXPECT_EQ(insertMapElement(pointerMap, (keyValue) key, (keyValue) key), true);
+    EXPECT_EQ(getMapElementWithLength(pointerMap, key, strlen(key)) == NULL, true);
+
+    deleteMap(pointerMap);
+    EdgeFree(pointerMap);
+    deleteMap(sampleMap);
+    EdgeFree(sampleMap);
+}
+
 TEST_F(OPC_util , cloneString_P)
 {
     char *retStr = NULL;
@@ -182,6 +318,171 @@ TEST_F(OPC_util , cloneData_ZeroLength)
     ASSERT_EQ(retVal == NULL, true);
 }
 
+TEST_F(OPC_util , hashEndpointAddress_P)
+{
+    uint32_t hash = hashEndpointAddress("opc.tcp://localhost:12686/edge-opc-server");
+
+    // Only host and port are hashed.
+    EXPECT_EQ(hash, hashEndpointAddress("opc.tcp://localhost:12686"));
+    EXPECT_EQ(hash, hashEndpointAddress("opc.tcp://localhost:12686/other-path"));
+    EXPECT_NE(hash, hashEndpointAddress("opc.tcp://localhost:12687/edge-opc-server"));
+    EXPECT_NE(hash, hashEndpointAddress("opc.tcp://remotehost:12686/edge-opc-server"));
+}
+
+TEST_F(OPC_util , getEndpointAddress_P)
+{
+    size_t length = 0;
+    const char *uri = "opc.tcp://localhost:12686/edge-opc-server";
+    const char *address = getEndpointAddress(uri, &length);
+    EXPECT_EQ(address, uri + strlen("opc.tcp://"));
+    EXPECT_EQ(length, strlen("localhost:12686"));
+    EXPECT_EQ(getEndpointAddress(NULL, &length), (const char *) NULL);
+}
+
+TEST_F(OPC_util , hashEndpointAddress_N)
+{
+    ASSERT_EQ(hashEndpointAddress(NULL), 0);
+}
+
+TEST_F(OPC_util , prepareReadGroup_P)
+{
+    EdgeMessage *msg = createEdgeAttributeMessage("opc.tcp://localhost:12686/edge-opc-server", 2,
+            CMD_READ);
+    ASSERT_EQ(msg != NULL, true);
+    insertReadAccessNode(&msg, "{2;S;v=0}String1");
+    insertReadAccessNode(&msg, "{2;S;v=0}String2");
+
+    EdgePreparedGroup *group = prepareReadGroup(msg);
+    ASSERT_EQ(group != NULL, true);
+    ASSERT_EQ(group->readValueIds != NULL, true);
+    EXPECT_EQ(group->readValueIds[1].attributeId, (UA_UInt32) UA_ATTRIBUTEID_VALUE);
+    EXPECT_EQ(group->readValueIds[1].nodeId.namespaceIndex, 2);
+
+    // An execution shares the nodes of the group and keeps it alive.
+    EdgeMessage *execution = createEdgePreparedMessage(group, NULL, NULL);
+    ASSERT_EQ(execution != NULL, true);
+    EXPECT_EQ(execution->requests, group->msg->requests);
+    EXPECT_EQ(execution->message_id, msg->message_id);
+    EXPECT_EQ(group->refCount, 2u);
+    freeEdgeMessage(execution);
+    EXPECT_EQ(group->refCount, 1u);
+
+    destroyPreparedGroup(group);
+    destroyEdgeMessage(msg);
+}
+
+TEST_F(OPC_util , prepareWriteGroup_P)
+{
+    EdgeMessage *msg = createEdgeMessage("opc.tcp://localhost:12686/edge-opc-server", 2, CMD_WRITE);
+    ASSERT_EQ(msg != NULL, true);
+    int32_t first = 1;
+    int32_t second = 2;
+    insertWriteAccessNode(&msg, "{2;S;v=6}Int32", &first, 1);
+    insertWriteAccessNode(&msg, "{2;S;v=6}UInt32", &second, 1);
+
+    EdgePreparedGroup *group = prepareWriteGroup(msg);
+    ASSERT_EQ(group != NULL, true);
+    ASSERT_EQ(group->writeValues != NULL, true);
+
+    int32_t value = 7;
+    void *values[2] = { &value, &value };
+    EdgeMessage *execution = createEdgePreparedMessage(group, values, NULL);
+    ASSERT_EQ(execution != NULL, true);
+    EdgeVersatility *written = (EdgeVersatility *) execution->requests[0]->value;
+    EXPECT_EQ(*(int32_t *) written->value, 7);
+    EXPECT_NE(written->value, (void *) &value);
+    EXPECT_EQ(execution->requests[0]->nodeInfo, group->msg->requests[0]->nodeInfo);
+    freeEdgeMessage(execution);
+
+    destroyPreparedGroup(group);
+    destroyEdgeMessage(msg);
+}
+
+TEST_F(OPC_util , mergedPollParts_P)
+{
+    const char *nodes[3] = { "{2;S;v=0}String1", "{2;S;v=0}String2", "{2;S;v=0}String3" };
+    EdgePreparedGroup *groups[3];
+    for (int i = 0; i < 3; i++)
+    {
+        EdgeMessage *msg = createEdgeAttributeMessage("opc.tcp://localhost:12686/edge-opc-server",
+                2, CMD_READ);
+        ASSERT_EQ(msg != NULL, true);
+        insertReadAccessNode(&msg, nodes[0]);
+        for (int j = 1; j <= i; j++)
+        {
+            insertReadAccessNode(&msg, nodes[j]);
+        }
+        groups[i] = prepareReadGroup(msg);
+        ASSERT_EQ(groups[i] != NULL, true);
+        destroyEdgeMessage(msg);
+    }
+
+    // Polls of 1, 2 and 3 nodes share a cycle.
+    EdgePreparedGroup *pair = (EdgePreparedGroup *) onPollMerge(groups[0], groups[1]);
+    ASSERT_EQ(pair != NULL, true);
+    EdgePreparedGroup *merged = (EdgePreparedGroup *) onPollMerge(pair, groups[2]);
+    ASSERT_EQ(merged != NULL, true);
+    ASSERT_EQ(merged->partCount, 3u);
+    EXPECT_EQ(merged->msg->requestLength, 6u);
+
+    uint32_t pollIds[3] = { 5, 6, 9 };
+    void *job = NULL;
+    EXPECT_EQ(onPollCycle(pollIds, 2, merged, &job), true);
+    EXPECT_EQ(job == NULL, true);
+    ASSERT_EQ(onPollCycle(pollIds, 3, merged, &job), true);
+    ASSERT_EQ(job != NULL, true);
+    EdgeMessage *execution = (EdgeMessage *) job;
+    EXPECT_EQ(execution->message_id, 5u);
+
+    // Each poll is answered with its own id and nodes.
+    size_t partCount = 0;
+    EdgeMessage *parts = createEdgePreparedPartMessages(execution, &partCount);
+    ASSERT_EQ(parts != NULL, true);
+    ASSERT_EQ(partCount, 3u);
+    size_t offset = 0;
+    for (size_t i = 0; i < partCount; i++)
+    {
+        EXPECT_EQ(parts[i].message_id, pollIds[i]);
+        EXPECT_EQ(parts[i].requestLength, i + 1);
+        EXPECT_EQ(parts[i].requests, execution->requests + offset);
+        EXPECT_EQ(parts[i].preparedGroup == NULL, true);
+        offset += parts[i].requestLength;
+    }
+    EdgeFree(parts);
+
+    // A single poll has no parts.
+    EXPECT_EQ(createEdgePreparedPartMessages(groups[0]->msg, &partCount) == NULL, true);
+    EXPECT_EQ(partCount, 0u);
+
+    freeEdgeMessage(execution);
+    onPollFree(merged);
+    onPollFree(pair);
+    for (int i = 0; i < 3; i++)
+    {
+        onPollFree(groups[i]);
+    }
+}
+
+TEST_F(OPC_util , prepareGroup_N)
+{
+    EXPECT_EQ(prepareReadGroup(NULL) == NULL, true);
+    EXPECT_EQ(prepareWriteGroup(NULL) == NULL, true);
+    EXPECT_EQ(executePreparedRead(NULL).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(executePreparedWrite(NULL, NULL, NULL).code, STATUS_PARAM_INVALID);
+
+    EdgeMessage *msg = createEdgeAttributeMessage("opc.tcp://localhost:12686/edge-opc-server", 2,
+            CMD_READ);
+    ASSERT_EQ(msg != NULL, true);
+    insertReadAccessNode(&msg, "{2;S;v=0}String1");
+    EXPECT_EQ(prepareWriteGroup(msg) == NULL, true);
+
+    EdgePreparedGroup *group = prepareReadGroup(msg);
+    ASSERT_EQ(group != NULL, true);
+    EXPECT_EQ(executePreparedWrite(group, NULL, NULL).code, STATUS_PARAM_INVALID);
+    destroyPreparedGroup(group);
+    destroyEdgeMessage(msg);
+}
+
 TEST_F(OPC_util , addListNode_HeadNull)
 {
     int dummyData = 10;
@@ -652,6 +953,91 @@ TEST_F(OPC_util , u_queue_get_head_N)
     ASSERT_EQ(u_queue_get_head(&queue), (void *)NULL); // Element is NULL
 }
 
+TEST_F(OPC_util , recordEdgeLatency_P)
+{
+    EdgeLatencyHistogram histogram;
+    memset(&histogram, 0, sizeof(histogram));
+    recordEdgeLatency(&histogram, 3);
+    recordEdgeLatency(&histogram, 100);
+    recordEdgeLatency(&histogram, 1000);
+
+    ASSERT_EQ(histogram.count, (uint64_t) 3);
+    ASSERT_EQ(histogram.totalUs, (uint64_t) 1103);
+    ASSERT_EQ(histogram.maxUs, (uint64_t) 1000);
+    ASSERT_EQ(histogram.buckets[getEdgeLatencyBucket(3)], (uint64_t) 1);
+    ASSERT_EQ(histogram.buckets[getEdgeLatencyBucket(100)], (uint64_t) 1);
+    ASSERT_EQ(histogram.buckets[getEdgeLatencyBucket(1000)], (uint64_t) 1);
+    ASSERT_EQ(getLatencyPercentile(&histogram, 100), (uint64_t) 1000);
+    ASSERT_EQ(getLatencyPercentile(NULL, 50), (uint64_t) 0);
+}
+
+TEST_F(OPC_util , getEdgeLatencyBucket_P)
+{
+    for (size_t i = 1; i < EDGE_LATENCY_HISTOGRAM_BUCKETS; i++)
+    {
+        uint64_t lowerBound = getEdgeLatencyBucketLowerBound(i);
+        ASSERT_GT(lowerBound, getEdgeLatencyBucketLowerBound(i - 1));
+        ASSERT_EQ(getEdgeLatencyBucket(lowerBound), i);
+        ASSERT_EQ(getEdgeLatencyBucket(lowerBound - 1), i - 1);
+    }
+    ASSERT_EQ(getEdgeLatencyBucket((uint64_t) -1), (size_t) (EDGE_LATENCY_HISTOGRAM_BUCKETS - 1));
+}
+
+TEST_F(OPC_util , mergeEdgeLatency_P)
+{
+    EdgeLatencyHistogram target, source;
+    memset(&target, 0, sizeof(target));
+    memset(&source, 0, sizeof(source));
+    recordEdgeLatency(&target, 10);
+    recordEdgeLatency(&source, 10);
+    recordEdgeLatency(&source, 5000);
+    mergeEdgeLatency(&target, &source);
+
+    ASSERT_EQ(target.count, (uint64_t) 3);
+    ASSERT_EQ(target.totalUs, (uint64_t) 5020);
+    ASSERT_EQ(target.maxUs, (uint64_t) 5000);
+    ASSERT_EQ(target.buckets[getEdgeLatencyBucket(10)], (uint64_t) 2);
+}
+
+TEST_F(OPC_util , convertToUANodeId_P)
+{
+    UA_NodeId nodeId;
+    EdgeNodeInfo *nodeInfo = createEdgeNodeInfo("{2;N;v=0}1001");
+    ASSERT_TRUE(NULL != nodeInfo);
+    ASSERT_EQ(nodeInfo->nodeId->integerNodeId, 1001);
+    ASSERT_TRUE(convertToUANodeId(nodeInfo, &nodeId));
+    ASSERT_EQ(nodeId.identifierType, UA_NODEIDTYPE_NUMERIC);
+    ASSERT_EQ(nodeId.namespaceIndex, 2);
+    ASSERT_EQ(nodeId.identifier.numeric, (UA_UInt32) 1001);
+    freeEdgeNodeInfo(nodeInfo);
+
+    nodeInfo = createEdgeNodeInfo("{2;S;v=11}Robot_Speed");
+    ASSERT_TRUE(NULL != nodeInfo);
+    ASSERT_TRUE(convertToUANodeId(nodeInfo, &nodeId));
+    ASSERT_EQ(nodeId.identifierType, UA_NODEIDTYPE_STRING);
+    ASSERT_EQ(nodeId.identifier.string.length, strlen("Robot_Speed"));
+    ASSERT_EQ(memcmp(nodeId.identifier.string.data, "Robot_Speed", nodeId.identifier.string.length), 0);
+    freeEdgeNodeInfo(nodeInfo);
+
+    nodeInfo = createEdgeNodeInfo("{1;G;v=0}72962b91-fa75-4ae6-8d28-b404dc7daf63");
+    ASSERT_TRUE(NULL != nodeInfo);
+    ASSERT_TRUE(convertToUANodeId(nodeInfo, &nodeId));
+    ASSERT_EQ(nodeId.identifierType, UA_NODEIDTYPE_GUID);
+    ASSERT_EQ(nodeId.identifier.guid.data1, (UA_UInt32) 0x72962b91);
+    ASSERT_EQ(nodeId.identifier.guid.data4[7], 0x63);
+    freeEdgeNodeInfo(nodeInfo);
+}
+
+TEST_F(OPC_util , convertToUANodeId_N)
+{
+    UA_NodeId nodeId;
+    ASSERT_FALSE(convertToUANodeId(NULL, &nodeId));
+    EdgeNodeInfo *nodeInfo = createEdgeNodeInfo("{1;G;v=0}72962b91-fa75");
+    ASSERT_TRUE(NULL != nodeInfo);
+    ASSERT_FALSE(convertToUANodeId(nodeInfo, &nodeId));
+    freeEdgeNodeInfo(nodeInfo);
+}
+
 /*
  int main(int argc, char **argv) {
  ::testing::InitGoogleTest(&argc, argv);
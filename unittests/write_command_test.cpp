@@ -0,0 +1,283 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include "opcua_manager.h"
+#include "write.h"
+#include "message_dispatcher.h"
+#include "edge_server_capabilities.h"
+#include "edge_utils.h"
+#include "edge_malloc.h"
+}
+
+#define TEST_ENDPOINT "opc.tcp://localhost:12686/edge-opc-server"
+
+// A response received for a write message, with the requestId and status of each node.
+struct ReceivedWrite
+{
+    EdgeMessageType type;
+    uint32_t messageId;
+    std::vector<int> requestIds;
+    std::vector<uint32_t> statuses;
+    std::vector<std::string> statusNames;
+};
+
+static pthread_mutex_t g_receivedMutex = PTHREAD_MUTEX_INITIALIZER;
+static std::vector<ReceivedWrite> g_received;
+static std::vector<size_t> g_writeCallSizes;
+// Service result of the write call of this index, the calls before it succeed.
+static size_t g_failingCall = SIZE_MAX;
+static UA_StatusCode g_failingResult = UA_STATUSCODE_GOOD;
+// Write call of this index answers one result less than it was asked for.
+static size_t g_shortCall = SIZE_MAX;
+static int g_fakeClient;
+
+// Nodes of these numbers are not writable, the others are written.
+static std::vector<int> g_badNodes;
+
+static int getNodeNumber(const UA_WriteValue *value)
+{
+    const UA_String *name = &value->nodeId.identifier.string;
+    char node[32] = { 0 };
+    memcpy(node, name->data, (name->length < sizeof(node)) ? name->length : sizeof(node) - 1);
+    return atoi(node + strlen("Node"));
+}
+
+static UA_WriteResponse fakeWrite(UA_Client *client, const UA_WriteRequest request)
+{
+    (void) client;
+    size_t call = g_writeCallSizes.size();
+    g_writeCallSizes.push_back(request.nodesToWriteSize);
+    UA_WriteResponse response;
+    UA_WriteResponse_init(&response);
+    if (call == g_failingCall)
+    {
+        response.responseHeader.serviceResult = g_failingResult;
+        return response;
+    }
+    size_t resultsSize = request.nodesToWriteSize - ((call == g_shortCall) ? 1 : 0);
+    response.results = (UA_StatusCode *) UA_Array_new(resultsSize,
+            &UA_TYPES[UA_TYPES_STATUSCODE]);
+    response.resultsSize = resultsSize;
+    for (size_t i = 0; i < resultsSize; i++)
+    {
+        int node = getNodeNumber(&request.nodesToWrite[i]);
+        bool bad = false;
+        for (size_t j = 0; j < g_badNodes.size(); j++)
+        {
+            bad = bad || (g_badNodes[j] == node);
+        }
+        response.results[i] = bad ? UA_STATUSCODE_BADNOTWRITABLE : UA_STATUSCODE_GOOD;
+    }
+    return response;
+}
+
+static void recordResponse(EdgeMessage *msg)
+{
+    ReceivedWrite received;
+    received.type = msg->type;
+    received.messageId = msg->message_id;
+    for (size_t i = 0; GENERAL_RESPONSE == msg->type && i < msg->responseLength; i++)
+    {
+        EdgeResponse *response = msg->responses[i];
+        received.requestIds.push_back(response->requestId);
+        received.statuses.push_back(response->status);
+        received.statusNames.push_back((const char *) response->message->value);
+    }
+    pthread_mutex_lock(&g_receivedMutex);
+    g_received.push_back(received);
+    pthread_mutex_unlock(&g_receivedMutex);
+}
+
+// Waits up to a second for the response.
+static bool waitForResponse()
+{
+    for (int i = 0; i < 100; i++)
+    {
+        pthread_mutex_lock(&g_receivedMutex);
+        bool received = !g_received.empty();
+        pthread_mutex_unlock(&g_receivedMutex);
+        if (received)
+        {
+            return true;
+        }
+        usleep(10 * 1000);
+    }
+    return false;
+}
+
+// A write of Int32 N to the nodes "Node1" to "Node<count>", whose requestIds are their numbers.
+// count > 1.
+static EdgeMessage *createWriteMessage(uint32_t messageId, int count)
+{
+    EdgeMessage *msg = createEdgeMessage(TEST_ENDPOINT, count, CMD_WRITE);
+    for (int i = 0; i < count; i++)
+    {
+        char node[32];
+        snprintf(node, sizeof(node), "{2;S;v=6}Node%d", i + 1);
+        int32_t value = i + 1;
+        insertWriteAccessNode(&msg, node, &value, 1);
+        msg->requests[i]->requestId = i + 1;
+    }
+    msg->message_id = messageId;
+    return msg;
+}
+
+class WriteCommandF : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        g_received.clear();
+        g_writeCallSizes.clear();
+        g_badNodes.clear();
+        g_failingCall = SIZE_MAX;
+        g_failingResult = UA_STATUSCODE_GOOD;
+        g_shortCall = SIZE_MAX;
+        setWriteService(fakeWrite);
+        registerMQCallback(recordResponse, onSendMessage);
+        init_queue();
+    }
+
+    virtual void TearDown()
+    {
+        delete_queue();
+        registerMQCallback(onResponseMessage, onSendMessage);
+        setWriteService(NULL);
+        removeServerCapabilities(client());
+    }
+
+    UA_Client *client()
+    {
+        return (UA_Client *) &g_fakeClient;
+    }
+
+    void setMaxNodesPerWrite(uint32_t maxNodesPerWrite)
+    {
+        EdgeServerCapabilities capabilities;
+        memset(&capabilities, 0, sizeof(capabilities));
+        capabilities.maxNodesPerWrite = maxNodesPerWrite;
+        ASSERT_TRUE(setServerCapabilities(client(), &capabilities));
+    }
+
+    // Writes count nodes and checks that every node is answered once, in the request order.
+    const ReceivedWrite &writeNodes(int count)
+    {
+        EdgeMessage *msg = createWriteMessage(31, count);
+        EXPECT_EQ(STATUS_OK, executeWrite(client(), msg).code);
+        destroyEdgeMessage(msg);
+
+        EXPECT_TRUE(waitForResponse());
+        usleep(20 * 1000);
+        EXPECT_EQ(1u, g_received.size());
+        const ReceivedWrite &received = g_received[0];
+        EXPECT_EQ(GENERAL_RESPONSE, received.type);
+        EXPECT_EQ(31u, received.messageId);
+        EXPECT_EQ((size_t) count, received.requestIds.size());
+        for (size_t i = 0; i < received.requestIds.size(); i++)
+        {
+            EXPECT_EQ((int) i + 1, received.requestIds[i]);
+            EXPECT_STREQ(UA_StatusCode_name(received.statuses[i]),
+                    received.statusNames[i].c_str());
+        }
+        return received;
+    }
+};
+
+TEST_F(WriteCommandF, ChunkedWriteAnswersEachNodeInOrder)
+{
+    setMaxNodesPerWrite(2);
+    g_badNodes.push_back(2);
+    g_badNodes.push_back(5);
+    const ReceivedWrite &received = writeNodes(5);
+
+    ASSERT_EQ(3u, g_writeCallSizes.size());
+    EXPECT_EQ(2u, g_writeCallSizes[0]);
+    EXPECT_EQ(2u, g_writeCallSizes[1]);
+    EXPECT_EQ(1u, g_writeCallSizes[2]);
+    ASSERT_EQ(5u, received.statuses.size());
+    EXPECT_EQ(UA_STATUSCODE_GOOD, received.statuses[0]);
+    EXPECT_EQ(UA_STATUSCODE_BADNOTWRITABLE, received.statuses[1]);
+    EXPECT_EQ(UA_STATUSCODE_GOOD, received.statuses[2]);
+    EXPECT_EQ(UA_STATUSCODE_GOOD, received.statuses[3]);
+    EXPECT_EQ(UA_STATUSCODE_BADNOTWRITABLE, received.statuses[4]);
+}
+
+TEST_F(WriteCommandF, FailedWriteGivesItsStatusToEveryNode)
+{
+    g_failingCall = 0;
+    g_failingResult = UA_STATUSCODE_BADTIMEOUT;
+    const ReceivedWrite &received = writeNodes(3);
+
+    ASSERT_EQ(1u, g_writeCallSizes.size());
+    EXPECT_EQ(3u, g_writeCallSizes[0]);
+    ASSERT_EQ(3u, received.statuses.size());
+    for (size_t i = 0; i < received.statuses.size(); i++)
+    {
+        EXPECT_EQ(UA_STATUSCODE_BADTIMEOUT, received.statuses[i]);
+    }
+}
+
+TEST_F(WriteCommandF, FailedChunkGivesItsStatusToTheRemainingChunks)
+{
+    setMaxNodesPerWrite(2);
+    g_badNodes.push_back(1);
+    g_failingCall = 1;
+    g_failingResult = UA_STATUSCODE_BADTOOMANYOPERATIONS;
+    const ReceivedWrite &received = writeNodes(6);
+
+    // The chunks after the failed one are not written.
+    ASSERT_EQ(2u, g_writeCallSizes.size());
+    ASSERT_EQ(6u, received.statuses.size());
+    EXPECT_EQ(UA_STATUSCODE_BADNOTWRITABLE, received.statuses[0]);
+    EXPECT_EQ(UA_STATUSCODE_GOOD, received.statuses[1]);
+    for (size_t i = 2; i < received.statuses.size(); i++)
+    {
+        EXPECT_EQ(UA_STATUSCODE_BADTOOMANYOPERATIONS, received.statuses[i]);
+    }
+}
+
+TEST_F(WriteCommandF, ResultCountMismatchFailsTheRemainingChunks)
+{
+    setMaxNodesPerWrite(2);
+    g_shortCall = 1;
+    const ReceivedWrite &received = writeNodes(5);
+
+    ASSERT_EQ(2u, g_writeCallSizes.size());
+    ASSERT_EQ(5u, received.statuses.size());
+    EXPECT_EQ(UA_STATUSCODE_GOOD, received.statuses[0]);
+    EXPECT_EQ(UA_STATUSCODE_GOOD, received.statuses[1]);
+    for (size_t i = 2; i < received.statuses.size(); i++)
+    {
+        EXPECT_EQ(UA_STATUSCODE_BADUNEXPECTEDERROR, received.statuses[i]);
+    }
+}